@@ -15,22 +15,30 @@
 #include "MLLib/config.hpp"
 #include "MLLib/device/device.hpp"
 #include "MLLib/ndarray.hpp"
+#include "MLLib/ndarray_expr.hpp"
+#include "MLLib/sparse.hpp"
 
 // Backend components
 #include "MLLib/backend/backend.hpp"
+#include "MLLib/backend/placement.hpp"
+#include "MLLib/backend/stream.hpp"
 
 // Data processing
 #include "MLLib/data/batch.hpp"
 #include "MLLib/data/loader.hpp"
 #include "MLLib/data/preprocess.hpp"
+#include "MLLib/data/window.hpp"
 
 // Layer base and implementations
 #include "MLLib/layer/base.hpp"
+#include "MLLib/layer/attention.hpp"
 #include "MLLib/layer/convolution2d.hpp"
 #include "MLLib/layer/dense.hpp"
 #include "MLLib/layer/dropout.hpp"
 #include "MLLib/layer/flatten.hpp"
 #include "MLLib/layer/pooling.hpp"
+#include "MLLib/layer/pruning.hpp"
+#include "MLLib/layer/recurrent.hpp"
 
 // Activation functions
 #include "MLLib/layer/activation/activation.hpp"
@@ -44,16 +52,21 @@
 #include "MLLib/loss/mse.hpp"
 
 // Model components
+#include "MLLib/model/batching_executor.hpp"
 #include "MLLib/model/custom.hpp"
 #include "MLLib/model/functional.hpp"
 #include "MLLib/model/model_io.hpp"
 #include "MLLib/model/sequential.hpp"
+#include "MLLib/model/static_sequential.hpp"
 
 // Autoencoder models
 #include "MLLib/model/autoencoder/anomaly_detector.hpp"
 #include "MLLib/model/autoencoder/base.hpp"
+#include "MLLib/model/autoencoder/convolutional.hpp"
 #include "MLLib/model/autoencoder/denoising.hpp"
 #include "MLLib/model/autoencoder/dense.hpp"
+#include "MLLib/model/autoencoder/recurrent.hpp"
+#include "MLLib/model/autoencoder/sparse.hpp"
 #include "MLLib/model/autoencoder/variational.hpp"
 
 // Optimization
@@ -2,6 +2,8 @@
 
 #include "../device/device.hpp"
 #include "../ndarray.hpp"
+#include "device_memory.hpp"
+#include <memory>
 #include <vector>
 
 /**
@@ -25,9 +27,38 @@ enum class GPUBackendType {
   ONEAPI   ///< Intel oneAPI
 };
 
+/**
+ * @struct BackendOps
+ * @brief Table of operation entry points for one device
+ * @details Backend resolves the table once per device switch, so each
+ * operation costs one indirect call instead of a device query and a
+ * try/catch per element-wise op.
+ */
+struct BackendOps {
+  void (*matmul)(const NDArray&, const NDArray&, NDArray&);
+  void (*add)(const NDArray&, const NDArray&, NDArray&);
+  void (*subtract)(const NDArray&, const NDArray&, NDArray&);
+  void (*multiply)(const NDArray&, const NDArray&, NDArray&);
+  void (*add_scalar)(const NDArray&, double, NDArray&);
+  void (*multiply_scalar)(const NDArray&, double, NDArray&);
+  void (*fill)(NDArray&, double);
+  void (*copy)(const NDArray&, NDArray&);
+  void (*axpy)(double, const NDArray&, NDArray&);
+  void (*axpby)(double, const NDArray&, double, NDArray&);
+  void (*multiply_add)(const NDArray&, const NDArray&, NDArray&);
+};
+
+template <DeviceType D>
+class StaticBackend;
+
 /**
  * @class Backend
  * @brief Backend interface for device-specific operations
+ * @details Operations write into a caller-provided result. A result with
+ * the right element count is reshaped in place and reused; storage is
+ * allocated only when the count differs. The accumulating operations
+ * (axpy, axpby, multiply_add) update their destination in place and never
+ * allocate.
  */
 class Backend {
 public:
@@ -112,7 +143,68 @@ public:
    */
   static void copy(const NDArray& src, NDArray& dst);
 
+  /**
+   * @brief y += alpha * x
+   * @param alpha Scale of x
+   * @param x Input array
+   * @param y Accumulator, same shape as x
+   * @throws std::invalid_argument if the shapes differ
+   */
+  static void axpy(double alpha, const NDArray& x, NDArray& y);
+
+  /**
+   * @brief y = alpha * x + beta * y
+   * @throws std::invalid_argument if the shapes differ
+   */
+  static void axpby(double alpha, const NDArray& x, double beta, NDArray& y);
+
+  /**
+   * @brief y += a * b element-wise (fused multiply-add)
+   * @throws std::invalid_argument if the shapes differ
+   */
+  static void multiply_add(const NDArray& a, const NDArray& b, NDArray& y);
+
+  /**
+   * @brief Install the device memory used for device-resident arrays
+   * @param memory Backend owning device buffers, or nullptr to disable
+   * @details While installed and the current device is GPU, GPU operations
+   * leave their results in device memory; NDArray downloads them only when
+   * the host reads the data.
+   */
+  static void
+  setDeviceMemoryBackend(std::shared_ptr<DeviceMemoryBackend> memory);
+
+  /**
+   * @brief Get the installed device memory backend
+   * @return Device memory backend, or nullptr if none is installed
+   */
+  static std::shared_ptr<DeviceMemoryBackend> getDeviceMemoryBackend();
+
+  /**
+   * @brief Get the dispatch table for the current device
+   * @return Table resolved at the last device switch
+   */
+  static const BackendOps& getOps();
+
+  /**
+   * @brief Get the dispatch table for a device
+   * @param device Device type; AUTO places each call with
+   * PlacementScheduler::global()
+   * @return Table with statically bound entry points
+   */
+  static const BackendOps& getOps(DeviceType device);
+
+  /**
+   * @brief Re-resolve the dispatch table from Device::getCurrentDevice()
+   * @details Called automatically by Device::setDevice(); only needed if
+   * the device is changed by other means.
+   */
+  static void refreshDispatch();
+
 private:
+  template <DeviceType D>
+  friend class StaticBackend;
+
   // CPU-specific implementations
   static void cpu_matmul(const NDArray& a, const NDArray& b, NDArray& result);
   static void cpu_add(const NDArray& a, const NDArray& b, NDArray& result);
@@ -123,6 +215,11 @@ private:
                                   NDArray& result);
   static void cpu_fill(NDArray& array, double value);
   static void cpu_copy(const NDArray& src, NDArray& dst);
+  static void cpu_axpy(double alpha, const NDArray& x, NDArray& y);
+  static void cpu_axpby(double alpha, const NDArray& x, double beta,
+                        NDArray& y);
+  static void cpu_multiply_add(const NDArray& a, const NDArray& b,
+                               NDArray& y);
 
   // GPU-specific implementations
   static void gpu_matmul(const NDArray& a, const NDArray& b, NDArray& result);
@@ -134,7 +231,121 @@ private:
                                   NDArray& result);
   static void gpu_fill(NDArray& array, double value);
   static void gpu_copy(const NDArray& src, NDArray& dst);
+  static void gpu_axpy(double alpha, const NDArray& x, NDArray& y);
+  static void gpu_axpby(double alpha, const NDArray& x, double beta,
+                        NDArray& y);
+  static void gpu_multiply_add(const NDArray& a, const NDArray& b,
+                               NDArray& y);
 };
 
+/**
+ * @class StaticBackend
+ * @brief Backend operations bound to one device at compile time
+ * @details Calls resolve directly to the device implementation with no
+ * runtime dispatch. DefaultBackend is StaticBackend<CPU> in CPU_ONLY
+ * builds and the runtime-dispatched Backend otherwise, so layers can use
+ * it unconditionally.
+ */
+template <DeviceType D>
+class StaticBackend {
+  static constexpr bool kGPU = D == DeviceType::GPU;
+
+public:
+  static void matmul(const NDArray& a, const NDArray& b, NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_matmul(a, b, result);
+    } else {
+      Backend::cpu_matmul(a, b, result);
+    }
+  }
+
+  static void add(const NDArray& a, const NDArray& b, NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_add(a, b, result);
+    } else {
+      Backend::cpu_add(a, b, result);
+    }
+  }
+
+  static void subtract(const NDArray& a, const NDArray& b, NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_subtract(a, b, result);
+    } else {
+      Backend::cpu_subtract(a, b, result);
+    }
+  }
+
+  static void multiply(const NDArray& a, const NDArray& b, NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_multiply(a, b, result);
+    } else {
+      Backend::cpu_multiply(a, b, result);
+    }
+  }
+
+  static void add_scalar(const NDArray& a, double scalar, NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_add_scalar(a, scalar, result);
+    } else {
+      Backend::cpu_add_scalar(a, scalar, result);
+    }
+  }
+
+  static void multiply_scalar(const NDArray& a, double scalar,
+                              NDArray& result) {
+    if constexpr (kGPU) {
+      Backend::gpu_multiply_scalar(a, scalar, result);
+    } else {
+      Backend::cpu_multiply_scalar(a, scalar, result);
+    }
+  }
+
+  static void fill(NDArray& array, double value) {
+    if constexpr (kGPU) {
+      Backend::gpu_fill(array, value);
+    } else {
+      Backend::cpu_fill(array, value);
+    }
+  }
+
+  static void copy(const NDArray& src, NDArray& dst) {
+    if constexpr (kGPU) {
+      Backend::gpu_copy(src, dst);
+    } else {
+      Backend::cpu_copy(src, dst);
+    }
+  }
+
+  static void axpy(double alpha, const NDArray& x, NDArray& y) {
+    if constexpr (kGPU) {
+      Backend::gpu_axpy(alpha, x, y);
+    } else {
+      Backend::cpu_axpy(alpha, x, y);
+    }
+  }
+
+  static void axpby(double alpha, const NDArray& x, double beta, NDArray& y) {
+    if constexpr (kGPU) {
+      Backend::gpu_axpby(alpha, x, beta, y);
+    } else {
+      Backend::cpu_axpby(alpha, x, beta, y);
+    }
+  }
+
+  static void multiply_add(const NDArray& a, const NDArray& b, NDArray& y) {
+    if constexpr (kGPU) {
+      Backend::gpu_multiply_add(a, b, y);
+    } else {
+      Backend::cpu_multiply_add(a, b, y);
+    }
+  }
+};
+
+#ifdef CPU_ONLY
+using DefaultBackend = StaticBackend<DeviceType::CPU>;
+#else
+using DefaultBackend = Backend;
+#endif
+
 }  // namespace Backend
 }  // namespace MLLib
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file device_memory.hpp
+ * @brief Device memory interface for device-resident NDArray storage
+ *
+ * A DeviceMemoryBackend owns buffers in a separate address space and runs
+ * Backend operations on them. When one is installed with
+ * Backend::setDeviceMemoryBackend() and the current device is GPU, Backend
+ * operations keep their results on the device and NDArray copies data back
+ * only when the host reads it.
+ */
+
+namespace MLLib {
+namespace Backend {
+
+class DeviceMemoryBackend;
+
+/**
+ * @class DeviceBuffer
+ * @brief Storage for doubles in device memory
+ */
+class DeviceBuffer {
+public:
+  virtual ~DeviceBuffer() = default;
+
+  /**
+   * @brief Copy host data into the buffer
+   * @param host Source in host memory
+   * @param count Number of elements
+   */
+  virtual void upload(const double* host, size_t count) = 0;
+
+  /**
+   * @brief Copy the buffer back to host memory
+   * @param host Destination in host memory
+   * @param count Number of elements
+   */
+  virtual void download(double* host, size_t count) const = 0;
+
+  /**
+   * @brief Get number of elements the buffer holds
+   * @return Capacity in elements
+   */
+  virtual size_t size() const = 0;
+
+  /**
+   * @brief Get the backend that allocated this buffer
+   * @return Owning backend
+   */
+  virtual const DeviceMemoryBackend* owner() const = 0;
+};
+
+/**
+ * @class DeviceMemoryBackend
+ * @brief Allocates device buffers and runs operations on them
+ *
+ * Shapes are validated by Backend before these are called.
+ */
+class DeviceMemoryBackend {
+public:
+  virtual ~DeviceMemoryBackend() = default;
+
+  /**
+   * @brief Allocate an uninitialized device buffer
+   * @param count Number of elements
+   * @return New buffer
+   */
+  virtual std::shared_ptr<DeviceBuffer> allocate(size_t count) = 0;
+
+  /**
+   * @brief c[m, n] = a[m, k] * b[k, n]
+   */
+  virtual void matmul(const DeviceBuffer& a, const DeviceBuffer& b,
+                      DeviceBuffer& c, size_t m, size_t k, size_t n) = 0;
+
+  /**
+   * @brief out = a + b (element-wise)
+   */
+  virtual void add(const DeviceBuffer& a, const DeviceBuffer& b,
+                   DeviceBuffer& out, size_t count) = 0;
+
+  /**
+   * @brief out = a - b (element-wise)
+   */
+  virtual void subtract(const DeviceBuffer& a, const DeviceBuffer& b,
+                        DeviceBuffer& out, size_t count) = 0;
+
+  /**
+   * @brief out = a * b (element-wise)
+   */
+  virtual void multiply(const DeviceBuffer& a, const DeviceBuffer& b,
+                        DeviceBuffer& out, size_t count) = 0;
+
+  /**
+   * @brief out = a + scalar
+   */
+  virtual void add_scalar(const DeviceBuffer& a, double scalar,
+                          DeviceBuffer& out, size_t count) = 0;
+
+  /**
+   * @brief out = a * scalar
+   */
+  virtual void multiply_scalar(const DeviceBuffer& a, double scalar,
+                               DeviceBuffer& out, size_t count) = 0;
+
+  /**
+   * @brief Set every element of buffer to value
+   */
+  virtual void fill(DeviceBuffer& buffer, double value, size_t count) = 0;
+
+  /**
+   * @brief Device-to-device copy
+   */
+  virtual void copy(const DeviceBuffer& src, DeviceBuffer& dst,
+                    size_t count) = 0;
+
+  /**
+   * @brief y = alpha * x + beta * y
+   */
+  virtual void axpby(double alpha, const DeviceBuffer& x, double beta,
+                     DeviceBuffer& y, size_t count) = 0;
+
+  /**
+   * @brief y += a * b (element-wise)
+   */
+  virtual void multiply_add(const DeviceBuffer& a, const DeviceBuffer& b,
+                            DeviceBuffer& y, size_t count) = 0;
+};
+
+}  // namespace Backend
+}  // namespace MLLib
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file expression_kernel.hpp
+ * @brief CPU execution of element-wise kernel expressions
+ *
+ * Kernel expressions are the C-like snippets used to generate GPU kernels,
+ * e.g. "input > 0.0f ? input : alpha * input". An ExpressionKernel compiles
+ * one into bytecode for a small stack machine. Each instruction is applied
+ * to a whole block of elements at a time, so the per-instruction dispatch
+ * cost is amortized and the inner loops are simple enough for the compiler
+ * to vectorize. Blocks are spread over util::ThreadPool::global().
+ *
+ * Supported syntax: floating-point literals (an 'f' suffix is accepted),
+ * variables and parameters by name, unary - + !, binary * / + -,
+ * comparisons, && ||, the ternary operator, and the functions exp, log,
+ * sqrt, tanh, sin, cos, abs, fabs, floor, ceil (one argument) and max, min,
+ * fmax, fmin, pow (two arguments).
+ */
+
+namespace MLLib {
+namespace Backend {
+
+/**
+ * @class ExpressionKernel
+ * @brief Element-wise expression compiled for the CPU
+ */
+class ExpressionKernel {
+public:
+  /**
+   * @brief Elements per block evaluated by one instruction
+   */
+  static constexpr size_t BLOCK_SIZE = 256;
+
+  /**
+   * @brief Compile an expression
+   * @param expression Expression source
+   * @param variables Names of per-element inputs, e.g. {"input"}
+   * @param parameters Names of scalar parameters, e.g. {"alpha"}
+   * @throws std::invalid_argument on syntax errors or unknown names
+   */
+  ExpressionKernel(const std::string& expression,
+                   const std::vector<std::string>& variables,
+                   const std::vector<std::string>& parameters = {});
+
+  /**
+   * @brief Evaluate the expression for every element
+   * @param inputs One pointer per variable, each with size elements
+   * @param output Destination with size elements (may alias an input)
+   * @param size Number of elements
+   * @param params One value per parameter
+   * @throws std::invalid_argument if the input or parameter count is wrong
+   */
+  void execute(const std::vector<const double*>& inputs, double* output,
+               size_t size, const std::vector<double>& params = {}) const;
+
+  /**
+   * @brief Get the source expression
+   * @return Expression as passed to the constructor
+   */
+  const std::string& expression() const { return expression_; }
+
+  /**
+   * @brief Get number of per-element inputs
+   * @return Variable count
+   */
+  size_t variable_count() const { return variable_count_; }
+
+  /**
+   * @brief Get number of scalar parameters
+   * @return Parameter count
+   */
+  size_t parameter_count() const { return parameter_count_; }
+
+  /**
+   * @brief Get number of bytecode instructions
+   * @return Program length
+   */
+  size_t instruction_count() const { return code_.size(); }
+
+private:
+  enum class OpCode : uint8_t {
+    LOAD_VAR,
+    LOAD_PARAM,
+    CONST,
+    NEG,
+    NOT,
+    EXP,
+    LOG,
+    SQRT,
+    TANH,
+    SIN,
+    COS,
+    ABS,
+    FLOOR,
+    CEIL,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MAX,
+    MIN,
+    POW,
+    LT,
+    GT,
+    LE,
+    GE,
+    EQ,
+    NE,
+    AND,
+    OR,
+    SELECT
+  };
+
+  struct Instruction {
+    OpCode op;
+    size_t index;  ///< Variable or parameter index
+    double value;  ///< Constant value
+  };
+
+  class Parser;
+
+  /**
+   * @brief Run a program over one block of at most BLOCK_SIZE elements
+   * @param stack Scratch space of depth * BLOCK_SIZE elements
+   */
+  static void run_block(const std::vector<Instruction>& code,
+                        const double* const* inputs, double* output,
+                        size_t count, const double* params, double* stack);
+
+  std::string expression_;
+  size_t variable_count_;
+  size_t parameter_count_;
+  std::vector<Instruction> code_;
+  size_t max_depth_;
+};
+
+}  // namespace Backend
+}  // namespace MLLib
@@ -27,7 +27,7 @@ namespace Backend {
  */
 struct KernelParams {
   std::string name;
-  std::string source;
+  std::string source;  // Complete backend shader source (Metal builds only)
   std::vector<double>
       constants;  // For parameterized kernels (e.g., LeakyReLU alpha)
 };
@@ -69,9 +69,28 @@ public:
   /**
    * @brief Register a new kernel
    * @param kernel_params Kernel definition
+   * @details The source is backend shader code, so builds without that
+   * backend ignore it. Use registerExpressionKernel() for kernels that must
+   * run on every build.
    */
   static void registerKernel(const KernelParams& kernel_params);
 
+  /**
+   * @brief Register an element-wise expression kernel on every backend
+   * @param name Kernel name used by executeUnaryKernel/executeBinaryKernel
+   * @param expression Expression over "input" (one input) or "input1" and
+   * "input2" (two inputs); constants are bound to p0, p1, ...
+   * @param inputs Number of inputs, 1 or 2
+   * @param constants Default values of p0, p1, ...
+   * @throws std::invalid_argument if inputs is not 1 or 2, or the expression
+   * does not compile
+   */
+  static void registerExpressionKernel(const std::string& name,
+                                       const std::string& expression,
+                                       size_t inputs,
+                                       const std::vector<double>& constants =
+                                           {});
+
   /**
    * @brief Initialize all built-in kernels
    */
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "device_memory.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file mock_device.hpp
+ * @brief Simulated device memory backend for CPU-only machines
+ *
+ * Buffers live in separate host allocations, so data only moves between an
+ * NDArray and the "device" through counted uploads and downloads. Tests use
+ * it to check that device-resident chains avoid host round trips.
+ */
+
+namespace MLLib {
+namespace Backend {
+
+/**
+ * @struct TransferStats
+ * @brief Counters collected by MockDeviceMemoryBackend
+ */
+struct TransferStats {
+  size_t uploads = 0;           ///< Host-to-device copies
+  size_t downloads = 0;         ///< Device-to-host copies
+  size_t bytes_uploaded = 0;    ///< Bytes copied host-to-device
+  size_t bytes_downloaded = 0;  ///< Bytes copied device-to-host
+  size_t allocations = 0;       ///< Device buffers allocated
+  size_t kernel_launches = 0;   ///< Operations executed on the device
+};
+
+/**
+ * @class MockDeviceMemoryBackend
+ * @brief DeviceMemoryBackend that simulates separate memory and counts
+ * transfers
+ */
+class MockDeviceMemoryBackend : public DeviceMemoryBackend {
+public:
+  /**
+   * @brief Get a snapshot of the counters
+   * @return Transfer statistics
+   */
+  TransferStats stats() const;
+
+  /**
+   * @brief Reset all counters to zero
+   */
+  void reset_stats();
+
+  std::shared_ptr<DeviceBuffer> allocate(size_t count) override;
+  void matmul(const DeviceBuffer& a, const DeviceBuffer& b, DeviceBuffer& c,
+              size_t m, size_t k, size_t n) override;
+  void add(const DeviceBuffer& a, const DeviceBuffer& b, DeviceBuffer& out,
+           size_t count) override;
+  void subtract(const DeviceBuffer& a, const DeviceBuffer& b,
+                DeviceBuffer& out, size_t count) override;
+  void multiply(const DeviceBuffer& a, const DeviceBuffer& b,
+                DeviceBuffer& out, size_t count) override;
+  void add_scalar(const DeviceBuffer& a, double scalar, DeviceBuffer& out,
+                  size_t count) override;
+  void multiply_scalar(const DeviceBuffer& a, double scalar,
+                       DeviceBuffer& out, size_t count) override;
+  void fill(DeviceBuffer& buffer, double value, size_t count) override;
+  void copy(const DeviceBuffer& src, DeviceBuffer& dst,
+            size_t count) override;
+  void axpby(double alpha, const DeviceBuffer& x, double beta, DeviceBuffer& y,
+             size_t count) override;
+  void multiply_add(const DeviceBuffer& a, const DeviceBuffer& b,
+                    DeviceBuffer& y, size_t count) override;
+
+private:
+  friend class MockDeviceBuffer;
+
+  std::atomic<size_t> uploads_{0};
+  std::atomic<size_t> downloads_{0};
+  std::atomic<size_t> bytes_uploaded_{0};
+  std::atomic<size_t> bytes_downloaded_{0};
+  std::atomic<size_t> allocations_{0};
+  std::atomic<size_t> kernel_launches_{0};
+};
+
+}  // namespace Backend
+}  // namespace MLLib
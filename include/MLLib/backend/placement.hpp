@@ -0,0 +1,278 @@
+#pragma once
+
+#include "../device/device.hpp"
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file placement.hpp
+ * @brief Cost-model driven CPU/GPU placement of individual operations
+ *
+ * Offloading a small op to a GPU is slower than running it on the CPU once
+ * launch latency and host/device transfers are counted. A CostProfile holds
+ * a fitted linear cost (fixed + per-unit time) per op class and device,
+ * built from micro-benchmarks and persisted to disk. The PlacementScheduler
+ * uses it to pick the cheaper device per op. With DeviceType::AUTO
+ * selected, each call through the Backend dispatch table is placed on its
+ * own by PlacementScheduler::global(); layers bound to a fixed backend at
+ * compile time (e.g. StaticBackend<CPU>) do not consult it.
+ *
+ * All times are in microseconds.
+ */
+
+namespace MLLib {
+namespace Backend {
+
+/**
+ * @enum OpKind
+ * @brief Operation classes with separate cost models
+ */
+enum class OpKind {
+  GEMM,        ///< Matrix multiplication, work = 2 * m * k * n flops
+  ELEMENTWISE  ///< Element-wise op, work = element count
+};
+
+/**
+ * @struct OpDescriptor
+ * @brief Shape of one operation as seen by the cost model
+ */
+struct OpDescriptor {
+  OpKind kind = OpKind::ELEMENTWISE;
+  size_t m = 0;  ///< GEMM rows of A
+  size_t k = 0;  ///< GEMM inner dimension
+  size_t n = 0;  ///< GEMM columns of B, or element count
+
+  /**
+   * @brief Describe c[m, n] = a[m, k] * b[k, n]
+   */
+  static OpDescriptor gemm(size_t m, size_t k, size_t n);
+
+  /**
+   * @brief Describe an element-wise op over size elements
+   */
+  static OpDescriptor elementwise(size_t size);
+
+  /**
+   * @brief Get the amount of work the cost is proportional to
+   * @return Flops for GEMM, elements for element-wise ops
+   */
+  double work() const;
+
+  /**
+   * @brief Get bytes of the activation input moved if it is not resident
+   * @return a for GEMM (weights are assumed to stay on the device), the
+   * input for element-wise ops
+   */
+  size_t input_bytes() const;
+
+  /**
+   * @brief Get bytes of the result
+   */
+  size_t output_bytes() const;
+};
+
+/**
+ * @struct LinearCost
+ * @brief time = fixed_us + per_unit_us * units
+ */
+struct LinearCost {
+  double fixed_us = 0.0;
+  double per_unit_us = 0.0;
+
+  double at(double units) const { return fixed_us + per_unit_us * units; }
+
+  /**
+   * @brief Least-squares fit with both coefficients clamped to >= 0
+   * @param units Work per sample
+   * @param times_us Measured time per sample
+   * @return Fitted cost
+   */
+  static LinearCost fit(const std::vector<double>& units,
+                        const std::vector<double>& times_us);
+};
+
+/**
+ * @struct CostModel
+ * @brief Costs of one device
+ */
+struct CostModel {
+  LinearCost gemm;         ///< Units: flops
+  LinearCost elementwise;  ///< Units: elements
+  LinearCost transfer;     ///< Units: bytes moved to or from the host
+
+  /**
+   * @brief Estimate compute time of an op, excluding transfers
+   */
+  double compute_us(const OpDescriptor& op) const;
+};
+
+/**
+ * @class CostProfile
+ * @brief Per-device cost models
+ */
+class CostProfile {
+public:
+  /**
+   * @brief Set the model of a device
+   */
+  void set(DeviceType device, const CostModel& model);
+
+  /**
+   * @brief Check whether a device has a model
+   */
+  bool has(DeviceType device) const;
+
+  /**
+   * @brief Get the model of a device
+   * @throws std::invalid_argument if the device has no model
+   */
+  const CostModel& get(DeviceType device) const;
+
+  /**
+   * @brief Get devices with a model
+   */
+  std::vector<DeviceType> devices() const;
+
+  /**
+   * @brief Check whether no device has a model
+   */
+  bool empty() const { return models_.empty(); }
+
+  /**
+   * @brief Write the profile to a text file
+   * @param path Destination file
+   * @return true on success
+   */
+  bool save(const std::string& path) const;
+
+  /**
+   * @brief Replace this profile with one read from a file
+   * @param path File written by save()
+   * @return true on success; the profile is unchanged on failure
+   */
+  bool load(const std::string& path);
+
+private:
+  std::map<DeviceType, CostModel> models_;
+};
+
+/**
+ * @struct BenchmarkTarget
+ * @brief Device under measurement
+ * @details run_op returns the time of one execution of an op, transfer the
+ * time to move a number of bytes between host and device (0 for the host).
+ */
+struct BenchmarkTarget {
+  DeviceType device = DeviceType::CPU;
+  std::function<double(const OpDescriptor&)> run_op;
+  std::function<double(size_t)> transfer;
+
+  /**
+   * @brief Measure real Backend operations with a wall clock
+   * @param device CPU or GPU; GPU transfers are timed when a device memory
+   * backend is installed and are free otherwise
+   */
+  static BenchmarkTarget backend(DeviceType device);
+};
+
+/**
+ * @struct BenchmarkPlan
+ * @brief Shapes and sizes sampled by a benchmark
+ */
+struct BenchmarkPlan {
+  std::vector<size_t> gemm_sizes = {8, 32, 64, 128};  ///< Square m = k = n
+  std::vector<size_t> elementwise_sizes = {1024, 16384, 262144};
+  std::vector<size_t> transfer_bytes = {4096, 65536, 1048576};
+  size_t repetitions = 3;  ///< Best of this many runs per sample
+};
+
+/**
+ * @brief Measure devices and fit a profile
+ * @param targets Devices to measure
+ * @param plan Shapes to sample
+ * @return Profile with one model per target
+ */
+CostProfile benchmarkProfile(const std::vector<BenchmarkTarget>& targets,
+                             const BenchmarkPlan& plan = BenchmarkPlan());
+
+/**
+ * @class SimulatedDevice
+ * @brief Device whose timings come from a known cost model
+ * @details Lets benchmarking and placement be exercised deterministically
+ * on a CPU-only machine, e.g. a GPU with a high launch cost but a fast
+ * per-flop rate.
+ */
+class SimulatedDevice {
+public:
+  SimulatedDevice(DeviceType device, const CostModel& truth)
+      : device_(device), truth_(truth) {}
+
+  /**
+   * @brief Benchmark target reporting the simulated timings
+   */
+  BenchmarkTarget target() const;
+
+private:
+  DeviceType device_;
+  CostModel truth_;
+};
+
+/**
+ * @class PlacementScheduler
+ * @brief Chooses the cheapest device for operations
+ */
+class PlacementScheduler {
+public:
+  explicit PlacementScheduler(CostProfile profile = CostProfile());
+
+  /**
+   * @brief Replace the cost profile
+   */
+  void setProfile(const CostProfile& profile);
+
+  /**
+   * @brief Get a copy of the cost profile
+   */
+  CostProfile getProfile() const;
+
+  /**
+   * @brief Estimate the cost of running an op on a device
+   * @param op Operation
+   * @param device Where it runs
+   * @param data_location Where its input currently lives
+   * @return Compute plus transfer time, infinity without a model
+   */
+  double estimate(const OpDescriptor& op, DeviceType device,
+                  DeviceType data_location) const;
+
+  /**
+   * @brief Pick the device with the lowest estimate
+   * @param op Operation
+   * @param data_location Where its input currently lives
+   * @return Chosen device; CPU when the profile is empty
+   */
+  DeviceType place(const OpDescriptor& op,
+                   DeviceType data_location = DeviceType::CPU) const;
+
+  /**
+   * @brief Scheduler used by Backend for DeviceType::AUTO
+   * @details Starts with an empty profile (everything on the CPU) unless
+   * the MLLIB_COST_PROFILE environment variable names a saved profile.
+   */
+  static PlacementScheduler& global();
+
+private:
+  double transfer_us(size_t bytes, DeviceType from, DeviceType to) const;
+  double cost_us(const OpDescriptor& op, DeviceType device,
+                 DeviceType data_location) const;
+
+  mutable std::mutex mutex_;
+  CostProfile profile_;
+};
+
+}  // namespace Backend
+}  // namespace MLLib
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../ndarray.hpp"
+#include "../util/system/thread.hpp"
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file stream.hpp
+ * @brief Asynchronous execution streams for Backend operations
+ *
+ * A Stream is an in-order work queue served by its own CPU worker. Work on
+ * different streams runs concurrently; Events order work across streams.
+ * The semantics follow CUDA/HIP streams and events (in-order per stream,
+ * record/wait for cross-stream dependencies) so a GPU backend can later map
+ * a Stream onto a native queue without changing callers.
+ *
+ * As with device streams, operands passed by reference must outlive the
+ * Event returned for the operation.
+ */
+
+namespace MLLib {
+namespace Backend {
+
+/**
+ * @class Event
+ * @brief Completion marker for work enqueued on a Stream
+ */
+class Event {
+public:
+  /**
+   * @brief Create an event that is already complete
+   */
+  Event();
+
+  /**
+   * @brief Wrap a future signalling completion
+   * @param done Future becoming ready when the work finishes
+   */
+  explicit Event(std::shared_future<void> done);
+
+  /**
+   * @brief Block until the work has finished
+   * @throws Any exception raised by the work
+   */
+  void wait() const;
+
+  /**
+   * @brief Check for completion without blocking
+   * @return true if the work has finished (successfully or not)
+   */
+  bool ready() const;
+
+private:
+  std::shared_future<void> done_;  ///< Completion state
+};
+
+/**
+ * @class Stream
+ * @brief In-order asynchronous queue of Backend operations
+ */
+class Stream {
+public:
+  /**
+   * @brief Create a stream served by an unpinned worker
+   */
+  Stream();
+
+  /**
+   * @brief Create a stream whose worker is pinned to a NUMA node
+   * @param numa_node Node id from Device::detectNUMANodes()
+   * @throws std::invalid_argument if the node does not exist
+   */
+  explicit Stream(int numa_node);
+
+  /**
+   * @brief Finish all enqueued work and stop the worker
+   */
+  ~Stream();
+
+  Stream(const Stream&) = delete;
+  Stream& operator=(const Stream&) = delete;
+
+  /**
+   * @brief Enqueue arbitrary work after everything already on the stream
+   * @param task Callable taking no arguments
+   * @return Future holding the task's result or exception
+   */
+  template <typename F>
+  auto enqueue(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    return worker_->submit(std::forward<F>(task));
+  }
+
+  /**
+   * @brief Record an event completing when all prior work has finished
+   * @return Event for the current tail of the stream
+   */
+  Event record();
+
+  /**
+   * @brief Make later work on this stream wait for an event
+   * @param event Event, typically recorded on another stream
+   */
+  void wait_event(const Event& event);
+
+  /**
+   * @brief Block until all enqueued work has finished
+   */
+  void synchronize();
+
+  /**
+   * @brief Asynchronous Backend::matmul
+   * @return Event completing when result is written
+   */
+  Event matmul(const NDArray& a, const NDArray& b, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::add
+   * @return Event completing when result is written
+   */
+  Event add(const NDArray& a, const NDArray& b, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::subtract
+   * @return Event completing when result is written
+   */
+  Event subtract(const NDArray& a, const NDArray& b, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::multiply
+   * @return Event completing when result is written
+   */
+  Event multiply(const NDArray& a, const NDArray& b, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::add_scalar
+   * @return Event completing when result is written
+   */
+  Event add_scalar(const NDArray& a, double scalar, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::multiply_scalar
+   * @return Event completing when result is written
+   */
+  Event multiply_scalar(const NDArray& a, double scalar, NDArray& result);
+
+  /**
+   * @brief Asynchronous Backend::fill
+   * @return Event completing when array is filled
+   */
+  Event fill(NDArray& array, double value);
+
+  /**
+   * @brief Asynchronous Backend::copy
+   * @return Event completing when dst is written
+   */
+  Event copy(const NDArray& src, NDArray& dst);
+
+private:
+  /**
+   * @brief Enqueue work that produces no value and wrap it in an Event
+   */
+  template <typename F>
+  Event launch(F&& task) {
+    return Event(enqueue(std::forward<F>(task)).share());
+  }
+
+  std::unique_ptr<util::ThreadPool> worker_;  ///< Single in-order worker
+};
+
+}  // namespace Backend
+}  // namespace MLLib
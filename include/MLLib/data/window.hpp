@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../ndarray.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file window.hpp
+ * @brief Sliding-window views over a time series
+ *
+ * Overlapping windows of a series share their steps, so storing each window
+ * as its own NDArray multiplies memory by window / stride. WindowDataset
+ * keeps the series once, in one contiguous buffer of [steps, features]
+ * values, and a window is only a pointer into it. Values are copied once,
+ * when a mini-batch is gathered straight into the batch buffer.
+ */
+
+namespace MLLib {
+namespace data {
+
+/**
+ * @struct WindowView
+ * @brief Read-only view of one window
+ * @details Valid until the dataset is next appended to or cleared.
+ */
+struct WindowView {
+  const double* data;  ///< steps * features values, step by step
+  size_t steps;        ///< Steps in the window
+  size_t features;     ///< Values per step
+  size_t start;        ///< Position of the first step in the whole stream
+
+  /**
+   * @brief Number of values, the flat sample size
+   */
+  size_t size() const { return steps * features; }
+
+  /**
+   * @brief Values of step t of the window
+   */
+  const double* step(size_t t) const { return data + t * features; }
+};
+
+/**
+ * @class WindowDataset
+ * @brief Time series split into windows without copying them
+ * @details Window k starts at step k * stride of the stream. Windows are
+ * indexed from 0 over those still held; with a bounded history, the oldest
+ * steps are dropped as new ones arrive and the indices move with them.
+ *
+ * For online scoring, append() returns how many windows the new steps
+ * completed, which are the last ones:
+ * @code
+ * size_t fresh = windows.append(reading);
+ * windows.gather(windows.size() - fresh, windows.size(), batch);
+ * @endcode
+ */
+class WindowDataset {
+public:
+  /**
+   * @brief Constructor for an empty stream
+   * @param window Steps per window
+   * @param features Values per step
+   * @param stride Steps between the starts of neighbouring windows
+   * @param history Steps to keep, 0 to keep all; old steps are dropped
+   * once more than this many are held
+   * @throws std::invalid_argument if a size is 0 or history is shorter
+   * than window
+   */
+  explicit WindowDataset(size_t window, size_t features = 1,
+                         size_t stride = 1, size_t history = 0);
+
+  /**
+   * @brief Constructor over a recorded series
+   * @param series Series [steps, features], or [steps] for one feature
+   * @param window Steps per window
+   * @param stride Steps between the starts of neighbouring windows
+   * @throws std::invalid_argument if window or stride is 0, or the series
+   * has no steps
+   */
+  WindowDataset(const NDArray& series, size_t window, size_t stride = 1);
+
+  /**
+   * @brief Append steps to the stream
+   * @param values steps * features values, step by step
+   * @param steps Number of steps
+   * @return Number of windows the new steps completed
+   */
+  size_t append(const double* values, size_t steps);
+
+  /**
+   * @brief Append steps to the stream
+   * @param steps Steps [count, features], or [count] for one feature
+   * @return Number of windows the new steps completed
+   * @throws std::invalid_argument unless the array holds whole steps
+   */
+  size_t append(const NDArray& steps);
+
+  /**
+   * @brief Number of windows held
+   */
+  size_t size() const;
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief View of window i
+   * @throws std::out_of_range if i >= size()
+   */
+  WindowView operator[](size_t i) const;
+
+  /**
+   * @brief Copy windows [begin, end) into batch rows
+   * @param batch Resized to [end - begin, window * features] when its
+   * shape differs, so a reused buffer is not reallocated
+   * @throws std::out_of_range if end > size() or begin > end
+   */
+  void gather(size_t begin, size_t end, NDArray& batch) const;
+
+  /**
+   * @brief Copy the windows at the given indices into batch rows
+   * @param indices Window indices
+   * @param count Number of indices
+   * @param batch Resized to [count, window * features] when needed
+   * @throws std::out_of_range for an index beyond size()
+   */
+  void gather(const size_t* indices, size_t count, NDArray& batch) const;
+
+  /**
+   * @brief Remove all steps, keeping the buffer's capacity
+   */
+  void clear();
+
+  size_t get_window() const { return window_; }
+  size_t get_features() const { return features_; }
+  size_t get_stride() const { return stride_; }
+  size_t get_history() const { return history_; }
+
+  /**
+   * @brief Values per window, the flat sample size
+   */
+  size_t sample_size() const { return window_ * features_; }
+
+  /**
+   * @brief Number of steps held
+   */
+  size_t length() const { return end_ - begin_; }
+
+  /**
+   * @brief Number of steps appended since construction or clear()
+   */
+  size_t total_steps() const { return dropped_ + length(); }
+
+private:
+  size_t window_;
+  size_t features_;
+  size_t stride_;
+  size_t history_;
+
+  std::vector<double> buffer_;  ///< Steps [begin_, end_) are held
+  size_t begin_ = 0;            ///< First held step in buffer_
+  size_t end_ = 0;              ///< One past the last held step
+  size_t dropped_ = 0;          ///< Steps dropped from the stream's front
+
+  /**
+   * @brief Number of windows started in steps already dropped
+   */
+  size_t first_window() const { return (dropped_ + stride_ - 1) / stride_; }
+
+  /**
+   * @brief Windows complete in a stream of the given length
+   */
+  size_t windows_in(size_t steps) const;
+
+  /**
+   * @brief Drop steps beyond the history, compacting the buffer
+   */
+  void trim();
+};
+
+}  // namespace data
+}  // namespace MLLib
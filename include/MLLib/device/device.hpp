@@ -10,6 +10,10 @@
 
 namespace MLLib {
 
+namespace util {
+class ThreadPool;
+}  // namespace util
+
 /**
  * @enum DeviceType
  * @brief Supported device types for computation
@@ -39,11 +43,21 @@ enum class GPUVendor {
 struct GPUInfo {
   GPUVendor vendor;         ///< GPU vendor
   std::string name;         ///< GPU name/model
-  size_t memory_mb;         ///< GPU memory in MB
+  size_t memory_mb;         ///< GPU memory in MB (0 if unknown)
   bool compute_capable;     ///< Whether GPU supports compute operations
   std::string api_support;  ///< Supported APIs (CUDA, ROCm, Metal, etc.)
 };
 
+/**
+ * @struct NUMANode
+ * @brief CPU sub-device backed by one NUMA node (socket)
+ */
+struct NUMANode {
+  int id;                 ///< Node index as in /sys/devices/system/node/nodeN
+  std::vector<int> cpus;  ///< Logical CPUs local to the node
+  size_t memory_mb;       ///< Node-local memory in MB (0 if unknown)
+};
+
 /**
  * @class Device
  * @brief Device management class
@@ -60,7 +74,15 @@ public:
    * @brief Set current device type
    * @param device Device type to set
    */
-  static void setDevice(DeviceType device) { current_device_ = device; }
+  static void setDevice(DeviceType device);
+
+  /**
+   * @brief Register a callback run whenever the current device is set
+   * @param listener Function receiving the new device type
+   * @details Used by Backend to re-resolve its dispatch table once per
+   * device switch instead of on every operation.
+   */
+  static void addDeviceChangeListener(void (*listener)(DeviceType));
 
   /**
    * @brief Check if GPU is available
@@ -86,10 +108,50 @@ public:
 
   /**
    * @brief Detect all available GPUs
+   * @details Discovery reads sysfs/procfs directly and runs once per process;
+   * later calls return the cached result. When a capability cache path is
+   * configured, a valid cache file is used instead of probing.
    * @return Vector of detected GPU information
    */
   static std::vector<GPUInfo> detectGPUs();
 
+  /**
+   * @brief Drop cached discovery results so the next query probes again
+   */
+  static void refreshGPUDetection();
+
+  /**
+   * @brief Set the root under which /sys and /proc are read
+   * @param root Directory prefix, empty for MLLIB_SYSFS_ROOT or "/"
+   */
+  static void setSysfsRoot(const std::string& root);
+
+  /**
+   * @brief Get the root under which /sys and /proc are read
+   * @return Directory prefix, empty for the real filesystem root
+   */
+  static std::string getSysfsRoot();
+
+  /**
+   * @brief Set the capability cache file used by detectGPUs()
+   * @param path Cache file path, empty for MLLIB_DEVICE_CACHE or no cache
+   */
+  static void setCapabilityCachePath(const std::string& path);
+
+  /**
+   * @brief Write current discovery results to a capability cache file
+   * @param path Cache file path
+   * @return true if the file was written
+   */
+  static bool saveCapabilityCache(const std::string& path);
+
+  /**
+   * @brief Replace cached discovery results with a capability cache file
+   * @param path Cache file path
+   * @return true if the file was valid for this boot and sysfs root
+   */
+  static bool loadCapabilityCache(const std::string& path);
+
   /**
    * @brief Get primary GPU vendor (highest priority available)
    * @return Primary GPU vendor
@@ -103,6 +165,53 @@ public:
    */
   static bool isGPUVendorAvailable(GPUVendor vendor);
 
+  /**
+   * @brief Detect NUMA nodes usable as CPU sub-devices
+   * @details Reads /sys/devices/system/node below the sysfs root once per
+   * discovery pass. Machines without NUMA information report a single node 0
+   * holding every CPU.
+   * @return Nodes ordered by id
+   */
+  static std::vector<NUMANode> detectNUMANodes();
+
+  /**
+   * @brief Select the CPU sub-device for the process
+   * @param node NUMA node id, or -1 to stop binding to a node
+   * @throws std::invalid_argument if the node does not exist
+   * @details Large NDArray allocations are first touched on the selected
+   * node. Threads bound with bindCurrentThreadToNode() keep their own node.
+   */
+  static void setCPUNode(int node);
+
+  /**
+   * @brief Get the CPU sub-device in effect for the calling thread
+   * @return Thread's bound node if any, else the process selection, else -1
+   */
+  static int getCPUNode();
+
+  /**
+   * @brief Get the node the calling thread is bound to
+   * @return Node id, or -1 if the thread is not bound
+   */
+  static int getCurrentThreadNode();
+
+  /**
+   * @brief Pin the calling thread to the CPUs of a NUMA node
+   * @param node NUMA node id, or -1 to unbind and allow every CPU
+   * @throws std::invalid_argument if the node does not exist
+   */
+  static void bindCurrentThreadToNode(int node);
+
+  /**
+   * @brief Get the worker pool whose threads are pinned to a NUMA node
+   * @param node NUMA node id
+   * @return Pool with one worker per node CPU, created on first use and kept
+   * for the process lifetime; submit data-parallel replicas here to keep
+   * their memory traffic socket-local
+   * @throws std::invalid_argument if the node does not exist
+   */
+  static util::ThreadPool& getNodeThreadPool(int node);
+
 private:
   static DeviceType current_device_;
 };
@@ -34,6 +34,17 @@ public:
   std::vector<NDArray*> get_parameters() override { return {}; }
 
 protected:
+  /**
+   * @brief Give output the shape of input, reusing its storage if possible
+   * @param input Input data
+   * @param output Output buffer
+   */
+  static void prepare_output(const NDArray& input, NDArray& output) {
+    if (output.shape() != input.shape()) {
+      output = NDArray(input.shape());
+    }
+  }
+
   NDArray last_input_;   ///< Cache input for backward pass
   bool forward_called_;  ///< Flag to track if forward has been called
 };
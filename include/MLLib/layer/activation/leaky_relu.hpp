@@ -38,6 +38,13 @@ public:
    */
   NDArray forward(const NDArray& input) override;
 
+  /**
+   * @brief Inference-only forward propagation
+   * @param input Input data
+   * @param output Output data
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
   /**
    * @brief Backward propagation
    * @param grad_output Gradient from the next layer
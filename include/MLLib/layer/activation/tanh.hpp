@@ -37,6 +37,13 @@ public:
    */
   NDArray forward(const NDArray& input) override;
 
+  /**
+   * @brief Inference-only forward propagation
+   * @param input Input data
+   * @param output Output data
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
   /**
    * @brief Backward pass
    * @param grad_output Gradient from next layer
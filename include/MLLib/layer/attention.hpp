@@ -0,0 +1,116 @@
+#pragma once
+
+#include "base.hpp"
+#include <cstddef>
+
+/**
+ * @file attention.hpp
+ * @brief Multi-head self-attention layer
+ *
+ * Sequences are flattened as in recurrent.hpp: [batch_size, steps *
+ * model_dim], or [batch_size, steps, model_dim]. The query, key and value
+ * projections of all steps are one GEMM with packed weights, and the output
+ * projection is another.
+ *
+ * Attention itself runs blockwise: for a block of queries, key and value
+ * blocks are visited in turn and the softmax is accumulated online with a
+ * running maximum and sum per query. Only one block of scores exists at a
+ * time, so memory grows with steps rather than steps squared, and the
+ * blocks stay in cache. Forward keeps the log-sum-exp of each query's
+ * scores, and backward recomputes the scores of each block from it. Work
+ * is spread over the batch rows and heads.
+ */
+
+namespace MLLib {
+namespace layer {
+
+/**
+ * @class MultiHeadAttention
+ * @brief Scaled dot-product self-attention over several heads
+ * @details Head h uses columns h * head_dim to (h + 1) * head_dim - 1 of
+ * the query, key and value projections, where head_dim = model_dim /
+ * heads. The packed projection weights are [model_dim, 3 * model_dim] with
+ * queries, keys and values in that order.
+ */
+class MultiHeadAttention : public BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param model_dim Features per step
+   * @param heads Attention heads; must divide model_dim
+   * @param causal Let each step attend only to itself and earlier steps
+   * @param block_size Queries and keys per block of the attention kernel
+   * @throws std::invalid_argument if a size is 0 or heads does not divide
+   * model_dim
+   */
+  MultiHeadAttention(size_t model_dim, size_t heads, bool causal = false,
+                     size_t block_size = 64);
+
+  /**
+   * @brief Forward propagation
+   * @param input Sequences [batch_size, steps * model_dim]
+   * @return Attended sequences of the input's shape
+   * @throws std::invalid_argument unless each row holds whole steps
+   */
+  NDArray forward(const NDArray& input) override;
+
+  /**
+   * @brief Inference-only forward propagation
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backward propagation
+   * @param grad_output Gradient with respect to the forward output
+   * @return Gradient with respect to the input
+   * @throws std::runtime_error if forward() has not been called
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override;
+  std::vector<NDArray*> get_gradients() override;
+
+  size_t get_model_dim() const { return model_dim_; }
+  size_t get_heads() const { return heads_; }
+  size_t get_head_dim() const { return model_dim_ / heads_; }
+  bool is_causal() const { return causal_; }
+  size_t get_block_size() const { return block_size_; }
+
+  const NDArray& get_qkv_weights() const { return qkv_weights_; }
+  const NDArray& get_qkv_bias() const { return qkv_bias_; }
+  const NDArray& get_output_weights() const { return output_weights_; }
+  const NDArray& get_output_bias() const { return output_bias_; }
+
+private:
+  size_t model_dim_;
+  size_t heads_;
+  bool causal_;
+  size_t block_size_;
+
+  NDArray qkv_weights_;     ///< [model_dim, 3 * model_dim]
+  NDArray qkv_bias_;        ///< [3 * model_dim]
+  NDArray output_weights_;  ///< [model_dim, model_dim]
+  NDArray output_bias_;     ///< [model_dim]
+
+  NDArray qkv_weight_gradients_;
+  NDArray qkv_bias_gradients_;
+  NDArray output_weight_gradients_;
+  NDArray output_bias_gradients_;
+
+  // Caches of the last forward pass
+  std::vector<size_t> last_input_shape_;
+  NDArray last_inputs_;  ///< Inputs [batch * steps, model_dim]
+  NDArray qkv_;          ///< Projections [batch * steps, 3 * model_dim]
+  NDArray context_;      ///< Attention output [batch * steps, model_dim]
+  NDArray log_sums_;     ///< Log-sum-exp per batch row, head and query
+
+  /**
+   * @brief Run the layer
+   * @param log_sums Receives the log-sum-exp of each query's scores
+   */
+  void run(const NDArray& input, NDArray& output, NDArray& inputs,
+           NDArray& qkv, NDArray& context, NDArray& log_sums) const;
+};
+
+}  // namespace layer
+}  // namespace MLLib
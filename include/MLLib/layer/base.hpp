@@ -28,6 +28,17 @@ public:
    */
   virtual NDArray forward(const NDArray& input) = 0;
 
+  /**
+   * @brief Inference-only forward propagation
+   * @param input Input data
+   * @param output Output data; its storage is reused when the shape matches
+   * @details Does not modify the layer, so any number of threads may call
+   * it concurrently on one instance. Training-only behaviour (e.g. dropout)
+   * is skipped. Sequential::predict() runs only through this method, so
+   * every layer must implement it.
+   */
+  virtual void infer(const NDArray& input, NDArray& output) const = 0;
+
   /**
    * @brief Backward propagation
    * @param grad_output Gradient from the next layer
@@ -41,6 +52,12 @@ public:
    */
   virtual std::vector<NDArray*> get_parameters() = 0;
 
+  /**
+   * @brief Get gradients of the trainable parameters
+   * @return One gradient per get_parameters() entry, in the same order
+   */
+  virtual std::vector<NDArray*> get_gradients() { return {}; }
+
   /**
    * @brief Set training mode
    * @param training True for training mode, false for inference
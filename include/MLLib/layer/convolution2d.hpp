@@ -0,0 +1,220 @@
+#pragma once
+
+#include "base.hpp"
+#include <cstddef>
+
+/**
+ * @file convolution2d.hpp
+ * @brief 2D convolution and transposed convolution layers
+ *
+ * Both layers read and write batches of flattened images: an input of
+ * shape [batch_size, channels * height * width] holds each image in
+ * channel-major (CHW) order, so convolutional layers mix freely with Dense
+ * and activation layers in a Sequential model. Any input whose size is a
+ * whole number of images is accepted, e.g. [batch_size, C, H, W].
+ *
+ * Convolutions run as one GEMM per batch: im2col copies every receptive
+ * field into a row of a [batch_size * positions, C * k * k] matrix that is
+ * multiplied by the weights through the default backend. Backward passes
+ * reuse the same rows, and col2im scatters row gradients back to images.
+ */
+
+namespace MLLib {
+namespace layer {
+
+/**
+ * @struct ImageShape
+ * @brief Channels, height and width of one image
+ */
+struct ImageShape {
+  size_t channels = 1;
+  size_t height = 1;
+  size_t width = 1;
+
+  /**
+   * @brief Number of values in one image
+   */
+  size_t size() const { return channels * height * width; }
+
+  bool operator==(const ImageShape& other) const {
+    return channels == other.channels && height == other.height &&
+           width == other.width;
+  }
+  bool operator!=(const ImageShape& other) const { return !(*this == other); }
+};
+
+/**
+ * @class Conv2D
+ * @brief 2D convolution over square kernels
+ * @details Output size per side is (size + 2 * padding - kernel) / stride
+ * + 1. A stride above 1 downsamples, which makes strided Conv2D the usual
+ * encoder stage of a convolutional autoencoder.
+ */
+class Conv2D : public BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param input_shape Shape of one input image
+   * @param out_channels Number of output channels (filters)
+   * @param kernel_size Kernel height and width
+   * @param stride Step between kernel positions
+   * @param padding Zero padding on each side
+   * @param use_bias Whether to add a bias per output channel
+   * @throws std::invalid_argument if a size is 0 or the kernel does not fit
+   * the padded input
+   */
+  Conv2D(const ImageShape& input_shape, size_t out_channels,
+         size_t kernel_size, size_t stride = 1, size_t padding = 0,
+         bool use_bias = true);
+
+  /**
+   * @brief Forward propagation
+   * @param input Images [batch_size, input_shape.size()]
+   * @return Feature maps [batch_size, output_shape.size()]
+   * @throws std::invalid_argument if input is not a whole number of images
+   */
+  NDArray forward(const NDArray& input) override;
+
+  /**
+   * @brief Inference-only forward propagation
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backward propagation
+   * @param grad_output Gradient [batch_size, output_shape.size()]
+   * @return Gradient with respect to input [batch_size, input_shape.size()]
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override;
+  std::vector<NDArray*> get_gradients() override;
+
+  const ImageShape& get_input_shape() const { return input_shape_; }
+  const ImageShape& get_output_shape() const { return output_shape_; }
+  size_t get_kernel_size() const { return kernel_size_; }
+  size_t get_stride() const { return stride_; }
+  size_t get_padding() const { return padding_; }
+  bool get_use_bias() const { return use_bias_; }
+
+  /**
+   * @brief Get weights
+   * @return Weights [in_channels * kernel_size^2, out_channels]
+   */
+  const NDArray& get_weights() const { return weights_; }
+  const NDArray& get_bias() const { return bias_; }
+  void set_weights(const NDArray& weights);
+  void set_biases(const NDArray& bias);
+
+  const NDArray& get_weight_gradients() const { return weight_gradients_; }
+  const NDArray& get_bias_gradients() const { return bias_gradients_; }
+
+private:
+  ImageShape input_shape_;
+  ImageShape output_shape_;
+  size_t kernel_size_;
+  size_t stride_;
+  size_t padding_;
+  bool use_bias_;
+
+  NDArray weights_;
+  NDArray bias_;
+  NDArray weight_gradients_;
+  NDArray bias_gradients_;
+
+  NDArray last_columns_;  ///< im2col rows of the last forward input
+
+  void compute(const NDArray& input, NDArray& columns, NDArray& output) const;
+};
+
+/**
+ * @class ConvTranspose2D
+ * @brief Transposed 2D convolution (the adjoint of Conv2D)
+ * @details Output size per side is (size - 1) * stride - 2 * padding +
+ * kernel + output_padding, so with the same kernel, stride and padding it
+ * upsamples a Conv2D output back to the Conv2D input size; output_padding
+ * picks between the sizes a strided Conv2D maps to the same output.
+ */
+class ConvTranspose2D : public BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param input_shape Shape of one input feature map
+   * @param out_channels Number of output channels
+   * @param kernel_size Kernel height and width
+   * @param stride Upsampling factor
+   * @param padding Rows and columns removed from each side of the output
+   * @param output_padding Extra rows and columns at the bottom and right,
+   * less than stride
+   * @param use_bias Whether to add a bias per output channel
+   * @throws std::invalid_argument if a size is 0, output_padding is not
+   * below stride or the output would be empty
+   */
+  ConvTranspose2D(const ImageShape& input_shape, size_t out_channels,
+                  size_t kernel_size, size_t stride = 1, size_t padding = 0,
+                  size_t output_padding = 0, bool use_bias = true);
+
+  /**
+   * @brief Forward propagation
+   * @param input Feature maps [batch_size, input_shape.size()]
+   * @return Images [batch_size, output_shape.size()]
+   * @throws std::invalid_argument if input is not a whole number of maps
+   */
+  NDArray forward(const NDArray& input) override;
+
+  /**
+   * @brief Inference-only forward propagation
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backward propagation
+   * @param grad_output Gradient [batch_size, output_shape.size()]
+   * @return Gradient with respect to input [batch_size, input_shape.size()]
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override;
+  std::vector<NDArray*> get_gradients() override;
+
+  const ImageShape& get_input_shape() const { return input_shape_; }
+  const ImageShape& get_output_shape() const { return output_shape_; }
+  size_t get_kernel_size() const { return kernel_size_; }
+  size_t get_stride() const { return stride_; }
+  size_t get_padding() const { return padding_; }
+  size_t get_output_padding() const { return output_padding_; }
+  bool get_use_bias() const { return use_bias_; }
+
+  /**
+   * @brief Get weights
+   * @return Weights [in_channels, out_channels * kernel_size^2]
+   */
+  const NDArray& get_weights() const { return weights_; }
+  const NDArray& get_bias() const { return bias_; }
+  void set_weights(const NDArray& weights);
+  void set_biases(const NDArray& bias);
+
+  const NDArray& get_weight_gradients() const { return weight_gradients_; }
+  const NDArray& get_bias_gradients() const { return bias_gradients_; }
+
+private:
+  ImageShape input_shape_;
+  ImageShape output_shape_;
+  size_t kernel_size_;
+  size_t stride_;
+  size_t padding_;
+  size_t output_padding_;
+  bool use_bias_;
+
+  NDArray weights_;
+  NDArray bias_;
+  NDArray weight_gradients_;
+  NDArray bias_gradients_;
+
+  NDArray last_pixels_;  ///< Last input as [batch_size * pixels, channels]
+
+  void compute(const NDArray& input, NDArray& pixels, NDArray& output) const;
+};
+
+}  // namespace layer
+}  // namespace MLLib
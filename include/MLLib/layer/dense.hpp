@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../sparse.hpp"
 #include "base.hpp"
 
 /**
@@ -36,10 +37,35 @@ public:
    */
   NDArray forward(const NDArray& input) override;
 
+  /**
+   * @brief Inference-only forward propagation
+   * @param input Input data [batch_size, input_size]
+   * @param output Output data [batch_size, output_size]
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Forward propagation of a sparse batch
+   * @details Costs O(nnz * output_size). The following backward() computes
+   * the weight gradient from the stored entries only.
+   * @param input Sparse input [batch_size, input_size]
+   * @return Output data [batch_size, output_size]
+   */
+  NDArray forward(const SparseMatrix& input);
+
+  /**
+   * @brief Inference-only forward propagation of a sparse batch
+   * @param input Sparse input [batch_size, input_size]
+   * @param output Output data [batch_size, output_size]
+   * @throws std::invalid_argument if the input width differs from input_size
+   */
+  void infer(const SparseMatrix& input, NDArray& output) const;
+
   /**
    * @brief Backward propagation
    * @param grad_output Gradient from the next layer [batch_size, output_size]
-   * @return Gradient with respect to input [batch_size, input_size]
+   * @return Gradient with respect to input [batch_size, input_size], or an
+   * empty array after a sparse forward, whose input is data
    */
   NDArray backward(const NDArray& grad_output) override;
 
@@ -49,6 +75,12 @@ public:
    */
   std::vector<NDArray*> get_parameters() override;
 
+  /**
+   * @brief Get gradients of the trainable parameters
+   * @return Weight gradients, then bias gradients if bias is used
+   */
+  std::vector<NDArray*> get_gradients() override;
+
   /**
    * @brief Get weights
    * @return Reference to weights matrix
@@ -63,9 +95,41 @@ public:
 
   /**
    * @brief Set weights
+   * @details Drops any compressed copy of the previous weights.
    * @param weights New weights matrix
    */
-  void set_weights(const NDArray& weights) { weights_ = weights; }
+  void set_weights(const NDArray& weights);
+
+  /**
+   * @brief Store the weights in block sparse form for inference
+   * @details Blocks of zeros left by pruning are skipped, so infer() costs
+   * O(batch * stored_blocks * block_rows * block_cols). The dense weights
+   * are kept for training; forward(), set_weights() and get_parameters()
+   * drop the compressed copy because the weights may change afterwards.
+   * @param block_rows Input rows per block
+   * @param block_cols Output columns per block
+   * @throws std::invalid_argument if a block size is 0
+   */
+  void compress_weights(size_t block_rows = 4, size_t block_cols = 4);
+
+  /**
+   * @brief Install compressed weights, replacing the dense weights
+   * @throws std::invalid_argument if the shape differs from the layer
+   */
+  void set_compressed_weights(const BlockSparseMatrix& weights);
+
+  /**
+   * @brief Get whether infer() runs on compressed weights
+   */
+  bool has_compressed_weights() const { return compressed_; }
+
+  /**
+   * @brief Get compressed weights
+   * @return Block sparse weights, valid while has_compressed_weights()
+   */
+  const BlockSparseMatrix& get_compressed_weights() const {
+    return compressed_weights_;
+  }
 
   /**
    * @brief Set bias
@@ -114,6 +178,11 @@ private:
   NDArray bias_gradients_;    ///< Gradients for bias
 
   NDArray last_input_;  ///< Cache input for backward pass
+  SparseMatrix last_input_transposed_;  ///< Transposed sparse input
+  bool sparse_input_ = false;           ///< Last forward was sparse
+
+  BlockSparseMatrix compressed_weights_;  ///< Block sparse copy of weights_
+  bool compressed_ = false;               ///< Inference uses the copy
 
   /**
    * @brief Initialize weights and bias
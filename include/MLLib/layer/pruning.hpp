@@ -0,0 +1,56 @@
+#pragma once
+
+#include "dense.hpp"
+#include <cstddef>
+
+/**
+ * @file pruning.hpp
+ * @brief Weight pruning for Dense layers
+ *
+ * Each function zeroes part of Dense::get_weights() and installs the result
+ * with set_weights(). Unstructured magnitude pruning removes the most
+ * weights for a given accuracy loss; N:M and block pruning leave regular
+ * patterns of zeros that Dense::compress_weights() turns into skipped
+ * work at inference.
+ */
+
+namespace MLLib {
+namespace layer {
+
+/**
+ * @brief Fraction of the layer's weights that are exactly zero
+ */
+double weight_sparsity(const Dense& layer);
+
+/**
+ * @brief Zero the weights of smallest magnitude
+ * @param layer Layer to prune
+ * @param sparsity Fraction of weights to zero, in [0, 1]
+ * @return Fraction of weights that are zero afterwards
+ * @throws std::invalid_argument if sparsity is outside [0, 1]
+ */
+double prune_magnitude(Dense& layer, double sparsity);
+
+/**
+ * @brief N:M pruning along the input dimension
+ * @details For every output, each run of m consecutive input weights keeps
+ * only its n largest in magnitude (2:4 keeps half).
+ * @return Fraction of weights that are zero afterwards
+ * @throws std::invalid_argument if m is 0 or n > m
+ */
+double prune_n_m(Dense& layer, size_t n, size_t m);
+
+/**
+ * @brief Zero whole block_rows x block_cols blocks of smallest norm
+ * @details Use the same block size with Dense::compress_weights() so the
+ * pruned blocks are skipped at inference. Edge blocks are clipped.
+ * @param sparsity Fraction of blocks to zero, in [0, 1]
+ * @return Fraction of weights that are zero afterwards
+ * @throws std::invalid_argument if a block size is 0 or sparsity is
+ * outside [0, 1]
+ */
+double prune_blocks(Dense& layer, size_t block_rows, size_t block_cols,
+                    double sparsity);
+
+}  // namespace layer
+}  // namespace MLLib
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "base.hpp"
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file recurrent.hpp
+ * @brief LSTM and GRU layers and the helpers sequence models need
+ *
+ * Sequences are flattened like images in convolution2d.hpp: an input of
+ * shape [batch_size, steps * features] holds each sequence step by step,
+ * and [batch_size, steps, features] is accepted as well. The number of
+ * steps is read from the input, so one layer handles any length.
+ *
+ * The input projections of all steps are computed up front as one GEMM
+ * over [steps * batch_size, features]. Each step then needs one packed GEMM
+ * of the previous hidden state with the recurrent weights of all gates,
+ * followed by a single fused loop that adds the bias, applies the gate
+ * nonlinearities and updates the state. Backward passes collect the gate
+ * gradients of all steps, so the weight gradients and the input gradient
+ * are again one GEMM each.
+ */
+
+namespace MLLib {
+namespace layer {
+
+/**
+ * @class Recurrent
+ * @brief Shared sequence handling of LSTM and GRU
+ * @details Weights are packed per gate: the input weights are
+ * [input_size, gates * hidden_size] and the recurrent weights
+ * [hidden_size, gates * hidden_size], with gate g in columns
+ * g * hidden_size to (g + 1) * hidden_size - 1.
+ */
+class Recurrent : public BaseLayer {
+public:
+  /**
+   * @brief Forward propagation
+   * @param input Sequences [batch_size, steps * input_size]
+   * @return Hidden states of every step [batch_size, steps * hidden_size]
+   * with return_sequences, else the last ones [batch_size, hidden_size]
+   * @throws std::invalid_argument unless each row holds whole steps
+   */
+  NDArray forward(const NDArray& input) override;
+
+  /**
+   * @brief Inference-only forward propagation
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backpropagation through time
+   * @param grad_output Gradient with respect to the forward output
+   * @return Gradient with respect to the input
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override;
+  std::vector<NDArray*> get_gradients() override;
+
+  size_t get_input_size() const { return input_size_; }
+  size_t get_hidden_size() const { return hidden_size_; }
+  bool get_return_sequences() const { return return_sequences_; }
+
+  /**
+   * @brief Get the truncation length of backpropagation through time
+   * @return Steps a gradient travels back, 0 for the whole sequence
+   */
+  size_t get_bptt_steps() const { return bptt_steps_; }
+
+  const NDArray& get_input_weights() const { return input_weights_; }
+  const NDArray& get_recurrent_weights() const { return recurrent_weights_; }
+  const NDArray& get_bias() const { return bias_; }
+  void set_input_weights(const NDArray& weights);
+  void set_recurrent_weights(const NDArray& weights);
+  void set_biases(const NDArray& bias);
+
+protected:
+  /**
+   * @brief Constructor
+   * @param input_size Features per step
+   * @param hidden_size Hidden units
+   * @param gates Gates packed in the weights
+   * @param cache_width Values per hidden unit kept for backward
+   * @param cell_state Whether the cell has a state besides its output
+   * @param return_sequences Output every step instead of the last one
+   * @param bptt_steps Truncation length of backpropagation, 0 = none
+   * @throws std::invalid_argument if a size is 0
+   */
+  Recurrent(size_t input_size, size_t hidden_size, size_t gates,
+            size_t cache_width, bool cell_state, bool return_sequences,
+            size_t bptt_steps);
+
+  /**
+   * @brief Update one step for rows [begin, end) of the batch
+   * @param x Input projections [batch, gates * hidden] without bias
+   * @param h Recurrent projections [batch, gates * hidden]
+   * @param h_prev Previous hidden state [batch, hidden]
+   * @param c_prev Previous cell state [batch, hidden], if any
+   * @param cache Receives what backward needs [batch, cache_width * hidden]
+   * @param h_next Receives the new hidden state
+   * @param c_next Receives the new cell state, if any
+   */
+  virtual void step(size_t begin, size_t end, const double* x,
+                    const double* h, const double* h_prev,
+                    const double* c_prev, double* cache, double* h_next,
+                    double* c_next) const = 0;
+
+  /**
+   * @brief Gradients of one step for rows [begin, end) of the batch
+   * @param cache Values stored by step()
+   * @param h_prev Previous hidden state
+   * @param c_prev Previous cell state, if any
+   * @param c_next Cell state of this step, if any
+   * @param dh Gradient with respect to the hidden state of this step
+   * @param dc Gradient with respect to the cell state of this step, if any;
+   * receives the one with respect to the previous cell state
+   * @param dx Receives the gradient of the input projections
+   * @param dhp Receives the gradient of the recurrent projections
+   * @param dh_prev Receives the gradient that reaches the previous hidden
+   * state directly, not through the recurrent weights
+   */
+  virtual void step_backward(size_t begin, size_t end, const double* cache,
+                             const double* h_prev, const double* c_prev,
+                             const double* c_next, const double* dh,
+                             double* dc, double* dx, double* dhp,
+                             double* dh_prev) const = 0;
+
+  size_t input_size_;
+  size_t hidden_size_;
+  size_t gates_;
+
+  NDArray input_weights_;
+  NDArray recurrent_weights_;
+  NDArray bias_;
+
+private:
+  size_t cache_width_;
+  bool cell_state_;
+  bool return_sequences_;
+  size_t bptt_steps_;
+
+  NDArray input_weight_gradients_;
+  NDArray recurrent_weight_gradients_;
+  NDArray bias_gradients_;
+
+  // Caches of the last forward pass
+  std::vector<size_t> last_input_shape_;
+  NDArray last_inputs_;                ///< Inputs [steps * batch, input]
+  std::vector<NDArray> hidden_states_;  ///< h_0 to h_T, each [batch, hidden]
+  std::vector<NDArray> cell_states_;    ///< c_0 to c_T, if any
+  NDArray step_cache_;                  ///< step() caches of every step
+
+  /**
+   * @brief Run the sequence
+   * @param training Keep every state for backward instead of two
+   */
+  void run(const NDArray& input, NDArray& output, bool training,
+           NDArray& inputs, std::vector<NDArray>& hidden,
+           std::vector<NDArray>& cells, NDArray& cache) const;
+};
+
+/**
+ * @class LSTM
+ * @brief Long short-term memory layer
+ * @details Gates are packed in the order input, forget, cell, output. The
+ * forget gate bias starts at 1 so early training keeps the cell state.
+ */
+class LSTM : public Recurrent {
+public:
+  /**
+   * @brief Constructor
+   * @param input_size Features per step
+   * @param hidden_size Hidden units
+   * @param return_sequences Output every step instead of the last one
+   * @param bptt_steps Truncation length of backpropagation, 0 = none
+   */
+  LSTM(size_t input_size, size_t hidden_size, bool return_sequences = false,
+       size_t bptt_steps = 0);
+
+protected:
+  void step(size_t begin, size_t end, const double* x, const double* h,
+            const double* h_prev, const double* c_prev, double* cache,
+            double* h_next, double* c_next) const override;
+
+  void step_backward(size_t begin, size_t end, const double* cache,
+                     const double* h_prev, const double* c_prev,
+                     const double* c_next, const double* dh, double* dc,
+                     double* dx, double* dhp, double* dh_prev) const override;
+};
+
+/**
+ * @class GRU
+ * @brief Gated recurrent unit layer
+ * @details Gates are packed in the order reset, update, candidate. The
+ * reset gate scales the recurrent projection of the candidate,
+ * n = tanh(x W_n + b_n + r * (h W_hn)), so all three recurrent
+ * projections come from one GEMM.
+ */
+class GRU : public Recurrent {
+public:
+  /**
+   * @brief Constructor
+   * @param input_size Features per step
+   * @param hidden_size Hidden units
+   * @param return_sequences Output every step instead of the last one
+   * @param bptt_steps Truncation length of backpropagation, 0 = none
+   */
+  GRU(size_t input_size, size_t hidden_size, bool return_sequences = false,
+      size_t bptt_steps = 0);
+
+protected:
+  void step(size_t begin, size_t end, const double* x, const double* h,
+            const double* h_prev, const double* c_prev, double* cache,
+            double* h_next, double* c_next) const override;
+
+  void step_backward(size_t begin, size_t end, const double* cache,
+                     const double* h_prev, const double* c_prev,
+                     const double* c_next, const double* dh, double* dc,
+                     double* dx, double* dhp, double* dh_prev) const override;
+};
+
+/**
+ * @class RepeatVector
+ * @brief Repeat each input row for a number of steps
+ * @details Turns [batch_size, features] into [batch_size, steps * features],
+ * e.g. to feed a sequence decoder with a fixed code.
+ */
+class RepeatVector : public BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param steps Number of repetitions
+   * @throws std::invalid_argument if steps is 0
+   */
+  explicit RepeatVector(size_t steps);
+
+  NDArray forward(const NDArray& input) override;
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backward propagation; sums the gradients of all steps
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override { return {}; }
+
+  size_t get_steps() const { return steps_; }
+
+private:
+  size_t steps_;
+  size_t features_ = 0;  ///< Row size of the last forward input
+};
+
+/**
+ * @class TimeDistributed
+ * @brief Apply a layer to every step of a sequence
+ * @details Rows [batch_size, steps * features] are viewed as
+ * [batch_size * steps, features], so the wrapped layer (e.g. a Dense
+ * output projection) runs as one batched call over all steps.
+ */
+class TimeDistributed : public BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param layer Layer applied to each step
+   * @param features Features per input step
+   * @throws std::invalid_argument if layer is null or features is 0
+   */
+  TimeDistributed(std::shared_ptr<BaseLayer> layer, size_t features);
+
+  NDArray forward(const NDArray& input) override;
+  void infer(const NDArray& input, NDArray& output) const override;
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override;
+  std::vector<NDArray*> get_gradients() override;
+  void set_training(bool training) override;
+
+  const std::shared_ptr<BaseLayer>& get_layer() const { return layer_; }
+
+private:
+  std::shared_ptr<BaseLayer> layer_;
+  size_t features_;
+  size_t last_batch_ = 0;  ///< Rows of the last forward input
+  size_t last_rows_ = 0;   ///< Steps of the last forward input, all rows
+};
+
+}  // namespace layer
+}  // namespace MLLib
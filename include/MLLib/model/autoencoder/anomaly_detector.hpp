@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../data/window.hpp"
 #include "base.hpp"
 #include <map>
 
@@ -98,12 +99,36 @@ public:
                   const std::vector<NDArray>* validation_data = nullptr,
                   std::function<void(int, double, double)> callback = nullptr);
 
+  /**
+   * @brief Train on windows of a normal series
+   * @details Mini-batches are gathered straight from the series, so
+   * overlapping windows are never stored one by one.
+   * @param normal_windows Windows of window * features = input_dim values
+   * @param loss Loss function
+   * @param optimizer Optimizer
+   * @param epochs Number of epochs
+   * @param batch_size Batch size
+   * @param callback Optional training callback
+   * @throws std::invalid_argument if the window size is not input_dim
+   */
+  void
+  train_on_normal(const data::WindowDataset& normal_windows,
+                  loss::BaseLoss& loss, optimizer::BaseOptimizer& optimizer,
+                  int epochs = 100, int batch_size = 32,
+                  std::function<void(int, double, double)> callback = nullptr);
+
   /**
    * @brief Calculate and set anomaly threshold based on normal data
    * @param normal_data Normal validation data
    */
   void calculate_threshold(const std::vector<NDArray>& normal_data);
 
+  /**
+   * @brief Calculate and set anomaly threshold based on normal windows
+   * @param normal_windows Windows of a normal series
+   */
+  void calculate_threshold(const data::WindowDataset& normal_windows);
+
   /**
    * @brief Detect anomalies in test data
    * @param test_data Test data to check for anomalies
@@ -114,6 +139,20 @@ public:
   detect_anomalies(const std::vector<NDArray>& test_data,
                    const std::vector<bool>* ground_truth = nullptr);
 
+  /**
+   * @brief Detect anomalies in windows of a series
+   * @details Windows are scored in batches gathered from the series. For
+   * online scoring, pass first = windows.size() - n after an append() that
+   * completed n windows.
+   * @param windows Windows to check
+   * @param first First window to check
+   * @param ground_truth Optional labels of windows [first, windows.size())
+   * @return Anomaly detection results, one entry per checked window
+   */
+  AnomalyResults
+  detect_anomalies(const data::WindowDataset& windows, size_t first = 0,
+                   const std::vector<bool>* ground_truth = nullptr);
+
   /**
    * @brief Check if single sample is anomalous
    * @param sample Input sample
@@ -204,6 +243,24 @@ private:
   double threshold_;
   bool threshold_calculated_;
 
+  /**
+   * @brief Reconstruction errors of windows [first, windows.size())
+   * @throws std::invalid_argument if the window size is not input_dim
+   */
+  std::vector<double> window_errors(const data::WindowDataset& windows,
+                                    size_t first);
+
+  /**
+   * @brief Set the threshold from errors of normal data
+   */
+  void threshold_from_errors(const std::vector<double>& errors);
+
+  /**
+   * @brief Flag errors above the threshold
+   */
+  AnomalyResults flag_errors(std::vector<double> errors,
+                             const std::vector<bool>* ground_truth);
+
   /**
    * @brief Calculate threshold using percentile method
    * @param errors Vector of reconstruction errors
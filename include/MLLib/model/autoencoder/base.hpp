@@ -7,6 +7,7 @@
 #include "../base_model.hpp"
 #include "../model_io.hpp"
 #include "../sequential.hpp"
+#include "../../util/misc/random.hpp"
 #include <memory>
 #include <vector>
 
@@ -27,8 +28,9 @@ enum class AutoencoderType {
   BASIC,         ///< Basic autoencoder
   DENOISING,     ///< Denoising autoencoder
   VARIATIONAL,   ///< Variational autoencoder
-  SPARSE,        ///< Sparse autoencoder
-  CONVOLUTIONAL  ///< Convolutional autoencoder
+  SPARSE,         ///< Sparse autoencoder
+  CONVOLUTIONAL,  ///< Convolutional autoencoder
+  RECURRENT       ///< Recurrent (LSTM) autoencoder
 };
 
 /**
@@ -113,6 +115,27 @@ public:
    */
   virtual NDArray reconstruct(const NDArray& input);
 
+  /**
+   * @brief Encode several inputs in shared batches
+   * @param inputs Input samples
+   * @return Latent representation per input
+   */
+  virtual std::vector<NDArray> encode(const std::vector<NDArray>& inputs);
+
+  /**
+   * @brief Decode several latent representations in shared batches
+   * @param latents Latent representations
+   * @return Reconstructed output per latent
+   */
+  virtual std::vector<NDArray> decode(const std::vector<NDArray>& latents);
+
+  /**
+   * @brief Reconstruct several inputs in shared batches
+   * @param inputs Input samples
+   * @return Reconstructed output per input
+   */
+  std::vector<NDArray> reconstruct(const std::vector<NDArray>& inputs);
+
   /**
    * @brief Train the autoencoder
    * @param training_data Training dataset
@@ -134,7 +157,8 @@ public:
    * @brief Calculate reconstruction error
    * @param input Input data
    * @param metric Error metric ("mse", "mae", "rmse")
-   * @return Reconstruction error
+   * @return Reconstruction error, averaged over the rows of a batch
+   * @throws std::invalid_argument for an unknown metric
    */
   virtual double reconstruction_error(const NDArray& input,
                                       const std::string& metric = "mse");
@@ -220,6 +244,7 @@ protected:
   AutoencoderConfig config_;             ///< Model configuration
   std::unique_ptr<Sequential> encoder_;  ///< Encoder network
   std::unique_ptr<Sequential> decoder_;  ///< Decoder network
+  util::RandomStream rng_;               ///< Noise and sampling stream
 
   /**
    * @brief Build encoder network
@@ -236,7 +261,18 @@ protected:
    * @param input Clean input
    * @return Noisy input
    */
-  virtual NDArray add_noise(const NDArray& input);
+  NDArray add_noise(const NDArray& input);
+
+  /**
+   * @brief Noise kernel: write a corrupted copy of clean to noisy
+   * @details Training calls this while gathering each mini-batch, so the
+   * corruption happens in the same pass that builds the first layer's
+   * input. noisy may alias clean.
+   * @param clean Clean values
+   * @param noisy Receives the corrupted values
+   * @param count Number of values
+   */
+  virtual void corrupt(const double* clean, double* noisy, size_t count);
 
   /**
    * @brief Get all trainable parameters
@@ -250,6 +286,50 @@ protected:
    */
   std::vector<NDArray*> get_gradients();
 
+  /**
+   * @brief Append the parameters and gradients of a network's layers
+   * @param network Network to scan
+   * @param params Receives parameter pointers, may be null
+   * @param grads Receives matching gradient pointers, may be null
+   */
+  static void collect_trainable(Sequential& network,
+                                std::vector<NDArray*>* params,
+                                std::vector<NDArray*>* grads);
+
+  /**
+   * @brief Training forward pass; layers cache what backward needs
+   */
+  static NDArray forward_layers(Sequential& network, const NDArray& input);
+
+  /**
+   * @brief Backward pass through a network
+   * @return Gradient with respect to the network input
+   */
+  static NDArray backward_layers(Sequential& network,
+                                 const NDArray& grad_output);
+
+  /**
+   * @brief Source of training sample i: its first value, and its size in
+   * *count
+   */
+  using SampleSource = std::function<const double*(size_t i, size_t* count)>;
+
+  /**
+   * @brief Mini-batch training loop of train()
+   * @details Each batch is gathered by copying its samples straight from
+   * the source into the batch buffers, so datasets that only hold views,
+   * e.g. overlapping windows of one series, are never materialized.
+   * @param count Number of samples
+   * @param sample Sample source; each size must be a multiple of the input
+   * dimension
+   * @param validation_loss Computes the validation loss after each epoch,
+   * may be null
+   */
+  void fit(size_t count, const SampleSource& sample, loss::BaseLoss& loss,
+           optimizer::BaseOptimizer& optimizer, int epochs, int batch_size,
+           const std::function<double()>& validation_loss,
+           const std::function<void(int, double, double)>& callback);
+
 protected:
   /**
    * @brief Initialize the autoencoder models
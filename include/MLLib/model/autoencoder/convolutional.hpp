@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../../layer/convolution2d.hpp"
+#include "base.hpp"
+
+/**
+ * @file convolutional.hpp
+ * @brief Convolutional autoencoder implementation
+ */
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+/**
+ * @struct ConvAutoencoderConfig
+ * @brief Architecture of a convolutional autoencoder
+ */
+struct ConvAutoencoderConfig {
+  layer::ImageShape image;              ///< Shape of one input image
+  std::vector<size_t> filters = {16, 32};  ///< Channels per encoder stage
+  size_t kernel_size = 3;               ///< Kernel height and width
+  size_t stride = 2;                    ///< Downsampling per stage
+  int latent_dim = 0;  ///< Dense bottleneck size, 0 = keep the feature map
+};
+
+/**
+ * @class ConvAutoencoder
+ * @brief Autoencoder with strided convolution stages
+ * @details Each encoder stage is a strided Conv2D with ReLU; the decoder
+ * mirrors it with ConvTranspose2D stages that restore the exact stage
+ * sizes and ends in a sigmoid. With latent_dim > 0 a Dense bottleneck sits
+ * between the last feature map and the decoder. Kernels share weights
+ * across positions, so the model needs far fewer parameters and
+ * multiply-adds than a Dense autoencoder of the same image size.
+ *
+ * Samples are flattened images in channel-major (CHW) order, so training,
+ * batching, reconstruction errors and model I/O work as for the other
+ * autoencoders.
+ */
+class ConvAutoencoder : public BaseAutoencoder {
+public:
+  /**
+   * @brief Default constructor (for deserialization)
+   */
+  ConvAutoencoder();
+
+  /**
+   * @brief Constructor
+   * @param conv_config Architecture
+   * @param device Computation device
+   * @throws std::invalid_argument if the image is empty, there are no
+   * stages or a stage would shrink the feature map to nothing
+   */
+  explicit ConvAutoencoder(const ConvAutoencoderConfig& conv_config,
+                           DeviceType device = DeviceType::CPU);
+
+  /**
+   * @brief Get autoencoder type
+   * @return CONVOLUTIONAL type
+   */
+  AutoencoderType get_type() const override {
+    return AutoencoderType::CONVOLUTIONAL;
+  }
+
+  /**
+   * @brief Get architecture
+   */
+  const ConvAutoencoderConfig& get_conv_config() const { return conv_config_; }
+
+  /**
+   * @brief Create a convolutional autoencoder for images
+   * @param height Image height
+   * @param width Image width
+   * @param channels Number of channels
+   * @param latent_dim Dense bottleneck size, 0 to keep the feature map
+   * @param device Computation device
+   * @return Two stride-2 stages of 16 and 32 filters
+   */
+  static std::unique_ptr<ConvAutoencoder>
+  create_for_images(int height, int width, int channels = 1,
+                    int latent_dim = 64, DeviceType device = DeviceType::CPU);
+
+protected:
+  std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+  serialize_impl() const override;
+
+  bool deserialize_impl(
+      const std::unordered_map<std::string, std::vector<uint8_t>>& data)
+      override;
+
+private:
+  ConvAutoencoderConfig conv_config_;
+  std::vector<layer::ImageShape> stage_shapes_;  ///< Input, then each stage
+
+  void build_encoder() override;
+  void build_decoder() override;
+
+  /**
+   * @brief Compute the stage shapes and the flat layer sizes in config_
+   */
+  void configure();
+};
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
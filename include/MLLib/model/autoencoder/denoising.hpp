@@ -32,6 +32,7 @@ struct DenoisingConfig {
   double noise_factor = 0.1;                   ///< Noise intensity
   double dropout_rate = 0.2;      ///< Dropout rate for dropout noise
   bool validate_on_clean = true;  ///< Validate on clean data
+  std::vector<size_t> image_shape;  ///< Sample shape {H, W, C}, empty if flat
 };
 
 /**
@@ -95,11 +96,19 @@ public:
    */
   NDArray denoise(const NDArray& noisy_input);
 
+  /**
+   * @brief Denoise several inputs in shared batches
+   * @param noisy_inputs Noisy input samples
+   * @return Denoised output per input
+   */
+  std::vector<NDArray> denoise(const std::vector<NDArray>& noisy_inputs);
+
   /**
    * @brief Calculate denoising performance metrics
    * @param clean_data Clean reference data
    * @param noisy_data Noisy input data
-   * @return Metrics (PSNR, SSIM, MSE)
+   * @return Metrics (PSNR, SSIM, MSE) averaged over the samples
+   * @throws std::invalid_argument if the samples differ in size
    */
   std::map<std::string, double>
   evaluate_denoising(const std::vector<NDArray>& clean_data,
@@ -136,43 +145,16 @@ public:
 
 protected:
   /**
-   * @brief Apply noise to input data
-   * @param input Clean input
-   * @return Noisy input
+   * @brief Corrupt values with the configured noise type
+   * @param clean Clean values
+   * @param noisy Receives the corrupted values, may alias clean
+   * @param count Number of values
    */
-  NDArray add_noise(const NDArray& input) override;
+  void corrupt(const double* clean, double* noisy, size_t count) override;
 
 private:
   DenoisingConfig denoising_config_;
 
-  /**
-   * @brief Apply Gaussian noise
-   * @param input Input data
-   * @return Noisy data
-   */
-  NDArray add_gaussian_noise(const NDArray& input);
-
-  /**
-   * @brief Apply salt and pepper noise
-   * @param input Input data
-   * @return Noisy data
-   */
-  NDArray add_salt_pepper_noise(const NDArray& input);
-
-  /**
-   * @brief Apply dropout noise
-   * @param input Input data
-   * @return Noisy data
-   */
-  NDArray add_dropout_noise(const NDArray& input);
-
-  /**
-   * @brief Apply uniform noise
-   * @param input Input data
-   * @return Noisy data
-   */
-  NDArray add_uniform_noise(const NDArray& input);
-
   /**
    * @brief Calculate PSNR (Peak Signal-to-Noise Ratio)
    * @param clean Clean image
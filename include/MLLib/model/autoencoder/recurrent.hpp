@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../../layer/recurrent.hpp"
+#include "base.hpp"
+
+/**
+ * @file recurrent.hpp
+ * @brief LSTM autoencoder for time series windows
+ */
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+/**
+ * @struct LSTMAutoencoderConfig
+ * @brief Architecture of an LSTM autoencoder
+ */
+struct LSTMAutoencoderConfig {
+  size_t steps = 1;         ///< Steps per window
+  size_t features = 1;      ///< Features per step
+  size_t hidden_size = 32;  ///< LSTM units of encoder and decoder
+  int latent_dim = 0;       ///< Dense bottleneck size, 0 = last hidden state
+  size_t bptt_steps = 0;    ///< Truncation of backpropagation, 0 = none
+};
+
+/**
+ * @class LSTMAutoencoder
+ * @brief Sequence-to-sequence autoencoder for sensor time series
+ * @details The encoder LSTM reads a window and its last hidden state,
+ * optionally compressed by a linear Dense layer, is the code. The decoder
+ * repeats the code for every step, runs a second LSTM over it and maps
+ * each hidden state back to the features with a shared Dense layer. The
+ * output is linear, so inputs are best standardized rather than scaled to
+ * [0, 1].
+ *
+ * Samples are windows flattened step by step, [steps * features] per row,
+ * so training, batching, reconstruction errors and model I/O work as for
+ * the other autoencoders.
+ */
+class LSTMAutoencoder : public BaseAutoencoder {
+public:
+  /**
+   * @brief Default constructor (for deserialization)
+   */
+  LSTMAutoencoder();
+
+  /**
+   * @brief Constructor
+   * @param lstm_config Architecture
+   * @param device Computation device
+   * @throws std::invalid_argument if a size is 0 or latent_dim is negative
+   */
+  explicit LSTMAutoencoder(const LSTMAutoencoderConfig& lstm_config,
+                           DeviceType device = DeviceType::CPU);
+
+  /**
+   * @brief Constructor with explicit parameters
+   * @param steps Steps per window
+   * @param features Features per step
+   * @param hidden_size LSTM units
+   * @param latent_dim Dense bottleneck size, 0 = last hidden state
+   * @param device Computation device
+   */
+  LSTMAutoencoder(size_t steps, size_t features, size_t hidden_size = 32,
+                  int latent_dim = 0, DeviceType device = DeviceType::CPU);
+
+  /**
+   * @brief Get autoencoder type
+   * @return RECURRENT type
+   */
+  AutoencoderType get_type() const override {
+    return AutoencoderType::RECURRENT;
+  }
+
+  /**
+   * @brief Get architecture
+   */
+  const LSTMAutoencoderConfig& get_lstm_config() const { return lstm_config_; }
+
+protected:
+  std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+  serialize_impl() const override;
+
+  bool deserialize_impl(
+      const std::unordered_map<std::string, std::vector<uint8_t>>& data)
+      override;
+
+private:
+  LSTMAutoencoderConfig lstm_config_;
+
+  void build_encoder() override;
+  void build_decoder() override;
+
+  /**
+   * @brief Validate the architecture and set the flat sizes in config_
+   */
+  void configure();
+
+  /**
+   * @brief Size of the code passed from encoder to decoder
+   */
+  size_t code_size() const;
+};
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "../../layer/base.hpp"
+#include "../../sparse.hpp"
+#include "base.hpp"
+#include <memory>
+
+/**
+ * @file sparse.hpp
+ * @brief Sparse autoencoder implementation
+ */
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+/**
+ * @enum SparsityType
+ * @brief Penalties that push latent activations towards zero
+ */
+enum class SparsityType {
+  L1,            ///< Mean L1 norm of ReLU latent codes
+  KL_DIVERGENCE  ///< KL divergence of sigmoid firing rates to a target rate
+};
+
+/**
+ * @struct SparseConfig
+ * @brief Configuration for sparse autoencoder
+ * @details The penalty weight is AutoencoderConfig::sparsity_penalty.
+ */
+struct SparseConfig {
+  SparsityType type = SparsityType::KL_DIVERGENCE;  ///< Penalty type
+  double target_rate = 0.05;  ///< Target mean activation for KL, in (0, 1)
+  size_t top_k = 0;  ///< Latent units kept per sample, 0 = all of them
+};
+
+/**
+ * @class SparseLatent
+ * @brief Latent activation that computes its sparsity penalty on the fly
+ * @details forward() applies the activation (ReLU for L1, sigmoid for KL),
+ * keeps the top_k largest units of each row and accumulates the penalty in
+ * the same pass. It keeps only a per-unit penalty gradient, which
+ * backward() adds to the incoming gradient while applying the activation
+ * derivative, so the penalty costs no extra pass over the batch.
+ */
+class SparseLatent : public layer::BaseLayer {
+public:
+  /**
+   * @brief Constructor
+   * @param type Penalty type, which also picks the activation
+   * @param weight Penalty weight
+   * @param target_rate Target mean activation for KL
+   * @param top_k Units kept per row, 0 = all of them
+   */
+  SparseLatent(SparsityType type, double weight, double target_rate,
+               size_t top_k = 0);
+
+  /**
+   * @brief Forward propagation
+   * @param input Pre-activations [batch_size, units]
+   * @return Sparse codes [batch_size, units]
+   */
+  NDArray forward(const NDArray& input) override;
+
+  /**
+   * @brief Inference-only forward propagation; computes no penalty
+   */
+  void infer(const NDArray& input, NDArray& output) const override;
+
+  /**
+   * @brief Backward propagation
+   * @param grad_output Gradient with respect to the codes
+   * @return Gradient with respect to the pre-activations, including the
+   * penalty gradient
+   */
+  NDArray backward(const NDArray& grad_output) override;
+
+  std::vector<NDArray*> get_parameters() override { return {}; }
+
+  /**
+   * @brief Mean penalty of the forward passes since reset_penalty()
+   */
+  double get_penalty() const;
+
+  /**
+   * @brief Start a new penalty average
+   */
+  void reset_penalty();
+
+private:
+  SparsityType type_;
+  double weight_;
+  double target_rate_;
+  size_t top_k_;
+
+  NDArray last_output_;                ///< Codes of the last forward pass
+  std::vector<double> penalty_grad_;   ///< Penalty gradient per unit
+  double penalty_sum_ = 0.0;
+  size_t penalty_count_ = 0;
+
+  /**
+   * @brief Activation and top-k selection of one row
+   * @param scratch Work space for the top-k selection
+   * @return Sum of the kept activations
+   */
+  double activate_row(const double* input, double* output, size_t units,
+                      std::vector<double>& scratch) const;
+};
+
+/**
+ * @class SparseAutoencoder
+ * @brief Autoencoder with a sparsity penalty on its latent code
+ * @details The encoder ends in a SparseLatent layer, so training with the
+ * base class loop adds the penalty gradient during backward. L1 codes are
+ * ReLU outputs with many exact zeros, and with top_k > 0 every code has at
+ * most top_k nonzeros. decode() feeds codes that are at most half full to
+ * the decoder as a CSR matrix, so the first decoder GEMM only reads the
+ * weight rows of active units.
+ */
+class SparseAutoencoder : public BaseAutoencoder {
+public:
+  /**
+   * @brief Default constructor (for deserialization)
+   */
+  SparseAutoencoder();
+
+  /**
+   * @brief Constructor with configuration
+   * @param config Base autoencoder configuration
+   * @param sparse_config Sparse-specific configuration
+   * @throws std::invalid_argument if the penalty is negative, the KL target
+   * rate is outside (0, 1) or top_k exceeds the latent dimension
+   */
+  SparseAutoencoder(const AutoencoderConfig& config,
+                    const SparseConfig& sparse_config = {});
+
+  /**
+   * @brief Constructor with explicit parameters
+   * @param input_dim Input dimension
+   * @param latent_dim Latent dimension
+   * @param hidden_dims Hidden layer dimensions
+   * @param sparsity_penalty Penalty weight
+   * @param type Penalty type
+   * @param device Computation device
+   */
+  SparseAutoencoder(int input_dim, int latent_dim,
+                    const std::vector<int>& hidden_dims = {},
+                    double sparsity_penalty = 0.1,
+                    SparsityType type = SparsityType::KL_DIVERGENCE,
+                    DeviceType device = DeviceType::CPU);
+
+  /**
+   * @brief Get autoencoder type
+   * @return SPARSE type
+   */
+  AutoencoderType get_type() const override { return AutoencoderType::SPARSE; }
+
+  /**
+   * @brief Decode latent codes, skipping inactive units
+   * @param latent Codes [batch, latent_dim]; with top_k > 0 only the top_k
+   * largest units of each row are used
+   * @return Reconstructed output
+   */
+  NDArray decode(const NDArray& latent) override;
+
+  /**
+   * @brief Decode several latent codes
+   * @details The codes are stacked and decoded as one batch, so the whole
+   * set goes through a single CSR matrix and decoder pass.
+   * @param latents Latent codes
+   * @return Reconstructed output per code
+   */
+  std::vector<NDArray> decode(const std::vector<NDArray>& latents) override;
+
+  /**
+   * @brief Train the sparse autoencoder
+   * @details Runs the base training loop; the callback's training loss
+   * includes the mean sparsity penalty.
+   */
+  void
+  train(const std::vector<NDArray>& training_data, loss::BaseLoss& loss,
+        optimizer::BaseOptimizer& optimizer, int epochs = 100,
+        int batch_size = 32,
+        const std::vector<NDArray>* validation_data = nullptr,
+        std::function<void(int, double, double)> callback = nullptr) override;
+
+  /**
+   * @brief Mean latent activation; KL training drives it to target_rate
+   * @param input Input data
+   */
+  double mean_activation(const NDArray& input);
+
+  /**
+   * @brief Get sparse configuration
+   */
+  const SparseConfig& get_sparse_config() const { return sparse_config_; }
+
+protected:
+  /**
+   * @brief Build encoder network ending in the sparse latent layer
+   */
+  void build_encoder() override;
+
+  std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+  serialize_impl() const override;
+
+  bool deserialize_impl(
+      const std::unordered_map<std::string, std::vector<uint8_t>>& data)
+      override;
+
+private:
+  SparseConfig sparse_config_;
+  std::shared_ptr<SparseLatent> latent_layer_;
+
+  /**
+   * @brief Throw unless the configuration is usable
+   */
+  void validate() const;
+
+  /**
+   * @brief Codes as CSR rows, keeping at most top_k units per row
+   */
+  SparseMatrix to_sparse_codes(const NDArray& latent) const;
+};
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
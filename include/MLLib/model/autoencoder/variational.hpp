@@ -70,6 +70,20 @@ public:
     return AutoencoderType::VARIATIONAL;
   }
 
+  /**
+   * @brief Encode input to the latent mean
+   * @param input Input data [batch, input_dim]
+   * @return Latent mean [batch, latent_dim]
+   */
+  NDArray encode(const NDArray& input) override;
+
+  /**
+   * @brief Encode several inputs to latent means in shared batches
+   * @param inputs Input samples
+   * @return Latent mean per input
+   */
+  std::vector<NDArray> encode(const std::vector<NDArray>& inputs) override;
+
   /**
    * @brief Encode input to latent distribution parameters
    * @param input Input data
@@ -104,6 +118,10 @@ public:
 
   /**
    * @brief Train the VAE
+   * @details Samples are stacked into [batch_size, input_dim] mini-batches.
+   * Each step runs one forward pass, reparameterizes the whole batch,
+   * back-propagates reconstruction and closed-form KL gradients through
+   * decoder, both heads and the shared encoder, then updates all weights.
    * @param training_data Training dataset
    * @param loss Base loss function (reconstruction loss)
    * @param optimizer Optimizer
@@ -196,19 +214,42 @@ private:
   std::unique_ptr<Sequential> mean_encoder_;    ///< Encoder for mean
   std::unique_ptr<Sequential> logvar_encoder_;  ///< Encoder for log variance
 
+  /**
+   * @brief Run the shared encoder layers
+   * @param input Input data
+   * @return Hidden features fed to both heads
+   */
+  NDArray encode_hidden(const NDArray& input) const;
+
+  /**
+   * @brief Train on one stacked mini-batch
+   * @param batch Inputs [batch, input_dim]
+   * @param loss Reconstruction loss
+   * @param optimizer Optimizer
+   * @param kl_weight Weight of the KL term
+   * @param kl_loss Receives the batch KL divergence
+   * @return Batch reconstruction loss
+   */
+  double train_batch(const NDArray& batch, loss::BaseLoss& loss,
+                     optimizer::BaseOptimizer& optimizer, double kl_weight,
+                     double& kl_loss);
+
   /**
    * @brief Reparameterization trick: sample = mean + std * epsilon
    * @param mean Latent mean
    * @param log_var Latent log variance
+   * @param epsilon Receives the noise used, for the backward pass; may be
+   * null
    * @return Sampled latent vector
    */
-  NDArray reparameterize_sample(const NDArray& mean, const NDArray& log_var);
+  NDArray reparameterize_sample(const NDArray& mean, const NDArray& log_var,
+                                NDArray* epsilon = nullptr);
 
   /**
    * @brief Calculate KL divergence loss
    * @param mean Latent mean
    * @param log_var Latent log variance
-   * @return KL divergence loss
+   * @return KL divergence to N(0, I), averaged over the batch
    */
   double calculate_kl_loss(const NDArray& mean, const NDArray& log_var);
 
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "../util/system/thread.hpp"
+#include "sequential.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file batching_executor.hpp
+ * @brief Dynamic batching of single-sample inference requests
+ *
+ * Serving one sample per predict() call turns every layer into a GEMV. The
+ * BatchingExecutor queues single-sample requests from any number of threads,
+ * closes a micro-batch when it reaches max_batch_size or its oldest request
+ * has waited max_wait, runs one batched forward pass on a worker pool and
+ * fulfils each request's future with its row of the output. At most
+ * num_workers batches run at once; while all workers are busy, requests
+ * stay queued and the next batch grows instead.
+ *
+ * max_batch_size and max_wait trade latency for throughput: larger values
+ * give bigger GEMMs, smaller values answer sooner under light load.
+ */
+
+namespace MLLib {
+namespace model {
+
+/**
+ * @struct BatchingOptions
+ * @brief Tuning knobs of a BatchingExecutor
+ */
+struct BatchingOptions {
+  size_t max_batch_size = 32;  ///< Requests per forward pass
+  std::chrono::microseconds max_wait{1000};  ///< Oldest request's wait bound
+  size_t num_workers = 1;      ///< Batches that may run concurrently
+  size_t max_queue_depth = 0;  ///< Queued plus running requests allowed,
+                               ///< 0 = unbounded
+};
+
+/**
+ * @struct BatchingMetrics
+ * @brief Snapshot of executor activity
+ */
+struct BatchingMetrics {
+  size_t queue_depth = 0;       ///< Requests queued or running now
+  size_t peak_queue_depth = 0;  ///< Highest queue depth seen
+  uint64_t requests = 0;        ///< Requests completed (including failures)
+  uint64_t batches = 0;         ///< Forward passes run
+  uint64_t rejected = 0;        ///< Requests refused because the queue was full
+  double average_batch_size = 0.0;
+  double average_latency_us = 0.0;  ///< Submit to completion
+  double max_latency_us = 0.0;
+};
+
+/**
+ * @class BatchingExecutor
+ * @brief Collects single-sample requests into batched forward passes
+ */
+class BatchingExecutor {
+public:
+  /**
+   * @brief Start the executor
+   * @param model Model to serve; it is only read, so it may be shared with
+   * other executors or threads
+   * @param options Batching knobs
+   * @throws std::invalid_argument if model is null or max_batch_size is 0
+   */
+  explicit BatchingExecutor(std::shared_ptr<const Sequential> model,
+                            const BatchingOptions& options = BatchingOptions());
+
+  /**
+   * @brief Run all pending requests, then stop
+   */
+  ~BatchingExecutor();
+
+  BatchingExecutor(const BatchingExecutor&) = delete;
+  BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+
+  /**
+   * @brief Queue one sample
+   * @param input Feature vector of one sample
+   * @return Future holding the model output for the sample, or the error
+   * raised by the forward pass
+   * @throws std::invalid_argument if input is empty
+   * @throws std::runtime_error if the queue is full
+   */
+  std::future<std::vector<double>> submit(std::vector<double> input);
+
+  /**
+   * @brief Change the batch size limit for batches not yet formed
+   * @throws std::invalid_argument if max_batch_size is 0
+   */
+  void set_max_batch_size(size_t max_batch_size);
+
+  /**
+   * @brief Change the wait bound for batches not yet formed
+   */
+  void set_max_wait(std::chrono::microseconds max_wait);
+
+  /**
+   * @brief Get current options
+   */
+  BatchingOptions options() const;
+
+  /**
+   * @brief Get number of requests queued or running
+   */
+  size_t queue_depth() const;
+
+  /**
+   * @brief Get a snapshot of the metrics
+   */
+  BatchingMetrics metrics() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    std::vector<double> input;
+    std::promise<std::vector<double>> promise;
+    Clock::time_point submitted;
+  };
+
+  void dispatch_loop();
+  std::vector<Request> take_batch();
+  void run_batch(std::vector<Request>& batch);
+  void record_completion(const std::vector<Request>& batch);
+  size_t pending() const { return queue_.size() + in_flight_requests_; }
+
+  std::shared_ptr<const Sequential> model_;
+  BatchingOptions options_;
+  uint64_t options_version_;  ///< Bumped by the setters to wake the dispatcher
+
+  mutable std::mutex mutex_;           ///< Guards queue, options and metrics
+  std::condition_variable condition_;  ///< Signals requests/free slot/stop
+  std::deque<Request> queue_;
+  bool stop_;
+
+  size_t max_in_flight_;       ///< Batches allowed to run at once
+  size_t in_flight_batches_;   ///< Batches handed to the workers
+  size_t in_flight_requests_;  ///< Requests in those batches
+
+  BatchingMetrics metrics_;
+  double total_latency_us_;
+
+  std::unique_ptr<util::ThreadPool> workers_;  ///< Runs forward passes
+  std::thread dispatcher_;                     ///< Forms batches
+};
+
+}  // namespace model
+}  // namespace MLLib
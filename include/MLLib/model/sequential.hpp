@@ -1,11 +1,14 @@
 #pragma once
 
+#include "../backend/stream.hpp"
 #include "../device/device.hpp"
 #include "../layer/base.hpp"
 #include "../loss/base.hpp"
 #include "../optimizer/base.hpp"
+#include "../sparse.hpp"
 #include "base_model.hpp"
 #include <functional>
+#include <future>
 #include <initializer_list>
 #include <memory>
 #include <vector>
@@ -18,6 +21,28 @@
 namespace MLLib {
 namespace model {
 
+class Sequential;
+
+/**
+ * @class InferenceContext
+ * @brief Per-call scratch state for Sequential inference
+ * @details Holds one activation buffer per layer. Reusing a context across
+ * calls with the same input shape avoids reallocating them. A context must
+ * not be used by two calls at the same time; the model itself can be.
+ */
+class InferenceContext {
+public:
+  /**
+   * @brief Get the output of the last predict() call using this context
+   * @return Output predictions
+   */
+  const NDArray& output() const;
+
+private:
+  friend class Sequential;
+  std::vector<NDArray> activations_;  ///< Output of each layer
+};
+
 /**
  * @class Sequential
  * @brief Sequential neural network model
@@ -62,29 +87,61 @@ public:
    * @brief Forward propagation
    * @param input Input data
    * @return Output predictions
+   * @details Inference does not modify the model, so threads may share one
+   * Sequential as long as nobody trains or edits it concurrently.
    */
-  NDArray predict(const NDArray& input);
+  NDArray predict(const NDArray& input) const;
+
+  /**
+   * @brief Forward propagation into caller-owned scratch buffers
+   * @param input Input data
+   * @param context Scratch state, one per concurrent caller
+   * @return Output predictions, valid until context is reused
+   */
+  const NDArray& predict(const NDArray& input,
+                         InferenceContext& context) const;
 
   /**
    * @brief Forward propagation for multiple samples
    * @param inputs Vector of input samples
-   * @return Vector of predictions
+   * @return Vector of predictions, one per input
+   * @details [rows, features] inputs with the same feature count are stacked
+   * into shared batches, which run concurrently on the global thread pool.
+   * Inputs of any other rank are predicted one by one.
    */
-  std::vector<NDArray> predict(const std::vector<NDArray>& inputs);
+  std::vector<NDArray> predict(const std::vector<NDArray>& inputs) const;
 
   /**
    * @brief Predict from vector input (convenience method)
    * @param input Input vector
    * @return Output vector
    */
-  std::vector<double> predict(const std::vector<double>& input);
+  std::vector<double> predict(const std::vector<double>& input) const;
 
   /**
    * @brief Predict from initializer list (convenience method)
    * @param input Input as initializer list (e.g., {1.0, 2.0, 3.0})
    * @return Output vector
    */
-  std::vector<double> predict(std::initializer_list<double> input);
+  std::vector<double> predict(std::initializer_list<double> input) const;
+
+  /**
+   * @brief Forward propagation of a sparse batch
+   * @param input Sparse input [batch_size, features]
+   * @return Output predictions
+   * @throws std::invalid_argument if the first layer is not Dense
+   */
+  NDArray predict(const SparseMatrix& input) const;
+
+  /**
+   * @brief Enqueue forward propagation on a stream
+   * @param input Input data (copied, so the caller may release it)
+   * @param stream Stream to run on; requests for one model may be spread
+   * over several streams
+   * @return Future holding the output predictions
+   */
+  std::future<NDArray> predict_async(const NDArray& input,
+                                     Backend::Stream& stream) const;
 
   /**
    * @brief Train the model
@@ -101,6 +158,24 @@ public:
              std::function<void(int, double)> callback = nullptr,
              int epochs = 1000);
 
+  /**
+   * @brief Train the model on sparse inputs
+   * @details The first layer, which must be Dense, runs sparse x dense
+   * products, so its cost scales with the number of stored entries rather
+   * than the input width.
+   * @param X Sparse training inputs [samples, features]
+   * @param Y Training targets
+   * @param loss Loss function
+   * @param optimizer Optimizer
+   * @param callback Optional callback function for epoch end
+   * @param epochs Number of training epochs
+   * @throws std::invalid_argument if the first layer is not Dense
+   */
+  void train(const SparseMatrix& X, const std::vector<std::vector<double>>& Y,
+             loss::BaseLoss& loss, optimizer::BaseOptimizer& optimizer,
+             std::function<void(int, double)> callback = nullptr,
+             int epochs = 1000);
+
   /**
    * @brief Set training mode for all layers
    * @param training True for training mode, false for inference
@@ -155,6 +230,17 @@ private:
    */
   NDArray vectorsToNDArray(const std::vector<std::vector<double>>& data);
 
+  /**
+   * @brief Full-batch training loop shared by dense and sparse inputs
+   * @param forward_input Runs the layers before first_layer on the inputs
+   * @param first_layer Index of the first layer run on dense activations
+   * @param targets Target batch
+   */
+  void fit(const std::function<NDArray()>& forward_input, size_t first_layer,
+           const NDArray& targets, loss::BaseLoss& loss,
+           optimizer::BaseOptimizer& optimizer,
+           const std::function<void(int, double)>& callback, int epochs);
+
   /**
    * @brief Get all trainable parameters from all layers
    * @return Vector of parameter pointers
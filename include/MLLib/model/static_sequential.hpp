@@ -0,0 +1,260 @@
+#pragma once
+
+#include "../layer/activation/relu.hpp"
+#include "../layer/activation/sigmoid.hpp"
+#include "../layer/activation/tanh.hpp"
+#include "../layer/dense.hpp"
+#include "model_io.hpp"
+#include "sequential.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+
+/**
+ * @file static_sequential.hpp
+ * @brief Sequential models with shapes fixed at compile time
+ *
+ * For models of a few small layers, shape vectors, heap allocation and
+ * virtual calls cost more than the arithmetic. StaticSequential fixes the
+ * architecture in its type,
+ *
+ *   StaticSequential<fixed::Dense<8, 16>, fixed::ReLU, fixed::Dense<16, 4>>
+ *
+ * keeps every parameter and activation in std::array storage and runs
+ * loops with constant trip counts that the compiler unrolls and
+ * vectorizes. It is inference only: train a Sequential, then copy its
+ * parameters with load() or read them from a file saved by GenericModelIO.
+ */
+
+namespace MLLib {
+namespace model {
+namespace fixed {
+
+/**
+ * @class Dense
+ * @brief Fully connected layer of fixed size
+ * @tparam In Input features
+ * @tparam Out Output features
+ * @tparam UseBias Whether a bias is added
+ */
+template <size_t In, size_t Out, bool UseBias = true> class Dense {
+public:
+  static_assert(In > 0 && Out > 0, "Dense sizes must be positive");
+
+  static constexpr size_t input_size = In;
+
+  /**
+   * @brief Output features for an input of N features
+   */
+  template <size_t N> static constexpr size_t output_size() {
+    static_assert(N == In, "Dense input size does not match previous layer");
+    return Out;
+  }
+
+  /**
+   * @brief Weights [In, Out], row-major like layer::Dense
+   */
+  std::array<double, In * Out>& weights() { return weights_; }
+  const std::array<double, In * Out>& weights() const { return weights_; }
+
+  std::array<double, Out>& bias() { return bias_; }
+  const std::array<double, Out>& bias() const { return bias_; }
+
+  void infer(const std::array<double, In>& input,
+             std::array<double, Out>& output) const {
+    if constexpr (UseBias) {
+      output = bias_;
+    } else {
+      output.fill(0.0);
+    }
+    for (size_t i = 0; i < In; ++i) {
+      const double x = input[i];
+      const double* row = weights_.data() + i * Out;
+      for (size_t j = 0; j < Out; ++j) {
+        output[j] += x * row[j];
+      }
+    }
+  }
+
+  /**
+   * @brief Copy the parameters of a layer::Dense of the same shape
+   * @return False if the layer is not such a Dense layer
+   */
+  bool load(const layer::BaseLayer& source) {
+    const auto* dense = dynamic_cast<const layer::Dense*>(&source);
+    if (!dense || dense->get_input_size() != In ||
+        dense->get_output_size() != Out || dense->get_use_bias() != UseBias) {
+      return false;
+    }
+    const double* w = dense->get_weights().data();
+    std::copy(w, w + In * Out, weights_.begin());
+    if constexpr (UseBias) {
+      const double* b = dense->get_bias().data();
+      std::copy(b, b + Out, bias_.begin());
+    }
+    return true;
+  }
+
+private:
+  std::array<double, In * Out> weights_{};
+  std::array<double, Out> bias_{};
+};
+
+/**
+ * @class Elementwise
+ * @brief Activation applied to each element; keeps the width
+ * @tparam Op Function object with static double apply(double)
+ * @tparam Source Matching layer type of a Sequential model
+ */
+template <typename Op, typename Source> class Elementwise {
+public:
+  template <size_t N> static constexpr size_t output_size() { return N; }
+
+  template <size_t N>
+  void infer(const std::array<double, N>& input,
+             std::array<double, N>& output) const {
+    for (size_t i = 0; i < N; ++i) {
+      output[i] = Op::apply(input[i]);
+    }
+  }
+
+  bool load(const layer::BaseLayer& source) const {
+    return dynamic_cast<const Source*>(&source) != nullptr;
+  }
+};
+
+namespace detail {
+
+struct ReLUOp {
+  static double apply(double x) { return x > 0.0 ? x : 0.0; }
+};
+struct SigmoidOp {
+  static double apply(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+};
+struct TanhOp {
+  static double apply(double x) { return std::tanh(x); }
+};
+
+}  // namespace detail
+
+using ReLU = Elementwise<detail::ReLUOp, layer::activation::ReLU>;
+using Sigmoid = Elementwise<detail::SigmoidOp, layer::activation::Sigmoid>;
+using Tanh = Elementwise<detail::TanhOp, layer::activation::Tanh>;
+
+}  // namespace fixed
+
+namespace detail {
+
+/**
+ * @brief Width after layer I of a layer tuple for an input of width N
+ */
+template <typename LayerTuple, size_t I, size_t N>
+constexpr size_t staticWidthAfter() {
+  constexpr size_t width =
+      std::tuple_element_t<I, LayerTuple>::template output_size<N>();
+  if constexpr (I + 1 == std::tuple_size_v<LayerTuple>) {
+    return width;
+  } else {
+    return staticWidthAfter<LayerTuple, I + 1, width>();
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @class StaticSequential
+ * @brief Inference-only sequential model with compile-time shapes
+ * @tparam Layers Layer types from namespace fixed; the first must be Dense
+ */
+template <typename... Layers> class StaticSequential {
+public:
+  static_assert(sizeof...(Layers) > 0, "StaticSequential needs a layer");
+
+  using LayerTuple = std::tuple<Layers...>;
+  static constexpr size_t num_layers = sizeof...(Layers);
+  static constexpr size_t input_size =
+      std::tuple_element_t<0, LayerTuple>::input_size;
+  static constexpr size_t output_size =
+      detail::staticWidthAfter<LayerTuple, 0, input_size>();
+
+  using Input = std::array<double, input_size>;
+  using Output = std::array<double, output_size>;
+
+  /**
+   * @brief Forward pass of one sample; allocates nothing
+   */
+  Output predict(const Input& input) const {
+    Output output;
+    run<0>(input, output);
+    return output;
+  }
+
+  /**
+   * @brief Forward pass of one sample into caller-owned storage
+   */
+  void predict(const Input& input, Output& output) const {
+    run<0>(input, output);
+  }
+
+  /**
+   * @brief Layer I, e.g. to set its parameters directly
+   */
+  template <size_t I> auto& layer() { return std::get<I>(layers_); }
+  template <size_t I> const auto& layer() const { return std::get<I>(layers_); }
+
+  /**
+   * @brief Copy the parameters of a trained Sequential model
+   * @return False unless the model has the same layer types and shapes;
+   * the parameters are left unchanged then
+   */
+  bool load(const Sequential& model) {
+    const auto& source = model.get_layers();
+    if (source.size() != num_layers) {
+      return false;
+    }
+    LayerTuple loaded = layers_;
+    const bool matched = std::apply(
+        [&](auto&... target) {
+          size_t i = 0;
+          return (target.load(*source[i++]) && ...);
+        },
+        loaded);
+    if (matched) {
+      layers_ = loaded;
+    }
+    return matched;
+  }
+
+  /**
+   * @brief Read the parameters of a Sequential model saved by GenericModelIO
+   * @return False if the file cannot be read or does not match the type
+   */
+  bool load(const std::string& filepath,
+            SaveFormat format = SaveFormat::BINARY) {
+    auto model = GenericModelIO::load_model<Sequential>(filepath, format);
+    return model && load(*model);
+  }
+
+private:
+  LayerTuple layers_;
+
+  template <size_t I, size_t N>
+  void run(const std::array<double, N>& input, Output& output) const {
+    if constexpr (I + 1 == num_layers) {
+      std::get<I>(layers_).infer(input, output);
+    } else {
+      constexpr size_t width =
+          std::tuple_element_t<I, LayerTuple>::template output_size<N>();
+      std::array<double, width> hidden;
+      std::get<I>(layers_).infer(input, hidden);
+      run<I + 1>(hidden, output);
+    }
+  }
+};
+
+}  // namespace model
+}  // namespace MLLib
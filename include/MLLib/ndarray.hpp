@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <initializer_list>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 /**
@@ -11,9 +13,45 @@
 
 namespace MLLib {
 
+namespace Backend {
+class DeviceBuffer;
+class DeviceMemoryBackend;
+}  // namespace Backend
+
+namespace expr {
+template <typename Derived> class Expression;
+}  // namespace expr
+
+/**
+ * @enum Residency
+ * @brief Where the valid copy of an NDArray's data lives
+ */
+enum class Residency {
+  HOST,    ///< Only host memory is valid
+  DEVICE,  ///< Only device memory is valid; host reads trigger a download
+  BOTH     ///< Host and device copies are identical
+};
+
+/**
+ * @enum Accumulation
+ * @brief Summation scheme used by reductions
+ */
+enum class Accumulation {
+  NAIVE,     ///< Running sums in independent lanes; fastest
+  PAIRWISE,  ///< Pairwise over blocks; error grows with log(n)
+  KAHAN      ///< Compensated; error independent of n
+};
+
 /**
  * @class NDArray
  * @brief Multi-dimensional array class for tensor operations
+ * @details Element-wise operators broadcast like NumPy: shapes are aligned
+ * from the right and each pair of dimensions must be equal or contain a 1.
+ * Axis reductions accept negative axes counted from the end.
+ *
+ * These operators are eager: each one allocates and fills its result. For
+ * chains of element-wise operations use the lazy expressions of
+ * ndarray_expr.hpp, which evaluate in one fused pass.
  */
 class NDArray {
 public:
@@ -56,6 +94,30 @@ public:
    */
   NDArray& operator=(const NDArray& other);
 
+  /**
+   * @brief Move constructor; other is left empty
+   */
+  NDArray(NDArray&& other) noexcept;
+
+  /**
+   * @brief Move assignment; other is left empty
+   */
+  NDArray& operator=(NDArray&& other) noexcept;
+
+  /**
+   * @brief Construct by evaluating a lazy expression in one pass
+   * @details Defined in ndarray_expr.hpp
+   */
+  template <typename E> NDArray(const expr::Expression<E>& expression);
+
+  /**
+   * @brief Evaluate a lazy expression into this array
+   * @details The current storage is reused when the element count matches,
+   * and the expression may read this array. Defined in ndarray_expr.hpp.
+   * @return Reference to this array
+   */
+  template <typename E> NDArray& assign(const expr::Expression<E>& expression);
+
   /**
    * @brief Get element at index (1D)
    * @param index Index
@@ -98,15 +160,80 @@ public:
 
   /**
    * @brief Get raw data pointer
+   * @details Downloads device-resident data first and invalidates the device
+   * copy, since the caller may write through the pointer
    * @return Raw data pointer
    */
-  double* data() { return data_.get(); }
+  double* data() {
+    sync_host_for_write();
+    return data_.get();
+  }
 
   /**
    * @brief Get raw data pointer - const version
+   * @details Downloads device-resident data first. The download is
+   * serialized per array, so concurrent const readers (e.g. several threads
+   * predicting through shared device-resident weights) are safe.
    * @return Const raw data pointer
    */
-  const double* data() const { return data_.get(); }
+  const double* data() const {
+    sync_host();
+    return data_.get();
+  }
+
+  /**
+   * @brief Get where the valid copy of the data lives
+   * @return Residency state
+   */
+  Residency residency() const {
+    return residency_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Get the device copy, if one has been attached
+   * @return Device buffer or nullptr
+   */
+  Backend::DeviceBuffer* device_buffer() const { return device_.get(); }
+
+  /**
+   * @brief Attach a device copy and record which copy is valid
+   * @param buffer Device buffer holding at least size() elements
+   * @param residency New residency state
+   * @details Used by Backend when it uploads data or writes results on the
+   * device. Device state is a cache of the logical contents, so this is
+   * allowed on const arrays.
+   */
+  void set_device_state(std::shared_ptr<Backend::DeviceBuffer> buffer,
+                        Residency residency) const;
+
+  /**
+   * @brief Get a valid device copy in @p memory, uploading if necessary
+   * @param memory Device memory the copy must live in
+   * @return Device buffer holding the current contents
+   * @details Check, allocate, upload and attach run under the array's lock,
+   * so concurrent readers of shared weights upload once and never replace a
+   * buffer another thread is using. The returned pointer keeps the buffer
+   * alive independently of the array.
+   */
+  std::shared_ptr<Backend::DeviceBuffer>
+  ensure_device(Backend::DeviceMemoryBackend& memory) const;
+
+  /**
+   * @brief Record which copy is valid without changing the device buffer
+   * @param residency New residency state
+   * @throws std::logic_error if device residency is set without a buffer
+   */
+  void set_residency(Residency residency) const;
+
+  /**
+   * @brief Make the host copy valid, downloading if necessary
+   * @details Thread-safe against other const accesses to the same array
+   */
+  void sync_host() const {
+    if (residency_.load(std::memory_order_acquire) == Residency::DEVICE) {
+      download_from_device();
+    }
+  }
 
   /**
    * @brief Reshape the array
@@ -134,26 +261,62 @@ public:
   NDArray matmul(const NDArray& other) const;
 
   /**
-   * @brief Element-wise addition
+   * @brief Element-wise addition with broadcasting
    * @param other Other NDArray
    * @return Result of addition
+   * @throws std::invalid_argument if the shapes cannot be broadcast
    */
   NDArray operator+(const NDArray& other) const;
 
   /**
-   * @brief Element-wise subtraction
+   * @brief Element-wise subtraction with broadcasting
    * @param other Other NDArray
    * @return Result of subtraction
    */
   NDArray operator-(const NDArray& other) const;
 
   /**
-   * @brief Element-wise multiplication
+   * @brief Element-wise multiplication with broadcasting
    * @param other Other NDArray
    * @return Result of multiplication
    */
   NDArray operator*(const NDArray& other) const;
 
+  /**
+   * @brief Element-wise division with broadcasting
+   * @param other Other NDArray
+   * @return Result of division
+   */
+  NDArray operator/(const NDArray& other) const;
+
+  /**
+   * @brief In-place addition; other must broadcast to this shape
+   * @throws std::invalid_argument if other does not broadcast to this shape
+   */
+  NDArray& operator+=(const NDArray& other);
+
+  /**
+   * @brief In-place subtraction; other must broadcast to this shape
+   */
+  NDArray& operator-=(const NDArray& other);
+
+  /**
+   * @brief In-place multiplication; other must broadcast to this shape
+   */
+  NDArray& operator*=(const NDArray& other);
+
+  /**
+   * @brief In-place division; other must broadcast to this shape
+   */
+  NDArray& operator/=(const NDArray& other);
+
+  /**
+   * @brief Shape of the result of broadcasting two shapes
+   * @throws std::invalid_argument if the shapes cannot be broadcast
+   */
+  static std::vector<size_t> broadcast_shape(const std::vector<size_t>& a,
+                                             const std::vector<size_t>& b);
+
   /**
    * @brief Scalar addition
    * @param scalar Scalar value
@@ -168,10 +331,103 @@ public:
    */
   NDArray operator*(double scalar) const;
 
+  /**
+   * @brief Sum of all elements
+   * @param accumulation Summation scheme
+   */
+  double sum(Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Sum along an axis
+   * @param axis Axis to reduce, negative values count from the end
+   * @param keep_dims Keep the reduced axis with length 1
+   * @param accumulation Summation scheme
+   * @throws std::invalid_argument if the axis is out of range
+   */
+  NDArray sum(int axis, bool keep_dims = false,
+              Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Mean of all elements
+   */
+  double mean(Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Mean along an axis
+   */
+  NDArray mean(int axis, bool keep_dims = false,
+               Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Largest element
+   * @throws std::invalid_argument if the array is empty
+   */
+  double max() const;
+
+  /**
+   * @brief Largest elements along an axis
+   */
+  NDArray max(int axis, bool keep_dims = false) const;
+
+  /**
+   * @brief Linear index of the first largest element
+   * @throws std::invalid_argument if the array is empty
+   */
+  size_t argmax() const;
+
+  /**
+   * @brief Indices of the first largest elements along an axis
+   * @return Indices stored as doubles
+   */
+  NDArray argmax(int axis, bool keep_dims = false) const;
+
+  /**
+   * @brief Population variance of all elements
+   * @details Computed in two passes, around the mean, for stability
+   */
+  double var(Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Population variance along an axis
+   */
+  NDArray var(int axis, bool keep_dims = false,
+              Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Euclidean norm of all elements
+   */
+  double norm(Accumulation accumulation = Accumulation::PAIRWISE) const;
+
+  /**
+   * @brief Euclidean norm along an axis
+   */
+  NDArray norm(int axis, bool keep_dims = false,
+               Accumulation accumulation = Accumulation::PAIRWISE) const;
+
 private:
   std::vector<size_t> shape_;
   size_t size_ = 0;
   std::unique_ptr<double[]> data_;
+  mutable std::shared_ptr<Backend::DeviceBuffer> device_;  ///< Device copy
+  mutable std::atomic<Residency> residency_{Residency::HOST};  ///< Valid copy
+  mutable std::mutex sync_mutex_;  ///< Serializes lazy transfers
+
+  /**
+   * @brief Copy device data to the host and mark both copies valid
+   * @details Takes sync_mutex_ and re-checks residency, so only the first
+   * of several concurrent readers downloads
+   */
+  void download_from_device() const;
+
+  /**
+   * @brief Make the host copy valid and the only valid copy
+   */
+  void sync_host_for_write() {
+    if (residency_ != Residency::HOST) {
+      sync_host();
+      residency_ = Residency::HOST;
+    }
+  }
 
   /**
    * @brief Calculate total size from shape
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "ndarray.hpp"
+#include "util/system/thread.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file ndarray_expr.hpp
+ * @brief Lazy element-wise expressions over NDArray
+ *
+ * Wrapping arrays with lazy() makes the arithmetic operators build an
+ * expression tree instead of allocating a result per operator. The tree is
+ * evaluated in a single pass when it is assigned to an array, so
+ *
+ *   out.assign(lazy(a) * 2.0 + lazy(b) * lazy(c));
+ *
+ * reads each input once, writes out once and allocates nothing when out
+ * already has the right size. Evaluation runs over fixed-size blocks that
+ * the compiler vectorizes and splits large arrays across the global
+ * thread pool.
+ *
+ * Operands must have the same shape; scalars apply to every element. The
+ * eager NDArray operators are unchanged and remain the way to broadcast or
+ * to inspect intermediate results. Expressions keep references to their
+ * arrays, which must outlive the evaluation.
+ */
+
+namespace MLLib {
+namespace expr {
+
+/**
+ * @class Expression
+ * @brief CRTP base of every expression node
+ */
+template <typename Derived> class Expression {
+public:
+  const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+/**
+ * @class Leaf
+ * @brief Reference to the elements of an array
+ */
+class Leaf : public Expression<Leaf> {
+public:
+  explicit Leaf(const NDArray& array)
+      : data_(array.data()), shape_(&array.shape()), size_(array.size()) {}
+
+  double operator[](size_t i) const { return data_[i]; }
+  const std::vector<size_t>* shape_ptr() const { return shape_; }
+  size_t size() const { return size_; }
+
+private:
+  const double* data_;
+  const std::vector<size_t>* shape_;
+  size_t size_;
+};
+
+/**
+ * @class Scalar
+ * @brief Constant applied to every element
+ */
+class Scalar : public Expression<Scalar> {
+public:
+  explicit Scalar(double value) : value_(value) {}
+
+  double operator[](size_t) const { return value_; }
+  const std::vector<size_t>* shape_ptr() const { return nullptr; }
+  size_t size() const { return 0; }
+
+private:
+  double value_;
+};
+
+struct Add {
+  static double apply(double a, double b) { return a + b; }
+};
+struct Subtract {
+  static double apply(double a, double b) { return a - b; }
+};
+struct Multiply {
+  static double apply(double a, double b) { return a * b; }
+};
+struct Divide {
+  static double apply(double a, double b) { return a / b; }
+};
+struct Negate {
+  static double apply(double a) { return -a; }
+};
+struct Square {
+  static double apply(double a) { return a * a; }
+};
+
+/**
+ * @class Binary
+ * @brief Element-wise binary operation; children are held by value
+ */
+template <typename Op, typename L, typename R>
+class Binary : public Expression<Binary<Op, L, R>> {
+public:
+  Binary(const L& left, const R& right) : left_(left), right_(right) {
+    const std::vector<size_t>* a = left.shape_ptr();
+    const std::vector<size_t>* b = right.shape_ptr();
+    if (!a && !b) {
+      throw std::invalid_argument("Lazy expression needs an array operand");
+    }
+    if (a && b && *a != *b) {
+      throw std::invalid_argument(
+          "Lazy expression operands must have the same shape");
+    }
+    shape_ = a ? a : b;
+    size_ = a ? left.size() : right.size();
+  }
+
+  double operator[](size_t i) const {
+    return Op::apply(left_[i], right_[i]);
+  }
+  const std::vector<size_t>* shape_ptr() const { return shape_; }
+  size_t size() const { return size_; }
+
+private:
+  L left_;
+  R right_;
+  const std::vector<size_t>* shape_;
+  size_t size_;
+};
+
+/**
+ * @class Unary
+ * @brief Element-wise unary operation
+ */
+template <typename Op, typename A>
+class Unary : public Expression<Unary<Op, A>> {
+public:
+  explicit Unary(const A& operand) : operand_(operand) {}
+
+  double operator[](size_t i) const { return Op::apply(operand_[i]); }
+  const std::vector<size_t>* shape_ptr() const { return operand_.shape_ptr(); }
+  size_t size() const { return operand_.size(); }
+
+private:
+  A operand_;
+};
+
+/**
+ * @brief Start a lazy expression from an array
+ */
+inline Leaf lazy(const NDArray& array) { return Leaf(array); }
+
+// Expression-expression, expression-array and expression-scalar operators
+#define MLLIB_EXPR_BINARY_OPERATOR(symbol, Op)                                 \
+  template <typename L, typename R>                                            \
+  Binary<Op, L, R> operator symbol(const Expression<L>& left,                  \
+                                   const Expression<R>& right) {               \
+    return Binary<Op, L, R>(left.self(), right.self());                        \
+  }                                                                            \
+  template <typename L>                                                        \
+  Binary<Op, L, Leaf> operator symbol(const Expression<L>& left,               \
+                                      const NDArray& right) {                  \
+    return Binary<Op, L, Leaf>(left.self(), Leaf(right));                      \
+  }                                                                            \
+  template <typename R>                                                        \
+  Binary<Op, Leaf, R> operator symbol(const NDArray& left,                     \
+                                      const Expression<R>& right) {            \
+    return Binary<Op, Leaf, R>(Leaf(left), right.self());                      \
+  }                                                                            \
+  template <typename L>                                                        \
+  Binary<Op, L, Scalar> operator symbol(const Expression<L>& left,             \
+                                        double right) {                        \
+    return Binary<Op, L, Scalar>(left.self(), Scalar(right));                  \
+  }                                                                            \
+  template <typename R>                                                        \
+  Binary<Op, Scalar, R> operator symbol(double left,                           \
+                                        const Expression<R>& right) {          \
+    return Binary<Op, Scalar, R>(Scalar(left), right.self());                  \
+  }
+
+MLLIB_EXPR_BINARY_OPERATOR(+, Add)
+MLLIB_EXPR_BINARY_OPERATOR(-, Subtract)
+MLLIB_EXPR_BINARY_OPERATOR(*, Multiply)
+MLLIB_EXPR_BINARY_OPERATOR(/, Divide)
+
+#undef MLLIB_EXPR_BINARY_OPERATOR
+
+template <typename A> Unary<Negate, A> operator-(const Expression<A>& a) {
+  return Unary<Negate, A>(a.self());
+}
+
+/**
+ * @brief Element-wise square
+ */
+template <typename A> Unary<Square, A> square(const Expression<A>& a) {
+  return Unary<Square, A>(a.self());
+}
+
+namespace detail {
+
+// Elements evaluated per block; a block fits in L1 next to its inputs
+constexpr size_t BLOCK_SIZE = 256;
+// Elements per task below which extra threads are not worth it
+constexpr size_t MIN_ELEMENTS_PER_TASK = 1 << 15;
+// Fixed summation chunk, so totals do not depend on the thread count
+constexpr size_t SUM_CHUNK = 1 << 16;
+// Independent accumulators per chunk
+constexpr size_t LANES = 8;
+
+/**
+ * @brief Evaluate [begin, end) of an expression into out
+ * @details Each block is computed into a local buffer and then copied, so
+ * the inner loop has no aliasing with out and vectorizes even when the
+ * expression reads out itself.
+ */
+template <typename E>
+void evaluateRange(const E& e, double* out, size_t begin, size_t end) {
+  double block[BLOCK_SIZE];
+  for (size_t start = begin; start < end; start += BLOCK_SIZE) {
+    const size_t n = std::min(BLOCK_SIZE, end - start);
+    for (size_t i = 0; i < n; ++i) {
+      block[i] = e[start + i];
+    }
+    std::copy(block, block + n, out + start);
+  }
+}
+
+template <typename E> double sumRange(const E& e, size_t begin, size_t end) {
+  double lanes[LANES] = {};
+  size_t i = begin;
+  for (; i + LANES <= end; i += LANES) {
+    for (size_t l = 0; l < LANES; ++l) {
+      lanes[l] += e[i + l];
+    }
+  }
+  for (size_t l = 0; i < end; ++i, ++l) {
+    lanes[l] += e[i];
+  }
+  for (size_t width = LANES / 2; width > 0; width /= 2) {
+    for (size_t l = 0; l < width; ++l) {
+      lanes[l] += lanes[l + width];
+    }
+  }
+  return lanes[0];
+}
+
+}  // namespace detail
+
+/**
+ * @brief Evaluate an expression into raw storage of e.size() elements
+ */
+template <typename E>
+void evaluate(const Expression<E>& expression, double* out) {
+  const E& e = expression.self();
+  util::ThreadPool::global().parallel_for(
+      0, e.size(),
+      [&](size_t begin, size_t end) {
+        detail::evaluateRange(e, out, begin, end);
+      },
+      detail::MIN_ELEMENTS_PER_TASK);
+}
+
+/**
+ * @brief Sum of an expression without materializing it
+ */
+template <typename E> double sum(const Expression<E>& expression) {
+  const E& e = expression.self();
+  const size_t n = e.size();
+  const size_t chunks = (n + detail::SUM_CHUNK - 1) / detail::SUM_CHUNK;
+  std::vector<double> partial(chunks);
+  util::ThreadPool::global().parallel_for(
+      0, chunks, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+          const size_t first = c * detail::SUM_CHUNK;
+          const size_t last = std::min(n, first + detail::SUM_CHUNK);
+          partial[c] = detail::sumRange(e, first, last);
+        }
+      });
+  double total = 0.0;
+  for (double p : partial) {
+    total += p;
+  }
+  return total;
+}
+
+/**
+ * @brief Mean of an expression without materializing it
+ * @return 0.0 for an empty expression
+ */
+template <typename E> double mean(const Expression<E>& expression) {
+  const size_t n = expression.self().size();
+  return n == 0 ? 0.0 : sum(expression) / static_cast<double>(n);
+}
+
+}  // namespace expr
+
+template <typename E>
+NDArray::NDArray(const expr::Expression<E>& expression) {
+  assign(expression);
+}
+
+template <typename E>
+NDArray& NDArray::assign(const expr::Expression<E>& expression) {
+  const E& e = expression.self();
+  const std::vector<size_t>& shape = *e.shape_ptr();
+  if (e.size() != size_) {
+    // A different size means the expression cannot read this array
+    *this = NDArray(shape);
+  } else if (shape_ != shape) {
+    shape_ = shape;
+  }
+  expr::evaluate(expression, data());
+  return *this;
+}
+
+}  // namespace MLLib
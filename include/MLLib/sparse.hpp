@@ -0,0 +1,186 @@
+#pragma once
+
+#include "ndarray.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file sparse.hpp
+ * @brief Compressed sparse row and block sparse row matrices
+ */
+
+namespace MLLib {
+
+/**
+ * @class SparseMatrix
+ * @brief Two-dimensional matrix in compressed sparse row (CSR) form
+ * @details Row r holds the entries row_offsets()[r] to
+ * row_offsets()[r + 1] - 1 of col_indices() and values(), with columns
+ * sorted and unique within each row. Build one from coordinate (COO)
+ * triplets with from_coo() or from a mostly-zero dense array with
+ * from_dense(). Products with dense matrices cost O(nnz * n) instead of
+ * O(rows * cols * n).
+ */
+class SparseMatrix {
+public:
+  /**
+   * @brief Empty 0 x 0 matrix
+   */
+  SparseMatrix() = default;
+
+  /**
+   * @brief Construct from CSR arrays
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param row_offsets rows + 1 non-decreasing offsets starting at 0
+   * @param col_indices Column of each entry, sorted and unique per row
+   * @param values Value of each entry
+   * @throws std::invalid_argument if the arrays are not valid CSR
+   */
+  explicit SparseMatrix(size_t rows, size_t cols,
+                        std::vector<size_t> row_offsets,
+                        std::vector<size_t> col_indices,
+                        std::vector<double> values);
+
+  /**
+   * @brief Construct from coordinate (COO) triplets in any order
+   * @details Duplicate coordinates are summed.
+   * @throws std::invalid_argument if the triplet arrays differ in length or
+   * an index is out of range
+   */
+  static SparseMatrix from_coo(size_t rows, size_t cols,
+                               const std::vector<size_t>& row_indices,
+                               const std::vector<size_t>& col_indices,
+                               const std::vector<double>& values);
+
+  /**
+   * @brief Keep the entries of a 2-D array whose magnitude exceeds threshold
+   * @throws std::invalid_argument if dense is not 2-D
+   */
+  static SparseMatrix from_dense(const NDArray& dense, double threshold = 0.0);
+
+  size_t rows() const { return rows_; }
+  size_t cols() const { return cols_; }
+  size_t nnz() const { return values_.size(); }
+  std::vector<size_t> shape() const { return {rows_, cols_}; }
+
+  const std::vector<size_t>& row_offsets() const { return row_offsets_; }
+  const std::vector<size_t>& col_indices() const { return col_indices_; }
+  const std::vector<double>& values() const { return values_; }
+
+  /**
+   * @brief Dense copy of shape [rows, cols]
+   */
+  NDArray to_dense() const;
+
+  /**
+   * @brief Transposed matrix, also in CSR form
+   */
+  SparseMatrix transpose() const;
+
+  /**
+   * @brief Sparse x dense product
+   * @param dense Matrix [cols, n]
+   * @param result Output [rows, n]; storage of the right size is reused
+   * @throws std::invalid_argument if the inner dimensions differ
+   */
+  void matmul(const NDArray& dense, NDArray& result) const;
+
+  /**
+   * @brief Sparse x dense product returning a new [rows, n] array
+   */
+  NDArray matmul(const NDArray& dense) const;
+
+private:
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  std::vector<size_t> row_offsets_ = {0};
+  std::vector<size_t> col_indices_;
+  std::vector<double> values_;
+};
+
+/**
+ * @class BlockSparseMatrix
+ * @brief Matrix of dense blocks in block compressed sparse row (BSR) form
+ * @details The matrix is tiled into block_rows x block_cols blocks and only
+ * blocks holding a nonzero are stored, each row-major and zero padded at
+ * the edges. Block row r owns blocks block_row_offsets()[r] to
+ * block_row_offsets()[r + 1] - 1. Products visit only stored blocks, so
+ * their cost falls with the fraction of blocks pruned away, while the
+ * dense blocks keep the inner loops contiguous.
+ */
+class BlockSparseMatrix {
+public:
+  /**
+   * @brief Empty 0 x 0 matrix
+   */
+  BlockSparseMatrix() = default;
+
+  /**
+   * @brief Construct from BSR arrays
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param block_rows Rows per block
+   * @param block_cols Columns per block
+   * @param block_row_offsets One offset per block row plus one
+   * @param block_col_indices Block column of each stored block, sorted and
+   * unique per block row
+   * @param values block_rows * block_cols values per stored block
+   * @throws std::invalid_argument if the arrays are not valid BSR
+   */
+  explicit BlockSparseMatrix(size_t rows, size_t cols, size_t block_rows,
+                             size_t block_cols,
+                             std::vector<size_t> block_row_offsets,
+                             std::vector<size_t> block_col_indices,
+                             std::vector<double> values);
+
+  /**
+   * @brief Keep the blocks of a 2-D array that contain a nonzero
+   * @throws std::invalid_argument if dense is not 2-D or a block size is 0
+   */
+  static BlockSparseMatrix from_dense(const NDArray& dense, size_t block_rows,
+                                      size_t block_cols);
+
+  size_t rows() const { return rows_; }
+  size_t cols() const { return cols_; }
+  size_t block_rows() const { return block_rows_; }
+  size_t block_cols() const { return block_cols_; }
+  size_t num_blocks() const { return block_col_indices_.size(); }
+
+  /**
+   * @brief Fraction of blocks that are stored
+   */
+  double density() const;
+
+  const std::vector<size_t>& block_row_offsets() const {
+    return block_row_offsets_;
+  }
+  const std::vector<size_t>& block_col_indices() const {
+    return block_col_indices_;
+  }
+  const std::vector<double>& values() const { return values_; }
+
+  /**
+   * @brief Dense copy of shape [rows, cols]
+   */
+  NDArray to_dense() const;
+
+  /**
+   * @brief Dense x block-sparse product, output = input * this
+   * @param input Matrix [n, rows]
+   * @param output Output [n, cols]; storage of the right size is reused
+   * @throws std::invalid_argument if the inner dimensions differ
+   */
+  void left_multiply(const NDArray& input, NDArray& output) const;
+
+private:
+  size_t rows_ = 0;
+  size_t cols_ = 0;
+  size_t block_rows_ = 1;
+  size_t block_cols_ = 1;
+  std::vector<size_t> block_row_offsets_ = {0};
+  std::vector<size_t> block_col_indices_;
+  std::vector<double> values_;
+};
+
+}  // namespace MLLib
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @file random.hpp
+ * @brief Counter-based random number generation
+ *
+ * Values come from Philox4x32-10, a generator that maps (key, counter) to
+ * random bits with no hidden state. A RandomStream is a key plus a position:
+ * element i of a draw depends only on the stream and its absolute position,
+ * so large fills can be split across threads and still produce the same
+ * values bit for bit, whatever the thread count.
+ *
+ * Streams are derived from one global seed. Components that need their own
+ * randomness (layer initialization, noise, sampling) take the next stream
+ * id, so a fixed seed reproduces a whole run.
+ */
+
+namespace MLLib {
+namespace util {
+
+/**
+ * @struct Philox4x32
+ * @brief Philox4x32-10 block function
+ */
+struct Philox4x32 {
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  /**
+   * @brief Map a counter to 128 random bits
+   * @param counter Block counter
+   * @param key Stream key
+   * @return Random block
+   */
+  static Counter apply(Counter counter, Key key);
+};
+
+/**
+ * @class RandomStream
+ * @brief Independent, seekable stream of random variates
+ * @details Each element position yields one variate. Batch fills of at least
+ * RANDOM_PARALLEL_MIN elements run on the global thread pool. The stream also
+ * satisfies UniformRandomBitGenerator, e.g. for std::shuffle.
+ */
+class RandomStream {
+public:
+  using result_type = uint64_t;
+
+  /**
+   * @brief Create a stream
+   * @param seed Global seed
+   * @param stream_id Stream within the seed; different ids are independent
+   */
+  explicit RandomStream(uint64_t seed = 0, uint64_t stream_id = 0);
+
+  /**
+   * @brief Fill with values uniform in [low, high)
+   */
+  void uniform(double* out, size_t count, double low = 0.0,
+               double high = 1.0);
+
+  /**
+   * @brief Fill with normally distributed values
+   */
+  void normal(double* out, size_t count, double mean = 0.0,
+              double stddev = 1.0);
+
+  /**
+   * @brief Fill with 1.0 with probability p, 0.0 otherwise
+   */
+  void bernoulli(double* out, size_t count, double p);
+
+  /**
+   * @brief Write in + N(0, stddev^2) to out
+   * @details The corrupting fills draw and apply the noise in one pass
+   * over the data; in and out may be the same buffer.
+   */
+  void add_normal(const double* in, double* out, size_t count, double stddev);
+
+  /**
+   * @brief Write in + U[low, high) to out
+   */
+  void add_uniform(const double* in, double* out, size_t count, double low,
+                   double high);
+
+  /**
+   * @brief Copy in to out, zeroing each value with probability rate
+   */
+  void dropout(const double* in, double* out, size_t count, double rate);
+
+  /**
+   * @brief Copy in to out, replacing a fraction of the values by 0 or 1
+   * with equal odds
+   */
+  void salt_pepper(const double* in, double* out, size_t count,
+                   double fraction);
+
+  /**
+   * @brief Draw one value uniform in [0, 1)
+   */
+  double uniform();
+
+  /**
+   * @brief Draw one standard normal value
+   */
+  double normal();
+
+  /**
+   * @brief Draw 64 random bits
+   */
+  result_type operator()();
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**
+   * @brief Get the position of the next element
+   */
+  uint64_t position() const { return position_; }
+
+  /**
+   * @brief Move to an absolute element position
+   */
+  void seek(uint64_t position) { position_ = position; }
+
+  /**
+   * @brief Derive an independent child stream
+   * @param id Child identifier
+   * @return Stream keyed by this stream's key and id
+   */
+  RandomStream split(uint64_t id) const;
+
+private:
+  Philox4x32::Key key_;
+  uint64_t position_;
+};
+
+/**
+ * @brief Batch fills smaller than this stay on the calling thread
+ */
+constexpr size_t RANDOM_PARALLEL_MIN = 1 << 16;
+
+/**
+ * @class Random
+ * @brief Process-wide seed and stream allocation
+ * @details Unless seed() is called, the seed comes from the MLLIB_SEED
+ * environment variable, or from std::random_device when it is unset.
+ */
+class Random {
+public:
+  /**
+   * @brief Set the global seed and restart stream allocation
+   */
+  static void seed(uint64_t seed);
+
+  /**
+   * @brief Get the global seed
+   */
+  static uint64_t get_seed();
+
+  /**
+   * @brief Get a stream by fixed id under the global seed
+   */
+  static RandomStream stream(uint64_t stream_id);
+
+  /**
+   * @brief Get the next unused stream under the global seed
+   * @details Ids are handed out in call order, so runs that create
+   * components in the same order see the same values.
+   */
+  static RandomStream next_stream();
+};
+
+}  // namespace util
+}  // namespace MLLib
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../../ndarray.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file stats.hpp
+ * @brief Batched reconstruction and image-quality metrics
+ *
+ * Every metric compares two arrays of the same shape whose leading axis is
+ * the sample axis and returns one value per sample. Samples are processed
+ * in parallel on the global thread pool, so whole validation sets are
+ * evaluated in one call.
+ *
+ * SSIM treats samples as [H, W, C] images: [N, H, W, C] and [N, H, W]
+ * (one channel) arrays are used as is, and [N, D] arrays are read as 1 x D
+ * single-channel images.
+ */
+
+namespace MLLib {
+namespace util {
+
+/**
+ * @brief Mean squared error per sample
+ * @param a Reference, leading axis is the sample axis
+ * @param b Estimate, same shape as a
+ * @return One value per sample
+ * @throws std::invalid_argument if the shapes differ
+ */
+std::vector<double> mse(const NDArray& a, const NDArray& b);
+
+/**
+ * @brief Mean absolute error per sample
+ */
+std::vector<double> mae(const NDArray& a, const NDArray& b);
+
+/**
+ * @brief Root mean squared error per sample
+ */
+std::vector<double> rmse(const NDArray& a, const NDArray& b);
+
+/**
+ * @brief Peak signal-to-noise ratio per sample, in dB
+ * @param a Reference
+ * @param b Estimate
+ * @param data_range Difference between the largest and smallest possible
+ * value, 1.0 for images in [0, 1]
+ * @return One value per sample, infinity for identical samples
+ */
+std::vector<double> psnr(const NDArray& a, const NDArray& b,
+                         double data_range = 1.0);
+
+/**
+ * @struct SSIMOptions
+ * @brief Parameters of windowed SSIM (Wang et al. 2004)
+ */
+struct SSIMOptions {
+  size_t window = 11;       ///< Gaussian window size, odd
+  double sigma = 1.5;       ///< Gaussian standard deviation
+  double data_range = 1.0;  ///< Value range of the images
+  double k1 = 0.01;         ///< Luminance stabilizer
+  double k2 = 0.03;         ///< Contrast stabilizer
+};
+
+/**
+ * @brief Mean structural similarity per sample
+ * @details Local statistics come from a separable Gaussian filter over the
+ * valid region of each channel; the window shrinks to fit images smaller
+ * than it. Channels are averaged.
+ * @param a Reference images
+ * @param b Estimated images, same shape as a
+ * @param options Window and stabilizer settings
+ * @return One value per sample in [-1, 1]
+ * @throws std::invalid_argument if the shapes differ or the window is even
+ */
+std::vector<double> ssim(const NDArray& a, const NDArray& b,
+                         const SSIMOptions& options = SSIMOptions());
+
+/**
+ * @brief Arithmetic mean of per-sample values
+ * @return 0.0 for an empty vector
+ */
+double mean(const std::vector<double>& values);
+
+}  // namespace util
+}  // namespace MLLib
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file memory.hpp
+ * @brief NUMA-aware array storage helpers
+ *
+ * Linux places a page on the NUMA node of the thread that first writes it.
+ * These helpers allocate without touching and then perform the first write
+ * from the CPU node selected with Device::setCPUNode(), so large arrays end
+ * up local to the socket that computes on them.
+ */
+
+namespace MLLib {
+namespace util {
+
+/**
+ * @brief Arrays smaller than this are touched on the calling thread
+ */
+constexpr size_t FIRST_TOUCH_MIN_BYTES = 256 * 1024;
+
+/**
+ * @brief Allocate storage for doubles without initializing it
+ * @param count Number of elements
+ * @return Owning pointer, nullptr when count is zero
+ */
+std::unique_ptr<double[]> allocate_uninitialized(size_t count);
+
+/**
+ * @brief Fill storage, first touching it from the selected CPU node
+ * @param data Destination
+ * @param count Number of elements
+ * @param value Fill value
+ */
+void first_touch_fill(double* data, size_t count, double value);
+
+/**
+ * @brief Copy into storage, first touching it from the selected CPU node
+ * @param src Source
+ * @param count Number of elements
+ * @param dst Destination
+ */
+void first_touch_copy(const double* src, size_t count, double* dst);
+
+}  // namespace util
+}  // namespace MLLib
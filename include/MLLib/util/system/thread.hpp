@@ -0,0 +1,112 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file thread.hpp
+ * @brief Worker thread pool and CPU affinity helpers
+ */
+
+namespace MLLib {
+namespace util {
+
+/**
+ * @brief Pin the calling thread to a set of logical CPUs
+ * @param cpus Logical CPU indices; CPUs that are not online are ignored
+ * @return true if the affinity was applied (always false off Linux)
+ */
+bool pin_current_thread(const std::vector<int>& cpus);
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of worker threads with a FIFO task queue
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief Start worker threads
+   * @param num_threads Number of workers (at least one is started)
+   * @param on_thread_start Optional hook run on each worker before it takes
+   * tasks, e.g. to pin it to a NUMA node
+   */
+  explicit ThreadPool(size_t num_threads,
+                      std::function<void()> on_thread_start = nullptr);
+
+  /**
+   * @brief Finish queued tasks and join all workers
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Queue a task
+   * @param task Callable taking no arguments
+   * @return Future holding the task's result or exception
+   */
+  template <typename F>
+  auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+    enqueue([packaged]() { (*packaged)(); });
+    return future;
+  }
+
+  /**
+   * @brief Run body over [begin, end) split into contiguous chunks
+   * @param begin First index
+   * @param end One past the last index
+   * @param body Called as body(chunk_begin, chunk_end)
+   * @param min_chunk Smallest chunk worth handing to another thread
+   * @details Blocks until every chunk is done. The caller runs one chunk
+   * itself; calls made from this pool's own workers run inline so nested
+   * parallel loops cannot deadlock. The first exception thrown by a chunk is
+   * rethrown.
+   */
+  void parallel_for(size_t begin, size_t end,
+                    const std::function<void(size_t, size_t)>& body,
+                    size_t min_chunk = 1);
+
+  /**
+   * @brief Get number of worker threads
+   * @return Worker count
+   */
+  size_t size() const { return workers_.size(); }
+
+  /**
+   * @brief Check whether the calling thread is one of this pool's workers
+   * @return true on a worker thread
+   */
+  bool is_worker_thread() const;
+
+  /**
+   * @brief Shared unpinned pool sized to the hardware concurrency
+   * @return Process-wide pool
+   */
+  static ThreadPool& global();
+
+private:
+  void enqueue(std::function<void()> task);
+  void worker_loop(const std::function<void()>& on_thread_start);
+
+  std::vector<std::thread> workers_;          ///< Worker threads
+  std::queue<std::function<void()>> tasks_;  ///< Pending tasks
+  std::mutex mutex_;                          ///< Guards tasks_ and stop_
+  std::condition_variable condition_;         ///< Signals new tasks/stop
+  bool stop_;                                 ///< Set on destruction
+};
+
+}  // namespace util
+}  // namespace MLLib
@@ -1,6 +1,8 @@
 #include "../../../include/MLLib/backend/backend.hpp"
+#include "../../../include/MLLib/backend/placement.hpp"
 #include "../../../include/MLLib/device/device.hpp"
 #include "backend_internal.hpp"
+#include <atomic>
 #include <cstdio>
 #include <stdexcept>
 #include <vector>
@@ -55,18 +57,8 @@ static bool isOneAPIAvailable() {
 static bool isMetalAvailable() {
 #if defined(WITH_METAL) && !defined(CI)
 #ifdef __APPLE__
-  // Check if Apple GPU is actually detected
-  if (!Device::isGPUAvailable()) {
-    return false;
-  }
-
-  auto gpus = Device::detectGPUs();
-  for (const auto& gpu : gpus) {
-    if (gpu.vendor == GPUVendor::APPLE) {
-      return true;
-    }
-  }
-  return false;
+  // Check if Apple GPU is actually detected (cached after first discovery)
+  return Device::isGPUVendorAvailable(GPUVendor::APPLE);
 #else
   return false;
 #endif
@@ -77,103 +69,189 @@ static bool isMetalAvailable() {
 
 static bool isCUDAAvailable() {
 #ifdef WITH_CUDA
-  // Check if actual CUDA hardware and drivers are available
-  if (!Device::isGPUAvailable()) {
-    return false;
-  }
-
-  // Check if any NVIDIA GPU is detected
-  auto gpus = Device::detectGPUs();
-  for (const auto& gpu : gpus) {
-    if (gpu.vendor == GPUVendor::NVIDIA) {
-      return true;
-    }
-  }
-  return false;
+  // Check if any NVIDIA GPU is detected (cached after first discovery)
+  return Device::isGPUVendorAvailable(GPUVendor::NVIDIA);
 #else
   return false;
 #endif
 }
 
+namespace {
+
+// Active table; swapped only when the device changes
+std::atomic<const BackendOps*> active_ops{nullptr};
+
+void onDeviceChanged(DeviceType) {
+  Backend::refreshDispatch();
+}
+
+// Keep the table in step with Device::setDevice()
+const bool dispatch_listener_registered = []() {
+  Device::addDeviceChangeListener(&onDeviceChanged);
+  return true;
+}();
+
+/**
+ * @brief Where an operand currently lives, for transfer costing
+ */
+DeviceType locationOf(const NDArray& array) {
+  return array.residency() == Residency::DEVICE ? DeviceType::GPU
+                                                : DeviceType::CPU;
+}
+
+const BackendOps& placeElementwise(const NDArray& a) {
+  return Backend::getOps(PlacementScheduler::global().place(
+      OpDescriptor::elementwise(a.size()), locationOf(a)));
+}
+
+// DeviceType::AUTO entry points: place each call with the cost model
+void autoMatmul(const NDArray& a, const NDArray& b, NDArray& result) {
+  OpDescriptor op;
+  if (a.shape().size() == 2 && b.shape().size() == 2) {
+    op = OpDescriptor::gemm(a.shape()[0], a.shape()[1], b.shape()[1]);
+  }
+  Backend::getOps(PlacementScheduler::global().place(op, locationOf(a)))
+      .matmul(a, b, result);
+}
+
+void autoAdd(const NDArray& a, const NDArray& b, NDArray& result) {
+  placeElementwise(a).add(a, b, result);
+}
+
+void autoSubtract(const NDArray& a, const NDArray& b, NDArray& result) {
+  placeElementwise(a).subtract(a, b, result);
+}
+
+void autoMultiply(const NDArray& a, const NDArray& b, NDArray& result) {
+  placeElementwise(a).multiply(a, b, result);
+}
+
+void autoAddScalar(const NDArray& a, double scalar, NDArray& result) {
+  placeElementwise(a).add_scalar(a, scalar, result);
+}
+
+void autoMultiplyScalar(const NDArray& a, double scalar, NDArray& result) {
+  placeElementwise(a).multiply_scalar(a, scalar, result);
+}
+
+void autoFill(NDArray& array, double value) {
+  placeElementwise(array).fill(array, value);
+}
+
+void autoCopy(const NDArray& src, NDArray& dst) {
+  placeElementwise(src).copy(src, dst);
+}
+
+void autoAxpy(double alpha, const NDArray& x, NDArray& y) {
+  placeElementwise(y).axpy(alpha, x, y);
+}
+
+void autoAxpby(double alpha, const NDArray& x, double beta, NDArray& y) {
+  placeElementwise(y).axpby(alpha, x, beta, y);
+}
+
+void autoMultiplyAdd(const NDArray& a, const NDArray& b, NDArray& y) {
+  placeElementwise(y).multiply_add(a, b, y);
+}
+
+}  // namespace
+
+const BackendOps& Backend::getOps(DeviceType device) {
+  using Binary = GPUFallback<const NDArray&, const NDArray&, NDArray&>;
+  using Scalar = GPUFallback<const NDArray&, double, NDArray&>;
+  using Fill = GPUFallback<NDArray&, double>;
+  using Copy = GPUFallback<const NDArray&, NDArray&>;
+  using Axpy = GPUFallback<double, const NDArray&, NDArray&>;
+  using Axpby = GPUFallback<double, const NDArray&, double, NDArray&>;
+
+  static const BackendOps cpu_ops = {
+      &cpu_matmul,     &cpu_add,          &cpu_subtract, &cpu_multiply,
+      &cpu_add_scalar, &cpu_multiply_scalar, &cpu_fill,  &cpu_copy,
+      &cpu_axpy,       &cpu_axpby,          &cpu_multiply_add};
+
+  static const BackendOps gpu_ops = {
+      &Binary::run<&gpu_matmul, &cpu_matmul>,
+      &Binary::run<&gpu_add, &cpu_add>,
+      &Binary::run<&gpu_subtract, &cpu_subtract>,
+      &Binary::run<&gpu_multiply, &cpu_multiply>,
+      &Scalar::run<&gpu_add_scalar, &cpu_add_scalar>,
+      &Scalar::run<&gpu_multiply_scalar, &cpu_multiply_scalar>,
+      &Fill::run<&gpu_fill, &cpu_fill>,
+      &Copy::run<&gpu_copy, &cpu_copy>,
+      &Axpy::run<&gpu_axpy, &cpu_axpy>,
+      &Axpby::run<&gpu_axpby, &cpu_axpby>,
+      &Binary::run<&gpu_multiply_add, &cpu_multiply_add>};
+
+  static const BackendOps auto_ops = {
+      &autoMatmul,    &autoAdd,           &autoSubtract, &autoMultiply,
+      &autoAddScalar, &autoMultiplyScalar, &autoFill,    &autoCopy,
+      &autoAxpy,      &autoAxpby,          &autoMultiplyAdd};
+
+  switch (device) {
+  case DeviceType::GPU: return gpu_ops;
+  case DeviceType::AUTO: return auto_ops;
+  default: return cpu_ops;
+  }
+}
+
+const BackendOps& Backend::getOps() {
+  const BackendOps* ops = active_ops.load(std::memory_order_acquire);
+  if (ops == nullptr) {
+    // Used before static initialization of this file finished
+    refreshDispatch();
+    ops = active_ops.load(std::memory_order_acquire);
+  }
+  return *ops;
+}
+
+void Backend::refreshDispatch() {
+  active_ops.store(&getOps(Device::getCurrentDevice()),
+                   std::memory_order_release);
+}
+
 void Backend::matmul(const NDArray& a, const NDArray& b, NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_matmul(a, b, result);
-      },
-      [&]() {
-        gpu_matmul(a, b, result);
-      });
+  getOps().matmul(a, b, result);
 }
 
 void Backend::add(const NDArray& a, const NDArray& b, NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_add(a, b, result);
-      },
-      [&]() {
-        gpu_add(a, b, result);
-      });
+  getOps().add(a, b, result);
 }
 
 void Backend::subtract(const NDArray& a, const NDArray& b, NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_subtract(a, b, result);
-      },
-      [&]() {
-        gpu_subtract(a, b, result);
-      });
+  getOps().subtract(a, b, result);
 }
 
 void Backend::multiply(const NDArray& a, const NDArray& b, NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_multiply(a, b, result);
-      },
-      [&]() {
-        gpu_multiply(a, b, result);
-      });
+  getOps().multiply(a, b, result);
 }
 
 void Backend::add_scalar(const NDArray& a, double scalar, NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_add_scalar(a, scalar, result);
-      },
-      [&]() {
-        gpu_add_scalar(a, scalar, result);
-      });
+  getOps().add_scalar(a, scalar, result);
 }
 
 void Backend::multiply_scalar(const NDArray& a, double scalar,
                               NDArray& result) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_multiply_scalar(a, scalar, result);
-      },
-      [&]() {
-        gpu_multiply_scalar(a, scalar, result);
-      });
+  getOps().multiply_scalar(a, scalar, result);
 }
 
 void Backend::fill(NDArray& array, double value) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_fill(array, value);
-      },
-      [&]() {
-        gpu_fill(array, value);
-      });
+  getOps().fill(array, value);
 }
 
 void Backend::copy(const NDArray& src, NDArray& dst) {
-  dispatch_backend_operation(
-      [&]() {
-        cpu_copy(src, dst);
-      },
-      [&]() {
-        gpu_copy(src, dst);
-      });
+  getOps().copy(src, dst);
+}
+
+void Backend::axpy(double alpha, const NDArray& x, NDArray& y) {
+  getOps().axpy(alpha, x, y);
+}
+
+void Backend::axpby(double alpha, const NDArray& x, double beta, NDArray& y) {
+  getOps().axpby(alpha, x, beta, y);
+}
+
+void Backend::multiply_add(const NDArray& a, const NDArray& b, NDArray& y) {
+  getOps().multiply_add(a, b, y);
 }
 
 GPUBackendType Backend::getCurrentGPUBackend() {
@@ -6,34 +6,49 @@
  */
 
 #include "../../../include/MLLib/backend/backend.hpp"
-#include <functional>
 #include <stdexcept>
+#include <vector>
 
 namespace MLLib {
 namespace Backend {
 
 /**
- * @brief Helper function to dispatch operations to appropriate backend with
- * error handling
- * @param cpu_func Function to execute on CPU backend
- * @param gpu_func Function to execute on GPU backend
+ * @brief Bind a GPU implementation with CPU fallback into one function
+ * @details GPUFallback<Args...>::run<gpu, cpu> is a plain function with the
+ * signature void(Args...), so it can be stored in a BackendOps table. If
+ * the GPU implementation throws, the CPU implementation runs instead; CPU
+ * errors propagate to the caller.
  */
-template <typename CpuFunc, typename GpuFunc>
-void dispatch_backend_operation(CpuFunc&& cpu_func, GpuFunc&& gpu_func) {
-  try {
-    switch (Device::getCurrentDevice()) {
-    case DeviceType::CPU: cpu_func(); break;
-    case DeviceType::GPU: gpu_func(); break;
-    default: cpu_func(); break;
-    }
-  } catch (const std::exception& e) {
-    // If GPU operation fails, fallback to CPU
-    if (Device::getCurrentDevice() == DeviceType::GPU) {
-      cpu_func();
-    } else {
-      throw;  // Re-throw if CPU operation fails
+template <typename... Args>
+struct GPUFallback {
+  template <void (*GpuFunc)(Args...), void (*CpuFunc)(Args...)>
+  static void run(Args... args) {
+    try {
+      GpuFunc(args...);
+    } catch (const std::exception&) {
+      CpuFunc(args...);
     }
   }
+};
+
+/**
+ * @brief Give an output array the requested shape
+ * @details Storage of the right element count is reshaped in place, so
+ * callers that pass the same buffer every step never reallocate.
+ */
+inline void prepare_output(NDArray& result, const std::vector<size_t>& shape) {
+  if (result.shape() == shape) {
+    return;
+  }
+  size_t size = 1;
+  for (size_t dim : shape) {
+    size *= dim;
+  }
+  if (result.size() == size) {
+    result.reshape(shape);
+  } else {
+    result = NDArray(shape);
+  }
 }
 
 }  // namespace Backend
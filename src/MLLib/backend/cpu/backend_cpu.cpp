@@ -1,5 +1,6 @@
 #include "../../../../include/MLLib/backend/backend.hpp"
 #include "../../../../include/MLLib/ndarray.hpp"
+#include "../backend_internal.hpp"
 #include <stdexcept>
 
 namespace MLLib {
@@ -20,10 +21,7 @@ void Backend::cpu_matmul(const NDArray& a, const NDArray& b, NDArray& result) {
   }
 
   // Ensure result has correct shape
-  if (result.shape().size() != 2 || result.shape()[0] != m ||
-      result.shape()[1] != n) {
-    result = NDArray({m, n});
-  }
+  prepare_output(result, {m, n});
 
   const double* a_data = a.data();
   const double* b_data = b.data();
@@ -46,9 +44,7 @@ void Backend::cpu_add(const NDArray& a, const NDArray& b, NDArray& result) {
     throw std::invalid_argument("Shapes must match for addition");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
-  }
+  prepare_output(result, a.shape());
 
   const double* a_data = a.data();
   const double* b_data = b.data();
@@ -66,9 +62,7 @@ void Backend::cpu_subtract(const NDArray& a, const NDArray& b,
     throw std::invalid_argument("Shapes must match for subtraction");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
-  }
+  prepare_output(result, a.shape());
 
   const double* a_data = a.data();
   const double* b_data = b.data();
@@ -86,9 +80,7 @@ void Backend::cpu_multiply(const NDArray& a, const NDArray& b,
     throw std::invalid_argument("Shapes must match for multiplication");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
-  }
+  prepare_output(result, a.shape());
 
   const double* a_data = a.data();
   const double* b_data = b.data();
@@ -101,9 +93,7 @@ void Backend::cpu_multiply(const NDArray& a, const NDArray& b,
 
 // CPU scalar addition
 void Backend::cpu_add_scalar(const NDArray& a, double scalar, NDArray& result) {
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
-  }
+  prepare_output(result, a.shape());
 
   const double* a_data = a.data();
   double* result_data = result.data();
@@ -116,9 +106,7 @@ void Backend::cpu_add_scalar(const NDArray& a, double scalar, NDArray& result) {
 // CPU scalar multiplication
 void Backend::cpu_multiply_scalar(const NDArray& a, double scalar,
                                   NDArray& result) {
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
-  }
+  prepare_output(result, a.shape());
 
   const double* a_data = a.data();
   double* result_data = result.data();
@@ -138,9 +126,7 @@ void Backend::cpu_fill(NDArray& array, double value) {
 
 // CPU copy array
 void Backend::cpu_copy(const NDArray& src, NDArray& dst) {
-  if (dst.shape() != src.shape()) {
-    dst = NDArray(src.shape());
-  }
+  prepare_output(dst, src.shape());
 
   const double* src_data = src.data();
   double* dst_data = dst.data();
@@ -150,5 +136,50 @@ void Backend::cpu_copy(const NDArray& src, NDArray& dst) {
   }
 }
 
+// CPU y += alpha * x
+void Backend::cpu_axpy(double alpha, const NDArray& x, NDArray& y) {
+  if (x.shape() != y.shape()) {
+    throw std::invalid_argument("Shapes must match for axpy");
+  }
+
+  const double* x_data = x.data();
+  double* y_data = y.data();
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    y_data[i] += alpha * x_data[i];
+  }
+}
+
+// CPU y = alpha * x + beta * y
+void Backend::cpu_axpby(double alpha, const NDArray& x, double beta,
+                        NDArray& y) {
+  if (x.shape() != y.shape()) {
+    throw std::invalid_argument("Shapes must match for axpby");
+  }
+
+  const double* x_data = x.data();
+  double* y_data = y.data();
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    y_data[i] = alpha * x_data[i] + beta * y_data[i];
+  }
+}
+
+// CPU y += a * b
+void Backend::cpu_multiply_add(const NDArray& a, const NDArray& b,
+                               NDArray& y) {
+  if (a.shape() != b.shape() || a.shape() != y.shape()) {
+    throw std::invalid_argument("Shapes must match for multiply_add");
+  }
+
+  const double* a_data = a.data();
+  const double* b_data = b.data();
+  double* y_data = y.data();
+
+  for (size_t i = 0; i < a.size(); ++i) {
+    y_data[i] += a_data[i] * b_data[i];
+  }
+}
+
 }  // namespace Backend
 }  // namespace MLLib
@@ -0,0 +1,546 @@
+#include "../../../../include/MLLib/backend/expression_kernel.hpp"
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace MLLib {
+namespace Backend {
+
+namespace {
+
+// Blocks per parallel_for chunk; smaller arrays stay on the calling thread
+constexpr size_t MIN_BLOCKS_PER_TASK = 16;
+
+template <typename F>
+void apply_unary(double* x, size_t n, F f) {
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = f(x[i]);
+  }
+}
+
+template <typename F>
+void apply_binary(double* a, const double* b, size_t n, F f) {
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = f(a[i], b[i]);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Recursive-descent parser emitting stack machine code
+ *
+ * Operators whose operands are all constants are folded while parsing, so
+ * e.g. "1.0f / (1.0f + exp(-input))" keeps only the work that depends on
+ * the input.
+ */
+class ExpressionKernel::Parser {
+public:
+  Parser(const std::string& source, const std::vector<std::string>& variables,
+         const std::vector<std::string>& parameters)
+      : source_(source), variables_(variables), parameters_(parameters),
+        pos_(0), depth_(0), max_depth_(0) {}
+
+  void parse() {
+    parse_ternary();
+    skip_space();
+    if (pos_ != source_.size()) {
+      fail("unexpected '" + std::string(1, source_[pos_]) + "'");
+    }
+  }
+
+  std::vector<Instruction> code;
+
+  size_t max_depth() const { return max_depth_; }
+
+private:
+  void parse_ternary() {
+    parse_or();
+    if (accept("?")) {
+      parse_ternary();
+      expect(":");
+      parse_ternary();
+      emit(OpCode::SELECT, 3);
+    }
+  }
+
+  void parse_or() {
+    parse_and();
+    while (accept("||")) {
+      parse_and();
+      emit(OpCode::OR, 2);
+    }
+  }
+
+  void parse_and() {
+    parse_equality();
+    while (accept("&&")) {
+      parse_equality();
+      emit(OpCode::AND, 2);
+    }
+  }
+
+  void parse_equality() {
+    parse_relational();
+    while (true) {
+      if (accept("==")) {
+        parse_relational();
+        emit(OpCode::EQ, 2);
+      } else if (accept("!=")) {
+        parse_relational();
+        emit(OpCode::NE, 2);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void parse_relational() {
+    parse_additive();
+    while (true) {
+      OpCode op;
+      if (accept("<=")) {
+        op = OpCode::LE;
+      } else if (accept(">=")) {
+        op = OpCode::GE;
+      } else if (accept("<")) {
+        op = OpCode::LT;
+      } else if (accept(">")) {
+        op = OpCode::GT;
+      } else {
+        return;
+      }
+      parse_additive();
+      emit(op, 2);
+    }
+  }
+
+  void parse_additive() {
+    parse_multiplicative();
+    while (true) {
+      if (accept("+")) {
+        parse_multiplicative();
+        emit(OpCode::ADD, 2);
+      } else if (accept("-")) {
+        parse_multiplicative();
+        emit(OpCode::SUB, 2);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void parse_multiplicative() {
+    parse_unary();
+    while (true) {
+      if (accept("*")) {
+        parse_unary();
+        emit(OpCode::MUL, 2);
+      } else if (accept("/")) {
+        parse_unary();
+        emit(OpCode::DIV, 2);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void parse_unary() {
+    if (accept("-")) {
+      parse_unary();
+      emit(OpCode::NEG, 1);
+    } else if (accept("+")) {
+      parse_unary();
+    } else if (peek("!") && !peek("!=")) {
+      ++pos_;
+      parse_unary();
+      emit(OpCode::NOT, 1);
+    } else {
+      parse_primary();
+    }
+  }
+
+  void parse_primary() {
+    skip_space();
+    if (pos_ >= source_.size()) {
+      fail("unexpected end of expression");
+    }
+
+    char c = source_[pos_];
+    if (accept("(")) {
+      parse_ternary();
+      expect(")");
+      return;
+    }
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      parse_number();
+      return;
+    }
+    if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      std::string name = parse_identifier();
+      if (accept("(")) {
+        parse_call(name);
+      } else {
+        load_name(name);
+      }
+      return;
+    }
+    fail("unexpected '" + std::string(1, c) + "'");
+  }
+
+  void parse_number() {
+    const char* begin = source_.c_str() + pos_;
+    char* end = nullptr;
+    double value = std::strtod(begin, &end);
+    if (end == begin) {
+      fail("invalid number");
+    }
+    pos_ += static_cast<size_t>(end - begin);
+    if (pos_ < source_.size() && (source_[pos_] == 'f' || source_[pos_] == 'F')) {
+      ++pos_;
+    }
+    push({OpCode::CONST, 0, value});
+  }
+
+  std::string parse_identifier() {
+    size_t start = pos_;
+    while (pos_ < source_.size() &&
+           (std::isalnum(static_cast<unsigned char>(source_[pos_])) ||
+            source_[pos_] == '_')) {
+      ++pos_;
+    }
+    return source_.substr(start, pos_ - start);
+  }
+
+  void parse_call(const std::string& name) {
+    static const std::vector<std::pair<std::string, OpCode>> unary = {
+        {"exp", OpCode::EXP},     {"log", OpCode::LOG},
+        {"sqrt", OpCode::SQRT},   {"tanh", OpCode::TANH},
+        {"sin", OpCode::SIN},     {"cos", OpCode::COS},
+        {"abs", OpCode::ABS},     {"fabs", OpCode::ABS},
+        {"floor", OpCode::FLOOR}, {"ceil", OpCode::CEIL}};
+    static const std::vector<std::pair<std::string, OpCode>> binary = {
+        {"max", OpCode::MAX},  {"fmax", OpCode::MAX}, {"min", OpCode::MIN},
+        {"fmin", OpCode::MIN}, {"pow", OpCode::POW}};
+
+    for (const auto& entry : unary) {
+      if (entry.first == name) {
+        parse_ternary();
+        expect(")");
+        emit(entry.second, 1);
+        return;
+      }
+    }
+    for (const auto& entry : binary) {
+      if (entry.first == name) {
+        parse_ternary();
+        expect(",");
+        parse_ternary();
+        expect(")");
+        emit(entry.second, 2);
+        return;
+      }
+    }
+    fail("unknown function '" + name + "'");
+  }
+
+  void load_name(const std::string& name) {
+    for (size_t i = 0; i < variables_.size(); ++i) {
+      if (variables_[i] == name) {
+        push({OpCode::LOAD_VAR, i, 0.0});
+        return;
+      }
+    }
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+      if (parameters_[i] == name) {
+        push({OpCode::LOAD_PARAM, i, 0.0});
+        return;
+      }
+    }
+    fail("unknown name '" + name + "'");
+  }
+
+  void push(const Instruction& instruction) {
+    code.push_back(instruction);
+    max_depth_ = std::max(max_depth_, ++depth_);
+  }
+
+  /**
+   * @brief Emit an operator consuming operands stack entries
+   */
+  void emit(OpCode op, size_t operands) {
+    bool constant = code.size() >= operands;
+    for (size_t i = 0; constant && i < operands; ++i) {
+      constant = code[code.size() - 1 - i].op == OpCode::CONST;
+    }
+
+    code.push_back({op, 0, 0.0});
+    depth_ -= operands - 1;
+
+    if (constant) {
+      // Evaluate the tail on one element and keep only the result
+      std::vector<Instruction> tail(code.end() - (operands + 1), code.end());
+      std::vector<double> stack(operands * BLOCK_SIZE);
+      double value = 0.0;
+      run_block(tail, nullptr, &value, 1, nullptr, stack.data());
+      code.resize(code.size() - (operands + 1));
+      code.push_back({OpCode::CONST, 0, value});
+    }
+  }
+
+  bool peek(const char* token) {
+    skip_space();
+    return source_.compare(pos_, std::char_traits<char>::length(token),
+                           token) == 0;
+  }
+
+  bool accept(const char* token) {
+    if (peek(token)) {
+      pos_ += std::char_traits<char>::length(token);
+      return true;
+    }
+    return false;
+  }
+
+  void expect(const char* token) {
+    if (!accept(token)) {
+      fail(std::string("expected '") + token + "'");
+    }
+  }
+
+  void skip_space() {
+    while (pos_ < source_.size() &&
+           std::isspace(static_cast<unsigned char>(source_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& message) {
+    throw std::invalid_argument("Expression error at position " +
+                                std::to_string(pos_) + ": " + message +
+                                " in \"" + source_ + "\"");
+  }
+
+  const std::string& source_;
+  const std::vector<std::string>& variables_;
+  const std::vector<std::string>& parameters_;
+  size_t pos_;
+  size_t depth_;
+  size_t max_depth_;
+};
+
+ExpressionKernel::ExpressionKernel(const std::string& expression,
+                                   const std::vector<std::string>& variables,
+                                   const std::vector<std::string>& parameters)
+    : expression_(expression), variable_count_(variables.size()),
+      parameter_count_(parameters.size()), max_depth_(0) {
+  Parser parser(expression_, variables, parameters);
+  parser.parse();
+  code_ = std::move(parser.code);
+  max_depth_ = parser.max_depth();
+}
+
+void ExpressionKernel::execute(const std::vector<const double*>& inputs,
+                               double* output, size_t size,
+                               const std::vector<double>& params) const {
+  if (inputs.size() != variable_count_) {
+    throw std::invalid_argument("Expression kernel expects " +
+                                std::to_string(variable_count_) +
+                                " inputs, got " +
+                                std::to_string(inputs.size()));
+  }
+  if (params.size() != parameter_count_) {
+    throw std::invalid_argument("Expression kernel expects " +
+                                std::to_string(parameter_count_) +
+                                " parameters, got " +
+                                std::to_string(params.size()));
+  }
+  if (size == 0) {
+    return;
+  }
+
+  const size_t blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  auto body = [&](size_t first_block, size_t last_block) {
+    std::vector<double> stack(max_depth_ * BLOCK_SIZE);
+    std::vector<const double*> offsets(inputs.size());
+    for (size_t block = first_block; block < last_block; ++block) {
+      size_t start = block * BLOCK_SIZE;
+      size_t count = std::min(BLOCK_SIZE, size - start);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        offsets[i] = inputs[i] + start;
+      }
+      run_block(code_, offsets.data(), output + start, count, params.data(),
+                stack.data());
+    }
+  };
+
+  if (blocks < 2 * MIN_BLOCKS_PER_TASK) {
+    body(0, blocks);
+  } else {
+    util::ThreadPool::global().parallel_for(0, blocks, body,
+                                            MIN_BLOCKS_PER_TASK);
+  }
+}
+
+void ExpressionKernel::run_block(const std::vector<Instruction>& code,
+                                 const double* const* inputs, double* output,
+                                 size_t count, const double* params,
+                                 double* stack) {
+  // Slot s of the stack occupies stack[s * BLOCK_SIZE, (s + 1) * BLOCK_SIZE)
+  size_t top = 0;
+  auto slot = [stack](size_t s) { return stack + s * BLOCK_SIZE; };
+
+  for (const Instruction& in : code) {
+    switch (in.op) {
+    case OpCode::LOAD_VAR:
+      std::copy(inputs[in.index], inputs[in.index] + count, slot(top++));
+      break;
+    case OpCode::LOAD_PARAM:
+      std::fill(slot(top), slot(top) + count, params[in.index]);
+      ++top;
+      break;
+    case OpCode::CONST:
+      std::fill(slot(top), slot(top) + count, in.value);
+      ++top;
+      break;
+
+    case OpCode::NEG:
+      apply_unary(slot(top - 1), count, [](double x) { return -x; });
+      break;
+    case OpCode::NOT:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return x == 0.0 ? 1.0 : 0.0; });
+      break;
+    case OpCode::EXP:
+      apply_unary(slot(top - 1), count, [](double x) { return std::exp(x); });
+      break;
+    case OpCode::LOG:
+      apply_unary(slot(top - 1), count, [](double x) { return std::log(x); });
+      break;
+    case OpCode::SQRT:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return std::sqrt(x); });
+      break;
+    case OpCode::TANH:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return std::tanh(x); });
+      break;
+    case OpCode::SIN:
+      apply_unary(slot(top - 1), count, [](double x) { return std::sin(x); });
+      break;
+    case OpCode::COS:
+      apply_unary(slot(top - 1), count, [](double x) { return std::cos(x); });
+      break;
+    case OpCode::ABS:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return std::fabs(x); });
+      break;
+    case OpCode::FLOOR:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return std::floor(x); });
+      break;
+    case OpCode::CEIL:
+      apply_unary(slot(top - 1), count,
+                  [](double x) { return std::ceil(x); });
+      break;
+
+    case OpCode::ADD:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a + b; });
+      break;
+    case OpCode::SUB:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a - b; });
+      break;
+    case OpCode::MUL:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a * b; });
+      break;
+    case OpCode::DIV:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a / b; });
+      break;
+    case OpCode::MAX:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a < b ? b : a; });
+      break;
+    case OpCode::MIN:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return b < a ? b : a; });
+      break;
+    case OpCode::POW:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return std::pow(a, b); });
+      break;
+    case OpCode::LT:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a < b ? 1.0 : 0.0; });
+      break;
+    case OpCode::GT:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a > b ? 1.0 : 0.0; });
+      break;
+    case OpCode::LE:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a <= b ? 1.0 : 0.0; });
+      break;
+    case OpCode::GE:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a >= b ? 1.0 : 0.0; });
+      break;
+    case OpCode::EQ:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a == b ? 1.0 : 0.0; });
+      break;
+    case OpCode::NE:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count,
+                   [](double a, double b) { return a != b ? 1.0 : 0.0; });
+      break;
+    case OpCode::AND:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count, [](double a, double b) {
+        return a != 0.0 && b != 0.0 ? 1.0 : 0.0;
+      });
+      break;
+    case OpCode::OR:
+      --top;
+      apply_binary(slot(top - 1), slot(top), count, [](double a, double b) {
+        return a != 0.0 || b != 0.0 ? 1.0 : 0.0;
+      });
+      break;
+
+    case OpCode::SELECT: {
+      // Both branches are already evaluated; pick per element
+      top -= 2;
+      double* condition = slot(top - 1);
+      const double* if_true = slot(top);
+      const double* if_false = slot(top + 1);
+      for (size_t i = 0; i < count; ++i) {
+        condition[i] = condition[i] != 0.0 ? if_true[i] : if_false[i];
+      }
+      break;
+    }
+    }
+  }
+
+  std::copy(slot(0), slot(0) + count, output);
+}
+
+}  // namespace Backend
+}  // namespace MLLib
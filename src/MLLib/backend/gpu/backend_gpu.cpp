@@ -1,6 +1,8 @@
 #include "../../../../include/MLLib/backend/backend.hpp"
 #include "../../../../include/MLLib/ndarray.hpp"
+#include "../backend_internal.hpp"
 #include <cstdio>
+#include <mutex>
 #include <stdexcept>
 
 // Include all GPU backend headers
@@ -38,6 +40,38 @@
 namespace MLLib {
 namespace Backend {
 
+namespace {
+
+std::mutex device_memory_mutex;
+std::shared_ptr<DeviceMemoryBackend> device_memory;
+
+/**
+ * @brief Device buffer for an output; its host copy becomes stale
+ */
+DeviceBuffer& device_output(NDArray& array, const std::vector<size_t>& shape,
+                            DeviceMemoryBackend& memory) {
+  prepare_output(array, shape);
+  DeviceBuffer* buffer = array.device_buffer();
+  if (!buffer || buffer->owner() != &memory || buffer->size() < array.size()) {
+    array.set_device_state(memory.allocate(array.size()), Residency::HOST);
+    buffer = array.device_buffer();
+  }
+  return *buffer;
+}
+
+}  // namespace
+
+void Backend::setDeviceMemoryBackend(
+    std::shared_ptr<DeviceMemoryBackend> memory) {
+  std::lock_guard<std::mutex> lock(device_memory_mutex);
+  device_memory = std::move(memory);
+}
+
+std::shared_ptr<DeviceMemoryBackend> Backend::getDeviceMemoryBackend() {
+  std::lock_guard<std::mutex> lock(device_memory_mutex);
+  return device_memory;
+}
+
 // Helper function to check CUDA availability and handle fallback
 bool use_cuda() {
   static bool cuda_checked = false;
@@ -83,12 +117,18 @@ void Backend::gpu_matmul(const NDArray& a, const NDArray& b, NDArray& result) {
     throw std::invalid_argument("Inner dimensions must match");
   }
 
-  // Ensure result has correct shape
-  if (result.shape().size() != 2 || result.shape()[0] != m ||
-      result.shape()[1] != n) {
-    result = NDArray({m, n});
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    auto b_buffer = b.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, {m, n}, *memory);
+    memory->matmul(*a_buffer, *b_buffer, out, m, k, n);
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  // Ensure result has correct shape
+  prepare_output(result, {m, n});
+
   const double* a_data = a.data();
   const double* b_data = b.data();
   double* result_data = result.data();
@@ -169,10 +209,17 @@ void Backend::gpu_add(const NDArray& a, const NDArray& b, NDArray& result) {
     throw std::invalid_argument("Shapes must match for addition");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    auto b_buffer = b.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, a.shape(), *memory);
+    memory->add(*a_buffer, *b_buffer, out, a.size());
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(result, a.shape());
+
   const double* a_data = a.data();
   const double* b_data = b.data();
   double* result_data = result.data();
@@ -200,10 +247,17 @@ void Backend::gpu_subtract(const NDArray& a, const NDArray& b,
     throw std::invalid_argument("Shapes must match for subtraction");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    auto b_buffer = b.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, a.shape(), *memory);
+    memory->subtract(*a_buffer, *b_buffer, out, a.size());
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(result, a.shape());
+
   const double* a_data = a.data();
   const double* b_data = b.data();
   double* result_data = result.data();
@@ -231,10 +285,17 @@ void Backend::gpu_multiply(const NDArray& a, const NDArray& b,
     throw std::invalid_argument("Shapes must match for multiplication");
   }
 
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    auto b_buffer = b.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, a.shape(), *memory);
+    memory->multiply(*a_buffer, *b_buffer, out, a.size());
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(result, a.shape());
+
   const double* a_data = a.data();
   const double* b_data = b.data();
   double* result_data = result.data();
@@ -257,10 +318,16 @@ void Backend::gpu_multiply(const NDArray& a, const NDArray& b,
 
 // GPU scalar addition
 void Backend::gpu_add_scalar(const NDArray& a, double scalar, NDArray& result) {
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, a.shape(), *memory);
+    memory->add_scalar(*a_buffer, scalar, out, a.size());
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(result, a.shape());
+
   const double* a_data = a.data();
   double* result_data = result.data();
   size_t size = a.size();
@@ -283,10 +350,16 @@ void Backend::gpu_add_scalar(const NDArray& a, double scalar, NDArray& result) {
 // GPU scalar multiplication
 void Backend::gpu_multiply_scalar(const NDArray& a, double scalar,
                                   NDArray& result) {
-  if (result.shape() != a.shape()) {
-    result = NDArray(a.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    DeviceBuffer& out = device_output(result, a.shape(), *memory);
+    memory->multiply_scalar(*a_buffer, scalar, out, a.size());
+    result.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(result, a.shape());
+
   const double* a_data = a.data();
   double* result_data = result.data();
   size_t size = a.size();
@@ -308,6 +381,13 @@ void Backend::gpu_multiply_scalar(const NDArray& a, double scalar,
 
 // GPU fill array
 void Backend::gpu_fill(NDArray& array, double value) {
+  if (auto memory = getDeviceMemoryBackend()) {
+    DeviceBuffer& out = device_output(array, array.shape(), *memory);
+    memory->fill(out, value, array.size());
+    array.set_residency(Residency::DEVICE);
+    return;
+  }
+
   double* data = array.data();
   size_t size = array.size();
 
@@ -328,10 +408,16 @@ void Backend::gpu_fill(NDArray& array, double value) {
 
 // GPU copy array
 void Backend::gpu_copy(const NDArray& src, NDArray& dst) {
-  if (dst.shape() != src.shape()) {
-    dst = NDArray(src.shape());
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto src_buffer = src.ensure_device(*memory);
+    DeviceBuffer& out = device_output(dst, src.shape(), *memory);
+    memory->copy(*src_buffer, out, src.size());
+    dst.set_residency(Residency::DEVICE);
+    return;
   }
 
+  prepare_output(dst, src.shape());
+
   const double* src_data = src.data();
   double* dst_data = dst.data();
   size_t size = src.size();
@@ -351,5 +437,48 @@ void Backend::gpu_copy(const NDArray& src, NDArray& dst) {
   cpu_copy(src, dst);
 }
 
+// GPU y += alpha * x
+void Backend::gpu_axpy(double alpha, const NDArray& x, NDArray& y) {
+  gpu_axpby(alpha, x, 1.0, y);
+}
+
+// GPU y = alpha * x + beta * y
+void Backend::gpu_axpby(double alpha, const NDArray& x, double beta,
+                        NDArray& y) {
+  if (x.shape() != y.shape()) {
+    throw std::invalid_argument("Shapes must match for axpby");
+  }
+
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto x_buffer = x.ensure_device(*memory);
+    auto y_buffer = y.ensure_device(*memory);
+    memory->axpby(alpha, *x_buffer, beta, *y_buffer, x.size());
+    y.set_residency(Residency::DEVICE);
+    return;
+  }
+
+  // No device kernel outside device memory; update the host copy
+  cpu_axpby(alpha, x, beta, y);
+}
+
+// GPU y += a * b
+void Backend::gpu_multiply_add(const NDArray& a, const NDArray& b,
+                               NDArray& y) {
+  if (a.shape() != b.shape() || a.shape() != y.shape()) {
+    throw std::invalid_argument("Shapes must match for multiply_add");
+  }
+
+  if (auto memory = getDeviceMemoryBackend()) {
+    auto a_buffer = a.ensure_device(*memory);
+    auto b_buffer = b.ensure_device(*memory);
+    auto y_buffer = y.ensure_device(*memory);
+    memory->multiply_add(*a_buffer, *b_buffer, *y_buffer, a.size());
+    y.set_residency(Residency::DEVICE);
+    return;
+  }
+
+  cpu_multiply_add(a, b, y);
+}
+
 }  // namespace Backend
 }  // namespace MLLib
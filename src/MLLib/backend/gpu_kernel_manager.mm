@@ -154,6 +154,47 @@ void GPUKernelManager::registerKernel(const KernelParams& kernel_params) {
 #endif
 }
 
+void GPUKernelManager::registerExpressionKernel(
+    const std::string& name,
+    const std::string& expression,
+    size_t inputs,
+    const std::vector<double>& constants) {
+    if (inputs != 1 && inputs != 2) {
+        throw std::invalid_argument(
+            "Expression kernels take one or two inputs");
+    }
+
+    // Inputs and constants become local floats, so the expression uses the
+    // same bare names as on the CPU backend
+    std::vector<std::string> input_names = inputs == 2
+        ? std::vector<std::string>{"input1", "input2"}
+        : std::vector<std::string>{"input"};
+    std::ostringstream oss;
+    oss << "#include <metal_stdlib>\nusing namespace metal;\n\n"
+        << "kernel void " << name << "_kernel(";
+    size_t buffer = 0;
+    for (const auto& input_name : input_names) {
+        oss << "device const float* " << input_name << "_buffer [[buffer("
+            << buffer++ << ")]],\n";
+    }
+    oss << "device float* output [[buffer(" << buffer++ << ")]],\n";
+    for (size_t i = 0; i < constants.size(); ++i) {
+        oss << "device const float* p" << i << "_buffer [[buffer("
+            << buffer++ << ")]],\n";
+    }
+    oss << "uint index [[thread_position_in_grid]]) {\n";
+    for (const auto& input_name : input_names) {
+        oss << "    float " << input_name << " = " << input_name
+            << "_buffer[index];\n";
+    }
+    for (size_t i = 0; i < constants.size(); ++i) {
+        oss << "    float p" << i << " = p" << i << "_buffer[0];\n";
+    }
+    oss << "    output[index] = " << expression << ";\n}\n";
+
+    registerKernel({name, oss.str(), constants});
+}
+
 void GPUKernelManager::initializeBuiltinKernels() {
     if (initialized_) return;
     
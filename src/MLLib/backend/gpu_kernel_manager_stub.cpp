@@ -1,14 +1,17 @@
 /**
  * @file gpu_kernel_manager_stub.cpp
- * @brief CPU-based stub implementation for GPU kernel management
- * Used in CI environments where GPU/Metal support is not available
+ * @brief CPU implementation of GPU kernel management
+ * Used where GPU/Metal support is not available. Kernel expressions are
+ * compiled into ExpressionKernel programs and run vectorized on the CPU
+ * thread pool.
  */
 
+#include "../../../include/MLLib/backend/expression_kernel.hpp"
 #include "../../../include/MLLib/backend/gpu_kernel_manager.hpp"
-#include <chrono>
-#include <cmath>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 
 namespace MLLib {
@@ -19,76 +22,151 @@ bool GPUKernelManager::initialized_ = false;
 std::unordered_map<std::string, ActivationKernelRegistry::ActivationDef>
     ActivationKernelRegistry::activations_;
 
-// GPUKernelManager Implementation (CPU fallback)
+namespace {
+
+/**
+ * @brief Compiled kernel and the parameter values used when none are given
+ */
+struct CompiledKernel {
+  std::shared_ptr<const ExpressionKernel> kernel;
+  std::vector<double> defaults;
+};
+
+struct KernelTable {
+  std::mutex mutex;
+  std::unordered_map<std::string, CompiledKernel> unary;
+  std::unordered_map<std::string, CompiledKernel> binary;
+};
+
+KernelTable& kernelTable() {
+  static KernelTable table;
+  return table;
+}
+
+const std::vector<std::string> kUnaryVariables = {"input"};
+const std::vector<std::string> kBinaryVariables = {"input1", "input2"};
+
+/**
+ * @brief Parameter names for kernels registered without names: p0, p1, ...
+ */
+std::vector<std::string> positionalNames(size_t count) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < count; ++i) {
+    names.push_back("p" + std::to_string(i));
+  }
+  return names;
+}
+
+void storeKernel(std::unordered_map<std::string, CompiledKernel>& kernels,
+                 const std::string& name, const std::string& expression,
+                 const std::vector<std::string>& variables,
+                 const std::vector<std::string>& param_names,
+                 const std::vector<double>& defaults) {
+  // Compile outside the lock; a bad expression leaves the table unchanged
+  auto kernel =
+      std::make_shared<const ExpressionKernel>(expression, variables,
+                                               param_names);
+  KernelTable& table = kernelTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  kernels[name] = CompiledKernel{kernel, defaults};
+}
+
+bool findKernel(std::unordered_map<std::string, CompiledKernel>& kernels,
+                const std::string& name, CompiledKernel& found) {
+  KernelTable& table = kernelTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto it = kernels.find(name);
+  if (it == kernels.end()) {
+    return false;
+  }
+  found = it->second;
+  return true;
+}
+
+/**
+ * @brief Complete caller parameters with the kernel's defaults
+ */
+std::vector<double> resolveParams(const std::string& name,
+                                  const CompiledKernel& compiled,
+                                  const std::vector<double>& params) {
+  size_t expected = compiled.kernel->parameter_count();
+  std::vector<double> values(params.begin(),
+                             params.begin() +
+                                 std::min(params.size(), expected));
+  for (size_t i = values.size(); i < expected; ++i) {
+    if (i >= compiled.defaults.size()) {
+      throw std::invalid_argument("Kernel " + name + " expects " +
+                                  std::to_string(expected) + " parameters");
+    }
+    values.push_back(compiled.defaults[i]);
+  }
+  return values;
+}
+
+void ensureInitialized() {
+  static std::once_flag once;
+  std::call_once(once, []() { GPUKernelManager::initializeBuiltinKernels(); });
+}
+
+}  // namespace
+
+// GPUKernelManager Implementation (CPU)
 void GPUKernelManager::executeUnaryKernel(const std::string& name,
                                           const double* input, double* output,
                                           size_t size,
                                           const std::vector<double>& params) {
+  ensureInitialized();
 
-  std::cout << "⚠️  Using CPU fallback for GPU kernel: " << name << std::endl;
-
-  // Simple CPU implementations for common operations
-  if (name == "relu") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = std::max(0.0, input[i]);
-    }
-  } else if (name == "sigmoid") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = 1.0 / (1.0 + std::exp(-input[i]));
-    }
-  } else if (name == "tanh") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = std::tanh(input[i]);
-    }
-  } else if (name == "leaky_relu") {
-    double alpha = params.empty() ? 0.01 : params[0];
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input[i] > 0 ? input[i] : alpha * input[i];
-    }
-  } else if (name == "elu") {
-    double alpha = params.empty() ? 1.0 : params[0];
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input[i] > 0 ? input[i] : alpha * (std::exp(input[i]) - 1.0);
-    }
-  } else if (name == "softplus") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = std::log(1.0 + std::exp(input[i]));
-    }
-  } else {
+  CompiledKernel compiled;
+  if (!findKernel(kernelTable().unary, name, compiled)) {
     // Default: copy input to output for unknown kernels
     std::cout << "⚠️  Unknown kernel: " << name << ", using identity"
               << std::endl;
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input[i];
-    }
+    std::copy(input, input + size, output);
+    return;
   }
-}
 
-void GPUKernelManager::executeBinaryKernel(
-    const std::string& name, const double* input1, const double* input2,
-    double* output, size_t size, const std::vector<double>& /* params */) {
+  compiled.kernel->execute({input}, output, size,
+                           resolveParams(name, compiled, params));
+}
 
-  std::cout << "⚠️  Using CPU fallback for binary GPU kernel: " << name
-            << std::endl;
+void GPUKernelManager::executeBinaryKernel(const std::string& name,
+                                           const double* input1,
+                                           const double* input2,
+                                           double* output, size_t size,
+                                           const std::vector<double>& params) {
+  ensureInitialized();
 
-  if (name == "add") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input1[i] + input2[i];
-    }
-  } else if (name == "multiply") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input1[i] * input2[i];
-    }
-  } else if (name == "subtract") {
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input1[i] - input2[i];
-    }
-  } else {
+  CompiledKernel compiled;
+  if (!findKernel(kernelTable().binary, name, compiled)) {
     // Default: copy first input to output
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input1[i];
-    }
+    std::copy(input1, input1 + size, output);
+    return;
   }
+
+  compiled.kernel->execute({input1, input2}, output, size,
+                           resolveParams(name, compiled, params));
+}
+
+void GPUKernelManager::registerKernel(const KernelParams& kernel_params) {
+  // Shader source targets a GPU backend this build does not have
+  std::cout << "⚠️  Ignoring GPU kernel source: " << kernel_params.name
+            << " (CPU fallback)" << std::endl;
+}
+
+void GPUKernelManager::registerExpressionKernel(
+    const std::string& name, const std::string& expression, size_t inputs,
+    const std::vector<double>& constants) {
+  if (inputs != 1 && inputs != 2) {
+    throw std::invalid_argument("Expression kernels take one or two inputs");
+  }
+  // Builtins first, so user kernels may replace them
+  ensureInitialized();
+
+  KernelTable& table = kernelTable();
+  storeKernel(inputs == 2 ? table.binary : table.unary, name, expression,
+              inputs == 2 ? kBinaryVariables : kUnaryVariables,
+              positionalNames(constants.size()), constants);
 }
 
 void GPUKernelManager::initializeBuiltinKernels() {
@@ -99,6 +177,14 @@ void GPUKernelManager::initializeBuiltinKernels() {
   std::cout << "🔧 Initializing GPU kernel manager (CPU fallback mode)"
             << std::endl;
 
+  KernelTable& table = kernelTable();
+  storeKernel(table.binary, "add", "input1 + input2", kBinaryVariables, {},
+              {});
+  storeKernel(table.binary, "subtract", "input1 - input2", kBinaryVariables,
+              {}, {});
+  storeKernel(table.binary, "multiply", "input1 * input2", kBinaryVariables,
+              {}, {});
+
   // Initialize activation kernel registry
   ActivationKernelRegistry::initializeBuiltinActivations();
 
@@ -115,30 +201,19 @@ void GPUKernelManager::cleanup() {
   initialized_ = false;
 }
 
-// ActivationKernelRegistry Implementation (CPU fallback)
+// ActivationKernelRegistry Implementation (CPU)
 void ActivationKernelRegistry::executeActivation(
     const std::string& name, const double* input, double* output, size_t size,
     const std::vector<double>& params) {
-
-  auto it = activations_.find(name);
-  if (it != activations_.end()) {
-    std::cout << "🔧 Executing activation " << name << " (CPU fallback)"
-              << std::endl;
-
-    // Use CPU implementation via kernel manager
-    GPUKernelManager::executeUnaryKernel(name, input, output, size, params);
-  } else {
-    std::cout << "⚠️  Unknown activation: " << name << ", using identity"
-              << std::endl;
-    for (size_t i = 0; i < size; ++i) {
-      output[i] = input[i];
-    }
-  }
+  GPUKernelManager::executeUnaryKernel(name, input, output, size, params);
 }
 
 void ActivationKernelRegistry::registerActivation(const ActivationDef& def) {
+  ensureInitialized();
   std::cout << "📝 Registering activation: " << def.name << " (CPU fallback)"
             << std::endl;
+  storeKernel(kernelTable().unary, def.name, def.gpu_expression,
+              kUnaryVariables, def.param_names, {});
   activations_[def.name] = def;
 }
 
@@ -146,30 +221,33 @@ void ActivationKernelRegistry::initializeBuiltinActivations() {
   std::cout << "🔧 Initializing builtin activations (CPU fallback mode)"
             << std::endl;
 
-  // Register common activation functions
-  ActivationDef relu = {"relu", "max(0.0f, input)", {}, false};
-  activations_["relu"] = relu;
-
-  ActivationDef sigmoid = {"sigmoid", "1.0f / (1.0f + exp(-input))", {}, false};
-  activations_["sigmoid"] = sigmoid;
-
-  ActivationDef tanh = {"tanh", "tanh(input)", {}, false};
-  activations_["tanh"] = tanh;
+  // Register common activation functions with their default parameters
+  struct Builtin {
+    ActivationDef def;
+    std::vector<double> defaults;
+  };
+  const std::vector<Builtin> builtins = {
+      {{"relu", "max(0.0f, input)", {}, false}, {}},
+      {{"sigmoid", "1.0f / (1.0f + exp(-input))", {}, false}, {}},
+      {{"tanh", "tanh(input)", {}, false}, {}},
+      {{"leaky_relu",
+        "input > 0.0f ? input : alpha * input",
+        {"alpha"},
+        true},
+       {0.01}},
+      {{"elu",
+        "input > 0.0f ? input : alpha * (exp(input) - 1.0f)",
+        {"alpha"},
+        true},
+       {1.0}},
+      {{"softplus", "log(1.0f + exp(input))", {}, false}, {}}};
 
-  ActivationDef leaky_relu = {"leaky_relu",
-                              "input > 0.0f ? input : alpha * input",
-                              {"alpha"},
-                              true};
-  activations_["leaky_relu"] = leaky_relu;
-
-  ActivationDef elu = {"elu",
-                       "input > 0.0f ? input : alpha * (exp(input) - 1.0f)",
-                       {"alpha"},
-                       true};
-  activations_["elu"] = elu;
-
-  ActivationDef softplus = {"softplus", "log(1.0f + exp(input))", {}, false};
-  activations_["softplus"] = softplus;
+  for (const auto& builtin : builtins) {
+    storeKernel(kernelTable().unary, builtin.def.name,
+                builtin.def.gpu_expression, kUnaryVariables,
+                builtin.def.param_names, builtin.defaults);
+    activations_[builtin.def.name] = builtin.def;
+  }
 
   std::cout << "✅ Builtin activations initialized (" << activations_.size()
             << " activations)" << std::endl;
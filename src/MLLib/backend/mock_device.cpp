@@ -0,0 +1,168 @@
+#include "../../../include/MLLib/backend/mock_device.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace MLLib {
+namespace Backend {
+
+/**
+ * @brief Mock device buffer backed by its own host allocation
+ */
+class MockDeviceBuffer : public DeviceBuffer {
+public:
+  MockDeviceBuffer(MockDeviceMemoryBackend* owner, size_t count)
+      : owner_(owner), memory_(count) {}
+
+  void upload(const double* host, size_t count) override {
+    std::copy(host, host + count, memory_.begin());
+    owner_->uploads_++;
+    owner_->bytes_uploaded_ += count * sizeof(double);
+  }
+
+  void download(double* host, size_t count) const override {
+    std::copy(memory_.begin(), memory_.begin() + count, host);
+    owner_->downloads_++;
+    owner_->bytes_downloaded_ += count * sizeof(double);
+  }
+
+  size_t size() const override { return memory_.size(); }
+
+  const DeviceMemoryBackend* owner() const override { return owner_; }
+
+  double* memory() { return memory_.data(); }
+  const double* memory() const { return memory_.data(); }
+
+private:
+  MockDeviceMemoryBackend* owner_;
+  std::vector<double> memory_;
+};
+
+namespace {
+
+const double* mem(const DeviceBuffer& buffer) {
+  return static_cast<const MockDeviceBuffer&>(buffer).memory();
+}
+
+double* mem(DeviceBuffer& buffer) {
+  return static_cast<MockDeviceBuffer&>(buffer).memory();
+}
+
+}  // namespace
+
+TransferStats MockDeviceMemoryBackend::stats() const {
+  TransferStats stats;
+  stats.uploads = uploads_;
+  stats.downloads = downloads_;
+  stats.bytes_uploaded = bytes_uploaded_;
+  stats.bytes_downloaded = bytes_downloaded_;
+  stats.allocations = allocations_;
+  stats.kernel_launches = kernel_launches_;
+  return stats;
+}
+
+void MockDeviceMemoryBackend::reset_stats() {
+  uploads_ = 0;
+  downloads_ = 0;
+  bytes_uploaded_ = 0;
+  bytes_downloaded_ = 0;
+  allocations_ = 0;
+  kernel_launches_ = 0;
+}
+
+std::shared_ptr<DeviceBuffer> MockDeviceMemoryBackend::allocate(size_t count) {
+  allocations_++;
+  return std::make_shared<MockDeviceBuffer>(this, count);
+}
+
+void MockDeviceMemoryBackend::matmul(const DeviceBuffer& a,
+                                     const DeviceBuffer& b, DeviceBuffer& c,
+                                     size_t m, size_t k, size_t n) {
+  kernel_launches_++;
+  const double* pa = mem(a);
+  const double* pb = mem(b);
+  std::vector<double> out(m * n, 0.0);
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t l = 0; l < k; ++l) {
+      double a_il = pa[i * k + l];
+      for (size_t j = 0; j < n; ++j) {
+        out[i * n + j] += a_il * pb[l * n + j];
+      }
+    }
+  }
+  std::copy(out.begin(), out.end(), mem(c));
+}
+
+void MockDeviceMemoryBackend::add(const DeviceBuffer& a, const DeviceBuffer& b,
+                                  DeviceBuffer& out, size_t count) {
+  kernel_launches_++;
+  std::transform(mem(a), mem(a) + count, mem(b), mem(out),
+                 [](double x, double y) { return x + y; });
+}
+
+void MockDeviceMemoryBackend::subtract(const DeviceBuffer& a,
+                                       const DeviceBuffer& b,
+                                       DeviceBuffer& out, size_t count) {
+  kernel_launches_++;
+  std::transform(mem(a), mem(a) + count, mem(b), mem(out),
+                 [](double x, double y) { return x - y; });
+}
+
+void MockDeviceMemoryBackend::multiply(const DeviceBuffer& a,
+                                       const DeviceBuffer& b,
+                                       DeviceBuffer& out, size_t count) {
+  kernel_launches_++;
+  std::transform(mem(a), mem(a) + count, mem(b), mem(out),
+                 [](double x, double y) { return x * y; });
+}
+
+void MockDeviceMemoryBackend::add_scalar(const DeviceBuffer& a, double scalar,
+                                         DeviceBuffer& out, size_t count) {
+  kernel_launches_++;
+  std::transform(mem(a), mem(a) + count, mem(out),
+                 [scalar](double x) { return x + scalar; });
+}
+
+void MockDeviceMemoryBackend::multiply_scalar(const DeviceBuffer& a,
+                                              double scalar, DeviceBuffer& out,
+                                              size_t count) {
+  kernel_launches_++;
+  std::transform(mem(a), mem(a) + count, mem(out),
+                 [scalar](double x) { return x * scalar; });
+}
+
+void MockDeviceMemoryBackend::fill(DeviceBuffer& buffer, double value,
+                                   size_t count) {
+  kernel_launches_++;
+  std::fill(mem(buffer), mem(buffer) + count, value);
+}
+
+void MockDeviceMemoryBackend::copy(const DeviceBuffer& src, DeviceBuffer& dst,
+                                   size_t count) {
+  kernel_launches_++;
+  std::copy(mem(src), mem(src) + count, mem(dst));
+}
+
+void MockDeviceMemoryBackend::axpby(double alpha, const DeviceBuffer& x,
+                                    double beta, DeviceBuffer& y,
+                                    size_t count) {
+  kernel_launches_++;
+  std::transform(mem(x), mem(x) + count, mem(y), mem(y),
+                 [alpha, beta](double xi, double yi) {
+                   return alpha * xi + beta * yi;
+                 });
+}
+
+void MockDeviceMemoryBackend::multiply_add(const DeviceBuffer& a,
+                                           const DeviceBuffer& b,
+                                           DeviceBuffer& y, size_t count) {
+  kernel_launches_++;
+  const double* a_data = mem(a);
+  const double* b_data = mem(b);
+  double* y_data = mem(y);
+  for (size_t i = 0; i < count; ++i) {
+    y_data[i] += a_data[i] * b_data[i];
+  }
+}
+
+}  // namespace Backend
+}  // namespace MLLib
@@ -0,0 +1,389 @@
+#include "../../../include/MLLib/backend/placement.hpp"
+#include "../../../include/MLLib/backend/backend.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace MLLib {
+namespace Backend {
+
+namespace {
+
+constexpr const char* kProfileMagic = "MLLIB_COST_PROFILE 1";
+
+const char* deviceKey(DeviceType device) {
+  return Device::getDeviceTypeString(device);
+}
+
+bool parseDeviceKey(const std::string& key, DeviceType& device) {
+  for (DeviceType candidate :
+       {DeviceType::CPU, DeviceType::GPU, DeviceType::AUTO}) {
+    if (key == deviceKey(candidate)) {
+      device = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Body>
+double timeMicros(Body body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+/**
+ * @brief Best of repetitions, which filters out scheduling noise
+ */
+template <typename Measure>
+double bestOf(size_t repetitions, Measure measure) {
+  double best = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < std::max<size_t>(1, repetitions); ++i) {
+    best = std::min(best, measure());
+  }
+  return best;
+}
+
+}  // namespace
+
+// OpDescriptor implementation
+
+OpDescriptor OpDescriptor::gemm(size_t m, size_t k, size_t n) {
+  OpDescriptor op;
+  op.kind = OpKind::GEMM;
+  op.m = m;
+  op.k = k;
+  op.n = n;
+  return op;
+}
+
+OpDescriptor OpDescriptor::elementwise(size_t size) {
+  OpDescriptor op;
+  op.kind = OpKind::ELEMENTWISE;
+  op.n = size;
+  return op;
+}
+
+double OpDescriptor::work() const {
+  if (kind == OpKind::GEMM) {
+    return 2.0 * static_cast<double>(m) * static_cast<double>(k) *
+           static_cast<double>(n);
+  }
+  return static_cast<double>(n);
+}
+
+size_t OpDescriptor::input_bytes() const {
+  return (kind == OpKind::GEMM ? m * k : n) * sizeof(double);
+}
+
+size_t OpDescriptor::output_bytes() const {
+  return (kind == OpKind::GEMM ? m * n : n) * sizeof(double);
+}
+
+// Cost model implementation
+
+LinearCost LinearCost::fit(const std::vector<double>& units,
+                           const std::vector<double>& times_us) {
+  if (units.size() != times_us.size() || units.empty()) {
+    throw std::invalid_argument("Cost fit needs matching, non-empty samples");
+  }
+
+  const double count = static_cast<double>(units.size());
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  for (size_t i = 0; i < units.size(); ++i) {
+    mean_x += units[i] / count;
+    mean_y += times_us[i] / count;
+  }
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (size_t i = 0; i < units.size(); ++i) {
+    covariance += (units[i] - mean_x) * (times_us[i] - mean_y);
+    variance += (units[i] - mean_x) * (units[i] - mean_x);
+  }
+
+  LinearCost cost;
+  cost.per_unit_us = variance > 0.0 ? std::max(0.0, covariance / variance)
+                                    : (mean_x > 0.0 ? mean_y / mean_x : 0.0);
+  cost.fixed_us = std::max(0.0, mean_y - cost.per_unit_us * mean_x);
+  return cost;
+}
+
+double CostModel::compute_us(const OpDescriptor& op) const {
+  return op.kind == OpKind::GEMM ? gemm.at(op.work())
+                                 : elementwise.at(op.work());
+}
+
+// CostProfile implementation
+
+void CostProfile::set(DeviceType device, const CostModel& model) {
+  models_[device] = model;
+}
+
+bool CostProfile::has(DeviceType device) const {
+  return models_.count(device) > 0;
+}
+
+const CostModel& CostProfile::get(DeviceType device) const {
+  auto it = models_.find(device);
+  if (it == models_.end()) {
+    throw std::invalid_argument(std::string("No cost model for device ") +
+                                deviceKey(device));
+  }
+  return it->second;
+}
+
+std::vector<DeviceType> CostProfile::devices() const {
+  std::vector<DeviceType> result;
+  for (const auto& entry : models_) {
+    result.push_back(entry.first);
+  }
+  return result;
+}
+
+bool CostProfile::save(const std::string& path) const {
+  // Write next to the target and rename so readers never see a partial file
+  const std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    file << kProfileMagic << "\n" << std::setprecision(17);
+    for (const auto& entry : models_) {
+      const CostModel& model = entry.second;
+      file << "device\t" << deviceKey(entry.first) << "\t"
+           << model.gemm.fixed_us << "\t" << model.gemm.per_unit_us << "\t"
+           << model.elementwise.fixed_us << "\t"
+           << model.elementwise.per_unit_us << "\t"
+           << model.transfer.fixed_us << "\t" << model.transfer.per_unit_us
+           << "\n";
+    }
+    if (!file.good()) {
+      return false;
+    }
+  }
+
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+bool CostProfile::load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kProfileMagic) {
+    return false;
+  }
+
+  std::map<DeviceType, CostModel> models;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string tag;
+    std::string key;
+    CostModel model;
+    if (!(fields >> tag >> key >> model.gemm.fixed_us >>
+          model.gemm.per_unit_us >> model.elementwise.fixed_us >>
+          model.elementwise.per_unit_us >> model.transfer.fixed_us >>
+          model.transfer.per_unit_us) ||
+        tag != "device") {
+      return false;
+    }
+    DeviceType device;
+    if (!parseDeviceKey(key, device)) {
+      return false;
+    }
+    models[device] = model;
+  }
+
+  models_ = std::move(models);
+  return true;
+}
+
+// Benchmarking
+
+BenchmarkTarget BenchmarkTarget::backend(DeviceType device) {
+  BenchmarkTarget target;
+  target.device = device;
+
+  target.run_op = [device](const OpDescriptor& op) {
+    const BackendOps& ops = Backend::getOps(device);
+    if (op.kind == OpKind::GEMM) {
+      NDArray a({op.m, op.k});
+      NDArray b({op.k, op.n});
+      NDArray c({op.m, op.n});
+      a.fill(1.0);
+      b.fill(0.5);
+      return timeMicros([&]() { ops.matmul(a, b, c); });
+    }
+    NDArray a({op.n});
+    NDArray b({op.n});
+    NDArray c({op.n});
+    a.fill(1.0);
+    b.fill(0.5);
+    return timeMicros([&]() { ops.add(a, b, c); });
+  };
+
+  target.transfer = [device](size_t bytes) {
+    auto memory = Backend::getDeviceMemoryBackend();
+    if (device != DeviceType::GPU || !memory) {
+      return 0.0;
+    }
+    size_t count = std::max<size_t>(1, bytes / sizeof(double));
+    std::vector<double> host(count, 1.0);
+    auto buffer = memory->allocate(count);
+    return timeMicros([&]() { buffer->upload(host.data(), count); });
+  };
+
+  return target;
+}
+
+BenchmarkTarget SimulatedDevice::target() const {
+  BenchmarkTarget target;
+  target.device = device_;
+  CostModel truth = truth_;
+  target.run_op = [truth](const OpDescriptor& op) {
+    return truth.compute_us(op);
+  };
+  target.transfer = [truth](size_t bytes) {
+    return truth.transfer.at(static_cast<double>(bytes));
+  };
+  return target;
+}
+
+CostProfile benchmarkProfile(const std::vector<BenchmarkTarget>& targets,
+                             const BenchmarkPlan& plan) {
+  CostProfile profile;
+  for (const auto& target : targets) {
+    if (!target.run_op || !target.transfer) {
+      throw std::invalid_argument("Benchmark target needs run_op and transfer");
+    }
+
+    std::vector<double> units;
+    std::vector<double> times;
+    CostModel model;
+
+    for (size_t size : plan.gemm_sizes) {
+      OpDescriptor op = OpDescriptor::gemm(size, size, size);
+      units.push_back(op.work());
+      times.push_back(
+          bestOf(plan.repetitions, [&]() { return target.run_op(op); }));
+    }
+    model.gemm = LinearCost::fit(units, times);
+
+    units.clear();
+    times.clear();
+    for (size_t size : plan.elementwise_sizes) {
+      OpDescriptor op = OpDescriptor::elementwise(size);
+      units.push_back(op.work());
+      times.push_back(
+          bestOf(plan.repetitions, [&]() { return target.run_op(op); }));
+    }
+    model.elementwise = LinearCost::fit(units, times);
+
+    units.clear();
+    times.clear();
+    for (size_t bytes : plan.transfer_bytes) {
+      units.push_back(static_cast<double>(bytes));
+      times.push_back(
+          bestOf(plan.repetitions, [&]() { return target.transfer(bytes); }));
+    }
+    model.transfer = LinearCost::fit(units, times);
+
+    profile.set(target.device, model);
+  }
+  return profile;
+}
+
+// PlacementScheduler implementation
+
+PlacementScheduler::PlacementScheduler(CostProfile profile)
+    : profile_(std::move(profile)) {}
+
+void PlacementScheduler::setProfile(const CostProfile& profile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  profile_ = profile;
+}
+
+CostProfile PlacementScheduler::getProfile() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return profile_;
+}
+
+double PlacementScheduler::transfer_us(size_t bytes, DeviceType from,
+                                       DeviceType to) const {
+  if (from == to || bytes == 0) {
+    return 0.0;
+  }
+  // The link is characterized by whichever side reports a transfer cost
+  double cost = 0.0;
+  for (DeviceType device : {from, to}) {
+    if (profile_.has(device)) {
+      cost = std::max(cost, profile_.get(device).transfer.at(
+                                static_cast<double>(bytes)));
+    }
+  }
+  return cost;
+}
+
+double PlacementScheduler::cost_us(const OpDescriptor& op, DeviceType device,
+                                   DeviceType data_location) const {
+  if (!profile_.has(device)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return profile_.get(device).compute_us(op) +
+         transfer_us(op.input_bytes(), data_location, device);
+}
+
+double PlacementScheduler::estimate(const OpDescriptor& op, DeviceType device,
+                                    DeviceType data_location) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cost_us(op, device, data_location);
+}
+
+DeviceType PlacementScheduler::place(const OpDescriptor& op,
+                                     DeviceType data_location) const {
+  // One lock per call: AUTO dispatch runs this for every Backend op
+  std::lock_guard<std::mutex> lock(mutex_);
+  DeviceType best = DeviceType::CPU;
+  if (profile_.empty()) {
+    return best;
+  }
+  double best_cost = std::numeric_limits<double>::infinity();
+  for (DeviceType device : {DeviceType::CPU, DeviceType::GPU}) {
+    double cost = cost_us(op, device, data_location);
+    if (cost < best_cost) {
+      best = device;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+PlacementScheduler& PlacementScheduler::global() {
+  static PlacementScheduler scheduler = []() {
+    CostProfile profile;
+    if (const char* path = std::getenv("MLLIB_COST_PROFILE")) {
+      profile.load(path);
+    }
+    return PlacementScheduler(profile);
+  }();
+  return scheduler;
+}
+
+}  // namespace Backend
+}  // namespace MLLib
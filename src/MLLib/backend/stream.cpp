@@ -0,0 +1,108 @@
+#include "../../../include/MLLib/backend/stream.hpp"
+#include "../../../include/MLLib/backend/backend.hpp"
+#include "../../../include/MLLib/device/device.hpp"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace MLLib {
+namespace Backend {
+
+namespace {
+std::shared_future<void> completed_future() {
+  std::promise<void> promise;
+  promise.set_value();
+  return promise.get_future().share();
+}
+}  // namespace
+
+// Event implementation
+
+Event::Event() : done_(completed_future()) {}
+
+Event::Event(std::shared_future<void> done) : done_(std::move(done)) {}
+
+void Event::wait() const {
+  done_.get();
+}
+
+bool Event::ready() const {
+  return done_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// Stream implementation
+
+Stream::Stream() : worker_(std::make_unique<util::ThreadPool>(1)) {}
+
+Stream::Stream(int numa_node) {
+  // Validate before starting the worker so a bad node throws here
+  bool found = false;
+  for (const auto& node : Device::detectNUMANodes()) {
+    found = found || node.id == numa_node;
+  }
+  if (!found) {
+    throw std::invalid_argument("Unknown NUMA node: " +
+                                std::to_string(numa_node));
+  }
+  worker_ = std::make_unique<util::ThreadPool>(
+      1, [numa_node]() { Device::bindCurrentThreadToNode(numa_node); });
+}
+
+Stream::~Stream() = default;
+
+Event Stream::record() {
+  return launch([]() {});
+}
+
+void Stream::wait_event(const Event& event) {
+  // Only ordering matters here; failures surface through the event itself
+  enqueue([event]() {
+    try {
+      event.wait();
+    } catch (...) {
+    }
+  });
+}
+
+void Stream::synchronize() {
+  enqueue([]() {}).wait();
+}
+
+Event Stream::matmul(const NDArray& a, const NDArray& b, NDArray& result) {
+  return launch([&a, &b, &result]() { Backend::matmul(a, b, result); });
+}
+
+Event Stream::add(const NDArray& a, const NDArray& b, NDArray& result) {
+  return launch([&a, &b, &result]() { Backend::add(a, b, result); });
+}
+
+Event Stream::subtract(const NDArray& a, const NDArray& b, NDArray& result) {
+  return launch([&a, &b, &result]() { Backend::subtract(a, b, result); });
+}
+
+Event Stream::multiply(const NDArray& a, const NDArray& b, NDArray& result) {
+  return launch([&a, &b, &result]() { Backend::multiply(a, b, result); });
+}
+
+Event Stream::add_scalar(const NDArray& a, double scalar, NDArray& result) {
+  return launch(
+      [&a, scalar, &result]() { Backend::add_scalar(a, scalar, result); });
+}
+
+Event Stream::multiply_scalar(const NDArray& a, double scalar,
+                              NDArray& result) {
+  return launch([&a, scalar, &result]() {
+    Backend::multiply_scalar(a, scalar, result);
+  });
+}
+
+Event Stream::fill(NDArray& array, double value) {
+  return launch([&array, value]() { Backend::fill(array, value); });
+}
+
+Event Stream::copy(const NDArray& src, NDArray& dst) {
+  return launch([&src, &dst]() { Backend::copy(src, dst); });
+}
+
+}  // namespace Backend
+}  // namespace MLLib
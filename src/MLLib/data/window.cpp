@@ -0,0 +1,172 @@
+#include "../../../include/MLLib/data/window.hpp"
+#include "../../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace MLLib {
+namespace data {
+
+namespace {
+
+// Rows below this are copied on the calling thread
+constexpr size_t MIN_ROWS_PER_TASK = 64;
+
+void resizeBatch(NDArray& batch, size_t rows, size_t columns) {
+  const std::vector<size_t> shape = {rows, columns};
+  if (batch.shape() != shape) {
+    batch = NDArray(shape);
+  }
+}
+
+/**
+ * @brief Features per step of a recorded [steps, features] or [steps] series
+ * @throws std::invalid_argument if the series has no steps
+ */
+size_t seriesFeatures(const NDArray& series) {
+  if (series.shape().empty() || series.shape()[0] == 0) {
+    throw std::invalid_argument("WindowDataset series has no steps");
+  }
+  return series.shape().size() > 1 ? series.size() / series.shape()[0] : 1;
+}
+
+}  // namespace
+
+WindowDataset::WindowDataset(size_t window, size_t features, size_t stride,
+                             size_t history)
+    : window_(window), features_(features), stride_(stride),
+      history_(history) {
+  if (window == 0 || features == 0 || stride == 0) {
+    throw std::invalid_argument(
+        "WindowDataset needs positive window, features and stride");
+  }
+  if (history != 0 && history < window) {
+    throw std::invalid_argument("WindowDataset history of " +
+                                std::to_string(history) +
+                                " steps cannot hold a window of " +
+                                std::to_string(window));
+  }
+}
+
+WindowDataset::WindowDataset(const NDArray& series, size_t window,
+                             size_t stride)
+    : WindowDataset(window, seriesFeatures(series), stride) {
+  append(series);
+}
+
+size_t WindowDataset::windows_in(size_t steps) const {
+  return steps < window_ ? 0 : (steps - window_) / stride_ + 1;
+}
+
+size_t WindowDataset::append(const double* values, size_t steps) {
+  if (steps == 0) {
+    return 0;
+  }
+  const size_t before = windows_in(total_steps());
+
+  // Amortized growth of the one series buffer
+  const size_t needed = (end_ + steps) * features_;
+  if (buffer_.size() < needed) {
+    buffer_.resize(std::max(needed, 2 * buffer_.size()));
+  }
+  std::memcpy(buffer_.data() + end_ * features_, values,
+              steps * features_ * sizeof(double));
+  end_ += steps;
+
+  const size_t completed = windows_in(total_steps()) - before;
+  trim();
+  // A long append may complete windows that start in dropped steps
+  return std::min(completed, size());
+}
+
+size_t WindowDataset::append(const NDArray& steps) {
+  if (steps.size() % features_ != 0 ||
+      (steps.shape().size() > 1 &&
+       steps.size() / steps.shape()[0] != features_)) {
+    throw std::invalid_argument("WindowDataset expects steps of " +
+                                std::to_string(features_) + " values");
+  }
+  return append(steps.data(), steps.size() / features_);
+}
+
+void WindowDataset::trim() {
+  if (history_ == 0 || length() <= history_) {
+    return;
+  }
+  const size_t drop = length() - history_;
+  begin_ += drop;
+  dropped_ += drop;
+
+  // Move the held steps to the front once the dead prefix is as large as
+  // them, so each step is moved O(1) times
+  if (begin_ >= length()) {
+    std::memmove(buffer_.data(), buffer_.data() + begin_ * features_,
+                 length() * features_ * sizeof(double));
+    end_ -= begin_;
+    begin_ = 0;
+  }
+}
+
+size_t WindowDataset::size() const {
+  const size_t complete = windows_in(total_steps());
+  const size_t first = first_window();
+  return complete > first ? complete - first : 0;
+}
+
+WindowView WindowDataset::operator[](size_t i) const {
+  if (i >= size()) {
+    throw std::out_of_range("Window " + std::to_string(i) + " of " +
+                            std::to_string(size()));
+  }
+  const size_t start = (first_window() + i) * stride_;
+  const double* data =
+      buffer_.data() + (begin_ + start - dropped_) * features_;
+  return WindowView{data, window_, features_, start};
+}
+
+void WindowDataset::gather(size_t begin, size_t end, NDArray& batch) const {
+  if (begin > end || end > size()) {
+    throw std::out_of_range("Windows [" + std::to_string(begin) + ", " +
+                            std::to_string(end) + ") of " +
+                            std::to_string(size()));
+  }
+  std::vector<size_t> indices(end - begin);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = begin + i;
+  }
+  gather(indices.data(), indices.size(), batch);
+}
+
+void WindowDataset::gather(const size_t* indices, size_t count,
+                           NDArray& batch) const {
+  const size_t available = size();
+  for (size_t i = 0; i < count; ++i) {
+    if (indices[i] >= available) {
+      throw std::out_of_range("Window " + std::to_string(indices[i]) +
+                              " of " + std::to_string(available));
+    }
+  }
+
+  const size_t row = sample_size();
+  resizeBatch(batch, count, row);
+  double* out = batch.data();
+  util::ThreadPool::global().parallel_for(
+      0, count,
+      [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          std::memcpy(out + i * row, (*this)[indices[i]].data,
+                      row * sizeof(double));
+        }
+      },
+      MIN_ROWS_PER_TASK);
+}
+
+void WindowDataset::clear() {
+  begin_ = 0;
+  end_ = 0;
+  dropped_ = 0;
+}
+
+}  // namespace data
+}  // namespace MLLib
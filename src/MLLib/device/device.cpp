@@ -1,12 +1,20 @@
 #include "../../../include/MLLib/device/device.hpp"
+#include "../../../include/MLLib/util/system/thread.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifdef WITH_CUDA
@@ -17,7 +25,7 @@
 #include <sys/sysctl.h>
 #endif
 
-#ifdef __linux__
+#if defined(__linux__) || defined(__APPLE__)
 #include <unistd.h>
 #endif
 
@@ -25,25 +33,99 @@ namespace MLLib {
 
 // Forward declarations for helper functions
 namespace {
-bool checkNVIDIAGPU();
-std::string detectNVIDIAGPUName();
-int detectNVIDIAGPUMemoryMB();
-bool checkAMDGPU();
-std::string detectAMDGPUName();
-int detectAMDGPUMemoryMB();
-bool checkIntelGPU();
-std::string detectIntelGPUName();
-int detectIntelGPUMemoryMB();
-#ifdef __APPLE__
-bool checkAppleGPU();
-std::string detectAppleGPUName();
-int detectAppleGPUMemoryMB();
-#endif
+
+/**
+ * @brief Result of a single discovery pass
+ *
+ * A snapshot is replaced as a whole when detection is refreshed, so callers
+ * that still hold the previous one keep a consistent view.
+ */
+struct DetectionSnapshot {
+  std::once_flag once;                ///< Guards the one-time GPU probe
+  std::vector<GPUInfo> gpus;          ///< Detected GPUs
+  std::once_flag numa_once;           ///< Guards the one-time NUMA probe
+  std::vector<NUMANode> numa_nodes;  ///< Detected NUMA nodes
+};
+
+/**
+ * @brief Process-wide discovery configuration and cached results
+ */
+struct DiscoveryState {
+  std::mutex mutex;
+  std::shared_ptr<DetectionSnapshot> snapshot =
+      std::make_shared<DetectionSnapshot>();
+  std::string sysfs_root;  ///< Empty: MLLIB_SYSFS_ROOT or the real root
+  std::string cache_path;  ///< Empty: MLLIB_DEVICE_CACHE or no cache
+};
+
+DiscoveryState& discoveryState() {
+  static DiscoveryState state;
+  return state;
+}
+
+// Process-wide CPU sub-device selection (-1: none)
+std::atomic<int> selected_cpu_node{-1};
+
+// Node the current thread is pinned to (-1: not pinned)
+thread_local int current_thread_node = -1;
+
+/**
+ * @brief Per-node worker pools, created on first use
+ */
+struct NodePools {
+  std::mutex mutex;
+  std::map<int, std::unique_ptr<util::ThreadPool>> pools;
+};
+
+NodePools& nodePools() {
+  static NodePools pools;
+  return pools;
+}
+
+/**
+ * @brief Callbacks notified by Device::setDevice()
+ */
+struct DeviceListeners {
+  std::mutex mutex;
+  std::vector<void (*)(DeviceType)> callbacks;
+};
+
+DeviceListeners& deviceListeners() {
+  static DeviceListeners listeners;
+  return listeners;
+}
+
+std::string effectiveSysfsRoot(const DiscoveryState& state);
+std::string effectiveCachePath(const DiscoveryState& state);
+std::vector<GPUInfo> probeGPUs(const std::string& root);
+std::vector<NUMANode> probeNUMANodes(const std::string& root);
+NUMANode findNUMANode(int node);
+bool readCapabilityCache(const std::string& path, const std::string& root,
+                         std::vector<GPUInfo>& gpus);
+bool writeCapabilityCache(const std::string& path, const std::string& root,
+                          const std::vector<GPUInfo>& gpus);
 }  // namespace
 
 // Static member definition
 DeviceType Device::current_device_ = DeviceType::CPU;
 
+void Device::setDevice(DeviceType device) {
+  current_device_ = device;
+
+  DeviceListeners& listeners = deviceListeners();
+  std::lock_guard<std::mutex> lock(listeners.mutex);
+  for (auto callback : listeners.callbacks) {
+    callback(device);
+  }
+}
+
+void Device::addDeviceChangeListener(void (*listener)(DeviceType)) {
+  DeviceListeners& listeners = deviceListeners();
+  std::lock_guard<std::mutex> lock(listeners.mutex);
+  listeners.callbacks.push_back(listener);
+  listener(current_device_);
+}
+
 bool Device::isGPUAvailable() {
 #ifdef WITH_CUDA
   try {
@@ -61,108 +143,145 @@ bool Device::isGPUAvailable() {
 }
 
 std::vector<GPUInfo> Device::detectGPUs() {
-  std::vector<GPUInfo> gpus;
-
-// Debug: Log detection process in debug builds
+  std::shared_ptr<DetectionSnapshot> snapshot;
+  std::string root;
+  std::string cache_path;
+  {
+    DiscoveryState& state = discoveryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    snapshot = state.snapshot;
+    root = effectiveSysfsRoot(state);
+    cache_path = effectiveCachePath(state);
+  }
+
+  std::call_once(snapshot->once, [&]() {
+    if (!cache_path.empty() &&
+        readCapabilityCache(cache_path, root, snapshot->gpus)) {
 #ifdef DEBUG_GPU_DETECTION
-  printf("🔍 Starting GPU detection process...\n");
+      printf("🔍 Loaded %zu GPU(s) from capability cache %s\n",
+             snapshot->gpus.size(), cache_path.c_str());
 #endif
+      return;
+    }
 
-  // 1. Check NVIDIA GPUs (CUDA) first
-  bool has_nvidia = checkNVIDIAGPU();
-#ifdef DEBUG_GPU_DETECTION
-  printf("🔍 NVIDIA check: %s\n", has_nvidia ? "Found" : "Not found");
-#endif
-  if (has_nvidia) {
-    GPUInfo nvidia_gpu;
-    nvidia_gpu.vendor = GPUVendor::NVIDIA;
-    nvidia_gpu.name = detectNVIDIAGPUName();
-    nvidia_gpu.memory_mb = detectNVIDIAGPUMemoryMB();
-    nvidia_gpu.compute_capable = true;
-#ifdef WITH_CUDA
-    nvidia_gpu.api_support = "CUDA";
-#else
-    nvidia_gpu.api_support = "OpenCL/Metal";
-#endif
-    gpus.push_back(nvidia_gpu);
-#ifdef DEBUG_GPU_DETECTION
-    printf("✅ Added NVIDIA GPU: %s (%d MB)\n", nvidia_gpu.name.c_str(),
-           nvidia_gpu.memory_mb);
-#endif
+    snapshot->gpus = probeGPUs(root);
+
+    if (!cache_path.empty()) {
+      writeCapabilityCache(cache_path, root, snapshot->gpus);
+    }
+  });
+
+  return snapshot->gpus;
+}
+
+void Device::refreshGPUDetection() {
+  DiscoveryState& state = discoveryState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.snapshot = std::make_shared<DetectionSnapshot>();
+}
+
+void Device::setSysfsRoot(const std::string& root) {
+  {
+    DiscoveryState& state = discoveryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.sysfs_root = root;
   }
+  refreshGPUDetection();
+}
 
-  // 2. Check AMD GPUs (ROCm/OpenCL)
-  bool has_amd = checkAMDGPU();
-#ifdef DEBUG_GPU_DETECTION
-  printf("🔍 AMD check: %s\n", has_amd ? "Found" : "Not found");
-#endif
-  if (has_amd) {
-    GPUInfo amd_gpu;
-    amd_gpu.vendor = GPUVendor::AMD;
-    amd_gpu.name = detectAMDGPUName();
-    amd_gpu.memory_mb = detectAMDGPUMemoryMB();
-    amd_gpu.compute_capable = true;
-#ifdef WITH_ROCM
-    amd_gpu.api_support = "ROCm";
-#else
-    amd_gpu.api_support = "OpenCL/Metal";
-#endif
-    gpus.push_back(amd_gpu);
-#ifdef DEBUG_GPU_DETECTION
-    printf("✅ Added AMD GPU: %s (%d MB)\n", amd_gpu.name.c_str(),
-           amd_gpu.memory_mb);
-#endif
+std::string Device::getSysfsRoot() {
+  DiscoveryState& state = discoveryState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return effectiveSysfsRoot(state);
+}
+
+void Device::setCapabilityCachePath(const std::string& path) {
+  {
+    DiscoveryState& state = discoveryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.cache_path = path;
   }
+  refreshGPUDetection();
+}
 
-  // 3. Check Intel GPUs (oneAPI/OpenCL)
-  bool has_intel = checkIntelGPU();
-#ifdef DEBUG_GPU_DETECTION
-  printf("🔍 Intel check: %s\n", has_intel ? "Found" : "Not found");
-#endif
-  if (has_intel) {
-    GPUInfo intel_gpu;
-    intel_gpu.vendor = GPUVendor::INTEL_GPU;
-    intel_gpu.name = detectIntelGPUName();
-    intel_gpu.memory_mb = detectIntelGPUMemoryMB();
-    intel_gpu.compute_capable = true;
-#ifdef WITH_ONEAPI
-    intel_gpu.api_support = "oneAPI";
-#else
-    intel_gpu.api_support = "oneAPI/OpenCL";
-#endif
-    gpus.push_back(intel_gpu);
-#ifdef DEBUG_GPU_DETECTION
-    printf("✅ Added Intel GPU: %s (%d MB)\n", intel_gpu.name.c_str(),
-           intel_gpu.memory_mb);
-#endif
+bool Device::saveCapabilityCache(const std::string& path) {
+  return writeCapabilityCache(path, getSysfsRoot(), detectGPUs());
+}
+
+bool Device::loadCapabilityCache(const std::string& path) {
+  std::vector<GPUInfo> gpus;
+  if (!readCapabilityCache(path, getSysfsRoot(), gpus)) {
+    return false;
   }
 
-  // 4. Check Apple Silicon GPUs (Metal) - only on Apple Silicon
-#ifdef __APPLE__
-  bool has_apple = checkAppleGPU();
-#ifdef DEBUG_GPU_DETECTION
-  printf("🔍 Apple check: %s\n", has_apple ? "Found" : "Not found");
-#endif
-  if (has_apple) {
-    GPUInfo apple_gpu;
-    apple_gpu.vendor = GPUVendor::APPLE;
-    apple_gpu.name = detectAppleGPUName();
-    apple_gpu.memory_mb = detectAppleGPUMemoryMB();
-    apple_gpu.compute_capable = true;
-    apple_gpu.api_support = "Metal";
-    gpus.push_back(apple_gpu);
-#ifdef DEBUG_GPU_DETECTION
-    printf("✅ Added Apple GPU: %s (%d MB)\n", apple_gpu.name.c_str(),
-           apple_gpu.memory_mb);
-#endif
+  auto snapshot = std::make_shared<DetectionSnapshot>();
+  std::call_once(snapshot->once, [&]() { snapshot->gpus = std::move(gpus); });
+
+  DiscoveryState& state = discoveryState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.snapshot = snapshot;
+  return true;
+}
+
+std::vector<NUMANode> Device::detectNUMANodes() {
+  std::shared_ptr<DetectionSnapshot> snapshot;
+  std::string root;
+  {
+    DiscoveryState& state = discoveryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    snapshot = state.snapshot;
+    root = effectiveSysfsRoot(state);
   }
-#endif
 
-#ifdef DEBUG_GPU_DETECTION
-  printf("🔍 Total GPUs detected: %zu\n", gpus.size());
-#endif
+  std::call_once(snapshot->numa_once,
+                 [&]() { snapshot->numa_nodes = probeNUMANodes(root); });
+  return snapshot->numa_nodes;
+}
 
-  return gpus;
+void Device::setCPUNode(int node) {
+  if (node >= 0) {
+    findNUMANode(node);  // validates
+  }
+  selected_cpu_node = node;
+}
+
+int Device::getCPUNode() {
+  return current_thread_node >= 0 ? current_thread_node
+                                  : selected_cpu_node.load();
+}
+
+int Device::getCurrentThreadNode() {
+  return current_thread_node;
+}
+
+void Device::bindCurrentThreadToNode(int node) {
+  if (node < 0) {
+    std::vector<int> all_cpus;
+    for (const auto& numa_node : detectNUMANodes()) {
+      all_cpus.insert(all_cpus.end(), numa_node.cpus.begin(),
+                      numa_node.cpus.end());
+    }
+    util::pin_current_thread(all_cpus);
+    current_thread_node = -1;
+    return;
+  }
+
+  // Pinning is best effort: CPUs that are offline are simply ignored
+  util::pin_current_thread(findNUMANode(node).cpus);
+  current_thread_node = node;
+}
+
+util::ThreadPool& Device::getNodeThreadPool(int node) {
+  NUMANode numa_node = findNUMANode(node);
+
+  NodePools& node_pools = nodePools();
+  std::lock_guard<std::mutex> lock(node_pools.mutex);
+  auto& pool = node_pools.pools[node];
+  if (!pool) {
+    pool = std::make_unique<util::ThreadPool>(
+        numa_node.cpus.size(), [node]() { bindCurrentThreadToNode(node); });
+  }
+  return *pool;
 }
 
 GPUVendor Device::getPrimaryGPUVendor() {
@@ -217,7 +336,7 @@ bool Device::setDeviceWithValidation(DeviceType device, bool show_warnings) {
         printf("   - GPU is being used by another process\n");
 #endif
       }
-      current_device_ = DeviceType::CPU;
+      setDevice(DeviceType::CPU);
       return false;
     } else {
       if (show_warnings) {
@@ -226,7 +345,7 @@ bool Device::setDeviceWithValidation(DeviceType device, bool show_warnings) {
     }
   }
 
-  current_device_ = device;
+  setDevice(device);
   return true;
 }
 
@@ -239,313 +358,508 @@ const char* Device::getDeviceTypeString(DeviceType device) {
   }
 }
 
-// Helper functions for GPU vendor detection with caching
+// Helper functions for GPU discovery
 namespace {
 
-// Cache for GPU detection results
-struct GPUDetectionCache {
-  bool initialized = false;
-  bool nvidia_available = false;
-  bool amd_available = false;
-  bool intel_available = false;
-  std::string system_profiler_output;
+constexpr const char* kCacheMagic = "MLLIB_DEVICE_CACHE 1";
 
-  void initialize() {
-    if (initialized) return;
+// PCI vendor IDs as exposed in sysfs "vendor" files
+constexpr unsigned long kPCIVendorNVIDIA = 0x10de;
+constexpr unsigned long kPCIVendorAMD = 0x1002;
+constexpr unsigned long kPCIVendorIntel = 0x8086;
 
-#ifdef __APPLE__
-    // Get system profiler output once
-    FILE* pipe = popen("system_profiler SPDisplaysDataType 2>/dev/null", "r");
-    if (pipe) {
-      char buffer[4096];
-      while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        system_profiler_output += buffer;
-      }
-      pclose(pipe);
+std::string effectiveSysfsRoot(const DiscoveryState& state) {
+  if (!state.sysfs_root.empty()) {
+    return state.sysfs_root;
+  }
+  const char* env = std::getenv("MLLIB_SYSFS_ROOT");
+  return env ? std::string(env) : std::string();
+}
 
-      // Check for different GPU vendors in cached output
-      std::string lower_output = system_profiler_output;
-      std::transform(lower_output.begin(), lower_output.end(),
-                     lower_output.begin(), ::tolower);
+std::string effectiveCachePath(const DiscoveryState& state) {
+  if (!state.cache_path.empty()) {
+    return state.cache_path;
+  }
+  const char* env = std::getenv("MLLIB_DEVICE_CACHE");
+  return env ? std::string(env) : std::string();
+}
 
-      nvidia_available = (lower_output.find("nvidia") != std::string::npos ||
-                          lower_output.find("geforce") != std::string::npos ||
-                          lower_output.find("quadro") != std::string::npos);
+std::string trim(const std::string& value) {
+  const char* whitespace = " \t\n\r";
+  size_t begin = value.find_first_not_of(whitespace);
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = value.find_last_not_of(whitespace);
+  return value.substr(begin, end - begin + 1);
+}
 
-      amd_available = (lower_output.find("amd") != std::string::npos ||
-                       lower_output.find("radeon") != std::string::npos);
+std::string readFirstLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  if (file.is_open()) {
+    std::getline(file, line);
+  }
+  return trim(line);
+}
 
-      intel_available = (lower_output.find("intel") != std::string::npos);
+bool parseUnsigned(const std::string& text, unsigned long long& value,
+                   int base = 10) {
+  if (text.empty()) {
+    return false;
+  }
+  try {
+    size_t consumed = 0;
+    value = std::stoull(text, &consumed, base);
+    return consumed == text.size();
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+/**
+ * @brief Read "Key: value" from procfs-style files
+ * @return Value with surrounding whitespace removed, empty if absent
+ */
+std::string readKeyValue(const std::string& path, const std::string& key) {
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    size_t colon = line.find(':');
+    if (colon != std::string::npos && trim(line.substr(0, colon)) == key) {
+      return trim(line.substr(colon + 1));
     }
-#endif
-    initialized = true;
   }
-};
+  return "";
+}
 
-static GPUDetectionCache gpu_cache;
+/**
+ * @brief List directory entries in a stable order
+ */
+std::vector<std::string> listDirectory(const std::string& path) {
+  std::vector<std::string> names;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(path, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    names.push_back(it->path().filename().string());
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
 
-bool checkNVIDIAGPU() {
-  gpu_cache.initialize();
-#ifdef __APPLE__
-  return gpu_cache.nvidia_available;
-#endif
+/**
+ * @brief True for DRM card nodes ("card0") but not connectors ("card0-DP-1")
+ */
+bool isDRMCardNode(const std::string& name) {
+  if (name.size() <= 4 || name.compare(0, 4, "card") != 0) {
+    return false;
+  }
+  return std::all_of(name.begin() + 4, name.end(),
+                     [](unsigned char c) { return std::isdigit(c); });
+}
 
-#ifdef __linux__
-  // Check for NVIDIA GPU via nvidia-smi or /proc
-  FILE* pipe = popen("nvidia-smi -L 2>/dev/null", "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
+GPUInfo makeGPUInfo(GPUVendor vendor, const std::string& name,
+                    size_t memory_mb) {
+  GPUInfo info;
+  info.vendor = vendor;
+  info.name = name;
+  info.memory_mb = memory_mb;
+  info.compute_capable = true;
 
-    if (!result.empty() && result.find("GPU") != std::string::npos) {
-      return true;
-    }
+  switch (vendor) {
+  case GPUVendor::NVIDIA:
+#ifdef WITH_CUDA
+    info.api_support = "CUDA";
+#else
+    info.api_support = "OpenCL/Metal";
+#endif
+    break;
+  case GPUVendor::AMD:
+#ifdef WITH_ROCM
+    info.api_support = "ROCm";
+#else
+    info.api_support = "OpenCL/Metal";
+#endif
+    break;
+  case GPUVendor::INTEL_GPU:
+#ifdef WITH_ONEAPI
+    info.api_support = "oneAPI";
+#else
+    info.api_support = "oneAPI/OpenCL";
+#endif
+    break;
+  case GPUVendor::APPLE: info.api_support = "Metal"; break;
+  default: info.api_support = "Unknown"; break;
   }
+  return info;
+}
 
-  // Check for NVIDIA driver
-  std::ifstream proc_modules("/proc/modules");
-  if (proc_modules.is_open()) {
-    std::string line;
-    while (std::getline(proc_modules, line)) {
-      if (line.find("nvidia") != std::string::npos) {
-        return true;
-      }
+/**
+ * @brief Read "MemTotal" in MB from a meminfo file
+ *
+ * Handles both /proc/meminfo and the per-node "Node N MemTotal:" format.
+ */
+size_t readMemTotalMB(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    size_t key = line.find("MemTotal:");
+    if (key != std::string::npos) {
+      unsigned long long kb = 0;
+      std::istringstream value(line.substr(key + 9));
+      value >> kb;
+      return static_cast<size_t>(kb / 1024);
     }
   }
-#endif
-
-#ifdef _WIN32
-  // Windows: Check via nvidia-smi or WMI
-  // TODO: Implement Windows NVIDIA GPU detection
-#endif
+  return 0;
+}
 
-  return false;
+/**
+ * @brief Integrated GPUs share system memory; report a quarter of MemTotal
+ */
+size_t sharedMemoryEstimateMB(const std::string& root) {
+  return readMemTotalMB(root + "/proc/meminfo") / 4;
 }
 
-std::string detectNVIDIAGPUName() {
-#ifdef __APPLE__
-  // Get NVIDIA GPU name from system_profiler on Mac
-  FILE* pipe = popen(
-      "system_profiler SPDisplaysDataType | grep -i 'Chipset Model' | grep -i 'nvidia\\|geforce\\|quadro' | head -1 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
+/**
+ * @brief Discover GPUs from sysfs/procfs below @p root
+ *
+ * NVIDIA devices bound to the proprietary driver are listed under
+ * /proc/driver/nvidia/gpus even on headless nodes without nvidia-drm; every
+ * other GPU is found through the DRM card nodes in /sys/class/drm.
+ */
+std::vector<GPUInfo> probeSysfs(const std::string& root) {
+  std::vector<GPUInfo> gpus;
 
-    if (!result.empty()) {
-      // Extract GPU name from system_profiler output
-      size_t pos = result.find(":");
-      if (pos != std::string::npos) {
-        std::string gpu_name = result.substr(pos + 1);
-        // Remove whitespace and newlines
-        gpu_name.erase(0, gpu_name.find_first_not_of(" \t\n\r"));
-        gpu_name.erase(gpu_name.find_last_not_of(" \t\n\r") + 1);
-        return gpu_name;
-      }
-    }
+  const std::string nvidia_dir = root + "/proc/driver/nvidia/gpus";
+  for (const auto& bus_id : listDirectory(nvidia_dir)) {
+    std::string name =
+        readKeyValue(nvidia_dir + "/" + bus_id + "/information", "Model");
+    // Neither procfs nor sysfs reports NVIDIA VRAM; see fillNVIDIAMemory
+    gpus.push_back(makeGPUInfo(GPUVendor::NVIDIA,
+                               name.empty() ? "NVIDIA GPU" : name, 0));
   }
-#endif
+  const bool nvidia_from_procfs = !gpus.empty();
 
-#ifdef __linux__
-  // Try to get GPU name from nvidia-smi
-  FILE* pipe = popen(
-      "nvidia-smi --query-gpu=name --format=csv,noheader,nounits 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
+  const std::string drm_dir = root + "/sys/class/drm";
+  for (const auto& card : listDirectory(drm_dir)) {
+    if (!isDRMCardNode(card)) {
+      continue;
     }
-    pclose(pipe);
 
-    if (!result.empty()) {
-      // Remove whitespace and newlines
-      result.erase(0, result.find_first_not_of(" \t\n\r"));
-      result.erase(result.find_last_not_of(" \t\n\r") + 1);
-      return result;
+    const std::string device_dir = drm_dir + "/" + card + "/device";
+    unsigned long long vendor_id = 0;
+    if (!parseUnsigned(readFirstLine(device_dir + "/vendor"), vendor_id, 16)) {
+      continue;
     }
-  }
 
-  // Fallback to generic name
-  return "NVIDIA GPU";
-#endif
-  return "NVIDIA GPU";
-}
-
-bool checkAMDGPU() {
-  gpu_cache.initialize();
-#ifdef __APPLE__
-  return gpu_cache.amd_available;
-#endif
+    unsigned long long vram_bytes = 0;
+    bool has_vram = parseUnsigned(
+        readFirstLine(device_dir + "/mem_info_vram_total"), vram_bytes);
+    size_t vram_mb = static_cast<size_t>(vram_bytes / (1024 * 1024));
+    std::string product = readFirstLine(device_dir + "/product_name");
 
-#ifdef __linux__
-  // Check for AMD GPU via lspci or /sys
-  std::ifstream lspci_proc("/proc/bus/pci/devices");
-  if (lspci_proc.is_open()) {
-    std::string line;
-    while (std::getline(lspci_proc, line)) {
-      if (line.find("1002") != std::string::npos) {  // AMD vendor ID
-        return true;
+    switch (vendor_id) {
+    case kPCIVendorNVIDIA:
+      if (!nvidia_from_procfs) {
+        gpus.push_back(makeGPUInfo(GPUVendor::NVIDIA,
+                                   product.empty() ? "NVIDIA GPU" : product,
+                                   has_vram ? vram_mb : 0));
       }
+      break;
+    case kPCIVendorAMD:
+      gpus.push_back(makeGPUInfo(GPUVendor::AMD,
+                                 product.empty() ? "AMD GPU" : product,
+                                 vram_mb));
+      break;
+    case kPCIVendorIntel:
+      gpus.push_back(makeGPUInfo(GPUVendor::INTEL_GPU,
+                                 product.empty() ? "Intel GPU" : product,
+                                 has_vram ? vram_mb
+                                          : sharedMemoryEstimateMB(root)));
+      break;
+    default: break;
     }
   }
 
-  // Check ROCm installation
-  std::ifstream rocm_file("/opt/rocm/bin/rocm-smi");
-  if (rocm_file.good()) {
-    return true;
-  }
-#endif
-
-#ifdef _WIN32
-  // Windows: Check via WMI or device manager
-  // TODO: Implement Windows AMD GPU detection
+#ifdef DEBUG_GPU_DETECTION
+  printf("🔍 sysfs discovery under '%s': %zu GPU(s)\n", root.c_str(),
+         gpus.size());
 #endif
+  return gpus;
+}
 
-  return false;
+/**
+ * @brief Parse a sysfs CPU list such as "0-3,8-11"
+ */
+std::vector<int> parseCPUList(const std::string& list) {
+  std::vector<int> cpus;
+  std::istringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    range = trim(range);
+    if (range.empty()) {
+      continue;
+    }
+    size_t dash = range.find('-');
+    unsigned long long first = 0;
+    unsigned long long last = 0;
+    if (!parseUnsigned(range.substr(0, dash), first)) {
+      continue;
+    }
+    last = first;
+    if (dash != std::string::npos &&
+        !parseUnsigned(range.substr(dash + 1), last)) {
+      continue;
+    }
+    for (unsigned long long cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+  }
+  return cpus;
 }
 
-std::string detectAMDGPUName() {
-#ifdef __APPLE__
-  // Get AMD GPU name from system_profiler on Mac
-  FILE* pipe = popen(
-      "system_profiler SPDisplaysDataType | grep -i 'Chipset Model' | grep -i 'AMD\\|Radeon' | head -1 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
+std::vector<NUMANode> probeNUMANodes(const std::string& root) {
+  std::vector<NUMANode> nodes;
+
+  const std::string node_dir = root + "/sys/devices/system/node";
+  for (const auto& entry : listDirectory(node_dir)) {
+    unsigned long long id = 0;
+    if (entry.compare(0, 4, "node") != 0 ||
+        !parseUnsigned(entry.substr(4), id)) {
+      continue;
     }
-    pclose(pipe);
 
-    if (!result.empty()) {
-      // Extract GPU name from system_profiler output
-      size_t pos = result.find(":");
-      if (pos != std::string::npos) {
-        std::string gpu_name = result.substr(pos + 1);
-        // Remove whitespace and newlines
-        gpu_name.erase(0, gpu_name.find_first_not_of(" \t\n\r"));
-        gpu_name.erase(gpu_name.find_last_not_of(" \t\n\r") + 1);
-        return gpu_name;
-      }
+    NUMANode node;
+    node.id = static_cast<int>(id);
+    node.cpus = parseCPUList(readFirstLine(node_dir + "/" + entry + "/cpulist"));
+    node.memory_mb = readMemTotalMB(node_dir + "/" + entry + "/meminfo");
+    // Memory-only nodes (e.g. CXL expanders) cannot run threads
+    if (!node.cpus.empty()) {
+      nodes.push_back(node);
     }
   }
-#endif
 
-#ifdef __linux__
-  // Try to get GPU name from ROCm
-  FILE* pipe = popen("rocm-smi --showid 2>/dev/null", "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
+  std::sort(nodes.begin(), nodes.end(),
+            [](const NUMANode& a, const NUMANode& b) { return a.id < b.id; });
 
-    if (!result.empty() && result.find("GPU") != std::string::npos) {
-      return "AMD ROCm GPU";
+  if (nodes.empty()) {
+    // No NUMA information: one node holding every CPU
+    NUMANode node;
+    node.id = 0;
+    unsigned int cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int cpu = 0; cpu < cpu_count; ++cpu) {
+      node.cpus.push_back(static_cast<int>(cpu));
     }
+    node.memory_mb = readMemTotalMB(root + "/proc/meminfo");
+    nodes.push_back(node);
   }
+  return nodes;
+}
 
-  // Fallback to generic name
-  return "AMD GPU";
-#endif
-  return "AMD GPU";
+NUMANode findNUMANode(int node) {
+  for (const auto& numa_node : Device::detectNUMANodes()) {
+    if (numa_node.id == node) {
+      return numa_node;
+    }
+  }
+  throw std::invalid_argument("Unknown NUMA node: " + std::to_string(node));
 }
 
-bool checkIntelGPU() {
-  gpu_cache.initialize();
 #ifdef __APPLE__
-  return gpu_cache.intel_available;
+std::vector<GPUInfo> probeApple();
 #endif
 
 #ifdef __linux__
-  // Check for Intel GPU via /sys
-  std::ifstream lspci_proc("/proc/bus/pci/devices");
-  if (lspci_proc.is_open()) {
-    std::string line;
-    while (std::getline(lspci_proc, line)) {
-      if (line.find("8086") != std::string::npos) {  // Intel vendor ID
-        return true;
-      }
-    }
+/**
+ * @brief Fill unknown NVIDIA VRAM sizes from one nvidia-smi query
+ *
+ * The proprietary driver exports no VRAM size in procfs or sysfs. nvidia-smi
+ * lists GPUs in PCI bus order, like the sorted procfs directory, so the n-th
+ * line belongs to the n-th NVIDIA entry. Runs only when some NVIDIA GPU is
+ * still unknown, i.e. at most once per discovery pass.
+ */
+void fillNVIDIAMemory(std::vector<GPUInfo>& gpus) {
+  bool unknown = false;
+  for (const auto& gpu : gpus) {
+    unknown |= gpu.vendor == GPUVendor::NVIDIA && gpu.memory_mb == 0;
+  }
+  if (!unknown) {
+    return;
   }
 
-  // Check for Intel oneAPI/OpenCL
-  std::ifstream oneapi_file(
-      "/opt/intel/oneapi/compiler/latest/linux/bin/intel64/icc");
-  if (oneapi_file.good()) {
-    return true;
+  FILE* pipe = popen("nvidia-smi --query-gpu=memory.total "
+                     "--format=csv,noheader,nounits 2>/dev/null",
+                     "r");
+  if (!pipe) {
+    return;
+  }
+  std::vector<size_t> sizes_mb;
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+    unsigned long long memory_mb = 0;
+    sizes_mb.push_back(parseUnsigned(trim(buffer), memory_mb)
+                           ? static_cast<size_t>(memory_mb)
+                           : 0);
+  }
+  pclose(pipe);
+
+  size_t index = 0;
+  for (auto& gpu : gpus) {
+    if (gpu.vendor != GPUVendor::NVIDIA) {
+      continue;
+    }
+    if (gpu.memory_mb == 0 && index < sizes_mb.size()) {
+      gpu.memory_mb = sizes_mb[index];
+    }
+    ++index;
   }
+}
 #endif
 
-#ifdef _WIN32
-  // Windows: Check for Intel GPU
-  // TODO: Implement Windows Intel GPU detection
+std::vector<GPUInfo> probeGPUs(const std::string& root) {
+#ifdef __APPLE__
+  // A configured root means a fake sysfs tree, which is platform neutral
+  if (root.empty()) {
+    return probeApple();
+  }
+#endif
+  std::vector<GPUInfo> gpus = probeSysfs(root);
+#ifdef __linux__
+  // Only the real system has an nvidia-smi that matches the tree
+  if (root.empty()) {
+    fillNVIDIAMemory(gpus);
+  }
 #endif
+  return gpus;
+}
 
-  return false;
+/**
+ * @brief Identify the current boot so stale caches are ignored after reboot
+ */
+std::string readBootId(const std::string& root) {
+  std::string boot_id = readFirstLine(root + "/proc/sys/kernel/random/boot_id");
+  return boot_id.empty() ? "-" : boot_id;
 }
 
-std::string detectIntelGPUName() {
-#ifdef __APPLE__
-  // Get Intel GPU name from system_profiler on Mac
-  FILE* pipe = popen(
-      "system_profiler SPDisplaysDataType | grep -i 'Chipset Model' | grep -i 'Intel' | head -1 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
+bool readCapabilityCache(const std::string& path, const std::string& root,
+                         std::vector<GPUInfo>& gpus) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kCacheMagic) {
+    return false;
+  }
+  if (!std::getline(file, line) || line != "boot_id " + readBootId(root)) {
+    return false;
+  }
+  if (!std::getline(file, line) || line != "root " + root) {
+    return false;
+  }
+
+  std::vector<GPUInfo> loaded;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
     }
-    pclose(pipe);
 
-    if (!result.empty()) {
-      // Extract GPU name from system_profiler output
-      size_t pos = result.find(":");
-      if (pos != std::string::npos) {
-        std::string gpu_name = result.substr(pos + 1);
-        // Remove whitespace and newlines
-        gpu_name.erase(0, gpu_name.find_first_not_of(" \t\n\r"));
-        gpu_name.erase(gpu_name.find_last_not_of(" \t\n\r") + 1);
-        return gpu_name;
-      }
+    // gpu <TAB> vendor <TAB> memory_mb <TAB> compute <TAB> api <TAB> name
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+      fields.push_back(field);
     }
+
+    unsigned long long vendor = 0;
+    unsigned long long memory_mb = 0;
+    if (fields.size() != 6 || fields[0] != "gpu" ||
+        !parseUnsigned(fields[1], vendor) ||
+        vendor > static_cast<unsigned long long>(GPUVendor::APPLE) ||
+        !parseUnsigned(fields[2], memory_mb) ||
+        (fields[3] != "0" && fields[3] != "1")) {
+      return false;
+    }
+
+    GPUInfo info;
+    info.vendor = static_cast<GPUVendor>(vendor);
+    info.memory_mb = static_cast<size_t>(memory_mb);
+    info.compute_capable = fields[3] == "1";
+    info.api_support = fields[4];
+    info.name = fields[5];
+    loaded.push_back(info);
   }
-#endif
 
-#ifdef __linux__
-  // Try to detect Intel GPU model
-  FILE* pipe = popen("lspci | grep -i intel | grep -i vga 2>/dev/null", "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
+  gpus = std::move(loaded);
+  return true;
+}
+
+bool writeCapabilityCache(const std::string& path, const std::string& root,
+                          const std::vector<GPUInfo>& gpus) {
+  // Write next to the target and rename so concurrent readers never observe
+  // a partially written cache. The temp name is unique per process and call,
+  // so concurrent writers never rename each other's half-written files.
+  static std::atomic<unsigned long> write_counter{0};
+  std::string temp_path = path + ".tmp.";
+#if defined(__linux__) || defined(__APPLE__)
+  temp_path += std::to_string(static_cast<long>(getpid())) + ".";
+#endif
+  temp_path += std::to_string(write_counter.fetch_add(1));
+  {
+    std::ofstream file(temp_path, std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
     }
-    pclose(pipe);
 
-    if (!result.empty()) {
-      return "Intel GPU";
+    file << kCacheMagic << "\n";
+    file << "boot_id " << readBootId(root) << "\n";
+    file << "root " << root << "\n";
+    for (const auto& gpu : gpus) {
+      file << "gpu\t" << static_cast<int>(gpu.vendor) << "\t" << gpu.memory_mb
+           << "\t" << (gpu.compute_capable ? 1 : 0) << "\t" << gpu.api_support
+           << "\t" << gpu.name << "\n";
+    }
+    if (!file.good()) {
+      file.close();
+      std::remove(temp_path.c_str());
+      return false;
     }
   }
-#endif
-  return "Intel GPU";
+
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
 }
 
 #ifdef __APPLE__
+/**
+ * @brief Extract "Chipset Model" entries from system_profiler output
+ */
+std::string findChipsetModel(const std::string& profiler_output,
+                             const std::vector<std::string>& keywords) {
+  std::istringstream stream(profiler_output);
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::string lower = line;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower.find("chipset model") == std::string::npos) {
+      continue;
+    }
+    for (const auto& keyword : keywords) {
+      if (lower.find(keyword) != std::string::npos) {
+        size_t colon = line.find(':');
+        return colon == std::string::npos ? "" : trim(line.substr(colon + 1));
+      }
+    }
+  }
+  return "";
+}
+
 bool checkAppleGPU() {
   // Check for Apple Silicon only (not Intel Macs with discrete GPUs)
   size_t size = 0;
@@ -588,227 +902,55 @@ std::string detectAppleGPUName() {
 
   return "Apple Silicon GPU";
 }
-#else
-bool checkAppleGPU() {
-  return false;  // Apple GPU not available on non-Apple platforms
-}
-
-std::string detectAppleGPUName() {
-  return "Apple GPU";  // Not available on non-Apple platforms
-}
-#endif
-
-int detectNVIDIAGPUMemoryMB() {
-#ifdef __APPLE__
-  // Get NVIDIA GPU VRAM from system_profiler on Mac
-  FILE* pipe = popen(
-      "system_profiler SPDisplaysDataType | grep -A 5 -i 'nvidia\\|geforce\\|quadro' | grep -i 'VRAM\\|Total.*GB' 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
 
-    if (!result.empty()) {
-      // Parse VRAM size from system_profiler output
-      size_t gb_pos = result.find("GB");
-      if (gb_pos != std::string::npos) {
-        // Find number before "GB"
-        size_t start = gb_pos;
-        while (start > 0 &&
-               (result[start - 1] == ' ' || result[start - 1] == ':')) {
-          start--;
-        }
-        while (start > 0 && std::isdigit(result[start - 1])) {
-          start--;
-        }
-        if (start < gb_pos) {
-          std::string gb_str = result.substr(start, gb_pos - start);
-          try {
-            int gb = std::stoi(gb_str);
-            return gb * 1024;  // Convert GB to MB
-          } catch (const std::exception&) {
-            // Ignore parsing errors, continue to return 0
-          }
-        }
-      }
-    }
+size_t systemMemoryMB() {
+  size_t size = sizeof(uint64_t);
+  uint64_t system_memory = 0;
+  if (sysctlbyname("hw.memsize", &system_memory, &size, nullptr, 0) == 0) {
+    return static_cast<size_t>(system_memory / (1024 * 1024));
   }
-#endif
-
-#ifdef __linux__
-#ifdef CI
-  // In CI environment, avoid external command execution
   return 0;
-#else
-  // Try to get VRAM from nvidia-smi
-  FILE* pipe = popen(
-      "nvidia-smi --query-gpu=memory.total --format=csv,noheader,nounits 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
-
-    if (!result.empty()) {
-      // nvidia-smi reports memory in MB
-      try {
-        int memory_mb = std::stoi(result);
-        return memory_mb;
-      } catch (const std::exception&) {
-        // Ignore parsing errors
-      }
-    }
-  }
-#endif
-#endif
-  return 0;  // Unknown or not available
 }
 
-int detectAMDGPUMemoryMB() {
-#ifdef __APPLE__
-  // Get AMD GPU VRAM from system_profiler on Mac
-  FILE* pipe = popen(
-      "system_profiler SPDisplaysDataType | grep -A 5 -i 'AMD\\|Radeon' | grep -i 'VRAM\\|Total.*GB' 2>/dev/null",
-      "r");
-  if (pipe) {
-    char buffer[256];
-    std::string result;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
-    }
-    pclose(pipe);
-
-    if (!result.empty()) {
-      // Parse VRAM size from system_profiler output
-      size_t gb_pos = result.find("GB");
-      if (gb_pos != std::string::npos) {
-        // Find number before "GB"
-        size_t start = gb_pos;
-        while (start > 0 &&
-               (result[start - 1] == ' ' || result[start - 1] == ':')) {
-          start--;
-        }
-        while (start > 0 && std::isdigit(result[start - 1])) {
-          start--;
-        }
-        if (start < gb_pos) {
-          std::string gb_str = result.substr(start, gb_pos - start);
-          try {
-            int gb = std::stoi(gb_str);
-            return gb * 1024;  // Convert GB to MB
-          } catch (const std::exception&) {
-            // Ignore parsing errors, continue to return 0
-          }
-        }
-      }
-    }
-  }
-#endif
+std::vector<GPUInfo> probeApple() {
+  std::vector<GPUInfo> gpus;
 
-#ifdef __linux__
-#ifdef CI
-  // In CI environment, avoid external command execution
-  return 0;
-#else
-  // Try to get VRAM from ROCm
-  FILE* pipe = popen("rocm-smi --showmeminfo vram --csv 2>/dev/null", "r");
+  // macOS has no sysfs; system_profiler is queried once per discovery pass
+  std::string profiler_output;
+  FILE* pipe = popen("system_profiler SPDisplaysDataType 2>/dev/null", "r");
   if (pipe) {
-    char buffer[256];
-    std::string result;
+    char buffer[4096];
     while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-      result += buffer;
+      profiler_output += buffer;
     }
     pclose(pipe);
+  }
 
-    if (!result.empty() && result.find(",") != std::string::npos) {
-      // Parse ROCm memory info
-      size_t pos = result.find_last_of(",");
-      if (pos != std::string::npos) {
-        std::string mem_str = result.substr(pos + 1);
-        // ROCm reports in bytes, convert to MB
-        try {
-          long long bytes = std::stoll(mem_str);
-          return static_cast<int>(bytes / (1024 * 1024));
-        } catch (const std::exception&) {
-          // Ignore parsing errors
-        }
-      }
-    }
+  std::string nvidia = findChipsetModel(profiler_output,
+                                        {"nvidia", "geforce", "quadro"});
+  if (!nvidia.empty()) {
+    gpus.push_back(makeGPUInfo(GPUVendor::NVIDIA, nvidia, 0));
   }
-#endif
-#endif
-  return 0;  // Unknown or not available
-}
 
-int detectIntelGPUMemoryMB() {
-  // Intel integrated GPUs typically use shared system memory
-  // We can report a portion of system RAM as available to Intel GPU
-#ifdef __APPLE__
-  size_t size = sizeof(uint64_t);
-  uint64_t system_memory = 0;
-  if (sysctlbyname("hw.memsize", &system_memory, &size, nullptr, 0) == 0) {
-    // Intel GPU can use about 1/4 to 1/2 of system memory
-    // Report 1/4 as conservative estimate
-    return static_cast<int>((system_memory / 4) /
-                            (1024 * 1024));  // Convert to MB
+  std::string amd = findChipsetModel(profiler_output, {"amd", "radeon"});
+  if (!amd.empty()) {
+    gpus.push_back(makeGPUInfo(GPUVendor::AMD, amd, 0));
   }
-#endif
 
-#ifdef __linux__
-  // Get system memory from /proc/meminfo
-  std::ifstream meminfo("/proc/meminfo");
-  if (meminfo.is_open()) {
-    std::string line;
-    while (std::getline(meminfo, line)) {
-      if (line.find("MemTotal:") != std::string::npos) {
-        size_t pos = line.find_first_of("0123456789");
-        if (pos != std::string::npos) {
-          size_t end = line.find(" kB");
-          if (end != std::string::npos) {
-            std::string mem_kb = line.substr(pos, end - pos);
-            try {
-              int kb = std::stoi(mem_kb);
-              // Report 1/4 of system memory for Intel integrated GPU
-              return (kb / 4) / 1024;  // Convert KB to MB
-            } catch (const std::exception&) {
-              // Ignore parsing errors
-            }
-          }
-        }
-        break;
-      }
-    }
+  std::string intel = findChipsetModel(profiler_output, {"intel"});
+  if (!intel.empty()) {
+    // Intel integrated GPUs share system memory
+    gpus.push_back(
+        makeGPUInfo(GPUVendor::INTEL_GPU, intel, systemMemoryMB() / 4));
   }
-#endif
-  return 0;  // Unknown or not available
-}
 
-#ifdef __APPLE__
-int detectAppleGPUMemoryMB() {
-  // Apple Silicon uses unified memory architecture
-  // The GPU shares system memory with the CPU
-  size_t size = sizeof(uint64_t);
-  uint64_t system_memory = 0;
-  if (sysctlbyname("hw.memsize", &system_memory, &size, nullptr, 0) == 0) {
-    // On Apple Silicon, GPU can access all system memory
-    // But we'll report a reasonable portion for GPU workloads
-    // Typical allocation is about 60-75% of system memory for GPU
-    uint64_t gpu_memory = (system_memory * 3) / 4;  // 75% of system memory
-    return static_cast<int>(gpu_memory / (1024 * 1024));  // Convert to MB
+  if (checkAppleGPU()) {
+    // Unified memory: report 75% of system memory for GPU workloads
+    gpus.push_back(makeGPUInfo(GPUVendor::APPLE, detectAppleGPUName(),
+                               (systemMemoryMB() * 3) / 4));
   }
-  return 0;  // Unknown or not available
-}
-#else
-int detectAppleGPUMemoryMB() {
-  // Apple GPU not available on non-Apple platforms
-  return 0;
+
+  return gpus;
 }
 #endif
 
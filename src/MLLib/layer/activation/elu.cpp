@@ -16,7 +16,14 @@ NDArray ELU::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void ELU::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
+
   const double* input_data = input.data();
   double* output_data = output.data();
 
@@ -27,8 +34,6 @@ NDArray ELU::forward(const NDArray& input) {
       output_data[i] = alpha_ * (std::exp(input_data[i]) - 1.0);
     }
   }
-
-  return output;
 }
 
 NDArray ELU::backward(const NDArray& grad_output) {
@@ -12,7 +12,14 @@ NDArray GELU::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void GELU::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
+
   const double* input_data = input.data();
   double* output_data = output.data();
 
@@ -35,8 +42,6 @@ NDArray GELU::forward(const NDArray& input) {
       output_data[i] = 0.5 * x * (1.0 + std::erf(x / sqrt_2));
     }
   }
-
-  return output;
 }
 
 NDArray GELU::backward(const NDArray& grad_output) {
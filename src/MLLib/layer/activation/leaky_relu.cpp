@@ -15,7 +15,14 @@ NDArray LeakyReLU::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void LeakyReLU::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
+
   const double* input_data = input.data();
   double* output_data = output.data();
 
@@ -26,8 +33,6 @@ NDArray LeakyReLU::forward(const NDArray& input) {
       output_data[i] = alpha_ * input_data[i];
     }
   }
-
-  return output;
 }
 
 NDArray LeakyReLU::backward(const NDArray& grad_output) {
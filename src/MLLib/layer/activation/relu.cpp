@@ -11,13 +11,17 @@ NDArray ReLU::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void ReLU::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
 
   for (size_t i = 0; i < input.size(); ++i) {
     output[i] = std::max(0.0, input[i]);
   }
-
-  return output;
 }
 
 NDArray ReLU::backward(const NDArray& grad_output) {
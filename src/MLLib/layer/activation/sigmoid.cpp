@@ -11,17 +11,19 @@ NDArray Sigmoid::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  last_output_ = output;
+  return output;
+}
+
+void Sigmoid::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
 
   for (size_t i = 0; i < input.size(); ++i) {
     // Sigmoid: 1 / (1 + exp(-x))
     output[i] = 1.0 / (1.0 + std::exp(-input[i]));
   }
-
-  // Cache output for backward pass
-  last_output_ = output;
-
-  return output;
 }
 
 NDArray Sigmoid::backward(const NDArray& grad_output) {
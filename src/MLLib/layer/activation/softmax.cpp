@@ -14,45 +14,39 @@ NDArray Softmax::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  last_output_ = output;
+  return output;
+}
 
+void Softmax::infer(const NDArray& input, NDArray& output) const {
   // For now, implement for 2D arrays (batch_size, features)
   // TODO: Extend to support arbitrary dimensions and axis
   if (input.shape().size() != 2) {
     throw std::invalid_argument("Softmax currently supports only 2D arrays");
   }
 
+  prepare_output(input, output);
+
+  // Subtract the row maximum for numerical stability (log-sum-exp trick)
+  NDArray row_max = input.max(1, true);
   size_t batch_size = input.shape()[0];
   size_t features = input.shape()[1];
 
   const double* input_data = input.data();
+  const double* max_data = row_max.data();
   double* output_data = output.data();
-
   for (size_t batch = 0; batch < batch_size; ++batch) {
     size_t batch_offset = batch * features;
-
-    // Find maximum value for numerical stability (log-sum-exp trick)
-    double max_val = -std::numeric_limits<double>::infinity();
-    for (size_t j = 0; j < features; ++j) {
-      max_val = std::max(max_val, input_data[batch_offset + j]);
-    }
-
-    // Compute exp(x - max) and sum
-    double sum_exp = 0.0;
     for (size_t j = 0; j < features; ++j) {
-      double exp_val = std::exp(input_data[batch_offset + j] - max_val);
-      output_data[batch_offset + j] = exp_val;
-      sum_exp += exp_val;
-    }
-
-    // Normalize
-    for (size_t j = 0; j < features; ++j) {
-      output_data[batch_offset + j] /= sum_exp;
+      output_data[batch_offset + j] =
+          std::exp(input_data[batch_offset + j] - max_data[batch]);
     }
   }
 
-  last_output_ = output;
-  return output;
+  // Normalize
+  output /= output.sum(1, true);
 }
 
 NDArray Softmax::backward(const NDArray& grad_output) {
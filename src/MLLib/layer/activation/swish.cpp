@@ -16,7 +16,14 @@ NDArray Swish::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void Swish::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
+
   const double* input_data = input.data();
   double* output_data = output.data();
 
@@ -25,8 +32,6 @@ NDArray Swish::forward(const NDArray& input) {
     double sigmoid_beta_x = 1.0 / (1.0 + std::exp(-beta_ * x));
     output_data[i] = x * sigmoid_beta_x;
   }
-
-  return output;
 }
 
 NDArray Swish::backward(const NDArray& grad_output) {
@@ -11,13 +11,17 @@ NDArray Tanh::forward(const NDArray& input) {
   last_input_ = input;
   forward_called_ = true;
 
-  NDArray output(input.shape());
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void Tanh::infer(const NDArray& input, NDArray& output) const {
+  prepare_output(input, output);
 
   for (size_t i = 0; i < input.size(); ++i) {
     output[i] = std::tanh(input[i]);
   }
-
-  return output;
 }
 
 NDArray Tanh::backward(const NDArray& grad_output) {
@@ -0,0 +1,389 @@
+#include "MLLib/layer/attention.hpp"
+#include "MLLib/backend/backend.hpp"
+#include "MLLib/util/system/thread.hpp"
+#include "layer_internal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace MLLib {
+namespace layer {
+
+namespace {
+
+// Score evaluations per task below which extra threads are not worth it
+constexpr size_t MIN_SCORES_PER_TASK = 1 << 15;
+
+/**
+ * @brief Layout of one batch of sequences
+ */
+struct Shape {
+  size_t batch = 0;
+  size_t steps = 0;
+  size_t model_dim = 0;
+  size_t heads = 0;
+  size_t head_dim = 0;
+};
+
+/**
+ * @brief Rows of one head's queries, keys and values
+ * @details Row t of head h in sequence b starts at
+ * base + (b * steps + t) * stride + h * head_dim.
+ */
+struct HeadView {
+  const double* queries;
+  const double* keys;
+  const double* values;
+  size_t stride;
+};
+
+/**
+ * @brief Gradient rows of one head, laid out like HeadView
+ */
+struct HeadGradients {
+  double* queries;
+  double* keys;
+  double* values;
+  size_t stride;
+};
+
+double dot(const double* a, const double* b, size_t n) {
+  double sum = 0.0;
+  for (size_t k = 0; k < n; ++k) {
+    sum += a[k] * b[k];
+  }
+  return sum;
+}
+
+void axpy(double alpha, const double* x, double* y, size_t n) {
+  for (size_t k = 0; k < n; ++k) {
+    y[k] += alpha * x[k];
+  }
+}
+
+/**
+ * @brief Keys of block [k0, k0 + kn) that query q may attend to
+ */
+size_t visibleKeys(bool causal, size_t q, size_t k0, size_t kn) {
+  if (!causal) {
+    return kn;
+  }
+  return q < k0 ? 0 : std::min(kn, q - k0 + 1);
+}
+
+/**
+ * @brief Attention of one head of one sequence, block by block
+ * @param out Output rows, stride model_dim
+ * @param log_sums Receives the log-sum-exp of each query's scores
+ */
+void attendHead(const HeadView& head, const Shape& shape, bool causal,
+                size_t block, double* out, double* log_sums) {
+  const size_t steps = shape.steps;
+  const size_t dim = shape.head_dim;
+  const double scale = 1.0 / std::sqrt(static_cast<double>(dim));
+
+  std::vector<double> scores(block);
+  std::vector<double> maxima(block);
+  std::vector<double> sums(block);
+  std::vector<double> acc(block * dim);
+
+  for (size_t q0 = 0; q0 < steps; q0 += block) {
+    const size_t qn = std::min(block, steps - q0);
+    std::fill(maxima.begin(), maxima.end(),
+              -std::numeric_limits<double>::infinity());
+    std::fill(sums.begin(), sums.end(), 0.0);
+    std::fill(acc.begin(), acc.end(), 0.0);
+
+    const size_t key_end = causal ? q0 + qn : steps;
+    for (size_t k0 = 0; k0 < key_end; k0 += block) {
+      const size_t kn = std::min(block, key_end - k0);
+      for (size_t i = 0; i < qn; ++i) {
+        const size_t visible = visibleKeys(causal, q0 + i, k0, kn);
+        if (visible == 0) {
+          continue;
+        }
+        const double* query = head.queries + (q0 + i) * head.stride;
+        double block_max = -std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < visible; ++j) {
+          scores[j] = scale * dot(query, head.keys + (k0 + j) * head.stride,
+                                  dim);
+          block_max = std::max(block_max, scores[j]);
+        }
+
+        // Online softmax: rescale what earlier blocks accumulated
+        const double new_max = std::max(maxima[i], block_max);
+        const double correction = std::exp(maxima[i] - new_max);
+        double* row = acc.data() + i * dim;
+        double sum = sums[i] * correction;
+        for (size_t k = 0; k < dim; ++k) {
+          row[k] *= correction;
+        }
+        for (size_t j = 0; j < visible; ++j) {
+          const double p = std::exp(scores[j] - new_max);
+          sum += p;
+          axpy(p, head.values + (k0 + j) * head.stride, row, dim);
+        }
+        sums[i] = sum;
+        maxima[i] = new_max;
+      }
+    }
+
+    for (size_t i = 0; i < qn; ++i) {
+      const double inverse = 1.0 / sums[i];
+      const double* row = acc.data() + i * shape.head_dim;
+      double* target = out + (q0 + i) * shape.model_dim;
+      for (size_t k = 0; k < dim; ++k) {
+        target[k] = row[k] * inverse;
+      }
+      log_sums[q0 + i] = maxima[i] + std::log(sums[i]);
+    }
+  }
+}
+
+/**
+ * @brief Gradients of one head of one sequence, recomputing the scores
+ * block by block
+ * @param out Attention output rows, stride model_dim
+ * @param grad_out Gradient of the attention output, stride model_dim
+ * @param grad Receives the query, key and value gradients, laid out like
+ * the projections
+ */
+void attendHeadBackward(const HeadView& head, const Shape& shape,
+                        bool causal, size_t block, const double* out,
+                        const double* grad_out, const double* log_sums,
+                        const HeadGradients& grad) {
+  const size_t steps = shape.steps;
+  const size_t dim = shape.head_dim;
+  const double scale = 1.0 / std::sqrt(static_cast<double>(dim));
+
+  // Row sums of grad_out * out, the softmax Jacobian term of each query
+  std::vector<double> deltas(steps);
+  for (size_t t = 0; t < steps; ++t) {
+    deltas[t] = dot(grad_out + t * shape.model_dim,
+                    out + t * shape.model_dim, dim);
+  }
+
+  for (size_t q0 = 0; q0 < steps; q0 += block) {
+    const size_t qn = std::min(block, steps - q0);
+    const size_t key_end = causal ? q0 + qn : steps;
+    for (size_t k0 = 0; k0 < key_end; k0 += block) {
+      const size_t kn = std::min(block, key_end - k0);
+      for (size_t i = 0; i < qn; ++i) {
+        const size_t q = q0 + i;
+        const size_t visible = visibleKeys(causal, q, k0, kn);
+        const double* query = head.queries + q * head.stride;
+        const double* grad_row = grad_out + q * shape.model_dim;
+        double* grad_query = grad.queries + q * grad.stride;
+        for (size_t j = 0; j < visible; ++j) {
+          const size_t k = k0 + j;
+          const double* key = head.keys + k * head.stride;
+          const double p =
+              std::exp(scale * dot(query, key, dim) - log_sums[q]);
+          axpy(p, grad_row, grad.values + k * grad.stride, dim);
+          const double dp = dot(grad_row, head.values + k * head.stride, dim);
+          const double ds = p * (dp - deltas[q]) * scale;
+          axpy(ds, key, grad_query, dim);
+          axpy(ds, query, grad.keys + k * grad.stride, dim);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Run body(b, h) for every sequence and head on the global pool
+ */
+template <typename Body> void forHeads(const Shape& shape, Body body) {
+  const size_t work = shape.steps * shape.steps * shape.head_dim;
+  const size_t min_tasks =
+      std::max<size_t>(1, MIN_SCORES_PER_TASK / std::max<size_t>(1, work));
+  util::ThreadPool::global().parallel_for(
+      0, shape.batch * shape.heads,
+      [&](size_t begin, size_t end) {
+        for (size_t task = begin; task < end; ++task) {
+          body(task / shape.heads, task % shape.heads);
+        }
+      },
+      min_tasks);
+}
+
+void addBias(NDArray& rows, const NDArray& bias) {
+  const size_t width = bias.size();
+  const double* b = bias.data();
+  double* data = rows.data();
+  for (size_t r = 0; r < rows.size() / width; ++r) {
+    for (size_t k = 0; k < width; ++k) {
+      data[r * width + k] += b[k];
+    }
+  }
+}
+
+void sumRows(const NDArray& rows, NDArray& sums) {
+  const size_t width = sums.size();
+  const double* data = rows.data();
+  double* out = sums.data();
+  std::fill(out, out + width, 0.0);
+  for (size_t r = 0; r < rows.size() / width; ++r) {
+    for (size_t k = 0; k < width; ++k) {
+      out[k] += data[r * width + k];
+    }
+  }
+}
+
+}  // namespace
+
+MultiHeadAttention::MultiHeadAttention(size_t model_dim, size_t heads,
+                                       bool causal, size_t block_size)
+    : model_dim_(model_dim), heads_(heads), causal_(causal),
+      block_size_(block_size) {
+  if (model_dim == 0 || heads == 0 || block_size == 0) {
+    throw std::invalid_argument("MultiHeadAttention sizes must be positive");
+  }
+  if (model_dim % heads != 0) {
+    throw std::invalid_argument(
+        "MultiHeadAttention heads must divide model_dim");
+  }
+  // Xavier/Glorot per projection: fan_out is model_dim, not the packed width
+  qkv_weights_ =
+      initialWeights({model_dim, 3 * model_dim}, model_dim, model_dim);
+  qkv_bias_ = zeros({3 * model_dim});
+  output_weights_ =
+      initialWeights({model_dim, model_dim}, model_dim, model_dim);
+  output_bias_ = zeros({model_dim});
+  qkv_weight_gradients_ = zeros({model_dim, 3 * model_dim});
+  qkv_bias_gradients_ = zeros({3 * model_dim});
+  output_weight_gradients_ = zeros({model_dim, model_dim});
+  output_bias_gradients_ = zeros({model_dim});
+}
+
+void MultiHeadAttention::run(const NDArray& input, NDArray& output,
+                             NDArray& inputs, NDArray& qkv, NDArray& context,
+                             NDArray& log_sums) const {
+  const auto& input_shape = input.shape();
+  const size_t batch = input_shape.size() >= 2 ? input_shape[0] : 1;
+  if (input.size() == 0 || batch == 0 || input.size() % batch != 0 ||
+      (input.size() / batch) % model_dim_ != 0) {
+    throw std::invalid_argument(
+        "Attention input rows must hold whole steps of model_dim features");
+  }
+  Shape shape;
+  shape.batch = batch;
+  shape.steps = input.size() / batch / model_dim_;
+  shape.model_dim = model_dim_;
+  shape.heads = heads_;
+  shape.head_dim = model_dim_ / heads_;
+  const size_t rows = batch * shape.steps;
+
+  // Projections of all steps in one GEMM
+  inputs = input;
+  inputs.reshape({rows, model_dim_});
+  Backend::DefaultBackend::matmul(inputs, qkv_weights_, qkv);
+  addBias(qkv, qkv_bias_);
+
+  context = NDArray({rows, model_dim_});
+  log_sums = NDArray({batch * heads_ * shape.steps});
+  const size_t stride = 3 * model_dim_;
+  const double* projections = std::as_const(qkv).data();
+  double* out = context.data();
+  double* sums = log_sums.data();
+  forHeads(shape, [&](size_t b, size_t h) {
+    const double* base =
+        projections + b * shape.steps * stride + h * shape.head_dim;
+    HeadView head{base, base + model_dim_, base + 2 * model_dim_, stride};
+    attendHead(head, shape, causal_, block_size_,
+               out + b * shape.steps * model_dim_ + h * shape.head_dim,
+               sums + (b * heads_ + h) * shape.steps);
+  });
+
+  Backend::DefaultBackend::matmul(context, output_weights_, output);
+  addBias(output, output_bias_);
+  output.reshape(input_shape);
+}
+
+NDArray MultiHeadAttention::forward(const NDArray& input) {
+  NDArray output;
+  run(input, output, last_inputs_, qkv_, context_, log_sums_);
+  last_input_shape_ = input.shape();
+  return output;
+}
+
+void MultiHeadAttention::infer(const NDArray& input, NDArray& output) const {
+  NDArray inputs;
+  NDArray qkv;
+  NDArray context;
+  NDArray log_sums;
+  run(input, output, inputs, qkv, context, log_sums);
+}
+
+NDArray MultiHeadAttention::backward(const NDArray& grad_output) {
+  if (last_input_shape_.empty()) {
+    throw std::runtime_error("backward() called without forward()");
+  }
+  const size_t rows = last_inputs_.shape()[0];
+  if (grad_output.size() != rows * model_dim_) {
+    throw std::invalid_argument(
+        "Attention gradient does not match the last forward output");
+  }
+  Shape shape;
+  shape.batch = last_input_shape_.size() >= 2 ? last_input_shape_[0] : 1;
+  shape.steps = rows / shape.batch;
+  shape.model_dim = model_dim_;
+  shape.heads = heads_;
+  shape.head_dim = model_dim_ / heads_;
+
+  // Output projection
+  NDArray grad_rows = grad_output;
+  grad_rows.reshape({rows, model_dim_});
+  Backend::DefaultBackend::matmul(transposed(context_), grad_rows,
+                                  output_weight_gradients_);
+  sumRows(grad_rows, output_bias_gradients_);
+  NDArray grad_context;
+  Backend::DefaultBackend::matmul(grad_rows, transposed(output_weights_),
+                                  grad_context);
+
+  // Attention, one task per sequence and head
+  const size_t stride = 3 * model_dim_;
+  NDArray grad_qkv = zeros({rows, stride});
+  const double* projections = std::as_const(qkv_).data();
+  const double* out = std::as_const(context_).data();
+  const double* grad_out = std::as_const(grad_context).data();
+  const double* sums = std::as_const(log_sums_).data();
+  double* grad_projections = grad_qkv.data();
+  forHeads(shape, [&](size_t b, size_t h) {
+    const size_t offset = b * shape.steps * stride + h * shape.head_dim;
+    const size_t row_offset =
+        b * shape.steps * model_dim_ + h * shape.head_dim;
+    const double* base = projections + offset;
+    double* grad_base = grad_projections + offset;
+    HeadView head{base, base + model_dim_, base + 2 * model_dim_, stride};
+    HeadGradients grad{grad_base, grad_base + model_dim_,
+                       grad_base + 2 * model_dim_, stride};
+    attendHeadBackward(head, shape, causal_, block_size_, out + row_offset,
+                       grad_out + row_offset,
+                       sums + (b * heads_ + h) * shape.steps, grad);
+  });
+
+  // Input projections
+  Backend::DefaultBackend::matmul(transposed(last_inputs_), grad_qkv,
+                                  qkv_weight_gradients_);
+  sumRows(grad_qkv, qkv_bias_gradients_);
+  NDArray grad_input;
+  Backend::DefaultBackend::matmul(grad_qkv, transposed(qkv_weights_),
+                                  grad_input);
+  grad_input.reshape(last_input_shape_);
+  return grad_input;
+}
+
+std::vector<NDArray*> MultiHeadAttention::get_parameters() {
+  return {&qkv_weights_, &qkv_bias_, &output_weights_, &output_bias_};
+}
+
+std::vector<NDArray*> MultiHeadAttention::get_gradients() {
+  return {&qkv_weight_gradients_, &qkv_bias_gradients_,
+          &output_weight_gradients_, &output_bias_gradients_};
+}
+
+}  // namespace layer
+}  // namespace MLLib
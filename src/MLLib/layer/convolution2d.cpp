@@ -0,0 +1,463 @@
+#include "MLLib/layer/convolution2d.hpp"
+#include "../backend/backend_internal.hpp"
+#include "MLLib/backend/backend.hpp"
+#include "MLLib/util/system/thread.hpp"
+#include "layer_internal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace MLLib {
+namespace layer {
+
+namespace {
+
+// Values copied per task below which extra threads are not worth it
+constexpr size_t MIN_VALUES_PER_TASK = 1 << 15;
+
+/**
+ * @brief Kernel positions over one zero-padded image
+ * @details im2col row (n * positions() + p) holds the receptive field of
+ * position p in image n, ordered by channel, kernel row, kernel column.
+ */
+struct Geometry {
+  ImageShape image;
+  size_t kernel = 1;
+  size_t stride = 1;
+  size_t padding = 0;
+  size_t out_height = 1;
+  size_t out_width = 1;
+
+  size_t patch() const { return image.channels * kernel * kernel; }
+  size_t positions() const { return out_height * out_width; }
+};
+
+size_t minSamplesPerTask(size_t values_per_sample) {
+  return std::max<size_t>(1, MIN_VALUES_PER_TASK /
+                                 std::max<size_t>(1, values_per_sample));
+}
+
+/**
+ * @brief Copy every receptive field of a batch into its own row
+ * @param images Batch [batch, image.size()]
+ * @param rows Output [batch * positions(), patch()]
+ */
+void im2col(const double* images, size_t batch, const Geometry& g,
+            double* rows) {
+  const size_t k = g.kernel;
+  const size_t image_size = g.image.size();
+  const size_t sample_rows = g.positions() * g.patch();
+  util::ThreadPool::global().parallel_for(
+      0, batch,
+      [&](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+          const double* image = images + n * image_size;
+          double* row = rows + n * sample_rows;
+          for (size_t oh = 0; oh < g.out_height; ++oh) {
+            for (size_t ow = 0; ow < g.out_width; ++ow) {
+              for (size_t c = 0; c < g.image.channels; ++c) {
+                const double* plane =
+                    image + c * g.image.height * g.image.width;
+                for (size_t ki = 0; ki < k; ++ki) {
+                  // Padded coordinates; values outside the image are zero
+                  const size_t y = oh * g.stride + ki;
+                  const bool row_inside =
+                      y >= g.padding && y - g.padding < g.image.height;
+                  for (size_t kj = 0; kj < k; ++kj) {
+                    const size_t x = ow * g.stride + kj;
+                    *row++ = row_inside && x >= g.padding &&
+                                     x - g.padding < g.image.width
+                                 ? plane[(y - g.padding) * g.image.width +
+                                         (x - g.padding)]
+                                 : 0.0;
+                  }
+                }
+              }
+            }
+          }
+        }
+      },
+      minSamplesPerTask(sample_rows));
+}
+
+/**
+ * @brief Add every row back to the image positions it was copied from
+ * @param rows Input [batch * positions(), patch()]
+ * @param images Output [batch, image.size()], overwritten
+ */
+void col2im(const double* rows, size_t batch, const Geometry& g,
+            double* images) {
+  const size_t k = g.kernel;
+  const size_t image_size = g.image.size();
+  const size_t sample_rows = g.positions() * g.patch();
+  util::ThreadPool::global().parallel_for(
+      0, batch,
+      [&](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+          double* image = images + n * image_size;
+          const double* row = rows + n * sample_rows;
+          std::fill(image, image + image_size, 0.0);
+          for (size_t oh = 0; oh < g.out_height; ++oh) {
+            for (size_t ow = 0; ow < g.out_width; ++ow) {
+              for (size_t c = 0; c < g.image.channels; ++c) {
+                double* plane = image + c * g.image.height * g.image.width;
+                for (size_t ki = 0; ki < k; ++ki) {
+                  const size_t y = oh * g.stride + ki;
+                  const bool row_inside =
+                      y >= g.padding && y - g.padding < g.image.height;
+                  for (size_t kj = 0; kj < k; ++kj, ++row) {
+                    const size_t x = ow * g.stride + kj;
+                    if (row_inside && x >= g.padding &&
+                        x - g.padding < g.image.width) {
+                      plane[(y - g.padding) * g.image.width +
+                            (x - g.padding)] += *row;
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      },
+      minSamplesPerTask(sample_rows));
+}
+
+/**
+ * @brief Channel-major images [batch, channels, pixels] to rows
+ * [batch * pixels, channels]
+ */
+void toPixelRows(const double* images, size_t batch, size_t channels,
+                 size_t pixels, double* rows) {
+  for (size_t n = 0; n < batch; ++n) {
+    const double* image = images + n * channels * pixels;
+    double* out = rows + n * pixels * channels;
+    for (size_t c = 0; c < channels; ++c) {
+      for (size_t p = 0; p < pixels; ++p) {
+        out[p * channels + c] = image[c * pixels + p];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Rows [batch * pixels, channels] to channel-major images
+ */
+void fromPixelRows(const double* rows, size_t batch, size_t channels,
+                   size_t pixels, double* images) {
+  for (size_t n = 0; n < batch; ++n) {
+    const double* in = rows + n * pixels * channels;
+    double* image = images + n * channels * pixels;
+    for (size_t c = 0; c < channels; ++c) {
+      for (size_t p = 0; p < pixels; ++p) {
+        image[c * pixels + p] = in[p * channels + c];
+      }
+    }
+  }
+}
+
+void addChannelBias(const NDArray& bias, size_t batch, size_t pixels,
+                    double* images) {
+  const size_t channels = bias.size();
+  for (size_t n = 0; n < batch; ++n) {
+    for (size_t c = 0; c < channels; ++c) {
+      double* plane = images + (n * channels + c) * pixels;
+      const double b = bias[c];
+      for (size_t p = 0; p < pixels; ++p) {
+        plane[p] += b;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Sum of channel-major gradients per channel
+ */
+NDArray channelSums(const double* images, size_t batch, size_t channels,
+                    size_t pixels) {
+  NDArray sums({channels});
+  sums.fill(0.0);
+  for (size_t n = 0; n < batch; ++n) {
+    for (size_t c = 0; c < channels; ++c) {
+      const double* plane = images + (n * channels + c) * pixels;
+      double total = 0.0;
+      for (size_t p = 0; p < pixels; ++p) {
+        total += plane[p];
+      }
+      sums[c] += total;
+    }
+  }
+  return sums;
+}
+
+/**
+ * @brief Number of images in a batch
+ * @throws std::invalid_argument unless input holds whole images
+ */
+size_t batchSize(const NDArray& input, const ImageShape& shape) {
+  if (input.size() == 0 || input.size() % shape.size() != 0) {
+    throw std::invalid_argument(
+        "Convolution input must hold whole images of the layer input shape");
+  }
+  return input.size() / shape.size();
+}
+
+}  // namespace
+
+// Conv2D
+
+Conv2D::Conv2D(const ImageShape& input_shape, size_t out_channels,
+               size_t kernel_size, size_t stride, size_t padding,
+               bool use_bias)
+    : input_shape_(input_shape), kernel_size_(kernel_size), stride_(stride),
+      padding_(padding), use_bias_(use_bias) {
+  if (input_shape.size() == 0 || out_channels == 0 || kernel_size == 0 ||
+      stride == 0) {
+    throw std::invalid_argument("Conv2D sizes must be positive");
+  }
+  if (input_shape.height + 2 * padding < kernel_size ||
+      input_shape.width + 2 * padding < kernel_size) {
+    throw std::invalid_argument("Conv2D kernel is larger than padded input");
+  }
+  output_shape_.channels = out_channels;
+  output_shape_.height =
+      (input_shape.height + 2 * padding - kernel_size) / stride + 1;
+  output_shape_.width =
+      (input_shape.width + 2 * padding - kernel_size) / stride + 1;
+
+  const size_t area = kernel_size * kernel_size;
+  const size_t patch = input_shape.channels * area;
+  weights_ = initialWeights({patch, out_channels}, patch, out_channels * area);
+  weight_gradients_ = zeros({patch, out_channels});
+  if (use_bias_) {
+    bias_ = zeros({out_channels});
+    bias_gradients_ = zeros({out_channels});
+  }
+}
+
+void Conv2D::compute(const NDArray& input, NDArray& columns,
+                     NDArray& output) const {
+  const size_t batch = batchSize(input, input_shape_);
+  const Geometry g{input_shape_, kernel_size_, stride_, padding_,
+                   output_shape_.height, output_shape_.width};
+  const size_t positions = g.positions();
+
+  Backend::prepare_output(columns, {batch * positions, g.patch()});
+  im2col(input.data(), batch, g, columns.data());
+
+  // [batch * positions, patch] x [patch, out_channels]
+  NDArray pixels;
+  Backend::DefaultBackend::matmul(columns, weights_, pixels);
+
+  Backend::prepare_output(output, {batch, output_shape_.size()});
+  fromPixelRows(std::as_const(pixels).data(), batch, output_shape_.channels,
+                positions, output.data());
+  if (use_bias_) {
+    addChannelBias(bias_, batch, positions, output.data());
+  }
+}
+
+NDArray Conv2D::forward(const NDArray& input) {
+  NDArray output;
+  compute(input, last_columns_, output);
+  return output;
+}
+
+void Conv2D::infer(const NDArray& input, NDArray& output) const {
+  NDArray columns;
+  compute(input, columns, output);
+}
+
+NDArray Conv2D::backward(const NDArray& grad_output) {
+  const size_t positions = output_shape_.height * output_shape_.width;
+  const size_t out_channels = output_shape_.channels;
+  const size_t batch = last_columns_.size() == 0
+                           ? 0
+                           : last_columns_.shape()[0] / positions;
+  if (batch == 0 || grad_output.size() != batch * output_shape_.size()) {
+    throw std::invalid_argument(
+        "Conv2D gradient does not match the last forward output");
+  }
+
+  const double* grad = grad_output.data();
+  NDArray grad_pixels({batch * positions, out_channels});
+  toPixelRows(grad, batch, out_channels, positions, grad_pixels.data());
+
+  // dW = columns^T x grad_pixels
+  Backend::DefaultBackend::matmul(transposed(last_columns_), grad_pixels,
+                                  weight_gradients_);
+  if (use_bias_) {
+    bias_gradients_ = channelSums(grad, batch, out_channels, positions);
+  }
+
+  // d(columns) = grad_pixels x W^T, scattered back onto the images
+  NDArray grad_columns;
+  Backend::DefaultBackend::matmul(grad_pixels, transposed(weights_),
+                                  grad_columns);
+  const Geometry g{input_shape_, kernel_size_, stride_, padding_,
+                   output_shape_.height, output_shape_.width};
+  NDArray grad_input({batch, input_shape_.size()});
+  col2im(std::as_const(grad_columns).data(), batch, g, grad_input.data());
+  return grad_input;
+}
+
+std::vector<NDArray*> Conv2D::get_parameters() {
+  std::vector<NDArray*> params = {&weights_};
+  if (use_bias_) {
+    params.push_back(&bias_);
+  }
+  return params;
+}
+
+std::vector<NDArray*> Conv2D::get_gradients() {
+  std::vector<NDArray*> grads = {&weight_gradients_};
+  if (use_bias_) {
+    grads.push_back(&bias_gradients_);
+  }
+  return grads;
+}
+
+void Conv2D::set_weights(const NDArray& weights) {
+  checkParameter(weights_, weights);
+  weights_ = weights;
+}
+
+void Conv2D::set_biases(const NDArray& bias) {
+  checkParameter(bias_, bias);
+  bias_ = bias;
+}
+
+// ConvTranspose2D
+
+ConvTranspose2D::ConvTranspose2D(const ImageShape& input_shape,
+                                 size_t out_channels, size_t kernel_size,
+                                 size_t stride, size_t padding,
+                                 size_t output_padding, bool use_bias)
+    : input_shape_(input_shape), kernel_size_(kernel_size), stride_(stride),
+      padding_(padding), output_padding_(output_padding), use_bias_(use_bias) {
+  if (input_shape.size() == 0 || out_channels == 0 || kernel_size == 0 ||
+      stride == 0) {
+    throw std::invalid_argument("ConvTranspose2D sizes must be positive");
+  }
+  if (output_padding >= stride) {
+    throw std::invalid_argument(
+        "ConvTranspose2D output_padding must be less than stride");
+  }
+  const size_t full_height =
+      (input_shape.height - 1) * stride + kernel_size + output_padding;
+  const size_t full_width =
+      (input_shape.width - 1) * stride + kernel_size + output_padding;
+  if (full_height <= 2 * padding || full_width <= 2 * padding) {
+    throw std::invalid_argument("ConvTranspose2D output would be empty");
+  }
+  output_shape_.channels = out_channels;
+  output_shape_.height = full_height - 2 * padding;
+  output_shape_.width = full_width - 2 * padding;
+
+  const size_t area = kernel_size * kernel_size;
+  const size_t patch = out_channels * area;
+  weights_ = initialWeights({input_shape.channels, patch},
+                            input_shape.channels * area, patch);
+  weight_gradients_ = zeros({input_shape.channels, patch});
+  if (use_bias_) {
+    bias_ = zeros({out_channels});
+    bias_gradients_ = zeros({out_channels});
+  }
+}
+
+void ConvTranspose2D::compute(const NDArray& input, NDArray& pixels,
+                              NDArray& output) const {
+  const size_t batch = batchSize(input, input_shape_);
+  const size_t positions = input_shape_.height * input_shape_.width;
+
+  Backend::prepare_output(pixels, {batch * positions, input_shape_.channels});
+  toPixelRows(input.data(), batch, input_shape_.channels, positions,
+              pixels.data());
+
+  // Each input pixel spreads a kernel-sized patch over the output, which is
+  // the Conv2D input gradient with the roles of the images swapped
+  NDArray columns;
+  Backend::DefaultBackend::matmul(pixels, weights_, columns);
+  const Geometry g{output_shape_, kernel_size_, stride_, padding_,
+                   input_shape_.height, input_shape_.width};
+
+  Backend::prepare_output(output, {batch, output_shape_.size()});
+  col2im(std::as_const(columns).data(), batch, g, output.data());
+  if (use_bias_) {
+    addChannelBias(bias_, batch, output_shape_.height * output_shape_.width,
+                   output.data());
+  }
+}
+
+NDArray ConvTranspose2D::forward(const NDArray& input) {
+  NDArray output;
+  compute(input, last_pixels_, output);
+  return output;
+}
+
+void ConvTranspose2D::infer(const NDArray& input, NDArray& output) const {
+  NDArray pixels;
+  compute(input, pixels, output);
+}
+
+NDArray ConvTranspose2D::backward(const NDArray& grad_output) {
+  const size_t positions = input_shape_.height * input_shape_.width;
+  const size_t batch =
+      last_pixels_.size() == 0 ? 0 : last_pixels_.shape()[0] / positions;
+  if (batch == 0 || grad_output.size() != batch * output_shape_.size()) {
+    throw std::invalid_argument(
+        "ConvTranspose2D gradient does not match the last forward output");
+  }
+
+  const double* grad = grad_output.data();
+  const Geometry g{output_shape_, kernel_size_, stride_, padding_,
+                   input_shape_.height, input_shape_.width};
+  NDArray grad_columns({batch * positions, g.patch()});
+  im2col(grad, batch, g, grad_columns.data());
+
+  // dW = pixels^T x grad_columns
+  Backend::DefaultBackend::matmul(transposed(last_pixels_), grad_columns,
+                                  weight_gradients_);
+  if (use_bias_) {
+    bias_gradients_ =
+        channelSums(grad, batch, output_shape_.channels,
+                    output_shape_.height * output_shape_.width);
+  }
+
+  NDArray grad_pixels;
+  Backend::DefaultBackend::matmul(grad_columns, transposed(weights_),
+                                  grad_pixels);
+  NDArray grad_input({batch, input_shape_.size()});
+  fromPixelRows(std::as_const(grad_pixels).data(), batch,
+                input_shape_.channels, positions, grad_input.data());
+  return grad_input;
+}
+
+std::vector<NDArray*> ConvTranspose2D::get_parameters() {
+  std::vector<NDArray*> params = {&weights_};
+  if (use_bias_) {
+    params.push_back(&bias_);
+  }
+  return params;
+}
+
+std::vector<NDArray*> ConvTranspose2D::get_gradients() {
+  std::vector<NDArray*> grads = {&weight_gradients_};
+  if (use_bias_) {
+    grads.push_back(&bias_gradients_);
+  }
+  return grads;
+}
+
+void ConvTranspose2D::set_weights(const NDArray& weights) {
+  checkParameter(weights_, weights);
+  weights_ = weights;
+}
+
+void ConvTranspose2D::set_biases(const NDArray& bias) {
+  checkParameter(bias_, bias);
+  bias_ = bias;
+}
+
+}  // namespace layer
+}  // namespace MLLib
@@ -1,7 +1,9 @@
 #include "MLLib/layer/dense.hpp"
 #include "MLLib/backend/backend.hpp"
+#include "MLLib/util/misc/random.hpp"
 #include <cmath>
-#include <random>
+#include <stdexcept>
+#include <utility>
 
 using namespace std;
 
@@ -16,30 +18,67 @@ Dense::Dense(size_t input_size, size_t output_size, bool use_bias)
 NDArray Dense::forward(const NDArray& input) {
   // Cache input for backward pass
   last_input_ = input;
+  sparse_input_ = false;
+  compressed_ = false;
 
+  NDArray output;
+  infer(input, output);
+  return output;
+}
+
+void Dense::infer(const NDArray& input, NDArray& output) const {
   // Input shape: [batch_size, input_size]
   // Weights shape: [input_size, output_size]
   // Output shape: [batch_size, output_size]
 
-  NDArray output = input.matmul(weights_);
+  if (compressed_) {
+    compressed_weights_.left_multiply(input, output);
+  } else {
+    Backend::DefaultBackend::matmul(input, weights_, output);
+  }
 
   if (use_bias_) {
     // Add bias to each sample in the batch
-    const auto& shape = output.shape();
-    size_t batch_size = shape[0];
-    size_t output_size = shape[1];
-
-    for (size_t i = 0; i < batch_size; ++i) {
-      for (size_t j = 0; j < output_size; ++j) {
-        output.at({i, j}) += bias_[j];
-      }
-    }
+    output += bias_;
   }
+}
+
+NDArray Dense::forward(const SparseMatrix& input) {
+  // The weight gradient needs only X^T, which stays sparse
+  last_input_transposed_ = input.transpose();
+  last_input_ = NDArray();
+  sparse_input_ = true;
+  compressed_ = false;
 
+  NDArray output;
+  infer(input, output);
   return output;
 }
 
+void Dense::infer(const SparseMatrix& input, NDArray& output) const {
+  if (input.cols() != input_size_) {
+    throw std::invalid_argument(
+        "Sparse input width must match the layer input size");
+  }
+
+  input.matmul(weights_, output);
+
+  if (use_bias_) {
+    output += bias_;
+  }
+}
+
 NDArray Dense::backward(const NDArray& grad_output) {
+  if (sparse_input_) {
+    // weight_gradients = X^T * grad_output over the stored entries of X
+    last_input_transposed_.matmul(grad_output, weight_gradients_);
+    if (use_bias_) {
+      bias_gradients_ = grad_output.sum(0);
+    }
+    // The input is data, so no gradient is propagated to it
+    return NDArray();
+  }
+
   // grad_output shape: [batch_size, output_size]
   // weights shape: [input_size, output_size]
   // last_input shape: [batch_size, input_size]
@@ -55,28 +94,20 @@ NDArray Dense::backward(const NDArray& grad_output) {
   size_t input_size = input_shape[1];
 
   NDArray input_transposed({input_size, batch_size});
+  const double* input_data = std::as_const(last_input_).data();
+  double* transposed = input_transposed.data();
   for (size_t i = 0; i < input_size; ++i) {
     for (size_t j = 0; j < batch_size; ++j) {
-      input_transposed.at({i, j}) = last_input_.at({j, i});
+      transposed[i * batch_size + j] = input_data[j * input_size + i];
     }
   }
 
-  weight_gradients_ = input_transposed.matmul(grad_output);
+  Backend::DefaultBackend::matmul(input_transposed, grad_output,
+                                  weight_gradients_);
 
   // Compute gradient w.r.t. bias: sum over batch dimension
   if (use_bias_) {
-    const auto& grad_shape = grad_output.shape();
-    size_t batch_size = grad_shape[0];
-    size_t output_size = grad_shape[1];
-
-    bias_gradients_ = NDArray({output_size});
-    for (size_t j = 0; j < output_size; ++j) {
-      double sum = 0.0;
-      for (size_t i = 0; i < batch_size; ++i) {
-        sum += grad_output.at({i, j});
-      }
-      bias_gradients_[j] = sum;
-    }
+    bias_gradients_ = grad_output.sum(0);
   }
 
   // Compute gradient w.r.t. input: grad_output * weights^T
@@ -86,18 +117,24 @@ NDArray Dense::backward(const NDArray& grad_output) {
 
   // Transpose weights
   NDArray weights_transposed({output_size_, input_size_});
+  const double* weights = std::as_const(weights_).data();
+  double* weights_t = weights_transposed.data();
   for (size_t i = 0; i < output_size_; ++i) {
     for (size_t j = 0; j < input_size_; ++j) {
-      weights_transposed.at({i, j}) = weights_.at({j, i});
+      weights_t[i * input_size_ + j] = weights[j * output_size_ + i];
     }
   }
 
-  NDArray grad_input = grad_output.matmul(weights_transposed);
+  NDArray grad_input;
+  Backend::DefaultBackend::matmul(grad_output, weights_transposed, grad_input);
 
   return grad_input;
 }
 
 std::vector<NDArray*> Dense::get_parameters() {
+  // The caller may update the weights through the returned pointers
+  compressed_ = false;
+
   std::vector<NDArray*> params;
   params.push_back(&weights_);
   if (use_bias_) {
@@ -106,21 +143,45 @@ std::vector<NDArray*> Dense::get_parameters() {
   return params;
 }
 
+std::vector<NDArray*> Dense::get_gradients() {
+  std::vector<NDArray*> grads;
+  grads.push_back(&weight_gradients_);
+  if (use_bias_) {
+    grads.push_back(&bias_gradients_);
+  }
+  return grads;
+}
+
+void Dense::set_weights(const NDArray& weights) {
+  weights_ = weights;
+  compressed_ = false;
+}
+
+void Dense::compress_weights(size_t block_rows, size_t block_cols) {
+  compressed_weights_ =
+      BlockSparseMatrix::from_dense(weights_, block_rows, block_cols);
+  compressed_ = true;
+}
+
+void Dense::set_compressed_weights(const BlockSparseMatrix& weights) {
+  if (weights.rows() != input_size_ || weights.cols() != output_size_) {
+    throw std::invalid_argument(
+        "Compressed weights must have shape [input_size, output_size]");
+  }
+  weights_ = weights.to_dense();
+  compressed_weights_ = weights;
+  compressed_ = true;
+}
+
 void Dense::initialize_parameters() {
   // Xavier/Glorot initialization
-  std::random_device rd;
-  std::mt19937 gen(rd());
-
   double limit = std::sqrt(6.0 / (input_size_ + output_size_));
-  std::uniform_real_distribution<double> dis(-limit, limit);
 
-  // Initialize weights
+  // Initialize weights; each layer draws from its own stream of the global
+  // seed, so a seeded run reproduces the same model
   weights_ = NDArray({input_size_, output_size_});
-  for (size_t i = 0; i < input_size_; ++i) {
-    for (size_t j = 0; j < output_size_; ++j) {
-      weights_.at({i, j}) = dis(gen);
-    }
-  }
+  util::Random::next_stream().uniform(weights_.data(), weights_.size(), -limit,
+                                      limit);
 
   // Initialize gradients
   weight_gradients_ = NDArray({input_size_, output_size_});
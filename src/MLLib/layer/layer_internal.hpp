@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file layer_internal.hpp
+ * @brief Internal helpers shared by the layer implementations
+ */
+
+#include "MLLib/ndarray.hpp"
+#include "MLLib/util/misc/random.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace layer {
+
+/**
+ * @brief Transpose of a 2-D array
+ */
+inline NDArray transposed(const NDArray& matrix) {
+  const size_t rows = matrix.shape()[0];
+  const size_t cols = matrix.shape()[1];
+  NDArray result({cols, rows});
+  const double* in = matrix.data();
+  double* out = result.data();
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      out[j * rows + i] = in[i * cols + j];
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Check that a replacement parameter has the shape of the current one
+ * @throws std::invalid_argument if the shapes differ
+ */
+inline void checkParameter(const NDArray& current,
+                           const NDArray& replacement) {
+  if (replacement.shape() != current.shape()) {
+    throw std::invalid_argument("Parameter shape does not match the layer");
+  }
+}
+
+/**
+ * @brief Xavier/Glorot uniform initialization, like Dense
+ * @details Draws from the next RNG stream, so every call is independent of
+ * the threads used elsewhere.
+ */
+inline NDArray initialWeights(const std::vector<size_t>& shape, size_t fan_in,
+                              size_t fan_out) {
+  const double limit =
+      std::sqrt(6.0 / static_cast<double>(fan_in + fan_out));
+  NDArray weights(shape);
+  util::Random::next_stream().uniform(weights.data(), weights.size(), -limit,
+                                      limit);
+  return weights;
+}
+
+/**
+ * @brief Zero-filled array of the given shape
+ */
+inline NDArray zeros(const std::vector<size_t>& shape) {
+  NDArray array(shape);
+  array.fill(0.0);
+  return array;
+}
+
+}  // namespace layer
+}  // namespace MLLib
@@ -0,0 +1,134 @@
+#include "MLLib/layer/pruning.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace layer {
+
+namespace {
+
+void checkSparsity(double sparsity) {
+  if (!(sparsity >= 0.0 && sparsity <= 1.0)) {
+    throw std::invalid_argument("Pruning sparsity must be in [0, 1]");
+  }
+}
+
+/**
+ * @brief Indices of the k smallest scores
+ */
+std::vector<size_t> smallest(const std::vector<double>& scores, size_t k) {
+  std::vector<size_t> order(scores.size());
+  std::iota(order.begin(), order.end(), size_t(0));
+  std::nth_element(order.begin(), order.begin() + k, order.end(),
+                   [&](size_t a, size_t b) { return scores[a] < scores[b]; });
+  order.resize(k);
+  return order;
+}
+
+size_t pruneCount(double sparsity, size_t total) {
+  return static_cast<size_t>(std::round(sparsity * static_cast<double>(total)));
+}
+
+}  // namespace
+
+double weight_sparsity(const Dense& layer) {
+  const NDArray& weights = layer.get_weights();
+  if (weights.size() == 0) {
+    return 0.0;
+  }
+  const double* w = weights.data();
+  const size_t zeros = std::count(w, w + weights.size(), 0.0);
+  return static_cast<double>(zeros) / static_cast<double>(weights.size());
+}
+
+double prune_magnitude(Dense& layer, double sparsity) {
+  checkSparsity(sparsity);
+  NDArray weights = layer.get_weights();
+  double* w = weights.data();
+
+  std::vector<double> magnitude(weights.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    magnitude[i] = std::abs(w[i]);
+  }
+  for (size_t i : smallest(magnitude, pruneCount(sparsity, weights.size()))) {
+    w[i] = 0.0;
+  }
+
+  layer.set_weights(weights);
+  return weight_sparsity(layer);
+}
+
+double prune_n_m(Dense& layer, size_t n, size_t m) {
+  if (m == 0 || n > m) {
+    throw std::invalid_argument("N:M pruning requires 0 < m and n <= m");
+  }
+  NDArray weights = layer.get_weights();
+  const size_t inputs = weights.shape()[0];
+  const size_t outputs = weights.shape()[1];
+  double* w = weights.data();
+
+  std::vector<double> group;
+  for (size_t col = 0; col < outputs; ++col) {
+    for (size_t start = 0; start < inputs; start += m) {
+      // A trailing partial group keeps at most n weights as well
+      const size_t size = std::min(m, inputs - start);
+      if (size <= n) {
+        continue;
+      }
+      group.resize(size);
+      for (size_t k = 0; k < size; ++k) {
+        group[k] = std::abs(w[(start + k) * outputs + col]);
+      }
+      for (size_t k : smallest(group, size - n)) {
+        w[(start + k) * outputs + col] = 0.0;
+      }
+    }
+  }
+
+  layer.set_weights(weights);
+  return weight_sparsity(layer);
+}
+
+double prune_blocks(Dense& layer, size_t block_rows, size_t block_cols,
+                    double sparsity) {
+  if (block_rows == 0 || block_cols == 0) {
+    throw std::invalid_argument("Block sizes must be positive");
+  }
+  checkSparsity(sparsity);
+  NDArray weights = layer.get_weights();
+  const size_t rows = weights.shape()[0];
+  const size_t cols = weights.shape()[1];
+  const size_t block_row_count = (rows + block_rows - 1) / block_rows;
+  const size_t block_col_count = (cols + block_cols - 1) / block_cols;
+  double* w = weights.data();
+
+  // Visit the elements of block b, clipped at the matrix edges
+  auto for_block = [&](size_t b, auto&& visit) {
+    const size_t row0 = (b / block_col_count) * block_rows;
+    const size_t col0 = (b % block_col_count) * block_cols;
+    const size_t row_end = std::min(rows, row0 + block_rows);
+    const size_t col_end = std::min(cols, col0 + block_cols);
+    for (size_t r = row0; r < row_end; ++r) {
+      for (size_t c = col0; c < col_end; ++c) {
+        visit(w[r * cols + c]);
+      }
+    }
+  };
+
+  std::vector<double> norms(block_row_count * block_col_count, 0.0);
+  for (size_t b = 0; b < norms.size(); ++b) {
+    for_block(b, [&](double& v) { norms[b] += v * v; });
+  }
+  for (size_t b : smallest(norms, pruneCount(sparsity, norms.size()))) {
+    for_block(b, [](double& v) { v = 0.0; });
+  }
+
+  layer.set_weights(weights);
+  return weight_sparsity(layer);
+}
+
+}  // namespace layer
+}  // namespace MLLib
@@ -0,0 +1,573 @@
+#include "MLLib/layer/recurrent.hpp"
+#include "MLLib/backend/backend.hpp"
+#include "MLLib/util/system/thread.hpp"
+#include "layer_internal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace MLLib {
+namespace layer {
+
+namespace {
+
+// Gate values updated per task below which extra threads are not worth it
+constexpr size_t MIN_VALUES_PER_TASK = 1 << 14;
+
+double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+/**
+ * @brief Batch size and number of steps of a sequence batch
+ */
+struct Sequence {
+  size_t batch = 0;
+  size_t steps = 0;
+};
+
+/**
+ * @throws std::invalid_argument unless every row holds whole steps
+ */
+Sequence sequenceOf(const NDArray& input, size_t features) {
+  const auto& shape = input.shape();
+  const size_t batch = shape.size() >= 2 ? shape[0] : 1;
+  if (input.size() == 0 || batch == 0 || input.size() % batch != 0 ||
+      (input.size() / batch) % features != 0) {
+    throw std::invalid_argument(
+        "Recurrent input rows must hold whole steps of input_size features");
+  }
+  return {batch, input.size() / batch / features};
+}
+
+/**
+ * @brief Run body(begin, end) over batch rows on the global thread pool
+ */
+template <typename Body>
+void forRows(size_t batch, size_t values_per_row, Body body) {
+  const size_t min_rows = std::max<size_t>(
+      1, MIN_VALUES_PER_TASK / std::max<size_t>(1, values_per_row));
+  util::ThreadPool::global().parallel_for(0, batch, body, min_rows);
+}
+
+}  // namespace
+
+// Recurrent
+
+Recurrent::Recurrent(size_t input_size, size_t hidden_size, size_t gates,
+                     size_t cache_width, bool cell_state,
+                     bool return_sequences, size_t bptt_steps)
+    : input_size_(input_size), hidden_size_(hidden_size), gates_(gates),
+      cache_width_(cache_width), cell_state_(cell_state),
+      return_sequences_(return_sequences), bptt_steps_(bptt_steps) {
+  if (input_size == 0 || hidden_size == 0) {
+    throw std::invalid_argument("Recurrent layer sizes must be positive");
+  }
+  const size_t packed = gates * hidden_size;
+  // Xavier/Glorot per gate: fan_out is one gate's width, not the packed one
+  input_weights_ =
+      initialWeights({input_size, packed}, input_size, hidden_size);
+  recurrent_weights_ =
+      initialWeights({hidden_size, packed}, hidden_size, hidden_size);
+  bias_ = zeros({packed});
+  input_weight_gradients_ = zeros({input_size, packed});
+  recurrent_weight_gradients_ = zeros({hidden_size, packed});
+  bias_gradients_ = zeros({packed});
+}
+
+void Recurrent::run(const NDArray& input, NDArray& output, bool training,
+                    NDArray& inputs, std::vector<NDArray>& hidden,
+                    std::vector<NDArray>& cells, NDArray& cache) const {
+  const Sequence seq = sequenceOf(input, input_size_);
+  const size_t batch = seq.batch;
+  const size_t steps = seq.steps;
+  const size_t hidden_size = hidden_size_;
+  const size_t packed = gates_ * hidden_size;
+  const size_t cache_row = cache_width_ * hidden_size;
+
+  // Time-major copy, so the rows of each step are contiguous
+  inputs = NDArray({steps * batch, input_size_});
+  const double* in = input.data();
+  double* rows = inputs.data();
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t t = 0; t < steps; ++t) {
+      std::copy(in + (b * steps + t) * input_size_,
+                in + (b * steps + t + 1) * input_size_,
+                rows + (t * batch + b) * input_size_);
+    }
+  }
+
+  // Input projections of all steps in one GEMM
+  NDArray projections;
+  Backend::DefaultBackend::matmul(inputs, input_weights_, projections);
+
+  // Training keeps every state for backward; inference alternates two
+  const size_t states = training ? steps + 1 : 2;
+  hidden.assign(states, NDArray());
+  hidden[0] = zeros({batch, hidden_size});
+  for (size_t s = 1; s < states; ++s) {
+    hidden[s] = NDArray({batch, hidden_size});
+  }
+  cells.clear();
+  if (cell_state_) {
+    cells.assign(states, NDArray());
+    cells[0] = zeros({batch, hidden_size});
+    for (size_t s = 1; s < states; ++s) {
+      cells[s] = NDArray({batch, hidden_size});
+    }
+  }
+  cache = NDArray({(training ? steps : 1) * batch, cache_row});
+
+  std::vector<size_t> output_shape;
+  if (!return_sequences_) {
+    output_shape = {batch, hidden_size};
+  } else if (input.shape().size() == 3) {
+    output_shape = {batch, steps, hidden_size};
+  } else {
+    output_shape = {batch, steps * hidden_size};
+  }
+  if (output.shape() != output_shape) {
+    output = NDArray(output_shape);
+  }
+
+  NDArray recurrent;
+  for (size_t t = 0; t < steps; ++t) {
+    const size_t prev = training ? t : t % 2;
+    const size_t next = training ? t + 1 : (t + 1) % 2;
+
+    // One packed GEMM for the recurrent projections of all gates
+    Backend::DefaultBackend::matmul(hidden[prev], recurrent_weights_,
+                                    recurrent);
+
+    const double* x = std::as_const(projections).data() + t * batch * packed;
+    const double* h = std::as_const(recurrent).data();
+    const double* h_prev = std::as_const(hidden[prev]).data();
+    const double* c_prev =
+        cell_state_ ? std::as_const(cells[prev]).data() : nullptr;
+    double* step_cache = cache.data() + (training ? t * batch * cache_row : 0);
+    double* h_next = hidden[next].data();
+    double* c_next = cell_state_ ? cells[next].data() : nullptr;
+    forRows(batch, packed, [&](size_t begin, size_t end) {
+      step(begin, end, x, h, h_prev, c_prev, step_cache, h_next, c_next);
+    });
+
+    if (return_sequences_) {
+      double* out = output.data();
+      for (size_t b = 0; b < batch; ++b) {
+        std::copy(h_next + b * hidden_size, h_next + (b + 1) * hidden_size,
+                  out + (b * steps + t) * hidden_size);
+      }
+    }
+  }
+
+  if (!return_sequences_) {
+    const double* last = std::as_const(hidden[steps % states]).data();
+    std::copy(last, last + batch * hidden_size, output.data());
+  }
+}
+
+NDArray Recurrent::forward(const NDArray& input) {
+  NDArray output;
+  run(input, output, true, last_inputs_, hidden_states_, cell_states_,
+      step_cache_);
+  last_input_shape_ = input.shape();
+  return output;
+}
+
+void Recurrent::infer(const NDArray& input, NDArray& output) const {
+  NDArray inputs;
+  std::vector<NDArray> hidden;
+  std::vector<NDArray> cells;
+  NDArray cache;
+  run(input, output, false, inputs, hidden, cells, cache);
+}
+
+NDArray Recurrent::backward(const NDArray& grad_output) {
+  if (hidden_states_.size() < 2) {
+    throw std::runtime_error("backward() called without forward()");
+  }
+  const size_t steps = hidden_states_.size() - 1;
+  const size_t batch = hidden_states_[0].shape()[0];
+  const size_t hidden_size = hidden_size_;
+  const size_t packed = gates_ * hidden_size;
+  const size_t cache_row = cache_width_ * hidden_size;
+  if (grad_output.size() !=
+      batch * hidden_size * (return_sequences_ ? steps : 1)) {
+    throw std::invalid_argument(
+        "Recurrent gradient does not match the last forward output");
+  }
+
+  // Gate gradients of all steps; truncated steps stay zero
+  NDArray grad_x = zeros({steps * batch, packed});
+  NDArray grad_h = zeros({steps * batch, packed});
+  NDArray grad_step({batch, packed});
+  NDArray carry = zeros({batch, hidden_size});  ///< dL/dh from later steps
+  NDArray dh({batch, hidden_size});
+  NDArray dh_direct({batch, hidden_size});
+  NDArray dc = zeros({batch, hidden_size});
+  const NDArray recurrent_t = transposed(recurrent_weights_);
+
+  // With only the last output, nothing reaches steps beyond the window
+  const size_t window = bptt_steps_ > 0 ? bptt_steps_ : steps;
+  const size_t first =
+      !return_sequences_ && steps > window ? steps - window : 0;
+
+  const double* grad = grad_output.data();
+  for (size_t t = steps; t-- > first;) {
+    const double* later = std::as_const(carry).data();
+    double* dh_data = dh.data();
+    for (size_t b = 0; b < batch; ++b) {
+      for (size_t j = 0; j < hidden_size; ++j) {
+        double g = later[b * hidden_size + j];
+        if (return_sequences_) {
+          g += grad[(b * steps + t) * hidden_size + j];
+        } else if (t + 1 == steps) {
+          g += grad[b * hidden_size + j];
+        }
+        dh_data[b * hidden_size + j] = g;
+      }
+    }
+
+    const double* step_cache =
+        std::as_const(step_cache_).data() + t * batch * cache_row;
+    const double* h_prev = std::as_const(hidden_states_[t]).data();
+    const double* c_prev =
+        cell_state_ ? std::as_const(cell_states_[t]).data() : nullptr;
+    const double* c_next =
+        cell_state_ ? std::as_const(cell_states_[t + 1]).data() : nullptr;
+    const double* dh_in = std::as_const(dh).data();
+    double* dc_data = cell_state_ ? dc.data() : nullptr;
+    double* dx = grad_x.data() + t * batch * packed;
+    double* dhp = grad_step.data();
+    double* dh_prev = dh_direct.data();
+    forRows(batch, packed, [&](size_t begin, size_t end) {
+      step_backward(begin, end, step_cache, h_prev, c_prev, c_next, dh_in,
+                    dc_data, dx, dhp, dh_prev);
+    });
+    std::copy(std::as_const(grad_step).data(),
+              std::as_const(grad_step).data() + batch * packed,
+              grad_h.data() + t * batch * packed);
+
+    // Truncation: no gradient crosses a window boundary
+    if (t == 0 || (steps - t) % window == 0) {
+      carry.fill(0.0);
+      dc.fill(0.0);
+    } else {
+      Backend::DefaultBackend::matmul(grad_step, recurrent_t, carry);
+      Backend::DefaultBackend::axpy(1.0, dh_direct, carry);
+    }
+  }
+
+  // Weight gradients over all steps at once
+  NDArray previous({steps * batch, hidden_size});
+  for (size_t t = 0; t < steps; ++t) {
+    const double* h = std::as_const(hidden_states_[t]).data();
+    std::copy(h, h + batch * hidden_size,
+              previous.data() + t * batch * hidden_size);
+  }
+  Backend::DefaultBackend::matmul(transposed(last_inputs_), grad_x,
+                                  input_weight_gradients_);
+  Backend::DefaultBackend::matmul(transposed(previous), grad_h,
+                                  recurrent_weight_gradients_);
+  bias_gradients_.fill(0.0);
+  const double* gx = std::as_const(grad_x).data();
+  double* gb = bias_gradients_.data();
+  for (size_t r = 0; r < steps * batch; ++r) {
+    for (size_t k = 0; k < packed; ++k) {
+      gb[k] += gx[r * packed + k];
+    }
+  }
+
+  // Input gradient in one GEMM, then back to the batch-major layout
+  NDArray grad_rows;
+  Backend::DefaultBackend::matmul(grad_x, transposed(input_weights_),
+                                  grad_rows);
+  NDArray grad_input(last_input_shape_);
+  const double* rows = std::as_const(grad_rows).data();
+  double* out = grad_input.data();
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t t = 0; t < steps; ++t) {
+      std::copy(rows + (t * batch + b) * input_size_,
+                rows + (t * batch + b + 1) * input_size_,
+                out + (b * steps + t) * input_size_);
+    }
+  }
+  return grad_input;
+}
+
+std::vector<NDArray*> Recurrent::get_parameters() {
+  return {&input_weights_, &recurrent_weights_, &bias_};
+}
+
+std::vector<NDArray*> Recurrent::get_gradients() {
+  return {&input_weight_gradients_, &recurrent_weight_gradients_,
+          &bias_gradients_};
+}
+
+void Recurrent::set_input_weights(const NDArray& weights) {
+  checkParameter(input_weights_, weights);
+  input_weights_ = weights;
+}
+
+void Recurrent::set_recurrent_weights(const NDArray& weights) {
+  checkParameter(recurrent_weights_, weights);
+  recurrent_weights_ = weights;
+}
+
+void Recurrent::set_biases(const NDArray& bias) {
+  checkParameter(bias_, bias);
+  bias_ = bias;
+}
+
+// LSTM
+
+LSTM::LSTM(size_t input_size, size_t hidden_size, bool return_sequences,
+           size_t bptt_steps)
+    : Recurrent(input_size, hidden_size, 4, 4, true, return_sequences,
+                bptt_steps) {
+  double* forget = bias_.data() + hidden_size;
+  std::fill(forget, forget + hidden_size, 1.0);
+}
+
+void LSTM::step(size_t begin, size_t end, const double* x, const double* h,
+                const double* h_prev, const double* c_prev, double* cache,
+                double* h_next, double* c_next) const {
+  (void)h_prev;
+  const size_t n = hidden_size_;
+  const double* bias = std::as_const(bias_).data();
+  for (size_t b = begin; b < end; ++b) {
+    const double* xb = x + b * 4 * n;
+    const double* hb = h + b * 4 * n;
+    const double* cp = c_prev + b * n;
+    double* gates = cache + b * 4 * n;
+    double* hn = h_next + b * n;
+    double* cn = c_next + b * n;
+    // All four gates and the state update in one pass over the units
+    for (size_t j = 0; j < n; ++j) {
+      const double i = sigmoid(xb[j] + hb[j] + bias[j]);
+      const double f = sigmoid(xb[n + j] + hb[n + j] + bias[n + j]);
+      const double g =
+          std::tanh(xb[2 * n + j] + hb[2 * n + j] + bias[2 * n + j]);
+      const double o =
+          sigmoid(xb[3 * n + j] + hb[3 * n + j] + bias[3 * n + j]);
+      const double c = f * cp[j] + i * g;
+      cn[j] = c;
+      hn[j] = o * std::tanh(c);
+      gates[j] = i;
+      gates[n + j] = f;
+      gates[2 * n + j] = g;
+      gates[3 * n + j] = o;
+    }
+  }
+}
+
+void LSTM::step_backward(size_t begin, size_t end, const double* cache,
+                         const double* h_prev, const double* c_prev,
+                         const double* c_next, const double* dh, double* dc,
+                         double* dx, double* dhp, double* dh_prev) const {
+  (void)h_prev;
+  const size_t n = hidden_size_;
+  for (size_t b = begin; b < end; ++b) {
+    const double* gates = cache + b * 4 * n;
+    const double* cp = c_prev + b * n;
+    const double* cn = c_next + b * n;
+    const double* dhb = dh + b * n;
+    double* dcb = dc + b * n;
+    double* dxb = dx + b * 4 * n;
+    double* dhpb = dhp + b * 4 * n;
+    for (size_t j = 0; j < n; ++j) {
+      const double i = gates[j];
+      const double f = gates[n + j];
+      const double g = gates[2 * n + j];
+      const double o = gates[3 * n + j];
+      const double tc = std::tanh(cn[j]);
+      const double dcell = dcb[j] + dhb[j] * o * (1.0 - tc * tc);
+      dxb[j] = dcell * g * i * (1.0 - i);
+      dxb[n + j] = dcell * cp[j] * f * (1.0 - f);
+      dxb[2 * n + j] = dcell * i * (1.0 - g * g);
+      dxb[3 * n + j] = dhb[j] * tc * o * (1.0 - o);
+      dcb[j] = dcell * f;
+    }
+    // Every gate reads h_prev only through the recurrent weights
+    std::copy(dxb, dxb + 4 * n, dhpb);
+    std::fill(dh_prev + b * n, dh_prev + (b + 1) * n, 0.0);
+  }
+}
+
+// GRU
+
+GRU::GRU(size_t input_size, size_t hidden_size, bool return_sequences,
+         size_t bptt_steps)
+    : Recurrent(input_size, hidden_size, 3, 4, false, return_sequences,
+                bptt_steps) {}
+
+void GRU::step(size_t begin, size_t end, const double* x, const double* h,
+               const double* h_prev, const double* c_prev, double* cache,
+               double* h_next, double* c_next) const {
+  (void)c_prev;
+  (void)c_next;
+  const size_t n = hidden_size_;
+  const double* bias = std::as_const(bias_).data();
+  for (size_t b = begin; b < end; ++b) {
+    const double* xb = x + b * 3 * n;
+    const double* hb = h + b * 3 * n;
+    const double* hp = h_prev + b * n;
+    double* saved = cache + b * 4 * n;
+    double* hn = h_next + b * n;
+    for (size_t j = 0; j < n; ++j) {
+      const double r = sigmoid(xb[j] + hb[j] + bias[j]);
+      const double z = sigmoid(xb[n + j] + hb[n + j] + bias[n + j]);
+      const double hc = hb[2 * n + j];
+      const double c = std::tanh(xb[2 * n + j] + bias[2 * n + j] + r * hc);
+      hn[j] = (1.0 - z) * c + z * hp[j];
+      saved[j] = r;
+      saved[n + j] = z;
+      saved[2 * n + j] = c;
+      saved[3 * n + j] = hc;
+    }
+  }
+}
+
+void GRU::step_backward(size_t begin, size_t end, const double* cache,
+                        const double* h_prev, const double* c_prev,
+                        const double* c_next, const double* dh, double* dc,
+                        double* dx, double* dhp, double* dh_prev) const {
+  (void)c_prev;
+  (void)c_next;
+  (void)dc;
+  const size_t n = hidden_size_;
+  for (size_t b = begin; b < end; ++b) {
+    const double* saved = cache + b * 4 * n;
+    const double* hp = h_prev + b * n;
+    const double* dhb = dh + b * n;
+    double* dxb = dx + b * 3 * n;
+    double* dhpb = dhp + b * 3 * n;
+    double* dhd = dh_prev + b * n;
+    for (size_t j = 0; j < n; ++j) {
+      const double r = saved[j];
+      const double z = saved[n + j];
+      const double c = saved[2 * n + j];
+      const double hc = saved[3 * n + j];
+      const double dcand = dhb[j] * (1.0 - z) * (1.0 - c * c);
+      const double dr = dcand * hc * r * (1.0 - r);
+      const double dz = dhb[j] * (hp[j] - c) * z * (1.0 - z);
+      dxb[j] = dr;
+      dxb[n + j] = dz;
+      dxb[2 * n + j] = dcand;
+      dhpb[j] = dr;
+      dhpb[n + j] = dz;
+      dhpb[2 * n + j] = dcand * r;
+      dhd[j] = dhb[j] * z;
+    }
+  }
+}
+
+// RepeatVector
+
+RepeatVector::RepeatVector(size_t steps) : steps_(steps) {
+  if (steps == 0) {
+    throw std::invalid_argument("RepeatVector needs at least one step");
+  }
+}
+
+NDArray RepeatVector::forward(const NDArray& input) {
+  NDArray output;
+  infer(input, output);
+  features_ = output.shape()[1] / steps_;
+  return output;
+}
+
+void RepeatVector::infer(const NDArray& input, NDArray& output) const {
+  const size_t batch = input.shape().size() >= 2 ? input.shape()[0] : 1;
+  const size_t features = batch > 0 ? input.size() / batch : 0;
+  const std::vector<size_t> shape = {batch, steps_ * features};
+  if (output.shape() != shape) {
+    output = NDArray(shape);
+  }
+  const double* in = input.data();
+  double* out = output.data();
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t t = 0; t < steps_; ++t) {
+      std::copy(in + b * features, in + (b + 1) * features,
+                out + (b * steps_ + t) * features);
+    }
+  }
+}
+
+NDArray RepeatVector::backward(const NDArray& grad_output) {
+  const size_t row = steps_ * features_;
+  if (row == 0 || grad_output.size() % row != 0) {
+    throw std::invalid_argument(
+        "RepeatVector gradient does not match the last forward output");
+  }
+  const size_t batch = grad_output.size() / row;
+  NDArray grad_input = zeros({batch, features_});
+  const double* grad = grad_output.data();
+  double* out = grad_input.data();
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t t = 0; t < steps_; ++t) {
+      const double* g = grad + (b * steps_ + t) * features_;
+      for (size_t f = 0; f < features_; ++f) {
+        out[b * features_ + f] += g[f];
+      }
+    }
+  }
+  return grad_input;
+}
+
+// TimeDistributed
+
+TimeDistributed::TimeDistributed(std::shared_ptr<BaseLayer> layer,
+                                 size_t features)
+    : layer_(std::move(layer)), features_(features) {
+  if (!layer_ || features == 0) {
+    throw std::invalid_argument(
+        "TimeDistributed needs a layer and a positive step size");
+  }
+}
+
+NDArray TimeDistributed::forward(const NDArray& input) {
+  const Sequence seq = sequenceOf(input, features_);
+  NDArray steps = input;
+  steps.reshape({seq.batch * seq.steps, features_});
+  NDArray output = layer_->forward(steps);
+  output.reshape({seq.batch, output.size() / seq.batch});
+  last_batch_ = seq.batch;
+  last_rows_ = seq.batch * seq.steps;
+  return output;
+}
+
+void TimeDistributed::infer(const NDArray& input, NDArray& output) const {
+  const Sequence seq = sequenceOf(input, features_);
+  NDArray steps = input;
+  steps.reshape({seq.batch * seq.steps, features_});
+  layer_->infer(steps, output);
+  output.reshape({seq.batch, output.size() / seq.batch});
+}
+
+NDArray TimeDistributed::backward(const NDArray& grad_output) {
+  if (last_rows_ == 0 || grad_output.size() % last_rows_ != 0) {
+    throw std::invalid_argument(
+        "TimeDistributed gradient does not match the last forward output");
+  }
+  NDArray grad = grad_output;
+  grad.reshape({last_rows_, grad_output.size() / last_rows_});
+  NDArray grad_input = layer_->backward(grad);
+  grad_input.reshape({last_batch_, grad_input.size() / last_batch_});
+  return grad_input;
+}
+
+std::vector<NDArray*> TimeDistributed::get_parameters() {
+  return layer_->get_parameters();
+}
+
+std::vector<NDArray*> TimeDistributed::get_gradients() {
+  return layer_->get_gradients();
+}
+
+void TimeDistributed::set_training(bool training) {
+  BaseLayer::set_training(training);
+  layer_->set_training(training);
+}
+
+}  // namespace layer
+}  // namespace MLLib
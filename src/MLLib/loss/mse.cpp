@@ -1,4 +1,5 @@
 #include "../../../include/MLLib/loss/mse.hpp"
+#include "../../../include/MLLib/ndarray_expr.hpp"
 #include <cmath>
 #include <stdexcept>
 
@@ -12,16 +13,8 @@ double MSELoss::compute_loss(const NDArray& predictions,
         "Predictions and targets must have the same shape");
   }
 
-  double total_loss = 0.0;
-  size_t total_elements = predictions.size();
-
-  for (size_t i = 0; i < total_elements; ++i) {
-    double diff = predictions[i] - targets[i];
-    total_loss += diff * diff;
-  }
-
-  // Return mean squared error
-  return total_loss / total_elements;
+  // Mean squared error in one pass, without a difference array
+  return expr::mean(expr::square(expr::lazy(predictions) - targets));
 }
 
 NDArray MSELoss::compute_gradient(const NDArray& predictions,
@@ -31,15 +24,8 @@ NDArray MSELoss::compute_gradient(const NDArray& predictions,
         "Predictions and targets must have the same shape");
   }
 
-  NDArray gradient(predictions.shape());
-  size_t total_elements = predictions.size();
-
-  for (size_t i = 0; i < total_elements; ++i) {
-    // Gradient of MSE: 2 * (predictions - targets) / n
-    gradient[i] = 2.0 * (predictions[i] - targets[i]) / total_elements;
-  }
-
-  return gradient;
+  // Gradient of MSE: 2 * (predictions - targets) / n
+  return (expr::lazy(predictions) - targets) * (2.0 / predictions.size());
 }
 
 }  // namespace loss
@@ -1,12 +1,31 @@
 #include "MLLib/model/autoencoder/anomaly_detector.hpp"
+#include "MLLib/util/number/stats.hpp"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace MLLib {
 namespace model {
 namespace autoencoder {
 
+namespace {
+
+// Windows reconstructed per call when scoring a series
+constexpr size_t SCORE_BATCH = 256;
+
+void checkWindowSize(const data::WindowDataset& windows, int input_dim) {
+  if (windows.sample_size() != static_cast<size_t>(input_dim)) {
+    throw std::invalid_argument(
+        "Windows of " + std::to_string(windows.sample_size()) +
+        " values do not match input_dim " + std::to_string(input_dim));
+  }
+}
+
+}  // namespace
+
 AnomalyDetector::AnomalyDetector(const AutoencoderConfig& config,
                                  const AnomalyConfig& anomaly_config)
     : BaseAutoencoder(config), anomaly_config_(anomaly_config), threshold_(0.0),
@@ -48,6 +67,21 @@ void AnomalyDetector::train_on_normal(
         callback);
 }
 
+void AnomalyDetector::train_on_normal(
+    const data::WindowDataset& normal_windows, loss::BaseLoss& loss,
+    optimizer::BaseOptimizer& optimizer, int epochs, int batch_size,
+    std::function<void(int, double, double)> callback) {
+  checkWindowSize(normal_windows, get_input_dim());
+  fit(
+      normal_windows.size(),
+      [&](size_t i, size_t* count) {
+        data::WindowView window = normal_windows[i];
+        *count = window.size();
+        return window.data;
+      },
+      loss, optimizer, epochs, batch_size, nullptr, callback);
+}
+
 void AnomalyDetector::calculate_threshold(
     const std::vector<NDArray>& normal_data) {
   std::vector<double> errors;
@@ -57,6 +91,16 @@ void AnomalyDetector::calculate_threshold(
     errors.push_back(error);
   }
 
+  threshold_from_errors(errors);
+}
+
+void AnomalyDetector::calculate_threshold(
+    const data::WindowDataset& normal_windows) {
+  threshold_from_errors(window_errors(normal_windows, 0));
+}
+
+void AnomalyDetector::threshold_from_errors(
+    const std::vector<double>& errors) {
   if (anomaly_config_.threshold_method == "percentile") {
     threshold_ = calculate_percentile_threshold(errors);
   } else if (anomaly_config_.threshold_method == "std") {
@@ -71,6 +115,49 @@ void AnomalyDetector::calculate_threshold(
 AnomalyResults
 AnomalyDetector::detect_anomalies(const std::vector<NDArray>& test_data,
                                   const std::vector<bool>* ground_truth) {
+  std::vector<double> errors;
+  for (const auto& sample : test_data) {
+    errors.push_back(
+        reconstruction_error(sample, anomaly_config_.error_metric));
+  }
+  return flag_errors(std::move(errors), ground_truth);
+}
+
+AnomalyResults
+AnomalyDetector::detect_anomalies(const data::WindowDataset& windows,
+                                  size_t first,
+                                  const std::vector<bool>* ground_truth) {
+  return flag_errors(window_errors(windows, first), ground_truth);
+}
+
+std::vector<double>
+AnomalyDetector::window_errors(const data::WindowDataset& windows,
+                               size_t first) {
+  checkWindowSize(windows, get_input_dim());
+  const std::string& metric = anomaly_config_.error_metric;
+  if (metric != "mse" && metric != "mae" && metric != "rmse") {
+    throw std::invalid_argument("Unknown reconstruction error metric: " +
+                                metric);
+  }
+
+  std::vector<double> errors;
+  NDArray batch;
+  for (size_t begin = first; begin < windows.size(); begin += SCORE_BATCH) {
+    const size_t end = std::min(windows.size(), begin + SCORE_BATCH);
+    windows.gather(begin, end, batch);
+    NDArray reconstruction = reconstruct(batch);
+    std::vector<double> batch_errors =
+        metric == "mse"   ? util::mse(batch, reconstruction)
+        : metric == "mae" ? util::mae(batch, reconstruction)
+                          : util::rmse(batch, reconstruction);
+    errors.insert(errors.end(), batch_errors.begin(), batch_errors.end());
+  }
+  return errors;
+}
+
+AnomalyResults
+AnomalyDetector::flag_errors(std::vector<double> errors,
+                             const std::vector<bool>* ground_truth) {
   AnomalyResults results;
 
   if (!threshold_calculated_) {
@@ -79,10 +166,9 @@ AnomalyDetector::detect_anomalies(const std::vector<NDArray>& test_data,
   }
 
   results.threshold = threshold_;
+  results.reconstruction_errors = std::move(errors);
 
-  for (const auto& sample : test_data) {
-    double error = reconstruction_error(sample, anomaly_config_.error_metric);
-    results.reconstruction_errors.push_back(error);
+  for (double error : results.reconstruction_errors) {
     results.anomaly_flags.push_back(error > threshold_);
   }
 
@@ -4,18 +4,72 @@
 #include "MLLib/model/autoencoder/base.hpp"
 #include "MLLib/model/model_io.hpp"
 #include "MLLib/util/misc/random.hpp"
+#include "MLLib/util/number/stats.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
-#include <random>
+#include <numeric>
+#include <stdexcept>
 
 namespace MLLib {
 namespace model {
 namespace autoencoder {
 
+namespace {
+
+/**
+ * @brief Store the parameters of the layers other than Dense, e.g.
+ * convolutional or recurrent ones
+ * @details Dense layers keep their own keys with shape information.
+ */
+void serializeOtherLayers(
+    const Sequential& network, const std::string& prefix,
+    std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+  const auto& layers = network.get_layers();
+  for (size_t i = 0; i < layers.size(); ++i) {
+    if (dynamic_cast<layer::Dense*>(layers[i].get())) {
+      continue;
+    }
+    auto params = layers[i]->get_parameters();
+    for (size_t p = 0; p < params.size(); ++p) {
+      const uint8_t* bytes =
+          reinterpret_cast<const uint8_t*>(params[p]->data());
+      data[prefix + "_param_" + std::to_string(i) + "_" + std::to_string(p)] =
+          std::vector<uint8_t>(bytes,
+                               bytes + params[p]->size() * sizeof(double));
+    }
+  }
+}
+
+bool deserializeOtherLayers(
+    Sequential& network, const std::string& prefix,
+    const std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+  const auto& layers = network.get_layers();
+  for (size_t i = 0; i < layers.size(); ++i) {
+    if (dynamic_cast<layer::Dense*>(layers[i].get())) {
+      continue;
+    }
+    auto params = layers[i]->get_parameters();
+    for (size_t p = 0; p < params.size(); ++p) {
+      auto it = data.find(prefix + "_param_" + std::to_string(i) + "_" +
+                          std::to_string(p));
+      if (it == data.end() ||
+          it->second.size() != params[p]->size() * sizeof(double)) {
+        std::cerr << "Parameters of " << prefix << " layer " << i
+                  << " not found" << std::endl;
+        return false;
+      }
+      std::memcpy(params[p]->data(), it->second.data(), it->second.size());
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 // AutoencoderConfig static methods
 AutoencoderConfig
 AutoencoderConfig::basic(int input_dim, int latent_dim,
@@ -47,7 +101,8 @@ AutoencoderConfig::denoising(int input_dim, int latent_dim, double noise_factor,
 
 // BaseAutoencoder implementation
 BaseAutoencoder::BaseAutoencoder()
-    : BaseModel(ModelType::AUTOENCODER_DENSE), config_() {
+    : BaseModel(ModelType::AUTOENCODER_DENSE), config_(),
+      rng_(util::Random::next_stream()) {
   // Default minimal configuration
   config_.encoder_dims = {1, 1};
   config_.decoder_dims = {1, 1};
@@ -56,7 +111,8 @@ BaseAutoencoder::BaseAutoencoder()
 }
 
 BaseAutoencoder::BaseAutoencoder(const AutoencoderConfig& config)
-    : BaseModel(ModelType::AUTOENCODER_DENSE), config_(config) {
+    : BaseModel(ModelType::AUTOENCODER_DENSE), config_(config),
+      rng_(util::Random::next_stream()) {
   initialize();
 }
 
@@ -77,68 +133,136 @@ NDArray BaseAutoencoder::decode(const NDArray& latent) {
 }
 
 NDArray BaseAutoencoder::reconstruct(const NDArray& input) {
-  NDArray noisy_input = add_noise(input);
-  NDArray latent = encode(noisy_input);
+  // Noise is a training-time corruption only; train() applies it
+  NDArray latent = encode(input);
   return decode(latent);
 }
 
+std::vector<NDArray>
+BaseAutoencoder::encode(const std::vector<NDArray>& inputs) {
+  return encoder_->predict(inputs);
+}
+
+std::vector<NDArray>
+BaseAutoencoder::decode(const std::vector<NDArray>& latents) {
+  return decoder_->predict(latents);
+}
+
+std::vector<NDArray>
+BaseAutoencoder::reconstruct(const std::vector<NDArray>& inputs) {
+  return decode(encode(inputs));
+}
+
 void BaseAutoencoder::train(const std::vector<NDArray>& training_data,
                             loss::BaseLoss& loss,
                             optimizer::BaseOptimizer& optimizer, int epochs,
                             int batch_size,
                             const std::vector<NDArray>* validation_data,
                             std::function<void(int, double, double)> callback) {
+  const size_t features = static_cast<size_t>(get_input_dim());
+  for (const auto& sample : training_data) {
+    if (sample.size() % features != 0) {
+      throw std::invalid_argument(
+          "Training samples must have input_dim features per row");
+    }
+  }
+
+  std::function<double()> validation_loss;
+  if (validation_data && !validation_data->empty()) {
+    validation_loss = [&]() {
+      std::vector<NDArray> reconstructions = reconstruct(*validation_data);
+      double total = 0.0;
+      for (size_t i = 0; i < validation_data->size(); ++i) {
+        total += loss.compute_loss(reconstructions[i], (*validation_data)[i]);
+      }
+      return total / validation_data->size();
+    };
+  }
+
+  fit(
+      training_data.size(),
+      [&](size_t i, size_t* count) {
+        *count = training_data[i].size();
+        return training_data[i].data();
+      },
+      loss, optimizer, epochs, batch_size, validation_loss, callback);
+}
+
+void BaseAutoencoder::fit(
+    size_t count, const SampleSource& sample, loss::BaseLoss& loss,
+    optimizer::BaseOptimizer& optimizer, int epochs, int batch_size,
+    const std::function<double()>& validation_loss,
+    const std::function<void(int, double, double)>& callback) {
+  if (count == 0) {
+    return;
+  }
+
+  const size_t features = static_cast<size_t>(get_input_dim());
+  const size_t step = static_cast<size_t>(std::max(batch_size, 1));
+
+  std::vector<NDArray*> params;
+  std::vector<NDArray*> grads;
+  collect_trainable(*encoder_, &params, &grads);
+  collect_trainable(*decoder_, &params, &grads);
 
-  // Get all parameters from both encoder and decoder
-  auto encoder_params = get_parameters();
+  std::vector<size_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  // Mini-batch buffers, reallocated only when the batch size changes
+  NDArray clean_batch;
+  NDArray noisy_batch;
 
   for (int epoch = 0; epoch < epochs; ++epoch) {
     double total_loss = 0.0;
     int num_batches = 0;
 
     // Shuffle training data
-    std::vector<size_t> indices(training_data.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::shuffle(indices.begin(), indices.end(),
-                 std::mt19937{std::random_device{}()});
+    std::shuffle(indices.begin(), indices.end(), rng_);
 
     // Process batches
-    for (size_t i = 0; i < training_data.size(); i += batch_size) {
-      size_t batch_end = std::min(i + batch_size, training_data.size());
-
-      // Create batch
-      std::vector<NDArray> batch_inputs;
-      for (size_t j = i; j < batch_end; ++j) {
-        batch_inputs.push_back(training_data[indices[j]]);
+    for (size_t begin = 0; begin < indices.size(); begin += step) {
+      size_t end = std::min(indices.size(), begin + step);
+
+      size_t values = 0;
+      for (size_t i = begin; i < end; ++i) {
+        size_t size = 0;
+        sample(indices[i], &size);
+        values += size;
+      }
+      if (values % features != 0) {
+        throw std::invalid_argument(
+            "Training samples must have input_dim features per row");
+      }
+      if (clean_batch.size() != values) {
+        clean_batch = NDArray({values / features, features});
+        noisy_batch = NDArray({values / features, features});
       }
 
-      // Forward pass
-      double batch_loss = 0.0;
-      for (const auto& input : batch_inputs) {
-        NDArray noisy_input = add_noise(input);
-        NDArray reconstruction = reconstruct(noisy_input);
-        batch_loss += loss.compute_loss(reconstruction, input);
+      // Gather the batch; the noisy copy is the first layer's input and is
+      // corrupted as it is written
+      size_t offset = 0;
+      for (size_t i = begin; i < end; ++i) {
+        size_t size = 0;
+        const double* source = sample(indices[i], &size);
+        std::copy(source, source + size, clean_batch.data() + offset);
+        corrupt(source, noisy_batch.data() + offset, size);
+        offset += size;
       }
-      batch_loss /= batch_inputs.size();
 
-      // Backward pass - simplified for demonstration
-      // In practice, you'd compute gradients properly
+      NDArray reconstruction =
+          forward_layers(*decoder_, forward_layers(*encoder_, noisy_batch));
+      total_loss += loss.compute_loss(reconstruction, clean_batch);
 
-      total_loss += batch_loss;
+      backward_layers(
+          *encoder_,
+          backward_layers(*decoder_,
+                          loss.compute_gradient(reconstruction, clean_batch)));
+      optimizer.update(params, grads);
       num_batches++;
     }
 
     double avg_loss = total_loss / num_batches;
-    double val_loss = 0.0;
-
-    // Validation
-    if (validation_data) {
-      for (const auto& val_input : *validation_data) {
-        NDArray reconstruction = reconstruct(val_input);
-        val_loss += loss.compute_loss(reconstruction, val_input);
-      }
-      val_loss /= validation_data->size();
-    }
+    double val_loss = validation_loss ? validation_loss() : 0.0;
 
     // Callback
     if (callback) {
@@ -151,19 +275,17 @@ double BaseAutoencoder::reconstruction_error(const NDArray& input,
                                              const std::string& metric) {
   NDArray reconstruction = reconstruct(input);
 
-  // Calculate error based on metric
+  // Rows of a batched input count equally
   if (metric == "mse") {
-    // MSE calculation would go here
-    return 0.0;  // Placeholder
+    return util::mean(util::mse(input, reconstruction));
   } else if (metric == "mae") {
-    // MAE calculation would go here
-    return 0.0;  // Placeholder
+    return util::mean(util::mae(input, reconstruction));
   } else if (metric == "rmse") {
-    // RMSE calculation would go here
-    return 0.0;  // Placeholder
+    return std::sqrt(util::mean(util::mse(input, reconstruction)));
   }
 
-  return 0.0;  // Default
+  throw std::invalid_argument("Unknown reconstruction error metric: " +
+                              metric);
 }
 
 void BaseAutoencoder::set_training(bool training) {
@@ -370,6 +492,10 @@ BaseAutoencoder::serialize_impl() const {
     }
   }
 
+  // Parameters of convolutional, recurrent and other layers
+  serializeOtherLayers(*encoder_, "encoder", data);
+  serializeOtherLayers(*decoder_, "decoder", data);
+
   return std::make_unique<
       std::unordered_map<std::string, std::vector<uint8_t>>>(std::move(data));
 }
@@ -585,7 +711,8 @@ bool BaseAutoencoder::deserialize_impl(
     }
   }
 
-  return true;
+  return deserializeOtherLayers(*encoder_, "encoder", data) &&
+         deserializeOtherLayers(*decoder_, "decoder", data);
 }
 
 bool BaseAutoencoder::save(const std::string& filepath) const {
@@ -628,7 +755,7 @@ bool BaseAutoencoder::load_legacy(const std::string& base_path) {
 
 void BaseAutoencoder::build_encoder() {
   // Default implementation - override in derived classes
-  for (size_t i = 0; i < config_.encoder_dims.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < config_.encoder_dims.size(); ++i) {
     size_t input_dim = static_cast<size_t>(config_.encoder_dims[i]);
     size_t output_dim = static_cast<size_t>(config_.encoder_dims[i + 1]);
 
@@ -645,7 +772,7 @@ void BaseAutoencoder::build_encoder() {
 
 void BaseAutoencoder::build_decoder() {
   // Default implementation - override in derived classes
-  for (size_t i = 0; i < config_.decoder_dims.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < config_.decoder_dims.size(); ++i) {
     size_t input_dim = static_cast<size_t>(config_.decoder_dims[i]);
     size_t output_dim = static_cast<size_t>(config_.decoder_dims[i + 1]);
 
@@ -665,49 +792,67 @@ void BaseAutoencoder::build_decoder() {
 }
 
 NDArray BaseAutoencoder::add_noise(const NDArray& input) {
+  NDArray noisy_input(input.shape());
+  corrupt(input.data(), noisy_input.data(), input.size());
+  return noisy_input;
+}
+
+void BaseAutoencoder::corrupt(const double* clean, double* noisy,
+                              size_t count) {
   if (config_.noise_factor <= 0.0) {
-    return input;
+    std::copy(clean, clean + count, noisy);
+    return;
   }
 
-  // Add Gaussian noise - simplified implementation
-  NDArray noisy_input = input;  // Copy
-  // In practice, you'd add proper noise here
-  return noisy_input;
+  // Add Gaussian noise scaled by the noise factor
+  rng_.add_normal(clean, noisy, count, config_.noise_factor);
 }
 
-std::vector<NDArray*> BaseAutoencoder::get_parameters() {
-  std::vector<NDArray*> params;
+void BaseAutoencoder::collect_trainable(Sequential& network,
+                                        std::vector<NDArray*>* params,
+                                        std::vector<NDArray*>* grads) {
+  for (auto& layer : network.get_layers()) {
+    if (params) {
+      auto layer_params = layer->get_parameters();
+      params->insert(params->end(), layer_params.begin(), layer_params.end());
+    }
+    if (grads) {
+      auto layer_grads = layer->get_gradients();
+      grads->insert(grads->end(), layer_grads.begin(), layer_grads.end());
+    }
+  }
+}
 
-  // Get encoder parameters
-  auto encoder_layers = encoder_->get_layers();
-  for (auto& layer : encoder_layers) {
-    // In practice, you'd get actual parameters from layers
+NDArray BaseAutoencoder::forward_layers(Sequential& network,
+                                        const NDArray& input) {
+  NDArray output = input;
+  for (auto& layer : network.get_layers()) {
+    output = layer->forward(output);
   }
+  return output;
+}
 
-  // Get decoder parameters
-  auto decoder_layers = decoder_->get_layers();
-  for (auto& layer : decoder_layers) {
-    // In practice, you'd get actual parameters from layers
+NDArray BaseAutoencoder::backward_layers(Sequential& network,
+                                         const NDArray& grad_output) {
+  NDArray grad = grad_output;
+  auto& layers = network.get_layers();
+  for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+    grad = (*it)->backward(grad);
   }
+  return grad;
+}
 
+std::vector<NDArray*> BaseAutoencoder::get_parameters() {
+  std::vector<NDArray*> params;
+  collect_trainable(*encoder_, &params, nullptr);
+  collect_trainable(*decoder_, &params, nullptr);
   return params;
 }
 
 std::vector<NDArray*> BaseAutoencoder::get_gradients() {
   std::vector<NDArray*> gradients;
-
-  // Get encoder gradients
-  auto encoder_layers = encoder_->get_layers();
-  for (auto& layer : encoder_layers) {
-    // In practice, you'd get actual gradients from layers
-  }
-
-  // Get decoder gradients
-  auto decoder_layers = decoder_->get_layers();
-  for (auto& layer : decoder_layers) {
-    // In practice, you'd get actual gradients from layers
-  }
-
+  collect_trainable(*encoder_, nullptr, &gradients);
+  collect_trainable(*decoder_, nullptr, &gradients);
   return gradients;
 }
 
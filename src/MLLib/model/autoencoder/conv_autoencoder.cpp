@@ -0,0 +1,218 @@
+#include "MLLib/layer/activation/relu.hpp"
+#include "MLLib/layer/activation/sigmoid.hpp"
+#include "MLLib/layer/dense.hpp"
+#include "MLLib/model/autoencoder/convolutional.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+namespace {
+
+template <typename T>
+std::vector<uint8_t> toBytes(const T* values, size_t count) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+  return std::vector<uint8_t>(bytes, bytes + count * sizeof(T));
+}
+
+/**
+ * @brief Read a key written by toBytes()
+ * @return False if the key is missing or does not hold whole values
+ */
+template <typename T>
+bool fromBytes(
+    const std::unordered_map<std::string, std::vector<uint8_t>>& data,
+    const std::string& key, std::vector<T>& values) {
+  auto it = data.find(key);
+  if (it == data.end() || it->second.size() % sizeof(T) != 0) {
+    return false;
+  }
+  values.resize(it->second.size() / sizeof(T));
+  std::memcpy(values.data(), it->second.data(), it->second.size());
+  return true;
+}
+
+/**
+ * @brief Output padding that makes a stride-s ConvTranspose2D with "same"
+ * padding map size back to target
+ * @details A strided Conv2D maps several sizes to the same output; this
+ * picks out the one the encoder started from.
+ */
+size_t outputPadding(size_t size, size_t target, size_t kernel,
+                     size_t stride) {
+  const size_t padding = kernel / 2;
+  return target - ((size - 1) * stride + kernel - 2 * padding);
+}
+
+}  // namespace
+
+ConvAutoencoder::ConvAutoencoder() : BaseAutoencoder() {
+  // Architecture is read during deserialization
+}
+
+ConvAutoencoder::ConvAutoencoder(const ConvAutoencoderConfig& conv_config,
+                                 DeviceType device)
+    : BaseAutoencoder(), conv_config_(conv_config) {
+  config_.device = device;
+  configure();
+  initialize();
+}
+
+std::unique_ptr<ConvAutoencoder>
+ConvAutoencoder::create_for_images(int height, int width, int channels,
+                                   int latent_dim, DeviceType device) {
+  if (height <= 0 || width <= 0 || channels <= 0 || latent_dim < 0) {
+    throw std::invalid_argument("Image sizes must be positive");
+  }
+  ConvAutoencoderConfig conv_config;
+  conv_config.image = {static_cast<size_t>(channels),
+                       static_cast<size_t>(height),
+                       static_cast<size_t>(width)};
+  conv_config.latent_dim = latent_dim;
+  return std::make_unique<ConvAutoencoder>(conv_config, device);
+}
+
+void ConvAutoencoder::configure() {
+  const ConvAutoencoderConfig& c = conv_config_;
+  if (c.image.size() == 0 || c.filters.empty() || c.kernel_size == 0 ||
+      c.stride == 0 || c.latent_dim < 0) {
+    throw std::invalid_argument(
+        "ConvAutoencoder needs an image, a stage and positive kernel sizes");
+  }
+
+  // "Same" padding, so each stage divides the size by the stride
+  const size_t padding = c.kernel_size / 2;
+  stage_shapes_ = {c.image};
+  for (size_t filters : c.filters) {
+    const layer::ImageShape& in = stage_shapes_.back();
+    if (filters == 0 || in.height + 2 * padding < c.kernel_size ||
+        in.width + 2 * padding < c.kernel_size) {
+      throw std::invalid_argument(
+          "ConvAutoencoder stage shrinks the feature map to nothing");
+    }
+    const layer::ImageShape out = {
+        filters, (in.height + 2 * padding - c.kernel_size) / c.stride + 1,
+        (in.width + 2 * padding - c.kernel_size) / c.stride + 1};
+    // The decoder's output padding restores both sides at once
+    if (outputPadding(out.height, in.height, c.kernel_size, c.stride) !=
+        outputPadding(out.width, in.width, c.kernel_size, c.stride)) {
+      throw std::invalid_argument(
+          "ConvAutoencoder needs height and width that downsample alike");
+    }
+    stage_shapes_.push_back(out);
+  }
+
+  // Flat layer sizes, so the base class sees the usual dimensions
+  config_.encoder_dims.clear();
+  for (const auto& shape : stage_shapes_) {
+    config_.encoder_dims.push_back(static_cast<int>(shape.size()));
+  }
+  if (c.latent_dim > 0) {
+    config_.encoder_dims.push_back(c.latent_dim);
+  }
+  config_.decoder_dims.assign(config_.encoder_dims.rbegin(),
+                              config_.encoder_dims.rend());
+  config_.latent_dim = config_.encoder_dims.back();
+}
+
+void ConvAutoencoder::build_encoder() {
+  encoder_ = std::make_unique<Sequential>(config_.device);
+  const size_t padding = conv_config_.kernel_size / 2;
+
+  for (size_t i = 0; i < conv_config_.filters.size(); ++i) {
+    encoder_->add(std::make_shared<layer::Conv2D>(
+        stage_shapes_[i], conv_config_.filters[i], conv_config_.kernel_size,
+        conv_config_.stride, padding));
+    encoder_->add(std::make_shared<layer::activation::ReLU>());
+  }
+
+  // Linear bottleneck
+  if (conv_config_.latent_dim > 0) {
+    encoder_->add(std::make_shared<layer::Dense>(
+        stage_shapes_.back().size(),
+        static_cast<size_t>(conv_config_.latent_dim)));
+  }
+}
+
+void ConvAutoencoder::build_decoder() {
+  decoder_ = std::make_unique<Sequential>(config_.device);
+  const size_t kernel = conv_config_.kernel_size;
+  const size_t stride = conv_config_.stride;
+  const size_t padding = kernel / 2;
+
+  if (conv_config_.latent_dim > 0) {
+    decoder_->add(std::make_shared<layer::Dense>(
+        static_cast<size_t>(conv_config_.latent_dim),
+        stage_shapes_.back().size()));
+    decoder_->add(std::make_shared<layer::activation::ReLU>());
+  }
+
+  for (size_t i = stage_shapes_.size() - 1; i > 0; --i) {
+    const layer::ImageShape& in = stage_shapes_[i];
+    const layer::ImageShape& target = stage_shapes_[i - 1];
+
+    decoder_->add(std::make_shared<layer::ConvTranspose2D>(
+        in, target.channels, kernel, stride, padding,
+        outputPadding(in.height, target.height, kernel, stride)));
+
+    if (i > 1) {
+      decoder_->add(std::make_shared<layer::activation::ReLU>());
+    } else {
+      // Bounded output [0,1], like the Dense autoencoders
+      decoder_->add(std::make_shared<layer::activation::Sigmoid>());
+    }
+  }
+}
+
+std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+ConvAutoencoder::serialize_impl() const {
+  auto data = BaseAutoencoder::serialize_impl();
+
+  const ConvAutoencoderConfig& c = conv_config_;
+  const size_t image[3] = {c.image.channels, c.image.height, c.image.width};
+  const size_t kernel[2] = {c.kernel_size, c.stride};
+  (*data)["conv_image"] = toBytes(image, 3);
+  (*data)["conv_filters"] = toBytes(c.filters.data(), c.filters.size());
+  (*data)["conv_kernel"] = toBytes(kernel, 2);
+  (*data)["conv_latent_dim"] = toBytes(&c.latent_dim, 1);
+  return data;
+}
+
+bool ConvAutoencoder::deserialize_impl(
+    const std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+  std::vector<size_t> image;
+  std::vector<size_t> filters;
+  std::vector<size_t> kernel;
+  std::vector<int> latent_dim;
+  if (!fromBytes(data, "conv_image", image) || image.size() != 3 ||
+      !fromBytes(data, "conv_filters", filters) ||
+      !fromBytes(data, "conv_kernel", kernel) || kernel.size() != 2 ||
+      !fromBytes(data, "conv_latent_dim", latent_dim) ||
+      latent_dim.size() != 1) {
+    std::cerr << "Convolutional autoencoder configuration not found"
+              << std::endl;
+    return false;
+  }
+
+  conv_config_.image = {image[0], image[1], image[2]};
+  conv_config_.filters = filters;
+  conv_config_.kernel_size = kernel[0];
+  conv_config_.stride = kernel[1];
+  conv_config_.latent_dim = latent_dim[0];
+  try {
+    configure();
+    // Rebuilds the networks and restores all layer parameters
+    return BaseAutoencoder::deserialize_impl(data);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid convolutional autoencoder: " << e.what()
+              << std::endl;
+    return false;
+  }
+}
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
@@ -1,13 +1,53 @@
 #include "MLLib/model/autoencoder/denoising.hpp"
+#include "MLLib/util/number/stats.hpp"
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <numeric>
-#include <random>
+#include <stdexcept>
 
 namespace MLLib {
 namespace model {
 namespace autoencoder {
 
+namespace {
+
+/**
+ * @brief Shape of a batch of samples for the metrics
+ * @details Samples are read as images when image_shape describes them and
+ * as flat rows otherwise.
+ */
+std::vector<size_t> batchShape(size_t samples, size_t sample_size,
+                               const std::vector<size_t>& image_shape) {
+  size_t image_size = std::accumulate(image_shape.begin(), image_shape.end(),
+                                      size_t(1), std::multiplies<size_t>());
+  if (!image_shape.empty() && image_size == sample_size) {
+    std::vector<size_t> shape = {samples};
+    shape.insert(shape.end(), image_shape.begin(), image_shape.end());
+    return shape;
+  }
+  return {samples, sample_size};
+}
+
+/**
+ * @brief Copy equally sized samples into one [N, ...] array
+ */
+NDArray stackSamples(const std::vector<NDArray>& samples, size_t count,
+                     const std::vector<size_t>& image_shape) {
+  const size_t sample_size = count > 0 ? samples[0].size() : 0;
+  NDArray batch(batchShape(count, sample_size, image_shape));
+  for (size_t i = 0; i < count; ++i) {
+    if (samples[i].size() != sample_size) {
+      throw std::invalid_argument("All samples must have the same size");
+    }
+    std::memcpy(batch.data() + i * sample_size, samples[i].data(),
+                sample_size * sizeof(double));
+  }
+  return batch;
+}
+
+}  // namespace
+
 DenoisingAutoencoder::DenoisingAutoencoder(
     const AutoencoderConfig& config, const DenoisingConfig& denoising_config)
     : BaseAutoencoder(config), denoising_config_(denoising_config) {}
@@ -53,28 +93,30 @@ NDArray DenoisingAutoencoder::denoise(const NDArray& noisy_input) {
   return reconstruct(noisy_input);
 }
 
+std::vector<NDArray>
+DenoisingAutoencoder::denoise(const std::vector<NDArray>& noisy_inputs) {
+  return reconstruct(noisy_inputs);
+}
+
 std::map<std::string, double> DenoisingAutoencoder::evaluate_denoising(
     const std::vector<NDArray>& clean_data,
     const std::vector<NDArray>& noisy_data) {
 
   std::map<std::string, double> metrics;
 
-  double total_psnr = 0.0;
-  double total_ssim = 0.0;
-  double total_mse = 0.0;
+  size_t num_samples = std::min(clean_data.size(), noisy_data.size());
+  std::vector<NDArray> noisy(noisy_data.begin(),
+                             noisy_data.begin() + num_samples);
+  std::vector<NDArray> denoised = denoise(noisy);
 
-  for (size_t i = 0; i < std::min(clean_data.size(), noisy_data.size()); ++i) {
-    NDArray denoised = denoise(noisy_data[i]);
+  // Score the whole set at once against the clean references
+  const auto& image_shape = denoising_config_.image_shape;
+  NDArray clean = stackSamples(clean_data, num_samples, image_shape);
+  NDArray output = stackSamples(denoised, num_samples, image_shape);
 
-    total_psnr += calculate_psnr(clean_data[i], denoised);
-    total_ssim += calculate_ssim(clean_data[i], denoised);
-    total_mse += reconstruction_error(clean_data[i], "mse");
-  }
-
-  size_t num_samples = std::min(clean_data.size(), noisy_data.size());
-  metrics["psnr"] = total_psnr / num_samples;
-  metrics["ssim"] = total_ssim / num_samples;
-  metrics["mse"] = total_mse / num_samples;
+  metrics["psnr"] = util::mean(util::psnr(clean, output));
+  metrics["ssim"] = util::mean(util::ssim(clean, output));
+  metrics["mse"] = util::mean(util::mse(clean, output));
 
   return metrics;
 }
@@ -93,52 +135,51 @@ DenoisingAutoencoder::create_for_images(int height, int width, int channels,
   std::vector<int> hidden_dims = {input_dim / 2,
                                   input_dim / 4};  // Progressive compression
 
-  return std::make_unique<DenoisingAutoencoder>(input_dim, latent_dim,
-                                                hidden_dims, noise_factor,
-                                                NoiseType::GAUSSIAN, device);
+  auto model = std::make_unique<DenoisingAutoencoder>(
+      input_dim, latent_dim, hidden_dims, noise_factor, NoiseType::GAUSSIAN,
+      device);
+  model->denoising_config_.image_shape = {static_cast<size_t>(height),
+                                          static_cast<size_t>(width),
+                                          static_cast<size_t>(channels)};
+  return model;
 }
 
-NDArray DenoisingAutoencoder::add_noise(const NDArray& input) {
-  if (denoising_config_.noise_factor <= 0.0) {
-    return input;
+void DenoisingAutoencoder::corrupt(const double* clean, double* noisy,
+                                   size_t count) {
+  const double factor = denoising_config_.noise_factor;
+  if (factor <= 0.0) {
+    std::copy(clean, clean + count, noisy);
+    return;
   }
 
+  // Each kernel draws and applies its noise in a single pass
   switch (denoising_config_.noise_type) {
-  case NoiseType::GAUSSIAN: return add_gaussian_noise(input);
-  case NoiseType::SALT_PEPPER: return add_salt_pepper_noise(input);
-  case NoiseType::DROPOUT: return add_dropout_noise(input);
-  case NoiseType::UNIFORM: return add_uniform_noise(input);
-  default: return input;
+  case NoiseType::GAUSSIAN: rng_.add_normal(clean, noisy, count, factor); break;
+  case NoiseType::SALT_PEPPER:
+    rng_.salt_pepper(clean, noisy, count, std::min(factor, 1.0));
+    break;
+  case NoiseType::DROPOUT:
+    rng_.dropout(clean, noisy, count, denoising_config_.dropout_rate);
+    break;
+  case NoiseType::UNIFORM:
+    rng_.add_uniform(clean, noisy, count, -factor, factor);
+    break;
+  default: std::copy(clean, clean + count, noisy); break;
   }
 }
 
-NDArray DenoisingAutoencoder::add_gaussian_noise(const NDArray& input) {
-  // Simplified - in practice you'd add proper Gaussian noise
-  return input;  // Placeholder
-}
-
-NDArray DenoisingAutoencoder::add_salt_pepper_noise(const NDArray& input) {
-  return input;  // Placeholder
-}
-
-NDArray DenoisingAutoencoder::add_dropout_noise(const NDArray& input) {
-  return input;  // Placeholder
-}
-
-NDArray DenoisingAutoencoder::add_uniform_noise(const NDArray& input) {
-  return input;  // Placeholder
-}
-
 double DenoisingAutoencoder::calculate_psnr(const NDArray& clean,
                                             const NDArray& noisy) {
-  // Simplified PSNR calculation - placeholder
-  return 20.0;  // Default PSNR value
+  const auto& image_shape = denoising_config_.image_shape;
+  return util::psnr(stackSamples({clean}, 1, image_shape),
+                    stackSamples({noisy}, 1, image_shape))[0];
 }
 
 double DenoisingAutoencoder::calculate_ssim(const NDArray& clean,
                                             const NDArray& reconstructed) {
-  // Simplified SSIM calculation - placeholder
-  return 0.8;  // Default SSIM value
+  const auto& image_shape = denoising_config_.image_shape;
+  return util::ssim(stackSamples({clean}, 1, image_shape),
+                    stackSamples({reconstructed}, 1, image_shape))[0];
 }
 
 }  // namespace autoencoder
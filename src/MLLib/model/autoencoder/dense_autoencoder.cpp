@@ -76,7 +76,7 @@ DenseAutoencoder::create_deep(int input_dim, int latent_dim, int num_layers,
 void DenseAutoencoder::build_encoder() {
   encoder_ = std::make_unique<Sequential>(config_.device);
 
-  for (size_t i = 0; i < config_.encoder_dims.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < config_.encoder_dims.size(); ++i) {
     size_t input_dim = static_cast<size_t>(config_.encoder_dims[i]);
     size_t output_dim = static_cast<size_t>(config_.encoder_dims[i + 1]);
 
@@ -97,7 +97,7 @@ void DenseAutoencoder::build_encoder() {
 void DenseAutoencoder::build_decoder() {
   decoder_ = std::make_unique<Sequential>(config_.device);
 
-  for (size_t i = 0; i < config_.decoder_dims.size() - 1; ++i) {
+  for (size_t i = 0; i + 1 < config_.decoder_dims.size(); ++i) {
     size_t input_dim = static_cast<size_t>(config_.decoder_dims[i]);
     size_t output_dim = static_cast<size_t>(config_.decoder_dims[i + 1]);
 
@@ -0,0 +1,122 @@
+#include "MLLib/layer/dense.hpp"
+#include "MLLib/model/autoencoder/recurrent.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+LSTMAutoencoder::LSTMAutoencoder() : BaseAutoencoder() {
+  // Architecture is read during deserialization
+}
+
+LSTMAutoencoder::LSTMAutoencoder(const LSTMAutoencoderConfig& lstm_config,
+                                 DeviceType device)
+    : BaseAutoencoder(), lstm_config_(lstm_config) {
+  config_.device = device;
+  configure();
+  initialize();
+}
+
+LSTMAutoencoder::LSTMAutoencoder(size_t steps, size_t features,
+                                 size_t hidden_size, int latent_dim,
+                                 DeviceType device)
+    : LSTMAutoencoder(
+          LSTMAutoencoderConfig{steps, features, hidden_size, latent_dim, 0},
+          device) {}
+
+size_t LSTMAutoencoder::code_size() const {
+  return lstm_config_.latent_dim > 0
+             ? static_cast<size_t>(lstm_config_.latent_dim)
+             : lstm_config_.hidden_size;
+}
+
+void LSTMAutoencoder::configure() {
+  const LSTMAutoencoderConfig& c = lstm_config_;
+  if (c.steps == 0 || c.features == 0 || c.hidden_size == 0 ||
+      c.latent_dim < 0) {
+    throw std::invalid_argument(
+        "LSTMAutoencoder needs positive window and hidden sizes");
+  }
+
+  // Flat window and code sizes, so the base class sees the usual dimensions
+  const int window = static_cast<int>(c.steps * c.features);
+  const int code = static_cast<int>(code_size());
+  config_.encoder_dims = {window, code};
+  config_.decoder_dims = {code, window};
+  config_.latent_dim = code;
+}
+
+void LSTMAutoencoder::build_encoder() {
+  encoder_ = std::make_unique<Sequential>(config_.device);
+  const LSTMAutoencoderConfig& c = lstm_config_;
+
+  encoder_->add(std::make_shared<layer::LSTM>(c.features, c.hidden_size,
+                                              false, c.bptt_steps));
+  if (c.latent_dim > 0) {
+    encoder_->add(std::make_shared<layer::Dense>(
+        c.hidden_size, static_cast<size_t>(c.latent_dim)));
+  }
+}
+
+void LSTMAutoencoder::build_decoder() {
+  decoder_ = std::make_unique<Sequential>(config_.device);
+  const LSTMAutoencoderConfig& c = lstm_config_;
+
+  decoder_->add(std::make_shared<layer::RepeatVector>(c.steps));
+  decoder_->add(std::make_shared<layer::LSTM>(code_size(), c.hidden_size,
+                                              true, c.bptt_steps));
+  decoder_->add(std::make_shared<layer::TimeDistributed>(
+      std::make_shared<layer::Dense>(c.hidden_size, c.features),
+      c.hidden_size));
+}
+
+std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+LSTMAutoencoder::serialize_impl() const {
+  auto data = BaseAutoencoder::serialize_impl();
+
+  const LSTMAutoencoderConfig& c = lstm_config_;
+  const size_t shape[4] = {c.steps, c.features, c.hidden_size, c.bptt_steps};
+  const uint8_t* shape_bytes = reinterpret_cast<const uint8_t*>(shape);
+  const uint8_t* latent_bytes = reinterpret_cast<const uint8_t*>(&c.latent_dim);
+  (*data)["lstm_shape"] =
+      std::vector<uint8_t>(shape_bytes, shape_bytes + sizeof(shape));
+  (*data)["lstm_latent_dim"] =
+      std::vector<uint8_t>(latent_bytes, latent_bytes + sizeof(int));
+  return data;
+}
+
+bool LSTMAutoencoder::deserialize_impl(
+    const std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+  auto shape_it = data.find("lstm_shape");
+  auto latent_it = data.find("lstm_latent_dim");
+  if (shape_it == data.end() || shape_it->second.size() != 4 * sizeof(size_t) ||
+      latent_it == data.end() || latent_it->second.size() != sizeof(int)) {
+    std::cerr << "LSTM autoencoder configuration not found" << std::endl;
+    return false;
+  }
+
+  size_t shape[4];
+  std::memcpy(shape, shape_it->second.data(), sizeof(shape));
+  lstm_config_.steps = shape[0];
+  lstm_config_.features = shape[1];
+  lstm_config_.hidden_size = shape[2];
+  lstm_config_.bptt_steps = shape[3];
+  std::memcpy(&lstm_config_.latent_dim, latent_it->second.data(),
+              sizeof(int));
+
+  try {
+    configure();
+    // Rebuilds the networks and restores all layer parameters
+    return BaseAutoencoder::deserialize_impl(data);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid LSTM autoencoder: " << e.what() << std::endl;
+    return false;
+  }
+}
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
@@ -0,0 +1,401 @@
+#include "MLLib/model/autoencoder/sparse.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace MLLib {
+namespace model {
+namespace autoencoder {
+
+namespace {
+
+AutoencoderConfig makeConfig(int input_dim, int latent_dim,
+                             const std::vector<int>& hidden_dims,
+                             double sparsity_penalty, DeviceType device) {
+  AutoencoderConfig config =
+      AutoencoderConfig::basic(input_dim, latent_dim, hidden_dims);
+  config.sparsity_penalty = sparsity_penalty;
+  config.device = device;
+  return config;
+}
+
+/**
+ * @brief Rows of a batch of codes with units values each
+ */
+size_t codeRows(const NDArray& codes, size_t units) {
+  if (units == 0 || codes.size() % units != 0) {
+    throw std::invalid_argument("Latent codes must have latent_dim units");
+  }
+  return codes.size() / units;
+}
+
+/**
+ * @brief Keep the count largest values of row and zero the rest
+ * @details Ties at the threshold are kept in column order.
+ */
+void keepLargest(double* row, size_t units, size_t count,
+                 std::vector<double>& scratch) {
+  scratch.assign(row, row + units);
+  std::nth_element(scratch.begin(), scratch.begin() + (count - 1),
+                   scratch.end(), std::greater<double>());
+  const double threshold = scratch[count - 1];
+
+  size_t above = 0;
+  for (size_t j = 0; j < units; ++j) {
+    above += row[j] > threshold;
+  }
+  size_t ties = count - above;
+  for (size_t j = 0; j < units; ++j) {
+    if (row[j] < threshold || (row[j] == threshold && ties-- == 0)) {
+      row[j] = 0.0;
+    }
+  }
+}
+
+}  // namespace
+
+// SparseLatent implementation
+SparseLatent::SparseLatent(SparsityType type, double weight,
+                           double target_rate, size_t top_k)
+    : type_(type), weight_(weight), target_rate_(target_rate),
+      top_k_(top_k) {}
+
+double SparseLatent::activate_row(const double* input, double* output,
+                                  size_t units,
+                                  std::vector<double>& scratch) const {
+  if (type_ == SparsityType::L1) {
+    for (size_t j = 0; j < units; ++j) {
+      output[j] = input[j] > 0.0 ? input[j] : 0.0;
+    }
+  } else {
+    for (size_t j = 0; j < units; ++j) {
+      output[j] = 1.0 / (1.0 + std::exp(-input[j]));
+    }
+  }
+  if (top_k_ > 0 && top_k_ < units) {
+    keepLargest(output, units, top_k_, scratch);
+  }
+  return std::accumulate(output, output + units, 0.0);
+}
+
+NDArray SparseLatent::forward(const NDArray& input) {
+  const size_t units = input.shape().empty() ? 0 : input.shape().back();
+  const size_t rows = codeRows(input, units);
+
+  NDArray output(input.shape());
+  std::vector<double> scratch;
+  std::vector<double> rates(units, 0.0);
+  double total = 0.0;
+
+  // The penalty statistics are gathered while the codes are written
+  for (size_t r = 0; r < rows; ++r) {
+    const double* in = input.data() + r * units;
+    double* out = output.data() + r * units;
+    total += activate_row(in, out, units, scratch);
+    if (type_ == SparsityType::KL_DIVERGENCE) {
+      for (size_t j = 0; j < units; ++j) {
+        rates[j] += out[j];
+      }
+    }
+  }
+
+  // Per-unit gradient of the penalty averaged over the batch rows
+  const double scale = weight_ / static_cast<double>(rows);
+  double penalty = 0.0;
+  if (type_ == SparsityType::L1) {
+    penalty = scale * total;
+    penalty_grad_.assign(units, scale);
+  } else {
+    const double rho = target_rate_;
+    penalty_grad_.resize(units);
+    for (size_t j = 0; j < units; ++j) {
+      const double rate =
+          std::min(std::max(rates[j] / rows, 1e-8), 1.0 - 1e-8);
+      penalty += rho * std::log(rho / rate) +
+                 (1.0 - rho) * std::log((1.0 - rho) / (1.0 - rate));
+      penalty_grad_[j] = scale * ((1.0 - rho) / (1.0 - rate) - rho / rate);
+    }
+    penalty *= weight_;
+  }
+  penalty_sum_ += penalty;
+  penalty_count_++;
+
+  last_output_ = output;
+  return output;
+}
+
+void SparseLatent::infer(const NDArray& input, NDArray& output) const {
+  const size_t units = input.shape().empty() ? 0 : input.shape().back();
+  const size_t rows = codeRows(input, units);
+  if (output.shape() != input.shape()) {
+    output = NDArray(input.shape());
+  }
+
+  std::vector<double> scratch;
+  for (size_t r = 0; r < rows; ++r) {
+    activate_row(input.data() + r * units, output.data() + r * units, units,
+                 scratch);
+  }
+}
+
+NDArray SparseLatent::backward(const NDArray& grad_output) {
+  if (grad_output.shape() != last_output_.shape()) {
+    throw std::invalid_argument("Gradient output shape must match input shape");
+  }
+
+  const size_t units = penalty_grad_.size();
+  const size_t rows = codeRows(grad_output, units);
+  NDArray grad_input(grad_output.shape());
+
+  // Penalty and activation derivative in one pass; units dropped by the
+  // top-k selection are 0 and get no gradient
+  for (size_t r = 0; r < rows; ++r) {
+    const double* a = last_output_.data() + r * units;
+    const double* g = grad_output.data() + r * units;
+    double* gi = grad_input.data() + r * units;
+    for (size_t j = 0; j < units; ++j) {
+      const double derivative = type_ == SparsityType::L1
+                                    ? (a[j] > 0.0 ? 1.0 : 0.0)
+                                    : a[j] * (1.0 - a[j]);
+      gi[j] = (g[j] + penalty_grad_[j]) * derivative;
+    }
+  }
+
+  return grad_input;
+}
+
+double SparseLatent::get_penalty() const {
+  return penalty_count_ > 0 ? penalty_sum_ / penalty_count_ : 0.0;
+}
+
+void SparseLatent::reset_penalty() {
+  penalty_sum_ = 0.0;
+  penalty_count_ = 0;
+}
+
+// SparseAutoencoder implementation
+SparseAutoencoder::SparseAutoencoder() : BaseAutoencoder() {
+  // Architecture is read during deserialization
+}
+
+SparseAutoencoder::SparseAutoencoder(const AutoencoderConfig& config,
+                                     const SparseConfig& sparse_config)
+    : BaseAutoencoder(), sparse_config_(sparse_config) {
+  config_ = config;
+  initialize();
+}
+
+SparseAutoencoder::SparseAutoencoder(int input_dim, int latent_dim,
+                                     const std::vector<int>& hidden_dims,
+                                     double sparsity_penalty,
+                                     SparsityType type, DeviceType device)
+    : SparseAutoencoder(makeConfig(input_dim, latent_dim, hidden_dims,
+                                   sparsity_penalty, device),
+                        SparseConfig{type}) {}
+
+void SparseAutoencoder::validate() const {
+  if (config_.encoder_dims.size() < 2) {
+    throw std::invalid_argument(
+        "Sparse autoencoder needs at least input and latent dimensions");
+  }
+  if (config_.sparsity_penalty < 0.0) {
+    throw std::invalid_argument("Sparsity penalty must not be negative");
+  }
+  if (sparse_config_.type == SparsityType::KL_DIVERGENCE &&
+      (sparse_config_.target_rate <= 0.0 ||
+       sparse_config_.target_rate >= 1.0)) {
+    throw std::invalid_argument("Sparsity target rate must be in (0, 1)");
+  }
+  if (sparse_config_.top_k >
+      static_cast<size_t>(config_.encoder_dims.back())) {
+    throw std::invalid_argument("top_k must not exceed the latent dimension");
+  }
+}
+
+void SparseAutoencoder::build_encoder() {
+  validate();
+  BaseAutoencoder::build_encoder();
+
+  latent_layer_ = std::make_shared<SparseLatent>(
+      sparse_config_.type, config_.sparsity_penalty,
+      sparse_config_.target_rate, sparse_config_.top_k);
+  encoder_->add(latent_layer_);
+}
+
+SparseMatrix SparseAutoencoder::to_sparse_codes(const NDArray& latent) const {
+  const size_t units = static_cast<size_t>(config_.encoder_dims.back());
+  const size_t rows = codeRows(latent, units);
+  const size_t keep =
+      sparse_config_.top_k > 0 ? sparse_config_.top_k : units;
+
+  std::vector<size_t> offsets = {0};
+  std::vector<size_t> columns;
+  std::vector<double> values;
+  std::vector<size_t> active;
+  offsets.reserve(rows + 1);
+  for (size_t r = 0; r < rows; ++r) {
+    const double* code = latent.data() + r * units;
+    active.clear();
+    for (size_t j = 0; j < units; ++j) {
+      if (code[j] != 0.0) {
+        active.push_back(j);
+      }
+    }
+    if (active.size() > keep) {
+      std::nth_element(
+          active.begin(), active.begin() + keep, active.end(),
+          [code](size_t a, size_t b) { return code[a] > code[b]; });
+      active.resize(keep);
+      std::sort(active.begin(), active.end());
+    }
+    for (size_t j : active) {
+      columns.push_back(j);
+      values.push_back(code[j]);
+    }
+    offsets.push_back(columns.size());
+  }
+
+  return SparseMatrix(rows, units, std::move(offsets), std::move(columns),
+                      std::move(values));
+}
+
+NDArray SparseAutoencoder::decode(const NDArray& latent) {
+  if (sparse_config_.top_k == 0) {
+    const size_t active = static_cast<size_t>(
+        std::count_if(latent.data(), latent.data() + latent.size(),
+                      [](double v) { return v != 0.0; }));
+    if (2 * active > latent.size()) {
+      return BaseAutoencoder::decode(latent);
+    }
+  }
+
+  // Only the weight rows of active units are read
+  SparseMatrix codes = to_sparse_codes(latent);
+  if (2 * codes.nnz() > latent.size()) {
+    return decoder_->predict(codes.to_dense());
+  }
+  return decoder_->predict(codes);
+}
+
+std::vector<NDArray>
+SparseAutoencoder::decode(const std::vector<NDArray>& latents) {
+  if (latents.empty()) {
+    return {};
+  }
+
+  // Stack every code into one batch, so the whole set becomes one CSR
+  // matrix and one decoder pass
+  const size_t units = static_cast<size_t>(config_.encoder_dims.back());
+  std::vector<size_t> rows(latents.size());
+  size_t total_rows = 0;
+  for (size_t i = 0; i < latents.size(); ++i) {
+    rows[i] = codeRows(latents[i], units);
+    total_rows += rows[i];
+  }
+  NDArray stacked({total_rows, units});
+  double* dst = stacked.data();
+  for (const auto& latent : latents) {
+    dst = std::copy(latent.data(), latent.data() + latent.size(), dst);
+  }
+
+  NDArray output = decode(stacked);
+  if (output.shape().size() != 2 || output.shape()[0] != total_rows) {
+    throw std::runtime_error("Decoder output does not have one row per code");
+  }
+
+  // Split the rows back into per-code outputs
+  const size_t width = output.shape()[1];
+  const double* src = output.data();
+  std::vector<NDArray> outputs;
+  outputs.reserve(latents.size());
+  for (size_t count : rows) {
+    NDArray result({count, width});
+    std::copy(src, src + count * width, result.data());
+    src += count * width;
+    outputs.push_back(std::move(result));
+  }
+  return outputs;
+}
+
+void SparseAutoencoder::train(
+    const std::vector<NDArray>& training_data, loss::BaseLoss& loss,
+    optimizer::BaseOptimizer& optimizer, int epochs, int batch_size,
+    const std::vector<NDArray>* validation_data,
+    std::function<void(int, double, double)> callback) {
+  latent_layer_->reset_penalty();
+  std::function<void(int, double, double)> report;
+  if (callback) {
+    report = [&](int epoch, double train_loss, double val_loss) {
+      const double penalty = latent_layer_->get_penalty();
+      latent_layer_->reset_penalty();
+      callback(epoch, train_loss + penalty, val_loss);
+    };
+  }
+  BaseAutoencoder::train(training_data, loss, optimizer, epochs, batch_size,
+                         validation_data, report);
+}
+
+double SparseAutoencoder::mean_activation(const NDArray& input) {
+  NDArray codes = encode(input);
+  if (codes.size() == 0) {
+    return 0.0;
+  }
+  return std::accumulate(codes.data(), codes.data() + codes.size(), 0.0) /
+         codes.size();
+}
+
+std::unique_ptr<std::unordered_map<std::string, std::vector<uint8_t>>>
+SparseAutoencoder::serialize_impl() const {
+  auto data = BaseAutoencoder::serialize_impl();
+
+  const uint8_t* rate_bytes =
+      reinterpret_cast<const uint8_t*>(&sparse_config_.target_rate);
+  const uint8_t* top_k_bytes =
+      reinterpret_cast<const uint8_t*>(&sparse_config_.top_k);
+  (*data)["sparse_type"] = {static_cast<uint8_t>(sparse_config_.type)};
+  (*data)["sparse_target_rate"] =
+      std::vector<uint8_t>(rate_bytes, rate_bytes + sizeof(double));
+  (*data)["sparse_top_k"] =
+      std::vector<uint8_t>(top_k_bytes, top_k_bytes + sizeof(size_t));
+  return data;
+}
+
+bool SparseAutoencoder::deserialize_impl(
+    const std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+  auto type_it = data.find("sparse_type");
+  auto rate_it = data.find("sparse_target_rate");
+  auto top_k_it = data.find("sparse_top_k");
+  if (type_it == data.end() || type_it->second.empty() ||
+      rate_it == data.end() || rate_it->second.size() < sizeof(double) ||
+      top_k_it == data.end() || top_k_it->second.size() < sizeof(size_t)) {
+    std::cerr << "Sparse autoencoder configuration not found" << std::endl;
+    return false;
+  }
+
+  const uint8_t type = type_it->second[0];
+  if (type != static_cast<uint8_t>(SparsityType::L1) &&
+      type != static_cast<uint8_t>(SparsityType::KL_DIVERGENCE)) {
+    std::cerr << "Unknown sparsity type " << static_cast<int>(type)
+              << std::endl;
+    return false;
+  }
+  sparse_config_.type = static_cast<SparsityType>(type);
+  std::memcpy(&sparse_config_.target_rate, rate_it->second.data(),
+              sizeof(double));
+  std::memcpy(&sparse_config_.top_k, top_k_it->second.data(), sizeof(size_t));
+
+  try {
+    // Rebuilds the networks, including the latent layer
+    return BaseAutoencoder::deserialize_impl(data);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid sparse autoencoder: " << e.what() << std::endl;
+    return false;
+  }
+}
+
+}  // namespace autoencoder
+}  // namespace model
+}  // namespace MLLib
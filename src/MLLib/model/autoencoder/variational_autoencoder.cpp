@@ -1,59 +1,78 @@
 #include "MLLib/model/autoencoder/variational.hpp"
+#include "MLLib/backend/backend.hpp"
+#include "MLLib/layer/activation/relu.hpp"
+#include "MLLib/layer/dense.hpp"
+#include <algorithm>
 #include <cmath>
-#include <random>
+#include <numeric>
+#include <stdexcept>
 
 namespace MLLib {
 namespace model {
 namespace autoencoder {
 
+namespace {
+
+/**
+ * @brief Base configuration with a symmetric decoder
+ */
+AutoencoderConfig makeConfig(int input_dim, int latent_dim,
+                             const std::vector<int>& hidden_dims,
+                             DeviceType device) {
+  AutoencoderConfig config =
+      AutoencoderConfig::basic(input_dim, latent_dim, hidden_dims);
+  config.device = device;
+  return config;
+}
+
+size_t batchRows(const NDArray& array) {
+  return array.shape().size() >= 2 ? array.shape()[0] : 1;
+}
+
+}  // namespace
+
 VariationalAutoencoder::VariationalAutoencoder(const AutoencoderConfig& config,
                                                const VAEConfig& vae_config)
     : BaseAutoencoder(config), vae_config_(vae_config) {
-  // VAE-specific initialization - defer to prevent segfault
-  // TODO: Initialize mean and logvar encoders safely
+  // The base constructor built a plain encoder; rebuild with the
+  // shared encoder and the mean/log-variance heads
+  initialize();
 }
 
 VariationalAutoencoder::VariationalAutoencoder(
     int input_dim, int latent_dim, const std::vector<int>& hidden_dims,
     double kl_weight, DeviceType device)
-    : BaseAutoencoder(AutoencoderConfig()) {
-  config_.encoder_dims = {input_dim};
-  config_.encoder_dims.insert(config_.encoder_dims.end(), hidden_dims.begin(),
-                              hidden_dims.end());
-  config_.encoder_dims.push_back(latent_dim);
-  config_.latent_dim = latent_dim;
-  config_.device = device;
-
-  // Calculate symmetric decoder dimensions
-  config_.decoder_dims = {latent_dim};
-  for (int i = static_cast<int>(config_.encoder_dims.size()) - 2; i >= 1; --i) {
-    config_.decoder_dims.push_back(config_.encoder_dims[i]);
-  }
-  config_.decoder_dims.push_back(input_dim);
-
+    : VariationalAutoencoder(
+          makeConfig(input_dim, latent_dim, hidden_dims, device)) {
   vae_config_.kl_weight = kl_weight;
+}
 
-  // Defer initialization to prevent segfault during construction
-  // initialize();
+NDArray VariationalAutoencoder::encode(const NDArray& input) {
+  return mean_encoder_->predict(encode_hidden(input));
+}
 
-  // Initialize mean and logvar encoders - commented out for safety
-  // mean_encoder_ = std::make_unique<Sequential>(device);
-  // logvar_encoder_ = std::make_unique<Sequential>(device);
+std::vector<NDArray>
+VariationalAutoencoder::encode(const std::vector<NDArray>& inputs) {
+  if (encoder_->get_layers().empty()) {
+    return mean_encoder_->predict(inputs);
+  }
+  return mean_encoder_->predict(encoder_->predict(inputs));
+}
+
+NDArray VariationalAutoencoder::encode_hidden(const NDArray& input) const {
+  // Without hidden layers both heads read the input directly
+  if (encoder_->get_layers().empty()) {
+    return input;
+  }
+  return encoder_->predict(input);
 }
 
 VAEOutput VariationalAutoencoder::encode_variational(const NDArray& input) {
   VAEOutput output;
 
-  // Temporary implementation to prevent segfault
-  // Encode to mean and log variance
-  // output.mean = mean_encoder_->predict(input);
-  // output.log_var = logvar_encoder_->predict(input);
-
-  // Use dummy values for now
-  output.mean = NDArray({1ul, static_cast<size_t>(config_.latent_dim)});
-  output.log_var = NDArray({1ul, static_cast<size_t>(config_.latent_dim)});
-  output.sample = output.mean;  // No sampling for now
-  output.kl_loss = 0.0;
+  NDArray hidden = encode_hidden(input);
+  output.mean = mean_encoder_->predict(hidden);
+  output.log_var = logvar_encoder_->predict(hidden);
 
   // Sample using reparameterization trick
   if (vae_config_.reparameterize) {
@@ -70,47 +89,47 @@ VAEOutput VariationalAutoencoder::encode_variational(const NDArray& input) {
 
 std::vector<NDArray> VariationalAutoencoder::sample_latent(int num_samples) {
   std::vector<NDArray> samples;
+  if (num_samples <= 0) {
+    return samples;
+  }
 
+  // One draw for all samples, split into [1, latent_dim] rows
+  const size_t latent_dim = static_cast<size_t>(config_.latent_dim);
+  NDArray all = sample_standard_normal({num_samples, config_.latent_dim});
+  const double* values = all.data();
+  samples.reserve(num_samples);
   for (int i = 0; i < num_samples; ++i) {
-    std::vector<int> shape = {1, config_.latent_dim};
-    NDArray sample = sample_standard_normal(shape);
-    samples.push_back(sample);
+    NDArray sample({1, latent_dim});
+    std::copy(values + i * latent_dim, values + (i + 1) * latent_dim,
+              sample.data());
+    samples.push_back(std::move(sample));
   }
 
   return samples;
 }
 
 std::vector<NDArray> VariationalAutoencoder::generate(int num_samples) {
-  auto latent_samples = sample_latent(num_samples);
-  std::vector<NDArray> generated_data;
-
-  for (const auto& latent : latent_samples) {
-    NDArray generated = decode(latent);
-    generated_data.push_back(generated);
-  }
-
-  return generated_data;
+  // All samples are decoded in shared batches
+  return decode(sample_latent(num_samples));
 }
 
 std::vector<NDArray>
 VariationalAutoencoder::interpolate(const NDArray& start_point,
                                     const NDArray& end_point, int num_steps) {
-  std::vector<NDArray> interpolated;
-
   auto start_encoding = encode_variational(start_point);
   auto end_encoding = encode_variational(end_point);
 
+  // Linear interpolation between the latent means
+  std::vector<NDArray> latents;
+  latents.reserve(std::max(num_steps, 0));
   for (int i = 0; i < num_steps; ++i) {
-    double alpha = static_cast<double>(i) / (num_steps - 1);
-
-    // Linear interpolation in latent space - simplified
-    // In practice you'd do proper tensor interpolation
-    NDArray interpolated_latent = start_encoding.mean;  // Placeholder
-    NDArray decoded = decode(interpolated_latent);
-    interpolated.push_back(decoded);
+    double alpha =
+        num_steps > 1 ? static_cast<double>(i) / (num_steps - 1) : 0.0;
+    latents.push_back(start_encoding.mean * (1.0 - alpha) +
+                      end_encoding.mean * alpha);
   }
 
-  return interpolated;
+  return decode(latents);
 }
 
 void VariationalAutoencoder::train(
@@ -118,31 +137,123 @@ void VariationalAutoencoder::train(
     optimizer::BaseOptimizer& optimizer, int epochs, int batch_size,
     const std::vector<NDArray>* validation_data,
     std::function<void(int, double, double)> callback) {
+  (void)validation_data;
+  if (training_data.empty()) {
+    return;
+  }
 
-  // VAE training with KL loss - simplified implementation
-  for (int epoch = 0; epoch < epochs; ++epoch) {
-    double total_recon_loss = 0.0;
-    double total_kl_loss = 0.0;
+  const size_t features = static_cast<size_t>(get_input_dim());
+  for (const auto& sample : training_data) {
+    if (sample.size() % features != 0) {
+      throw std::invalid_argument(
+          "VAE training samples must have input_dim features per row");
+    }
+  }
+  const size_t step = static_cast<size_t>(std::max(batch_size, 1));
 
-    // Process training data
-    for (const auto& input : training_data) {
-      auto vae_output = encode_variational(input);
-      NDArray reconstruction = decode(vae_output.sample);
+  std::vector<size_t> indices(training_data.size());
+  std::iota(indices.begin(), indices.end(), 0);
 
-      double recon_loss = loss.compute_loss(reconstruction, input);
-      double kl_loss = vae_output.kl_loss;
+  for (int epoch = 0; epoch < epochs; ++epoch) {
+    std::shuffle(indices.begin(), indices.end(), rng_);
+    const double kl_weight = get_current_kl_weight(epoch);
 
-      total_recon_loss += recon_loss;
-      total_kl_loss += kl_loss;
+    double total_recon_loss = 0.0;
+    double total_kl_loss = 0.0;
+    size_t total_rows = 0;
+
+    for (size_t begin = 0; begin < indices.size(); begin += step) {
+      size_t end = std::min(indices.size(), begin + step);
+
+      // Stack the mini-batch into one [rows, features] array
+      size_t rows = 0;
+      for (size_t i = begin; i < end; ++i) {
+        rows += training_data[indices[i]].size() / features;
+      }
+      NDArray batch({rows, features});
+      double* dst = batch.data();
+      for (size_t i = begin; i < end; ++i) {
+        const NDArray& sample = training_data[indices[i]];
+        dst = std::copy(sample.data(), sample.data() + sample.size(), dst);
+      }
+
+      double kl_loss = 0.0;
+      double recon_loss =
+          train_batch(batch, loss, optimizer, kl_weight, kl_loss);
+      total_recon_loss += recon_loss * rows;
+      total_kl_loss += kl_loss * rows;
+      total_rows += rows;
     }
 
-    double avg_recon_loss = total_recon_loss / training_data.size();
-    double avg_kl_loss = total_kl_loss / training_data.size();
-
     if (callback) {
-      callback(epoch, avg_recon_loss, avg_kl_loss);
+      callback(epoch, total_recon_loss / total_rows,
+               total_kl_loss / total_rows);
+    }
+  }
+}
+
+double VariationalAutoencoder::train_batch(const NDArray& batch,
+                                           loss::BaseLoss& loss,
+                                           optimizer::BaseOptimizer& optimizer,
+                                           double kl_weight,
+                                           double& kl_loss) {
+  // Forward: shared encoder, both heads, reparameterization, decoder
+  NDArray hidden = forward_layers(*encoder_, batch);
+  NDArray mean = forward_layers(*mean_encoder_, hidden);
+  NDArray log_var = forward_layers(*logvar_encoder_, hidden);
+
+  NDArray epsilon;
+  NDArray latent = vae_config_.reparameterize
+                       ? reparameterize_sample(mean, log_var, &epsilon)
+                       : mean;
+  NDArray reconstruction = forward_layers(*decoder_, latent);
+
+  double recon_loss = loss.compute_loss(reconstruction, batch);
+  kl_loss = calculate_kl_loss(mean, log_var);
+
+  // Backward through the decoder to the latent sample
+  NDArray grad_latent =
+      backward_layers(*decoder_, loss.compute_gradient(reconstruction, batch));
+
+  // Head gradients: the sample path plus the closed-form KL terms
+  //   dKL/dmean    = mean
+  //   dKL/dlog_var = (exp(log_var) - 1) / 2
+  // with the KL averaged over the batch rows
+  const size_t size = mean.size();
+  const double scale = kl_weight / static_cast<double>(batchRows(mean));
+  NDArray grad_mean(mean.shape());
+  NDArray grad_log_var(log_var.shape());
+  const double* mu = mean.data();
+  const double* lv = log_var.data();
+  const double* gz = grad_latent.data();
+  const double* eps = vae_config_.reparameterize ? epsilon.data() : nullptr;
+  double* gm = grad_mean.data();
+  double* glv = grad_log_var.data();
+  for (size_t i = 0; i < size; ++i) {
+    double variance = std::exp(lv[i]);
+    gm[i] = gz[i] + scale * mu[i];
+    glv[i] = scale * 0.5 * (variance - 1.0);
+    if (eps) {
+      // d(mean + exp(log_var / 2) * eps)/dlog_var = eps * std / 2
+      glv[i] += gz[i] * eps[i] * 0.5 * std::sqrt(variance);
     }
   }
+
+  // Both heads read the shared hidden layer; accumulate their gradients
+  NDArray grad_hidden = backward_layers(*mean_encoder_, grad_mean);
+  Backend::DefaultBackend::axpy(
+      1.0, backward_layers(*logvar_encoder_, grad_log_var), grad_hidden);
+  backward_layers(*encoder_, grad_hidden);
+
+  std::vector<NDArray*> params;
+  std::vector<NDArray*> grads;
+  collect_trainable(*encoder_, &params, &grads);
+  collect_trainable(*mean_encoder_, &params, &grads);
+  collect_trainable(*logvar_encoder_, &params, &grads);
+  collect_trainable(*decoder_, &params, &grads);
+  optimizer.update(params, grads);
+
+  return recon_loss;
 }
 
 double VariationalAutoencoder::calculate_vae_loss(const NDArray& input,
@@ -192,12 +303,26 @@ std::unique_ptr<VariationalAutoencoder> VariationalAutoencoder::create_beta_vae(
 }
 
 void VariationalAutoencoder::build_encoder() {
-  // Build mean encoder
+  const auto& dims = config_.encoder_dims;
+  if (dims.size() < 2) {
+    throw std::invalid_argument(
+        "VAE needs at least input and latent dimensions");
+  }
+
+  // Shared encoder: all but the last dimension, ReLU after each layer
+  for (size_t i = 0; i + 2 < dims.size(); ++i) {
+    encoder_->add(std::make_shared<layer::Dense>(
+        static_cast<size_t>(dims[i]), static_cast<size_t>(dims[i + 1])));
+    encoder_->add(std::make_shared<layer::activation::ReLU>());
+  }
+
+  // Linear heads for the mean and log variance of the latent distribution
+  size_t hidden_dim = static_cast<size_t>(dims[dims.size() - 2]);
+  size_t latent_dim = static_cast<size_t>(dims.back());
   mean_encoder_ = std::make_unique<Sequential>(config_.device);
-  // Build logvar encoder
+  mean_encoder_->add(std::make_shared<layer::Dense>(hidden_dim, latent_dim));
   logvar_encoder_ = std::make_unique<Sequential>(config_.device);
-
-  // Simplified implementation - in practice you'd build proper networks
+  logvar_encoder_->add(std::make_shared<layer::Dense>(hidden_dim, latent_dim));
 }
 
 void VariationalAutoencoder::build_decoder() {
@@ -205,21 +330,45 @@ void VariationalAutoencoder::build_decoder() {
 }
 
 NDArray VariationalAutoencoder::reparameterize_sample(const NDArray& mean,
-                                                      const NDArray& log_var) {
-  // Reparameterization trick: sample = mean + std * epsilon
-  // where epsilon ~ N(0,1) and std = exp(0.5 * log_var)
+                                                      const NDArray& log_var,
+                                                      NDArray* epsilon) {
+  if (mean.shape() != log_var.shape()) {
+    throw std::invalid_argument("Mean and log variance shapes must match");
+  }
 
-  // Simplified implementation - placeholder
-  return mean;  // In practice, you'd implement proper reparameterization
+  // sample = mean + exp(0.5 * log_var) * eps, eps ~ N(0, I); the noise for
+  // the whole batch is drawn in one fill and written straight into sample
+  NDArray sample(mean.shape());
+  double* out = sample.data();
+  const size_t size = mean.size();
+  rng_.normal(out, size);
+  if (epsilon) {
+    *epsilon = sample;
+  }
+
+  const double* mu = mean.data();
+  const double* lv = log_var.data();
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = mu[i] + std::exp(0.5 * lv[i]) * out[i];
+  }
+  return sample;
 }
 
 double VariationalAutoencoder::calculate_kl_loss(const NDArray& mean,
                                                  const NDArray& log_var) {
-  // KL divergence between N(mean, exp(log_var)) and N(0,1)
-  // KL = -0.5 * sum(1 + log_var - mean^2 - exp(log_var))
+  if (mean.shape() != log_var.shape()) {
+    throw std::invalid_argument("Mean and log variance shapes must match");
+  }
 
-  // Simplified implementation - placeholder
-  return 0.1;  // Default KL loss
+  // KL(N(mean, exp(log_var)) || N(0, I)) per row, averaged over the batch:
+  //   -0.5 * sum(1 + log_var - mean^2 - exp(log_var))
+  const double* mu = mean.data();
+  const double* lv = log_var.data();
+  double sum = 0.0;
+  for (size_t i = 0; i < mean.size(); ++i) {
+    sum += 1.0 + lv[i] - mu[i] * mu[i] - std::exp(lv[i]);
+  }
+  return -0.5 * sum / static_cast<double>(batchRows(mean));
 }
 
 NDArray
@@ -228,7 +377,7 @@ VariationalAutoencoder::sample_standard_normal(const std::vector<int>& shape) {
   // Convert int vector to size_t vector
   std::vector<size_t> shape_sizet(shape.begin(), shape.end());
   NDArray sample(shape_sizet);
-  // In practice, you'd fill with random normal samples
+  rng_.normal(sample.data(), sample.size());
   return sample;
 }
 
@@ -0,0 +1,233 @@
+#include "../../../include/MLLib/model/batching_executor.hpp"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace MLLib {
+namespace model {
+
+BatchingExecutor::BatchingExecutor(std::shared_ptr<const Sequential> model,
+                                   const BatchingOptions& options)
+    : model_(std::move(model)), options_(options), options_version_(0),
+      stop_(false), max_in_flight_(std::max<size_t>(1, options.num_workers)),
+      in_flight_batches_(0), in_flight_requests_(0), total_latency_us_(0.0) {
+  if (!model_) {
+    throw std::invalid_argument("BatchingExecutor requires a model");
+  }
+  if (options_.max_batch_size == 0) {
+    throw std::invalid_argument("max_batch_size must be positive");
+  }
+  workers_ = std::make_unique<util::ThreadPool>(max_in_flight_);
+  dispatcher_ = std::thread([this]() { dispatch_loop(); });
+}
+
+BatchingExecutor::~BatchingExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  dispatcher_.join();
+  // Destroying the pool finishes the batches already handed to it
+  workers_.reset();
+}
+
+std::future<std::vector<double>>
+BatchingExecutor::submit(std::vector<double> input) {
+  if (input.empty()) {
+    throw std::invalid_argument("Inference request must not be empty");
+  }
+
+  Request request;
+  request.input = std::move(input);
+  request.submitted = Clock::now();
+  std::future<std::vector<double>> future = request.promise.get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      throw std::runtime_error("BatchingExecutor is shutting down");
+    }
+    if (options_.max_queue_depth > 0 &&
+        pending() >= options_.max_queue_depth) {
+      ++metrics_.rejected;
+      throw std::runtime_error("Inference queue is full (" +
+                               std::to_string(pending()) + " pending)");
+    }
+    queue_.push_back(std::move(request));
+    metrics_.peak_queue_depth = std::max(metrics_.peak_queue_depth, pending());
+  }
+  condition_.notify_one();
+  return future;
+}
+
+void BatchingExecutor::set_max_batch_size(size_t max_batch_size) {
+  if (max_batch_size == 0) {
+    throw std::invalid_argument("max_batch_size must be positive");
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.max_batch_size = max_batch_size;
+    ++options_version_;
+  }
+  condition_.notify_one();
+}
+
+void BatchingExecutor::set_max_wait(std::chrono::microseconds max_wait) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.max_wait = max_wait;
+    ++options_version_;
+  }
+  condition_.notify_one();
+}
+
+BatchingOptions BatchingExecutor::options() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return options_;
+}
+
+size_t BatchingExecutor::queue_depth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending();
+}
+
+BatchingMetrics BatchingExecutor::metrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  BatchingMetrics snapshot = metrics_;
+  snapshot.queue_depth = pending();
+  if (snapshot.batches > 0) {
+    snapshot.average_batch_size = static_cast<double>(snapshot.requests) /
+                                  static_cast<double>(snapshot.batches);
+  }
+  if (snapshot.requests > 0) {
+    snapshot.average_latency_us =
+        total_latency_us_ / static_cast<double>(snapshot.requests);
+  }
+  return snapshot;
+}
+
+void BatchingExecutor::dispatch_loop() {
+  while (true) {
+    std::vector<Request> batch = take_batch();
+    if (batch.empty()) {
+      return;  // Stopped with nothing left to run
+    }
+
+    auto shared = std::make_shared<std::vector<Request>>(std::move(batch));
+    workers_->submit([this, shared]() { run_batch(*shared); });
+  }
+}
+
+std::vector<BatchingExecutor::Request> BatchingExecutor::take_batch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    // Only form a batch once a worker can take it, so requests keep
+    // accumulating here instead of in the pool
+    condition_.wait(lock, [this]() {
+      return (stop_ && queue_.empty()) ||
+             (!queue_.empty() && in_flight_batches_ < max_in_flight_);
+    });
+    if (queue_.empty()) {
+      return {};
+    }
+
+    // Wait for a full batch until the oldest request's deadline; on stop,
+    // flush immediately
+    const uint64_t version = options_version_;
+    Clock::time_point deadline = queue_.front().submitted + options_.max_wait;
+    bool woken = condition_.wait_until(lock, deadline, [this, version]() {
+      return stop_ || queue_.size() >= options_.max_batch_size ||
+             options_version_ != version;
+    });
+    if (!woken || stop_ || queue_.size() >= options_.max_batch_size) {
+      break;
+    }
+    // A knob changed; re-evaluate with the new options
+  }
+
+  // A batch holds requests of one feature size; others wait for the next
+  const size_t features = queue_.front().input.size();
+  std::vector<Request> batch;
+  batch.reserve(std::min(queue_.size(), options_.max_batch_size));
+  for (auto it = queue_.begin();
+       it != queue_.end() && batch.size() < options_.max_batch_size;) {
+    if (it->input.size() == features) {
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ++in_flight_batches_;
+  in_flight_requests_ += batch.size();
+  return batch;
+}
+
+void BatchingExecutor::run_batch(std::vector<Request>& batch) {
+  const size_t batch_size = batch.size();
+  const size_t features = batch.front().input.size();
+  std::vector<std::vector<double>> results;
+  std::exception_ptr error;
+
+  try {
+    NDArray input({batch_size, features});
+    double* data = input.data();
+    for (size_t i = 0; i < batch_size; ++i) {
+      std::copy(batch[i].input.begin(), batch[i].input.end(),
+                data + i * features);
+    }
+
+    // Each worker keeps its scratch buffers across batches
+    thread_local InferenceContext context;
+    const NDArray& output = model_->predict(input, context);
+    if (output.shape().size() != 2 || output.shape()[0] != batch_size) {
+      throw std::runtime_error("Model output does not have one row per sample");
+    }
+
+    const size_t outputs = output.shape()[1];
+    const double* rows = output.data();
+    results.reserve(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      results.emplace_back(rows + i * outputs, rows + (i + 1) * outputs);
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  // Metrics first, so they already include a request once its future is ready
+  record_completion(batch);
+
+  for (size_t i = 0; i < batch_size; ++i) {
+    if (error) {
+      batch[i].promise.set_exception(error);
+    } else {
+      batch[i].promise.set_value(std::move(results[i]));
+    }
+  }
+}
+
+void BatchingExecutor::record_completion(const std::vector<Request>& batch) {
+  Clock::time_point now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++metrics_.batches;
+    for (const auto& request : batch) {
+      double latency =
+          std::chrono::duration<double, std::micro>(now - request.submitted)
+              .count();
+      total_latency_us_ += latency;
+      metrics_.max_latency_us = std::max(metrics_.max_latency_us, latency);
+      ++metrics_.requests;
+    }
+    --in_flight_batches_;
+    in_flight_requests_ -= batch.size();
+  }
+  // Free slot for the dispatcher
+  condition_.notify_one();
+}
+
+}  // namespace model
+}  // namespace MLLib
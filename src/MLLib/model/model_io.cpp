@@ -8,7 +8,9 @@
 #include "MLLib/layer/dense.hpp"
 #include <algorithm>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #ifdef MLLIB_JSON_SUPPORT
 #include "MLLib/third_party/json.hpp"
 using json = nlohmann::json;
@@ -823,6 +825,8 @@ bool ModelIO::save_json(const Sequential& model, const std::string& filepath) {
 
   ModelConfig config = extract_config(model);
 
+  // Enough digits for parameters to round-trip exactly
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
   file << "{\n";
   file << "  \"model_type\": \"" << config.model_type << "\",\n";
   file << "  \"version\": \"" << config.version << "\",\n";
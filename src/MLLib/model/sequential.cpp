@@ -9,16 +9,74 @@
 #include "../../../include/MLLib/layer/activation/tanh.hpp"
 #include "../../../include/MLLib/layer/dense.hpp"
 #include "../../../include/MLLib/model/model_io.hpp"
+#include "../../../include/MLLib/util/system/thread.hpp"
 #include <algorithm>
 #include <cstring>
 #include <initializer_list>
 #include <iostream>
+#include <map>
 #include <stdexcept>
 #include <typeinfo>
 
 namespace MLLib {
 namespace model {
 
+namespace {
+
+// Inputs stacked per batch before another thread is worth using
+constexpr size_t kMinInputsPerBatch = 16;
+
+/**
+ * @brief First layer of a model that takes sparse inputs
+ */
+layer::Dense*
+sparseInputLayer(const std::vector<std::shared_ptr<layer::BaseLayer>>& layers) {
+  if (layers.empty()) {
+    throw std::runtime_error("No layers added to the model");
+  }
+  auto* dense = dynamic_cast<layer::Dense*>(layers.front().get());
+  if (!dense) {
+    throw std::invalid_argument("Sparse inputs require a Dense first layer");
+  }
+  return dense;
+}
+
+/**
+ * @brief Append an array as its size in bytes followed by its raw bytes
+ */
+template <typename T>
+void appendArray(std::vector<uint8_t>& out, const std::vector<T>& values) {
+  const size_t bytes = values.size() * sizeof(T);
+  const uint8_t* size_bytes = reinterpret_cast<const uint8_t*>(&bytes);
+  out.insert(out.end(), size_bytes, size_bytes + sizeof(size_t));
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(values.data());
+  out.insert(out.end(), data, data + bytes);
+}
+
+/**
+ * @brief Read an array written by appendArray
+ * @return False if the data ends early
+ */
+template <typename T>
+bool readArray(const std::vector<uint8_t>& data, size_t& offset,
+               std::vector<T>& values) {
+  if (offset + sizeof(size_t) > data.size()) {
+    return false;
+  }
+  size_t bytes;
+  std::memcpy(&bytes, &data[offset], sizeof(size_t));
+  offset += sizeof(size_t);
+  if (bytes % sizeof(T) != 0 || bytes > data.size() - offset) {
+    return false;
+  }
+  values.resize(bytes / sizeof(T));
+  std::memcpy(values.data(), data.data() + offset, bytes);
+  offset += bytes;
+  return true;
+}
+
+}  // namespace
+
 Sequential::Sequential()
     : BaseModel(ModelType::SEQUENTIAL), device_(DeviceType::CPU) {}
 
@@ -49,36 +107,127 @@ void Sequential::set_device(DeviceType device) {
   }
 }
 
-NDArray Sequential::predict(const NDArray& input) {
+const NDArray& InferenceContext::output() const {
+  if (activations_.empty()) {
+    throw std::logic_error("InferenceContext has not been used yet");
+  }
+  return activations_.back();
+}
+
+const NDArray& Sequential::predict(const NDArray& input,
+                                   InferenceContext& context) const {
   if (layers_.empty()) {
     throw std::runtime_error("No layers added to the model");
   }
 
-  NDArray current_output = input;
+  // Forward pass through all layers; weights are only read
+  context.activations_.resize(layers_.size());
+  const NDArray* current = &input;
+  for (size_t i = 0; i < layers_.size(); ++i) {
+    layers_[i]->infer(*current, context.activations_[i]);
+    current = &context.activations_[i];
+  }
 
-  // Set all layers to inference mode
-  set_training(false);
+  return *current;
+}
 
-  // Forward pass through all layers
-  for (const auto& layer : layers_) {
-    current_output = layer->forward(current_output);
+NDArray Sequential::predict(const NDArray& input) const {
+  InferenceContext context;
+  predict(input, context);
+  return std::move(context.activations_.back());
+}
+
+NDArray Sequential::predict(const SparseMatrix& input) const {
+  layer::Dense* first = sparseInputLayer(layers_);
+
+  std::vector<NDArray> activations(layers_.size());
+  first->infer(input, activations[0]);
+  for (size_t i = 1; i < layers_.size(); ++i) {
+    layers_[i]->infer(activations[i - 1], activations[i]);
   }
+  return std::move(activations.back());
+}
 
-  return current_output;
+std::future<NDArray> Sequential::predict_async(const NDArray& input,
+                                               Backend::Stream& stream) const {
+  return stream.enqueue([this, input]() { return predict(input); });
 }
 
-std::vector<NDArray> Sequential::predict(const std::vector<NDArray>& inputs) {
-  std::vector<NDArray> predictions;
-  predictions.reserve(inputs.size());
+std::vector<NDArray>
+Sequential::predict(const std::vector<NDArray>& inputs) const {
+  std::vector<NDArray> predictions(inputs.size());
+
+  // Bucket [rows, features] inputs by feature count so each bucket can run
+  // as stacked GEMMs; other shapes are predicted on their own
+  std::map<size_t, std::vector<size_t>> buckets;
+  std::vector<size_t> unbatched;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& shape = inputs[i].shape();
+    if (shape.size() == 2 && shape[0] > 0 && shape[1] > 0) {
+      buckets[shape[1]].push_back(i);
+    } else {
+      unbatched.push_back(i);
+    }
+  }
+
+  for (size_t index : unbatched) {
+    predictions[index] = predict(inputs[index]);
+  }
+
+  util::ThreadPool& pool = util::ThreadPool::global();
+  for (const auto& bucket : buckets) {
+    const size_t features = bucket.first;
+    const std::vector<size_t>& members = bucket.second;
+
+    // Each chunk of the bucket is stacked into one batch and run with its
+    // own scratch buffers; chunks run concurrently
+    pool.parallel_for(
+        0, members.size(),
+        [&](size_t begin, size_t end) {
+          InferenceContext context;
+          if (end - begin == 1) {
+            predict(inputs[members[begin]], context);
+            predictions[members[begin]] =
+                std::move(context.activations_.back());
+            return;
+          }
+
+          size_t rows = 0;
+          for (size_t m = begin; m < end; ++m) {
+            rows += inputs[members[m]].shape()[0];
+          }
+          NDArray batch({rows, features});
+          double* dst = batch.data();
+          for (size_t m = begin; m < end; ++m) {
+            const NDArray& input = inputs[members[m]];
+            dst = std::copy(input.data(), input.data() + input.size(), dst);
+          }
 
-  for (const auto& input : inputs) {
-    predictions.push_back(predict(input));
+          const NDArray& output = predict(batch, context);
+          if (output.shape().size() != 2 || output.shape()[0] != rows) {
+            throw std::runtime_error(
+                "Batched predict requires one output row per input row");
+          }
+
+          // Split the rows back into per-input outputs
+          const size_t width = output.shape()[1];
+          const double* src = output.data();
+          for (size_t m = begin; m < end; ++m) {
+            const size_t input_rows = inputs[members[m]].shape()[0];
+            NDArray result({input_rows, width});
+            std::copy(src, src + input_rows * width, result.data());
+            src += input_rows * width;
+            predictions[members[m]] = std::move(result);
+          }
+        },
+        kMinInputsPerBatch);
   }
 
   return predictions;
 }
 
-std::vector<double> Sequential::predict(const std::vector<double>& input) {
+std::vector<double>
+Sequential::predict(const std::vector<double>& input) const {
   NDArray input_array(input);
   input_array.reshape({1, input.size()});  // Add batch dimension
 
@@ -96,7 +245,8 @@ std::vector<double> Sequential::predict(const std::vector<double>& input) {
   return result;
 }
 
-std::vector<double> Sequential::predict(std::initializer_list<double> input) {
+std::vector<double>
+Sequential::predict(std::initializer_list<double> input) const {
   std::vector<double> input_vector(input);
   return predict(input_vector);
 }
@@ -119,21 +269,48 @@ void Sequential::train(const std::vector<std::vector<double>>& X,
   NDArray input_batch = vectorsToNDArray(X);
   NDArray target_batch = vectorsToNDArray(Y);
 
+  fit([&]() { return input_batch; }, 0, target_batch, loss, optimizer,
+      callback, epochs);
+}
+
+void Sequential::train(const SparseMatrix& X,
+                       const std::vector<std::vector<double>>& Y,
+                       loss::BaseLoss& loss,
+                       optimizer::BaseOptimizer& optimizer,
+                       std::function<void(int, double)> callback, int epochs) {
+  if (X.rows() != Y.size()) {
+    throw std::invalid_argument(
+        "Number of input samples must match number of targets");
+  }
+
+  layer::Dense* first = sparseInputLayer(layers_);
+  NDArray target_batch = vectorsToNDArray(Y);
+
+  fit([&]() { return first->forward(X); }, 1, target_batch, loss, optimizer,
+      callback, epochs);
+}
+
+void Sequential::fit(const std::function<NDArray()>& forward_input,
+                     size_t first_layer, const NDArray& targets,
+                     loss::BaseLoss& loss,
+                     optimizer::BaseOptimizer& optimizer,
+                     const std::function<void(int, double)>& callback,
+                     int epochs) {
   // Set all layers to training mode
   set_training(true);
 
   for (int epoch = 0; epoch < epochs; ++epoch) {
     // Forward pass
-    NDArray current_output = input_batch;
-    for (const auto& layer : layers_) {
-      current_output = layer->forward(current_output);
+    NDArray current_output = forward_input();
+    for (size_t i = first_layer; i < layers_.size(); ++i) {
+      current_output = layers_[i]->forward(current_output);
     }
 
     // Compute loss
-    double current_loss = loss.compute_loss(current_output, target_batch);
+    double current_loss = loss.compute_loss(current_output, targets);
 
     // Backward pass
-    NDArray grad = loss.compute_gradient(current_output, target_batch);
+    NDArray grad = loss.compute_gradient(current_output, targets);
 
     // Backpropagate through all layers in reverse order
     for (int i = layers_.size() - 1; i >= 0; --i) {
@@ -204,19 +381,10 @@ std::vector<NDArray*> Sequential::get_all_parameters() {
 std::vector<NDArray*> Sequential::get_all_gradients() {
   std::vector<NDArray*> all_grads;
 
+  // Layers without parameters return no gradients
   for (const auto& layer : layers_) {
-    auto layer_params = layer->get_parameters();
-
-    // For Dense layers, we need to get gradients
-    if (auto dense_layer = dynamic_cast<layer::Dense*>(layer.get())) {
-      all_grads.push_back(
-          const_cast<NDArray*>(&dense_layer->get_weight_gradients()));
-      if (dense_layer->get_bias().size() > 0) {  // Check if bias is used
-        all_grads.push_back(
-            const_cast<NDArray*>(&dense_layer->get_bias_gradients()));
-      }
-    }
-    // Activation layers don't have parameters, so no gradients to add
+    auto layer_grads = layer->get_gradients();
+    all_grads.insert(all_grads.end(), layer_grads.begin(), layer_grads.end());
   }
 
   return all_grads;
@@ -253,8 +421,10 @@ Sequential::serialize() const {
     // Check layer type and serialize accordingly
     if (auto dense_layer =
             dynamic_cast<const layer::Dense*>(layers_[i].get())) {
-      // Store layer type identifier
-      layer_data.push_back(1);  // Dense layer type = 1
+      // Store layer type identifier; pruned layers that were compressed
+      // store only their nonzero blocks
+      const bool compressed = dense_layer->has_compressed_weights();
+      layer_data.push_back(compressed ? 2 : 1);  // Dense = 1, block sparse = 2
 
       // Store Dense layer configuration
       size_t input_size = dense_layer->get_input_size();
@@ -271,6 +441,21 @@ Sequential::serialize() const {
 
       layer_data.push_back(use_bias ? 1 : 0);
 
+      if (compressed) {
+        const auto& weights = dense_layer->get_compressed_weights();
+        std::vector<size_t> block_shape = {weights.block_rows(),
+                                           weights.block_cols()};
+        appendArray(layer_data, block_shape);
+        appendArray(layer_data, weights.block_row_offsets());
+        appendArray(layer_data, weights.block_col_indices());
+        appendArray(layer_data, weights.values());
+        if (use_bias) {
+          appendArray(layer_data, dense_layer->get_bias().to_vector());
+        }
+        data.emplace(layer_key, std::move(layer_data));
+        continue;
+      }
+
       // Serialize weights and biases to the same data buffer
       const auto& weights = dense_layer->get_weights();
 
@@ -462,6 +647,53 @@ bool Sequential::deserialize(
           }
         }
       }
+    } else if (layer_type == 2) {  // Dense layer with block sparse weights
+      if (layer_data.size() < 1 + 2 * sizeof(size_t) + 1) {
+        std::cerr << "Invalid Dense layer data size" << std::endl;
+        return false;
+      }
+
+      size_t offset = 1;
+      size_t input_size;
+      size_t output_size;
+      std::memcpy(&input_size, &layer_data[offset], sizeof(size_t));
+      offset += sizeof(size_t);
+      std::memcpy(&output_size, &layer_data[offset], sizeof(size_t));
+      offset += sizeof(size_t);
+      bool use_bias = (layer_data[offset] != 0);
+      offset += 1;
+
+      std::vector<size_t> block_shape;
+      std::vector<size_t> block_row_offsets;
+      std::vector<size_t> block_col_indices;
+      std::vector<double> values;
+      std::vector<double> bias;
+      if (!readArray(layer_data, offset, block_shape) ||
+          block_shape.size() != 2 ||
+          !readArray(layer_data, offset, block_row_offsets) ||
+          !readArray(layer_data, offset, block_col_indices) ||
+          !readArray(layer_data, offset, values) ||
+          (use_bias && (!readArray(layer_data, offset, bias) ||
+                        bias.size() != output_size))) {
+        std::cerr << "Invalid block sparse Dense layer data" << std::endl;
+        return false;
+      }
+
+      auto dense_layer =
+          std::make_shared<layer::Dense>(input_size, output_size, use_bias);
+      try {
+        dense_layer->set_compressed_weights(BlockSparseMatrix(
+            input_size, output_size, block_shape[0], block_shape[1],
+            std::move(block_row_offsets), std::move(block_col_indices),
+            std::move(values)));
+      } catch (const std::invalid_argument& e) {
+        std::cerr << "Invalid block sparse weights: " << e.what() << std::endl;
+        return false;
+      }
+      if (use_bias) {
+        dense_layer->set_biases(NDArray(bias));
+      }
+      layers_.push_back(dense_layer);
     } else if (layer_type == 0) {
       // Activation layer - identify by name or specific identifier
       if (layer_data.size() < 2) {
@@ -1,28 +1,31 @@
 #include "../../include/MLLib/ndarray.hpp"
+#include "../../include/MLLib/backend/device_memory.hpp"
+#include "../../include/MLLib/util/system/memory.hpp"
 #include <algorithm>
 #include <cstring>
 #include <numeric>
 #include <stdexcept>
+#include <utility>
 
 namespace MLLib {
 
 NDArray::NDArray(const std::vector<size_t>& shape) : shape_(shape) {
   calculate_size();
-  data_ = std::make_unique<double[]>(size_);
-  std::fill(data_.get(), data_.get() + size_, 0.0);
+  data_ = util::allocate_uninitialized(size_);
+  util::first_touch_fill(data_.get(), size_, 0.0);
 }
 
 NDArray::NDArray(std::initializer_list<size_t> shape) : shape_(shape) {
   calculate_size();
-  data_ = std::make_unique<double[]>(size_);
-  std::fill(data_.get(), data_.get() + size_, 0.0);
+  data_ = util::allocate_uninitialized(size_);
+  util::first_touch_fill(data_.get(), size_, 0.0);
 }
 
 NDArray::NDArray(const std::vector<double>& data) {
   shape_ = {data.size()};
   calculate_size();
-  data_ = std::make_unique<double[]>(size_);
-  std::copy(data.begin(), data.end(), data_.get());
+  data_ = util::allocate_uninitialized(size_);
+  util::first_touch_copy(data.data(), size_, data_.get());
 }
 
 NDArray::NDArray(const std::vector<std::vector<double>>& data) {
@@ -51,8 +54,9 @@ NDArray::NDArray(const std::vector<std::vector<double>>& data) {
 NDArray::NDArray(const NDArray& other)
     : shape_(other.shape_), size_(other.size_) {
   if (size_ > 0) {
-    data_ = std::make_unique<double[]>(size_);
-    std::copy(other.data_.get(), other.data_.get() + size_, data_.get());
+    other.sync_host();
+    data_ = util::allocate_uninitialized(size_);
+    util::first_touch_copy(other.data_.get(), size_, data_.get());
   }
 }
 
@@ -60,9 +64,12 @@ NDArray& NDArray::operator=(const NDArray& other) {
   if (this != &other) {
     shape_ = other.shape_;
     size_ = other.size_;
+    device_.reset();
+    residency_ = Residency::HOST;
     if (size_ > 0) {
-      data_ = std::make_unique<double[]>(size_);
-      std::copy(other.data_.get(), other.data_.get() + size_, data_.get());
+      other.sync_host();
+      data_ = util::allocate_uninitialized(size_);
+      util::first_touch_copy(other.data_.get(), size_, data_.get());
     } else {
       data_.reset();
     }
@@ -70,10 +77,34 @@ NDArray& NDArray::operator=(const NDArray& other) {
   return *this;
 }
 
+NDArray::NDArray(NDArray&& other) noexcept
+    : shape_(std::move(other.shape_)), size_(other.size_),
+      data_(std::move(other.data_)), device_(std::move(other.device_)),
+      residency_(other.residency_.load()) {
+  other.shape_.clear();
+  other.size_ = 0;
+  other.residency_ = Residency::HOST;
+}
+
+NDArray& NDArray::operator=(NDArray&& other) noexcept {
+  if (this != &other) {
+    shape_ = std::move(other.shape_);
+    size_ = other.size_;
+    data_ = std::move(other.data_);
+    device_ = std::move(other.device_);
+    residency_ = other.residency_.load();
+    other.shape_.clear();
+    other.size_ = 0;
+    other.residency_ = Residency::HOST;
+  }
+  return *this;
+}
+
 double& NDArray::operator[](size_t index) {
   if (index >= size_) {
     throw std::out_of_range("Index out of range");
   }
+  sync_host_for_write();
   return data_[index];
 }
 
@@ -81,16 +112,19 @@ const double& NDArray::operator[](size_t index) const {
   if (index >= size_) {
     throw std::out_of_range("Index out of range");
   }
+  sync_host();
   return data_[index];
 }
 
 double& NDArray::at(const std::vector<size_t>& indices) {
   size_t linear_index = to_linear_index(indices);
+  sync_host_for_write();
   return data_[linear_index];
 }
 
 const double& NDArray::at(const std::vector<size_t>& indices) const {
   size_t linear_index = to_linear_index(indices);
+  sync_host();
   return data_[linear_index];
 }
 
@@ -108,10 +142,13 @@ void NDArray::reshape(const std::vector<size_t>& new_shape) {
 }
 
 void NDArray::fill(double value) {
+  // Every element is overwritten, so stale device data need not be fetched
+  residency_ = Residency::HOST;
   std::fill(data_.get(), data_.get() + size_, value);
 }
 
 std::vector<double> NDArray::to_vector() const {
+  sync_host();
   std::vector<double> result(size_);
   std::copy(data_.get(), data_.get() + size_, result.begin());
   return result;
@@ -132,6 +169,8 @@ NDArray NDArray::matmul(const NDArray& other) const {
   }
 
   NDArray result({m, n});
+  sync_host();
+  other.sync_host();
 
   // Simple CPU matrix multiplication
   for (size_t i = 0; i < m; ++i) {
@@ -147,58 +186,74 @@ NDArray NDArray::matmul(const NDArray& other) const {
   return result;
 }
 
-NDArray NDArray::operator+(const NDArray& other) const {
-  if (shape_ != other.shape_) {
-    throw std::invalid_argument("Shapes must match for element-wise addition");
-  }
-
+NDArray NDArray::operator+(double scalar) const {
   NDArray result(shape_);
+  sync_host();
   for (size_t i = 0; i < size_; ++i) {
-    result.data_[i] = data_[i] + other.data_[i];
+    result.data_[i] = data_[i] + scalar;
   }
   return result;
 }
 
-NDArray NDArray::operator-(const NDArray& other) const {
-  if (shape_ != other.shape_) {
-    throw std::invalid_argument(
-        "Shapes must match for element-wise subtraction");
-  }
-
+NDArray NDArray::operator*(double scalar) const {
   NDArray result(shape_);
+  sync_host();
   for (size_t i = 0; i < size_; ++i) {
-    result.data_[i] = data_[i] - other.data_[i];
+    result.data_[i] = data_[i] * scalar;
   }
   return result;
 }
 
-NDArray NDArray::operator*(const NDArray& other) const {
-  if (shape_ != other.shape_) {
-    throw std::invalid_argument(
-        "Shapes must match for element-wise multiplication");
+void NDArray::set_device_state(std::shared_ptr<Backend::DeviceBuffer> buffer,
+                               Residency residency) const {
+  if (residency != Residency::HOST && (!buffer || buffer->size() < size_)) {
+    throw std::invalid_argument("Device buffer is too small for the array");
   }
+  std::lock_guard<std::mutex> lock(sync_mutex_);
+  device_ = std::move(buffer);
+  residency_ = residency;
+}
 
-  NDArray result(shape_);
-  for (size_t i = 0; i < size_; ++i) {
-    result.data_[i] = data_[i] * other.data_[i];
+void NDArray::set_residency(Residency residency) const {
+  std::lock_guard<std::mutex> lock(sync_mutex_);
+  if (residency != Residency::HOST && !device_) {
+    throw std::logic_error("No device buffer attached to the array");
   }
-  return result;
+  residency_ = residency;
 }
 
-NDArray NDArray::operator+(double scalar) const {
-  NDArray result(shape_);
-  for (size_t i = 0; i < size_; ++i) {
-    result.data_[i] = data_[i] + scalar;
+std::shared_ptr<Backend::DeviceBuffer>
+NDArray::ensure_device(Backend::DeviceMemoryBackend& memory) const {
+  std::lock_guard<std::mutex> lock(sync_mutex_);
+  const Residency residency = residency_.load(std::memory_order_relaxed);
+  if (device_ && device_->owner() == &memory && device_->size() >= size_) {
+    if (residency == Residency::HOST) {
+      device_->upload(data_.get(), size_);
+      residency_.store(Residency::BOTH, std::memory_order_release);
+    }
+    return device_;
   }
-  return result;
+
+  // The only valid copy may live in another device memory; fetch it first
+  if (residency == Residency::DEVICE && size_ > 0) {
+    device_->download(data_.get(), size_);
+  }
+  std::shared_ptr<Backend::DeviceBuffer> fresh = memory.allocate(size_);
+  fresh->upload(data_.get(), size_);
+  device_ = fresh;
+  residency_.store(Residency::BOTH, std::memory_order_release);
+  return fresh;
 }
 
-NDArray NDArray::operator*(double scalar) const {
-  NDArray result(shape_);
-  for (size_t i = 0; i < size_; ++i) {
-    result.data_[i] = data_[i] * scalar;
+void NDArray::download_from_device() const {
+  std::lock_guard<std::mutex> lock(sync_mutex_);
+  if (residency_.load(std::memory_order_relaxed) != Residency::DEVICE) {
+    return;  // Another reader finished the download first
   }
-  return result;
+  if (size_ > 0) {
+    device_->download(data_.get(), size_);
+  }
+  residency_.store(Residency::BOTH, std::memory_order_release);
 }
 
 void NDArray::calculate_size() {
@@ -0,0 +1,622 @@
+#include "../../include/MLLib/ndarray.hpp"
+#include "../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Broadcasting element-wise operators and axis reductions.
+ *
+ * Reductions view the array as [outer, n, inner] around the reduced axis.
+ * With inner == 1 each output is a contiguous row, summed in LANES
+ * independent accumulators. Otherwise TILE inner columns are reduced
+ * together row by row, so every pass reads contiguous memory and keeps its
+ * accumulators in L1. Both layouts vectorize and are split into tasks on
+ * the global thread pool.
+ */
+
+namespace MLLib {
+
+namespace {
+
+// Work below this many elements stays on the calling thread
+constexpr size_t MIN_ELEMENTS_PER_TASK = 1 << 15;
+
+// Rows summed directly before pairwise combination
+constexpr size_t PAIRWISE_BLOCK = 128;
+
+// Independent accumulators for contiguous sums
+constexpr size_t LANES = 8;
+
+// Inner columns reduced together by strided reductions
+constexpr size_t TILE = 256;
+
+// Elements per partial result of a full reduction; fixed so results do not
+// depend on the number of threads
+constexpr size_t FULL_CHUNK = 1 << 16;
+
+template <typename Body>
+void forTasks(size_t tasks, size_t elements_per_task, Body body) {
+  size_t min_chunk = std::max<size_t>(
+      1, MIN_ELEMENTS_PER_TASK / std::max<size_t>(1, elements_per_task));
+  util::ThreadPool::global().parallel_for(
+      0, tasks,
+      [&](size_t begin, size_t end) {
+        for (size_t task = begin; task < end; ++task) {
+          body(task);
+        }
+      },
+      min_chunk);
+}
+
+struct Identity {
+  double operator()(double x) const { return x; }
+};
+
+// Contiguous sums of f(x[i])
+
+template <typename F> double laneSum(const double* x, size_t n, F f) {
+  double acc[LANES] = {};
+  size_t i = 0;
+  for (; i + LANES <= n; i += LANES) {
+    for (size_t l = 0; l < LANES; ++l) {
+      acc[l] += f(x[i + l]);
+    }
+  }
+  double total = ((acc[0] + acc[1]) + (acc[2] + acc[3])) +
+                 ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+  for (; i < n; ++i) {
+    total += f(x[i]);
+  }
+  return total;
+}
+
+template <typename F> double pairwiseSum(const double* x, size_t n, F f) {
+  if (n <= PAIRWISE_BLOCK) {
+    return laneSum(x, n, f);
+  }
+  size_t half = n / 2 / LANES * LANES;
+  return pairwiseSum(x, half, f) + pairwiseSum(x + half, n - half, f);
+}
+
+template <typename F> double kahanSum(const double* x, size_t n, F f) {
+  double sum = 0.0;
+  double compensation = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    double y = f(x[i]) - compensation;
+    double t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+  }
+  return sum;
+}
+
+template <typename F>
+double contiguousSum(const double* x, size_t n, Accumulation accumulation,
+                     F f) {
+  switch (accumulation) {
+  case Accumulation::NAIVE: return laneSum(x, n, f);
+  case Accumulation::KAHAN: return kahanSum(x, n, f);
+  default: return pairwiseSum(x, n, f);
+  }
+}
+
+// Strided sums of f(x[r * stride + j], j) over rows r, for w columns j
+
+template <typename F>
+void laneSumStrided(const double* x, size_t rows, size_t stride, size_t w,
+                    F f, double* acc) {
+  std::fill(acc, acc + w, 0.0);
+  for (size_t r = 0; r < rows; ++r) {
+    const double* row = x + r * stride;
+    for (size_t j = 0; j < w; ++j) {
+      acc[j] += f(row[j], j);
+    }
+  }
+}
+
+template <typename F>
+void pairwiseSumStrided(const double* x, size_t rows, size_t stride,
+                        size_t w, F f, double* acc) {
+  if (rows <= PAIRWISE_BLOCK) {
+    laneSumStrided(x, rows, stride, w, f, acc);
+    return;
+  }
+  size_t half = rows / 2;
+  double right[TILE];
+  pairwiseSumStrided(x, half, stride, w, f, acc);
+  pairwiseSumStrided(x + half * stride, rows - half, stride, w, f, right);
+  for (size_t j = 0; j < w; ++j) {
+    acc[j] += right[j];
+  }
+}
+
+template <typename F>
+void kahanSumStrided(const double* x, size_t rows, size_t stride, size_t w,
+                     F f, double* acc) {
+  double compensation[TILE] = {};
+  std::fill(acc, acc + w, 0.0);
+  for (size_t r = 0; r < rows; ++r) {
+    const double* row = x + r * stride;
+    for (size_t j = 0; j < w; ++j) {
+      double y = f(row[j], j) - compensation[j];
+      double t = acc[j] + y;
+      compensation[j] = (t - acc[j]) - y;
+      acc[j] = t;
+    }
+  }
+}
+
+/**
+ * @brief Array seen as [outer, n, inner] around a reduced axis
+ */
+struct AxisView {
+  size_t outer = 1;
+  size_t n = 1;
+  size_t inner = 1;
+  std::vector<size_t> result_shape;
+
+  size_t outputs() const { return outer * inner; }
+};
+
+AxisView axisView(const std::vector<size_t>& shape, int axis,
+                  bool keep_dims) {
+  const int rank = static_cast<int>(shape.size());
+  const int resolved = axis < 0 ? axis + rank : axis;
+  if (resolved < 0 || resolved >= rank) {
+    throw std::invalid_argument("Axis out of range");
+  }
+
+  AxisView view;
+  for (int d = 0; d < rank; ++d) {
+    if (d < resolved) {
+      view.outer *= shape[d];
+    } else if (d > resolved) {
+      view.inner *= shape[d];
+    }
+  }
+  view.n = shape[resolved];
+
+  view.result_shape = shape;
+  if (keep_dims) {
+    view.result_shape[resolved] = 1;
+  } else {
+    view.result_shape.erase(view.result_shape.begin() + resolved);
+    if (view.result_shape.empty()) {
+      view.result_shape = {1};
+    }
+  }
+  return view;
+}
+
+/**
+ * @brief out[k] = sum over the axis of f(x, k) for each output index k
+ */
+template <typename F>
+void reduceSum(const double* in, const AxisView& view,
+               Accumulation accumulation, double* out, F f) {
+  if (view.inner == 1) {
+    forTasks(view.outer, view.n, [&](size_t o) {
+      out[o] = contiguousSum(in + o * view.n, view.n, accumulation,
+                             [&](double x) { return f(x, o); });
+    });
+    return;
+  }
+
+  const size_t tiles = (view.inner + TILE - 1) / TILE;
+  forTasks(view.outer * tiles, view.n * std::min(TILE, view.inner),
+           [&](size_t task) {
+             const size_t o = task / tiles;
+             const size_t i0 = (task % tiles) * TILE;
+             const size_t w = std::min(TILE, view.inner - i0);
+             const size_t base = o * view.inner + i0;
+             const double* x = in + o * view.n * view.inner + i0;
+             auto g = [&](double value, size_t j) {
+               return f(value, base + j);
+             };
+             switch (accumulation) {
+             case Accumulation::NAIVE:
+               laneSumStrided(x, view.n, view.inner, w, g, out + base);
+               break;
+             case Accumulation::KAHAN:
+               kahanSumStrided(x, view.n, view.inner, w, g, out + base);
+               break;
+             default:
+               pairwiseSumStrided(x, view.n, view.inner, w, g, out + base);
+               break;
+             }
+           });
+}
+
+/**
+ * @brief Sum of f(x) over all elements, from fixed-size partial sums
+ */
+template <typename F>
+double fullSum(const double* in, size_t size, Accumulation accumulation,
+               F f) {
+  if (size <= FULL_CHUNK) {
+    return contiguousSum(in, size, accumulation, f);
+  }
+  const size_t chunks = (size + FULL_CHUNK - 1) / FULL_CHUNK;
+  std::vector<double> partial(chunks);
+  forTasks(chunks, FULL_CHUNK, [&](size_t c) {
+    const size_t begin = c * FULL_CHUNK;
+    partial[c] = contiguousSum(in + begin, std::min(FULL_CHUNK, size - begin),
+                               accumulation, f);
+  });
+  return contiguousSum(partial.data(), chunks, accumulation, Identity());
+}
+
+/**
+ * @brief Largest value and its first position along the axis
+ */
+void reduceArgMax(const double* in, const AxisView& view, double* values,
+                  double* indices) {
+  if (view.n == 0) {
+    throw std::invalid_argument("Cannot take the maximum of an empty axis");
+  }
+  if (view.inner == 1) {
+    forTasks(view.outer, view.n, [&](size_t o) {
+      const double* x = in + o * view.n;
+      double best = x[0];
+      size_t index = 0;
+      for (size_t i = 1; i < view.n; ++i) {
+        if (x[i] > best) {
+          best = x[i];
+          index = i;
+        }
+      }
+      values[o] = best;
+      indices[o] = static_cast<double>(index);
+    });
+    return;
+  }
+
+  const size_t tiles = (view.inner + TILE - 1) / TILE;
+  forTasks(view.outer * tiles, view.n * std::min(TILE, view.inner),
+           [&](size_t task) {
+             const size_t o = task / tiles;
+             const size_t i0 = (task % tiles) * TILE;
+             const size_t w = std::min(TILE, view.inner - i0);
+             const size_t base = o * view.inner + i0;
+             const double* x = in + o * view.n * view.inner + i0;
+             double* best = values + base;
+             double* index = indices + base;
+             std::copy(x, x + w, best);
+             std::fill(index, index + w, 0.0);
+             for (size_t r = 1; r < view.n; ++r) {
+               const double* row = x + r * view.inner;
+               const double position = static_cast<double>(r);
+               for (size_t j = 0; j < w; ++j) {
+                 bool larger = row[j] > best[j];
+                 best[j] = larger ? row[j] : best[j];
+                 index[j] = larger ? position : index[j];
+               }
+             }
+           });
+}
+
+/**
+ * @brief Largest element and its first linear index
+ */
+std::pair<double, size_t> fullArgMax(const double* in, size_t size) {
+  if (size == 0) {
+    throw std::invalid_argument("Cannot take the maximum of an empty array");
+  }
+  const size_t chunks = (size + FULL_CHUNK - 1) / FULL_CHUNK;
+  std::vector<std::pair<double, size_t>> partial(chunks);
+  forTasks(chunks, FULL_CHUNK, [&](size_t c) {
+    const size_t begin = c * FULL_CHUNK;
+    const size_t end = std::min(size, begin + FULL_CHUNK);
+    std::pair<double, size_t> best(in[begin], begin);
+    for (size_t i = begin + 1; i < end; ++i) {
+      if (in[i] > best.first) {
+        best = {in[i], i};
+      }
+    }
+    partial[c] = best;
+  });
+  std::pair<double, size_t> best = partial[0];
+  for (size_t c = 1; c < chunks; ++c) {
+    if (partial[c].first > best.first) {
+      best = partial[c];
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Iteration plan for a broadcast operation
+ * @details Dimensions of the output are coalesced wherever both operands
+ * stay contiguous (or both broadcast), leaving as few and as long inner
+ * rows as possible. Strides are in elements; 0 marks a broadcast dimension.
+ */
+struct BroadcastPlan {
+  std::vector<size_t> extent;
+  std::vector<size_t> stride_a;
+  std::vector<size_t> stride_b;
+};
+
+std::vector<size_t> alignedStrides(const std::vector<size_t>& shape,
+                                   size_t rank) {
+  std::vector<size_t> strides(rank, 0);
+  size_t stride = 1;
+  for (size_t k = 0; k < shape.size(); ++k) {
+    size_t d = shape.size() - 1 - k;
+    size_t out = rank - 1 - k;
+    strides[out] = shape[d] == 1 ? 0 : stride;
+    stride *= shape[d];
+  }
+  return strides;
+}
+
+BroadcastPlan planBroadcast(const std::vector<size_t>& out_shape,
+                            const std::vector<size_t>& a_shape,
+                            const std::vector<size_t>& b_shape) {
+  const size_t rank = out_shape.size();
+  std::vector<size_t> sa = alignedStrides(a_shape, rank);
+  std::vector<size_t> sb = alignedStrides(b_shape, rank);
+
+  // Build from the innermost dimension outwards, then reverse
+  BroadcastPlan plan;
+  for (size_t k = rank; k-- > 0;) {
+    if (out_shape[k] == 1) {
+      continue;
+    }
+    if (!plan.extent.empty()) {
+      size_t extent = plan.extent.back();
+      bool merge_a = sa[k] == plan.stride_a.back() * extent;
+      bool merge_b = sb[k] == plan.stride_b.back() * extent;
+      if (merge_a && merge_b) {
+        plan.extent.back() *= out_shape[k];
+        continue;
+      }
+    }
+    plan.extent.push_back(out_shape[k]);
+    plan.stride_a.push_back(sa[k]);
+    plan.stride_b.push_back(sb[k]);
+  }
+  if (plan.extent.empty()) {
+    plan = {{1}, {0}, {0}};
+  }
+  std::reverse(plan.extent.begin(), plan.extent.end());
+  std::reverse(plan.stride_a.begin(), plan.stride_a.end());
+  std::reverse(plan.stride_b.begin(), plan.stride_b.end());
+  return plan;
+}
+
+/**
+ * @brief out = op(a, b) over a broadcast plan; out is contiguous
+ * @details out may alias a when a has the output shape.
+ */
+template <typename Op>
+void broadcastApply(const double* a, const double* b, double* out,
+                    const BroadcastPlan& plan, Op op) {
+  const size_t dims = plan.extent.size();
+  const size_t inner = plan.extent.back();
+  const size_t ia = plan.stride_a.back();
+  const size_t ib = plan.stride_b.back();
+  size_t rows = 1;
+  for (size_t d = 0; d + 1 < dims; ++d) {
+    rows *= plan.extent[d];
+  }
+
+  forTasks(rows, inner, [&](size_t r) {
+    size_t offset_a = 0;
+    size_t offset_b = 0;
+    size_t rest = r;
+    for (size_t d = dims - 1; d-- > 0;) {
+      size_t index = rest % plan.extent[d];
+      rest /= plan.extent[d];
+      offset_a += index * plan.stride_a[d];
+      offset_b += index * plan.stride_b[d];
+    }
+    const double* x = a + offset_a;
+    const double* y = b + offset_b;
+    double* z = out + r * inner;
+
+    // Inner strides are 1 (contiguous) or 0 (broadcast)
+    if (ia != 0 && ib != 0) {
+      for (size_t j = 0; j < inner; ++j) z[j] = op(x[j], y[j]);
+    } else if (ia != 0) {
+      const double yv = y[0];
+      for (size_t j = 0; j < inner; ++j) z[j] = op(x[j], yv);
+    } else if (ib != 0) {
+      const double xv = x[0];
+      for (size_t j = 0; j < inner; ++j) z[j] = op(xv, y[j]);
+    } else {
+      const double value = op(x[0], y[0]);
+      std::fill(z, z + inner, value);
+    }
+  });
+}
+
+template <typename Op>
+NDArray broadcastBinary(const NDArray& a, const NDArray& b, Op op) {
+  NDArray result(NDArray::broadcast_shape(a.shape(), b.shape()));
+  if (result.size() > 0) {
+    broadcastApply(a.data(), b.data(), result.data(),
+                   planBroadcast(result.shape(), a.shape(), b.shape()), op);
+  }
+  return result;
+}
+
+template <typename Op>
+void broadcastInPlace(NDArray& a, const NDArray& b, Op op) {
+  if (NDArray::broadcast_shape(a.shape(), b.shape()) != a.shape()) {
+    throw std::invalid_argument(
+        "Operand does not broadcast to the shape of the array");
+  }
+  if (a.size() > 0) {
+    const double* y = b.data();
+    double* x = a.data();
+    broadcastApply(x, y, x, planBroadcast(a.shape(), a.shape(), b.shape()),
+                   op);
+  }
+}
+
+struct Add {
+  double operator()(double x, double y) const { return x + y; }
+};
+struct Subtract {
+  double operator()(double x, double y) const { return x - y; }
+};
+struct Multiply {
+  double operator()(double x, double y) const { return x * y; }
+};
+struct Divide {
+  double operator()(double x, double y) const { return x / y; }
+};
+
+}  // namespace
+
+std::vector<size_t> NDArray::broadcast_shape(const std::vector<size_t>& a,
+                                             const std::vector<size_t>& b) {
+  const size_t rank = std::max(a.size(), b.size());
+  std::vector<size_t> result(rank);
+  for (size_t k = 0; k < rank; ++k) {
+    size_t da = k < rank - a.size() ? 1 : a[k - (rank - a.size())];
+    size_t db = k < rank - b.size() ? 1 : b[k - (rank - b.size())];
+    if (da != db && da != 1 && db != 1) {
+      throw std::invalid_argument("Shapes cannot be broadcast together");
+    }
+    result[k] = da == 1 ? db : da;
+  }
+  return result;
+}
+
+NDArray NDArray::operator+(const NDArray& other) const {
+  return broadcastBinary(*this, other, Add());
+}
+
+NDArray NDArray::operator-(const NDArray& other) const {
+  return broadcastBinary(*this, other, Subtract());
+}
+
+NDArray NDArray::operator*(const NDArray& other) const {
+  return broadcastBinary(*this, other, Multiply());
+}
+
+NDArray NDArray::operator/(const NDArray& other) const {
+  return broadcastBinary(*this, other, Divide());
+}
+
+NDArray& NDArray::operator+=(const NDArray& other) {
+  broadcastInPlace(*this, other, Add());
+  return *this;
+}
+
+NDArray& NDArray::operator-=(const NDArray& other) {
+  broadcastInPlace(*this, other, Subtract());
+  return *this;
+}
+
+NDArray& NDArray::operator*=(const NDArray& other) {
+  broadcastInPlace(*this, other, Multiply());
+  return *this;
+}
+
+NDArray& NDArray::operator/=(const NDArray& other) {
+  broadcastInPlace(*this, other, Divide());
+  return *this;
+}
+
+double NDArray::sum(Accumulation accumulation) const {
+  return fullSum(data(), size_, accumulation, Identity());
+}
+
+NDArray NDArray::sum(int axis, bool keep_dims,
+                     Accumulation accumulation) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray result(view.result_shape);
+  reduceSum(data(), view, accumulation, result.data(),
+            [](double x, size_t) { return x; });
+  return result;
+}
+
+double NDArray::mean(Accumulation accumulation) const {
+  return sum(accumulation) / static_cast<double>(size_);
+}
+
+NDArray NDArray::mean(int axis, bool keep_dims,
+                      Accumulation accumulation) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray result = sum(axis, keep_dims, accumulation);
+  const double scale = 1.0 / static_cast<double>(view.n);
+  double* out = result.data();
+  for (size_t k = 0; k < result.size_; ++k) {
+    out[k] *= scale;
+  }
+  return result;
+}
+
+double NDArray::max() const { return fullArgMax(data(), size_).first; }
+
+NDArray NDArray::max(int axis, bool keep_dims) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray result(view.result_shape);
+  std::vector<double> indices(view.outputs());
+  reduceArgMax(data(), view, result.data(), indices.data());
+  return result;
+}
+
+size_t NDArray::argmax() const { return fullArgMax(data(), size_).second; }
+
+NDArray NDArray::argmax(int axis, bool keep_dims) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray result(view.result_shape);
+  std::vector<double> values(view.outputs());
+  reduceArgMax(data(), view, values.data(), result.data());
+  return result;
+}
+
+double NDArray::var(Accumulation accumulation) const {
+  const double center = mean(accumulation);
+  return fullSum(data(), size_, accumulation,
+                 [center](double x) {
+                   double d = x - center;
+                   return d * d;
+                 }) /
+         static_cast<double>(size_);
+}
+
+NDArray NDArray::var(int axis, bool keep_dims,
+                     Accumulation accumulation) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray centers = mean(axis, keep_dims, accumulation);
+  const double* center = centers.data();
+  NDArray result(view.result_shape);
+  reduceSum(data(), view, accumulation, result.data(),
+            [center](double x, size_t k) {
+              double d = x - center[k];
+              return d * d;
+            });
+  const double scale = 1.0 / static_cast<double>(view.n);
+  double* out = result.data();
+  for (size_t k = 0; k < result.size_; ++k) {
+    out[k] *= scale;
+  }
+  return result;
+}
+
+double NDArray::norm(Accumulation accumulation) const {
+  return std::sqrt(
+      fullSum(data(), size_, accumulation, [](double x) { return x * x; }));
+}
+
+NDArray NDArray::norm(int axis, bool keep_dims,
+                      Accumulation accumulation) const {
+  AxisView view = axisView(shape_, axis, keep_dims);
+  NDArray result(view.result_shape);
+  reduceSum(data(), view, accumulation, result.data(),
+            [](double x, size_t) { return x * x; });
+  double* out = result.data();
+  for (size_t k = 0; k < result.size_; ++k) {
+    out[k] = std::sqrt(out[k]);
+  }
+  return result;
+}
+
+}  // namespace MLLib
@@ -1,4 +1,5 @@
 #include "../../../include/MLLib/optimizer/sgd.hpp"
+#include "../../../include/MLLib/backend/backend.hpp"
 #include <stdexcept>
 
 namespace MLLib {
@@ -33,20 +34,14 @@ void SGD::update(const std::vector<NDArray*>& parameters,
 
     if (momentum_ > 0.0) {
       // Update velocity: v = momentum * v - learning_rate * gradient
-      for (size_t j = 0; j < velocity_[i].size(); ++j) {
-        velocity_[i][j] =
-            momentum_ * velocity_[i][j] - learning_rate_ * (*grad)[j];
-      }
+      Backend::DefaultBackend::axpby(-learning_rate_, *grad, momentum_,
+                                     velocity_[i]);
 
       // Update parameters: param = param + velocity
-      for (size_t j = 0; j < param->size(); ++j) {
-        (*param)[j] += velocity_[i][j];
-      }
+      Backend::DefaultBackend::axpy(1.0, velocity_[i], *param);
     } else {
       // Simple SGD: param = param - learning_rate * gradient
-      for (size_t j = 0; j < param->size(); ++j) {
-        (*param)[j] -= learning_rate_ * (*grad)[j];
-      }
+      Backend::DefaultBackend::axpy(-learning_rate_, *grad, *param);
     }
   }
 }
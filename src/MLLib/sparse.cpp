@@ -0,0 +1,350 @@
+#include "../../include/MLLib/sparse.hpp"
+#include "../../include/MLLib/util/system/thread.hpp"
+#include "backend/backend_internal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace MLLib {
+
+namespace {
+
+// Multiply-adds per task below which extra threads are not worth it
+constexpr size_t MIN_WORK_PER_TASK = 1 << 15;
+
+}  // namespace
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols,
+                           std::vector<size_t> row_offsets,
+                           std::vector<size_t> col_indices,
+                           std::vector<double> values)
+    : rows_(rows), cols_(cols), row_offsets_(std::move(row_offsets)),
+      col_indices_(std::move(col_indices)), values_(std::move(values)) {
+  if (row_offsets_.size() != rows_ + 1 || row_offsets_.front() != 0 ||
+      row_offsets_.back() != values_.size() ||
+      col_indices_.size() != values_.size()) {
+    throw std::invalid_argument("Inconsistent CSR array sizes");
+  }
+  for (size_t r = 0; r < rows_; ++r) {
+    if (row_offsets_[r] > row_offsets_[r + 1]) {
+      throw std::invalid_argument("CSR row offsets must not decrease");
+    }
+    for (size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+      if (col_indices_[k] >= cols_ ||
+          (k > row_offsets_[r] && col_indices_[k] <= col_indices_[k - 1])) {
+        throw std::invalid_argument(
+            "CSR columns must be in range, sorted and unique per row");
+      }
+    }
+  }
+}
+
+SparseMatrix SparseMatrix::from_coo(size_t rows, size_t cols,
+                                    const std::vector<size_t>& row_indices,
+                                    const std::vector<size_t>& col_indices,
+                                    const std::vector<double>& values) {
+  if (row_indices.size() != values.size() ||
+      col_indices.size() != values.size()) {
+    throw std::invalid_argument("COO arrays must have the same length");
+  }
+  for (size_t k = 0; k < values.size(); ++k) {
+    if (row_indices[k] >= rows || col_indices[k] >= cols) {
+      throw std::invalid_argument("COO index out of range");
+    }
+  }
+
+  std::vector<size_t> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return row_indices[a] != row_indices[b]
+               ? row_indices[a] < row_indices[b]
+               : col_indices[a] < col_indices[b];
+  });
+
+  SparseMatrix matrix;
+  matrix.rows_ = rows;
+  matrix.cols_ = cols;
+  matrix.row_offsets_.assign(rows + 1, 0);
+  matrix.col_indices_.reserve(values.size());
+  matrix.values_.reserve(values.size());
+  size_t last_row = rows;
+  for (size_t k : order) {
+    const size_t r = row_indices[k];
+    const size_t c = col_indices[k];
+    if (r == last_row && c == matrix.col_indices_.back()) {
+      matrix.values_.back() += values[k];
+      continue;
+    }
+    matrix.col_indices_.push_back(c);
+    matrix.values_.push_back(values[k]);
+    matrix.row_offsets_[r + 1]++;
+    last_row = r;
+  }
+  std::partial_sum(matrix.row_offsets_.begin(), matrix.row_offsets_.end(),
+                   matrix.row_offsets_.begin());
+  return matrix;
+}
+
+SparseMatrix SparseMatrix::from_dense(const NDArray& dense, double threshold) {
+  if (dense.shape().size() != 2) {
+    throw std::invalid_argument("SparseMatrix requires a 2D array");
+  }
+  SparseMatrix matrix;
+  matrix.rows_ = dense.shape()[0];
+  matrix.cols_ = dense.shape()[1];
+  matrix.row_offsets_.assign(matrix.rows_ + 1, 0);
+  const double* data = dense.data();
+  for (size_t r = 0; r < matrix.rows_; ++r) {
+    for (size_t c = 0; c < matrix.cols_; ++c) {
+      const double value = data[r * matrix.cols_ + c];
+      if (std::fabs(value) > threshold) {
+        matrix.col_indices_.push_back(c);
+        matrix.values_.push_back(value);
+      }
+    }
+    matrix.row_offsets_[r + 1] = matrix.values_.size();
+  }
+  return matrix;
+}
+
+NDArray SparseMatrix::to_dense() const {
+  NDArray dense({rows_, cols_});
+  double* data = dense.data();
+  for (size_t r = 0; r < rows_; ++r) {
+    for (size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+      data[r * cols_ + col_indices_[k]] = values_[k];
+    }
+  }
+  return dense;
+}
+
+SparseMatrix SparseMatrix::transpose() const {
+  // Counting sort by column; rows are visited in order, so the new rows
+  // come out with sorted columns
+  SparseMatrix result;
+  result.rows_ = cols_;
+  result.cols_ = rows_;
+  result.row_offsets_.assign(cols_ + 1, 0);
+  for (size_t c : col_indices_) {
+    result.row_offsets_[c + 1]++;
+  }
+  std::partial_sum(result.row_offsets_.begin(), result.row_offsets_.end(),
+                   result.row_offsets_.begin());
+
+  result.col_indices_.resize(nnz());
+  result.values_.resize(nnz());
+  std::vector<size_t> next(result.row_offsets_.begin(),
+                           result.row_offsets_.end() - 1);
+  for (size_t r = 0; r < rows_; ++r) {
+    for (size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+      const size_t slot = next[col_indices_[k]]++;
+      result.col_indices_[slot] = r;
+      result.values_[slot] = values_[k];
+    }
+  }
+  return result;
+}
+
+void SparseMatrix::matmul(const NDArray& dense, NDArray& result) const {
+  if (dense.shape().size() != 2 || dense.shape()[0] != cols_) {
+    throw std::invalid_argument(
+        "Sparse matmul requires a [cols, n] dense matrix");
+  }
+  const size_t n = dense.shape()[1];
+  Backend::prepare_output(result, {rows_, n});
+
+  const double* b = dense.data();
+  double* out = result.data();
+  const size_t row_nnz =
+      std::max<size_t>(1, nnz() / std::max<size_t>(1, rows_));
+  const size_t work_per_row = row_nnz * std::max<size_t>(1, n);
+  util::ThreadPool::global().parallel_for(
+      0, rows_,
+      [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+          // Each entry scales one contiguous row of the dense operand
+          double* dst = out + r * n;
+          std::fill(dst, dst + n, 0.0);
+          for (size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+            const double v = values_[k];
+            const double* src = b + col_indices_[k] * n;
+            for (size_t j = 0; j < n; ++j) {
+              dst[j] += v * src[j];
+            }
+          }
+        }
+      },
+      std::max<size_t>(1, MIN_WORK_PER_TASK / work_per_row));
+}
+
+NDArray SparseMatrix::matmul(const NDArray& dense) const {
+  NDArray result;
+  matmul(dense, result);
+  return result;
+}
+
+BlockSparseMatrix::BlockSparseMatrix(size_t rows, size_t cols,
+                                     size_t block_rows, size_t block_cols,
+                                     std::vector<size_t> block_row_offsets,
+                                     std::vector<size_t> block_col_indices,
+                                     std::vector<double> values)
+    : rows_(rows), cols_(cols), block_rows_(block_rows),
+      block_cols_(block_cols), block_row_offsets_(std::move(block_row_offsets)),
+      block_col_indices_(std::move(block_col_indices)),
+      values_(std::move(values)) {
+  if (block_rows_ == 0 || block_cols_ == 0) {
+    throw std::invalid_argument("Block sizes must be positive");
+  }
+  const size_t block_row_count = (rows_ + block_rows_ - 1) / block_rows_;
+  const size_t block_col_count = (cols_ + block_cols_ - 1) / block_cols_;
+  const size_t blocks = block_col_indices_.size();
+  if (block_row_offsets_.size() != block_row_count + 1 ||
+      block_row_offsets_.front() != 0 || block_row_offsets_.back() != blocks ||
+      values_.size() != blocks * block_rows_ * block_cols_) {
+    throw std::invalid_argument("Inconsistent BSR array sizes");
+  }
+  for (size_t r = 0; r < block_row_count; ++r) {
+    if (block_row_offsets_[r] > block_row_offsets_[r + 1]) {
+      throw std::invalid_argument("BSR row offsets must not decrease");
+    }
+    for (size_t k = block_row_offsets_[r]; k < block_row_offsets_[r + 1];
+         ++k) {
+      if (block_col_indices_[k] >= block_col_count ||
+          (k > block_row_offsets_[r] &&
+           block_col_indices_[k] <= block_col_indices_[k - 1])) {
+        throw std::invalid_argument(
+            "BSR block columns must be in range, sorted and unique per row");
+      }
+    }
+  }
+}
+
+BlockSparseMatrix BlockSparseMatrix::from_dense(const NDArray& dense,
+                                                size_t block_rows,
+                                                size_t block_cols) {
+  if (dense.shape().size() != 2) {
+    throw std::invalid_argument("BlockSparseMatrix requires a 2D array");
+  }
+  if (block_rows == 0 || block_cols == 0) {
+    throw std::invalid_argument("Block sizes must be positive");
+  }
+
+  BlockSparseMatrix matrix;
+  matrix.rows_ = dense.shape()[0];
+  matrix.cols_ = dense.shape()[1];
+  matrix.block_rows_ = block_rows;
+  matrix.block_cols_ = block_cols;
+  const size_t block_row_count = (matrix.rows_ + block_rows - 1) / block_rows;
+  const size_t block_col_count = (matrix.cols_ + block_cols - 1) / block_cols;
+  matrix.block_row_offsets_.assign(block_row_count + 1, 0);
+
+  const double* data = dense.data();
+  for (size_t r = 0; r < block_row_count; ++r) {
+    const size_t row0 = r * block_rows;
+    const size_t height = std::min(block_rows, matrix.rows_ - row0);
+    for (size_t c = 0; c < block_col_count; ++c) {
+      const size_t col0 = c * block_cols;
+      const size_t width = std::min(block_cols, matrix.cols_ - col0);
+      bool nonzero = false;
+      for (size_t i = 0; i < height && !nonzero; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+          if (data[(row0 + i) * matrix.cols_ + col0 + j] != 0.0) {
+            nonzero = true;
+            break;
+          }
+        }
+      }
+      if (!nonzero) {
+        continue;
+      }
+      matrix.block_col_indices_.push_back(c);
+      const size_t start = matrix.values_.size();
+      matrix.values_.resize(start + block_rows * block_cols, 0.0);
+      for (size_t i = 0; i < height; ++i) {
+        const double* src = data + (row0 + i) * matrix.cols_ + col0;
+        std::copy(src, src + width,
+                  matrix.values_.begin() + start + i * block_cols);
+      }
+    }
+    matrix.block_row_offsets_[r + 1] = matrix.block_col_indices_.size();
+  }
+  return matrix;
+}
+
+double BlockSparseMatrix::density() const {
+  const size_t total = ((rows_ + block_rows_ - 1) / block_rows_) *
+                       ((cols_ + block_cols_ - 1) / block_cols_);
+  return total == 0 ? 0.0
+                    : static_cast<double>(num_blocks()) /
+                          static_cast<double>(total);
+}
+
+NDArray BlockSparseMatrix::to_dense() const {
+  NDArray dense({rows_, cols_});
+  double* data = dense.data();
+  const size_t block_size = block_rows_ * block_cols_;
+  for (size_t r = 0; r + 1 < block_row_offsets_.size(); ++r) {
+    const size_t row0 = r * block_rows_;
+    const size_t height = std::min(block_rows_, rows_ - row0);
+    for (size_t k = block_row_offsets_[r]; k < block_row_offsets_[r + 1];
+         ++k) {
+      const size_t col0 = block_col_indices_[k] * block_cols_;
+      const size_t width = std::min(block_cols_, cols_ - col0);
+      const double* block = values_.data() + k * block_size;
+      for (size_t i = 0; i < height; ++i) {
+        std::copy(block + i * block_cols_, block + i * block_cols_ + width,
+                  data + (row0 + i) * cols_ + col0);
+      }
+    }
+  }
+  return dense;
+}
+
+void BlockSparseMatrix::left_multiply(const NDArray& input,
+                                      NDArray& output) const {
+  if (input.shape().size() != 2 || input.shape()[1] != rows_) {
+    throw std::invalid_argument(
+        "Block-sparse product requires an [n, rows] input");
+  }
+  const size_t n = input.shape()[0];
+  Backend::prepare_output(output, {n, cols_});
+
+  const double* x = input.data();
+  double* out = output.data();
+  const size_t block_size = block_rows_ * block_cols_;
+  const size_t block_row_count = block_row_offsets_.size() - 1;
+  const size_t work_per_row = std::max<size_t>(1, values_.size());
+  util::ThreadPool::global().parallel_for(
+      0, n,
+      [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+          const double* xs = x + b * rows_;
+          double* dst_row = out + b * cols_;
+          std::fill(dst_row, dst_row + cols_, 0.0);
+          for (size_t r = 0; r < block_row_count; ++r) {
+            const size_t row0 = r * block_rows_;
+            const size_t height = std::min(block_rows_, rows_ - row0);
+            for (size_t k = block_row_offsets_[r];
+                 k < block_row_offsets_[r + 1]; ++k) {
+              // One stored block updates one contiguous output slice
+              const size_t col0 = block_col_indices_[k] * block_cols_;
+              const size_t width = std::min(block_cols_, cols_ - col0);
+              const double* block = values_.data() + k * block_size;
+              double* dst = dst_row + col0;
+              for (size_t i = 0; i < height; ++i) {
+                const double v = xs[row0 + i];
+                const double* w = block + i * block_cols_;
+                for (size_t j = 0; j < width; ++j) {
+                  dst[j] += v * w[j];
+                }
+              }
+            }
+          }
+        }
+      },
+      std::max<size_t>(1, MIN_WORK_PER_TASK / work_per_row));
+}
+
+}  // namespace MLLib
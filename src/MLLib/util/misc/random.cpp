@@ -0,0 +1,310 @@
+#include "../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+
+namespace MLLib {
+namespace util {
+
+namespace {
+
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr int PHILOX_ROUNDS = 10;
+
+// Blocks generated together; the lane loops are written for vectorization
+constexpr size_t LANES = 8;
+
+constexpr double TWO_PI = 6.283185307179586476925286766559;
+
+uint64_t splitmix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Philox4x32-10 over LANES consecutive block counters
+ */
+void philox_lanes(uint64_t first_block, const Philox4x32::Key& key,
+                  uint32_t out[4][LANES]) {
+  uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+  for (size_t l = 0; l < LANES; ++l) {
+    uint64_t block = first_block + l;
+    c0[l] = static_cast<uint32_t>(block);
+    c1[l] = static_cast<uint32_t>(block >> 32);
+    c2[l] = 0;
+    c3[l] = 0;
+  }
+
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+    for (size_t l = 0; l < LANES; ++l) {
+      uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0[l];
+      uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2[l];
+      uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+      uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+      c1[l] = static_cast<uint32_t>(p1);
+      c3[l] = static_cast<uint32_t>(p0);
+      c0[l] = n0;
+      c2[l] = n2;
+    }
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+
+  for (size_t l = 0; l < LANES; ++l) {
+    out[0][l] = c0[l];
+    out[1][l] = c1[l];
+    out[2][l] = c2[l];
+    out[3][l] = c3[l];
+  }
+}
+
+/**
+ * @brief 53-bit uniform in [0, 1) from two 32-bit words
+ */
+inline double to_unit(uint32_t high, uint32_t low) {
+  uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Produce elements [position, position + count) of a stream
+ * @details Every block yields two uniforms, which transform(u, values)
+ * turns into the values of the block's two elements; store(k, value)
+ * consumes element position + k. Elements depend only on their position,
+ * so any split of a range gives the same result.
+ */
+template <typename Transform, typename Store>
+void fill_elements(const Philox4x32::Key& key, uint64_t position,
+                   size_t count, Transform transform, Store store) {
+  const uint64_t end = position + count;
+  uint64_t block = position / 2;
+  uint32_t bits[4][LANES];
+  while (block * 2 < end) {
+    philox_lanes(block, key, bits);
+    for (size_t l = 0; l < LANES; ++l, ++block) {
+      double u[2] = {to_unit(bits[0][l], bits[1][l]),
+                     to_unit(bits[2][l], bits[3][l])};
+      double values[2];
+      transform(u, values);
+      for (uint64_t slot = 0; slot < 2; ++slot) {
+        uint64_t element = block * 2 + slot;
+        if (element >= position && element < end) {
+          store(static_cast<size_t>(element - position), values[slot]);
+        }
+      }
+    }
+  }
+}
+
+template <typename Transform, typename Store>
+void fill_parallel(const Philox4x32::Key& key, uint64_t& position,
+                   size_t count, Transform transform, Store store) {
+  const uint64_t start = position;
+  if (count < RANDOM_PARALLEL_MIN) {
+    fill_elements(key, start, count, transform, store);
+  } else {
+    ThreadPool::global().parallel_for(
+        0, count,
+        [&](size_t begin, size_t end) {
+          fill_elements(key, start + begin, end - begin, transform,
+                        [&](size_t k, double value) {
+                          store(begin + k, value);
+                        });
+        },
+        RANDOM_PARALLEL_MIN / 2);
+  }
+  position += count;
+}
+
+/**
+ * @brief Store that writes the variates themselves
+ */
+struct WriteValue {
+  double* out;
+  void operator()(size_t k, double value) const { out[k] = value; }
+};
+
+void uniform_pair(const double u[2], double values[2]) {
+  values[0] = u[0];
+  values[1] = u[1];
+}
+
+void check_probability(double p, const char* message) {
+  if (!(p >= 0.0 && p <= 1.0)) {
+    throw std::invalid_argument(message);
+  }
+}
+
+struct GlobalSeed {
+  std::atomic<uint64_t> seed;
+  std::atomic<uint64_t> next_stream{0};
+
+  GlobalSeed() : seed(initial()) {}
+
+  static uint64_t initial() {
+    if (const char* value = std::getenv("MLLIB_SEED")) {
+      return std::strtoull(value, nullptr, 10);
+    }
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+  }
+};
+
+GlobalSeed& globalSeed() {
+  static GlobalSeed state;
+  return state;
+}
+
+}  // namespace
+
+Philox4x32::Counter Philox4x32::apply(Counter counter, Key key) {
+  for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+    uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * counter[0];
+    uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * counter[2];
+    counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<uint32_t>(p1),
+               static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<uint32_t>(p0)};
+    key[0] += PHILOX_W0;
+    key[1] += PHILOX_W1;
+  }
+  return counter;
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream_id) : position_(0) {
+  uint64_t key = splitmix64(seed ^ splitmix64(stream_id));
+  key_ = {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+}
+
+void RandomStream::uniform(double* out, size_t count, double low,
+                           double high) {
+  const double scale = high - low;
+  fill_parallel(key_, position_, count,
+                [low, scale](const double u[2], double values[2]) {
+                  values[0] = low + scale * u[0];
+                  values[1] = low + scale * u[1];
+                },
+                WriteValue{out});
+}
+
+void RandomStream::normal(double* out, size_t count, double mean,
+                          double stddev) {
+  // Box-Muller: each block's uniform pair gives two independent normals
+  fill_parallel(key_, position_, count,
+                [mean, stddev](const double u[2], double values[2]) {
+                  double radius = std::sqrt(-2.0 * std::log1p(-u[0]));
+                  double angle = TWO_PI * u[1];
+                  values[0] = mean + stddev * radius * std::cos(angle);
+                  values[1] = mean + stddev * radius * std::sin(angle);
+                },
+                WriteValue{out});
+}
+
+void RandomStream::bernoulli(double* out, size_t count, double p) {
+  check_probability(p, "Bernoulli probability must be in [0, 1]");
+  fill_parallel(key_, position_, count,
+                [p](const double u[2], double values[2]) {
+                  values[0] = u[0] < p ? 1.0 : 0.0;
+                  values[1] = u[1] < p ? 1.0 : 0.0;
+                },
+                WriteValue{out});
+}
+
+void RandomStream::add_normal(const double* in, double* out, size_t count,
+                              double stddev) {
+  fill_parallel(key_, position_, count,
+                [stddev](const double u[2], double values[2]) {
+                  double radius = std::sqrt(-2.0 * std::log1p(-u[0]));
+                  double angle = TWO_PI * u[1];
+                  values[0] = stddev * radius * std::cos(angle);
+                  values[1] = stddev * radius * std::sin(angle);
+                },
+                [in, out](size_t k, double noise) { out[k] = in[k] + noise; });
+}
+
+void RandomStream::add_uniform(const double* in, double* out, size_t count,
+                               double low, double high) {
+  const double scale = high - low;
+  fill_parallel(key_, position_, count, uniform_pair,
+                [in, out, low, scale](size_t k, double u) {
+                  out[k] = in[k] + low + scale * u;
+                });
+}
+
+void RandomStream::dropout(const double* in, double* out, size_t count,
+                           double rate) {
+  check_probability(rate, "Dropout rate must be in [0, 1]");
+  fill_parallel(key_, position_, count, uniform_pair,
+                [in, out, rate](size_t k, double u) {
+                  out[k] = u < rate ? 0.0 : in[k];
+                });
+}
+
+void RandomStream::salt_pepper(const double* in, double* out, size_t count,
+                               double fraction) {
+  check_probability(fraction, "Salt and pepper fraction must be in [0, 1]");
+  // The lower half of the replaced range is pepper (0), the upper salt (1)
+  const double pepper = 0.5 * fraction;
+  fill_parallel(key_, position_, count, uniform_pair,
+                [in, out, pepper, fraction](size_t k, double u) {
+                  out[k] = u < pepper ? 0.0 : (u < fraction ? 1.0 : in[k]);
+                });
+}
+
+double RandomStream::uniform() {
+  double value;
+  uniform(&value, 1);
+  return value;
+}
+
+double RandomStream::normal() {
+  double value;
+  normal(&value, 1);
+  return value;
+}
+
+RandomStream::result_type RandomStream::operator()() {
+  uint64_t block = position_ / 2;
+  Philox4x32::Counter bits = Philox4x32::apply(
+      {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), 0, 0},
+      key_);
+  size_t slot = static_cast<size_t>(position_ % 2) * 2;
+  ++position_;
+  return (static_cast<uint64_t>(bits[slot]) << 32) | bits[slot + 1];
+}
+
+RandomStream RandomStream::split(uint64_t id) const {
+  uint64_t key = (static_cast<uint64_t>(key_[1]) << 32) | key_[0];
+  return RandomStream(splitmix64(key), id);
+}
+
+void Random::seed(uint64_t seed) {
+  GlobalSeed& state = globalSeed();
+  state.seed = seed;
+  state.next_stream = 0;
+}
+
+uint64_t Random::get_seed() { return globalSeed().seed; }
+
+RandomStream Random::stream(uint64_t stream_id) {
+  return RandomStream(globalSeed().seed, stream_id);
+}
+
+RandomStream Random::next_stream() {
+  GlobalSeed& state = globalSeed();
+  // Allocated ids start high so they never collide with fixed ids
+  return RandomStream(state.seed, (1ull << 63) | state.next_stream++);
+}
+
+}  // namespace util
+}  // namespace MLLib
@@ -0,0 +1,325 @@
+#include "../../../../include/MLLib/util/number/stats.hpp"
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace MLLib {
+namespace util {
+
+namespace {
+
+// Elements per task below which extra threads are not worth it
+constexpr size_t MIN_ELEMENTS_PER_TASK = 1 << 14;
+
+struct SampleLayout {
+  size_t samples = 0;
+  size_t sample_size = 0;
+};
+
+SampleLayout checkPair(const NDArray& a, const NDArray& b) {
+  if (a.shape() != b.shape()) {
+    throw std::invalid_argument("Metric inputs must have the same shape");
+  }
+  SampleLayout layout;
+  if (a.size() == 0) {
+    return layout;
+  }
+  // Arrays of rank 1 are a single sample
+  layout.samples = a.shape().size() > 1 ? a.shape()[0] : 1;
+  layout.sample_size = a.size() / layout.samples;
+  return layout;
+}
+
+/**
+ * @brief Compute one value per sample on the global thread pool
+ */
+template <typename Body>
+std::vector<double> perSample(const SampleLayout& layout, Body body) {
+  std::vector<double> values(layout.samples);
+  size_t min_chunk =
+      std::max<size_t>(1, MIN_ELEMENTS_PER_TASK /
+                              std::max<size_t>(1, layout.sample_size));
+  ThreadPool::global().parallel_for(
+      0, layout.samples,
+      [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+          values[s] = body(s);
+        }
+      },
+      min_chunk);
+  return values;
+}
+
+double psnrFromMse(double mse, double data_range) {
+  if (mse == 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return 10.0 * std::log10(data_range * data_range / mse);
+}
+
+/**
+ * @brief Normalized 1-D Gaussian of an odd size
+ */
+std::vector<double> gaussianWindow(size_t size, double sigma) {
+  std::vector<double> weights(size);
+  const double center = static_cast<double>(size / 2);
+  double total = 0.0;
+  for (size_t k = 0; k < size; ++k) {
+    double d = static_cast<double>(k) - center;
+    weights[k] = std::exp(-0.5 * d * d / (sigma * sigma));
+    total += weights[k];
+  }
+  for (double& w : weights) {
+    w /= total;
+  }
+  return weights;
+}
+
+/**
+ * @brief Largest odd window not exceeding the extent
+ */
+size_t fitWindow(size_t window, size_t extent) {
+  size_t size = std::min(window, extent);
+  return size % 2 == 0 ? size - 1 : size;
+}
+
+struct ImageLayout {
+  size_t height = 1;
+  size_t width = 1;
+  size_t channels = 1;
+};
+
+ImageLayout imageLayout(const std::vector<size_t>& shape) {
+  ImageLayout image;
+  switch (shape.size()) {
+  case 1: image.width = shape[0]; break;
+  case 2: image.width = shape[1]; break;
+  case 3:
+    image.height = shape[1];
+    image.width = shape[2];
+    break;
+  case 4:
+    image.height = shape[1];
+    image.width = shape[2];
+    image.channels = shape[3];
+    break;
+  default:
+    throw std::invalid_argument("SSIM expects [N, H, W, C], [N, H, W] or "
+                                "[N, D] arrays");
+  }
+  return image;
+}
+
+/**
+ * @brief Separable Gaussian filtering and SSIM of single channels
+ * @details Filters run over the valid region. Both passes keep the
+ * contiguous image axis innermost with the window tap outside, so the
+ * inner loops are plain multiply-adds over rows that the compiler
+ * vectorizes.
+ */
+class SSIMKernel {
+public:
+  SSIMKernel(const ImageLayout& image, const SSIMOptions& options)
+      : height_(image.height), width_(image.width),
+        horizontal_(gaussianWindow(fitWindow(options.window, image.width),
+                                   options.sigma)),
+        vertical_(gaussianWindow(fitWindow(options.window, image.height),
+                                 options.sigma)),
+        out_height_(height_ - vertical_.size() + 1),
+        out_width_(width_ - horizontal_.size() + 1),
+        c1_(std::pow(options.k1 * options.data_range, 2)),
+        c2_(std::pow(options.k2 * options.data_range, 2)),
+        x_(height_ * width_), y_(height_ * width_),
+        product_(height_ * width_), rows_(height_ * out_width_) {
+    for (auto& moment : moments_) {
+      moment.resize(out_height_ * out_width_);
+    }
+  }
+
+  /**
+   * @brief Mean SSIM of one channel of interleaved [H, W, C] images
+   */
+  double channel(const double* a, const double* b, size_t channel,
+                 size_t channels) {
+    const size_t pixels = height_ * width_;
+    for (size_t p = 0; p < pixels; ++p) {
+      x_[p] = a[p * channels + channel];
+      y_[p] = b[p * channels + channel];
+    }
+
+    // Local means, second moments and cross moment
+    filter(x_.data(), moments_[0].data());
+    filter(y_.data(), moments_[1].data());
+    for (size_t p = 0; p < pixels; ++p) product_[p] = x_[p] * x_[p];
+    filter(product_.data(), moments_[2].data());
+    for (size_t p = 0; p < pixels; ++p) product_[p] = y_[p] * y_[p];
+    filter(product_.data(), moments_[3].data());
+    for (size_t p = 0; p < pixels; ++p) product_[p] = x_[p] * y_[p];
+    filter(product_.data(), moments_[4].data());
+
+    const size_t count = out_height_ * out_width_;
+    double total = 0.0;
+    for (size_t p = 0; p < count; ++p) {
+      double mu_x = moments_[0][p];
+      double mu_y = moments_[1][p];
+      double var_x = moments_[2][p] - mu_x * mu_x;
+      double var_y = moments_[3][p] - mu_y * mu_y;
+      double cov = moments_[4][p] - mu_x * mu_y;
+      total += ((2.0 * mu_x * mu_y + c1_) * (2.0 * cov + c2_)) /
+               ((mu_x * mu_x + mu_y * mu_y + c1_) * (var_x + var_y + c2_));
+    }
+    return total / static_cast<double>(count);
+  }
+
+private:
+  void filter(const double* in, double* out) {
+    // Horizontal pass: [H, W] -> [H, out_width]
+    std::fill(rows_.begin(), rows_.end(), 0.0);
+    for (size_t i = 0; i < height_; ++i) {
+      const double* src = in + i * width_;
+      double* dst = rows_.data() + i * out_width_;
+      for (size_t k = 0; k < horizontal_.size(); ++k) {
+        const double w = horizontal_[k];
+        for (size_t j = 0; j < out_width_; ++j) {
+          dst[j] += w * src[j + k];
+        }
+      }
+    }
+
+    // Vertical pass: [H, out_width] -> [out_height, out_width]
+    std::fill(out, out + out_height_ * out_width_, 0.0);
+    for (size_t i = 0; i < out_height_; ++i) {
+      double* dst = out + i * out_width_;
+      for (size_t k = 0; k < vertical_.size(); ++k) {
+        const double w = vertical_[k];
+        const double* src = rows_.data() + (i + k) * out_width_;
+        for (size_t j = 0; j < out_width_; ++j) {
+          dst[j] += w * src[j];
+        }
+      }
+    }
+  }
+
+  size_t height_;
+  size_t width_;
+  std::vector<double> horizontal_;
+  std::vector<double> vertical_;
+  size_t out_height_;
+  size_t out_width_;
+  double c1_;
+  double c2_;
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> product_;
+  std::vector<double> rows_;
+  std::vector<double> moments_[5];
+};
+
+}  // namespace
+
+std::vector<double> mse(const NDArray& a, const NDArray& b) {
+  SampleLayout layout = checkPair(a, b);
+  const double* x = a.data();
+  const double* y = b.data();
+  return perSample(layout, [&](size_t s) {
+    const size_t n = layout.sample_size;
+    const double* xs = x + s * n;
+    const double* ys = y + s * n;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      double d = xs[i] - ys[i];
+      sum += d * d;
+    }
+    return sum / static_cast<double>(n);
+  });
+}
+
+std::vector<double> mae(const NDArray& a, const NDArray& b) {
+  SampleLayout layout = checkPair(a, b);
+  const double* x = a.data();
+  const double* y = b.data();
+  return perSample(layout, [&](size_t s) {
+    const size_t n = layout.sample_size;
+    const double* xs = x + s * n;
+    const double* ys = y + s * n;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += std::fabs(xs[i] - ys[i]);
+    }
+    return sum / static_cast<double>(n);
+  });
+}
+
+std::vector<double> rmse(const NDArray& a, const NDArray& b) {
+  std::vector<double> values = mse(a, b);
+  for (double& v : values) {
+    v = std::sqrt(v);
+  }
+  return values;
+}
+
+std::vector<double> psnr(const NDArray& a, const NDArray& b,
+                         double data_range) {
+  if (data_range <= 0.0) {
+    throw std::invalid_argument("PSNR data range must be positive");
+  }
+  std::vector<double> values = mse(a, b);
+  for (double& v : values) {
+    v = psnrFromMse(v, data_range);
+  }
+  return values;
+}
+
+std::vector<double> ssim(const NDArray& a, const NDArray& b,
+                         const SSIMOptions& options) {
+  SampleLayout layout = checkPair(a, b);
+  if (options.window == 0 || options.window % 2 == 0) {
+    throw std::invalid_argument("SSIM window size must be odd");
+  }
+  if (options.sigma <= 0.0 || options.data_range <= 0.0) {
+    throw std::invalid_argument("SSIM sigma and data range must be positive");
+  }
+  std::vector<double> values(layout.samples);
+  if (layout.samples == 0) {
+    return values;
+  }
+  const ImageLayout image = imageLayout(a.shape());
+
+  const double* x = a.data();
+  const double* y = b.data();
+  const size_t min_chunk = std::max<size_t>(
+      1, MIN_ELEMENTS_PER_TASK / std::max<size_t>(1, layout.sample_size));
+  ThreadPool::global().parallel_for(
+      0, layout.samples,
+      [&](size_t begin, size_t end) {
+        // Scratch buffers are shared by the samples of one task
+        SSIMKernel kernel(image, options);
+        for (size_t s = begin; s < end; ++s) {
+          const double* xs = x + s * layout.sample_size;
+          const double* ys = y + s * layout.sample_size;
+          double total = 0.0;
+          for (size_t c = 0; c < image.channels; ++c) {
+            total += kernel.channel(xs, ys, c, image.channels);
+          }
+          values[s] = total / static_cast<double>(image.channels);
+        }
+      },
+      min_chunk);
+  return values;
+}
+
+double mean(const std::vector<double>& values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (double v : values) {
+    sum += v;
+  }
+  return sum / static_cast<double>(values.size());
+}
+
+}  // namespace util
+}  // namespace MLLib
@@ -0,0 +1,66 @@
+#include "../../../../include/MLLib/util/system/memory.hpp"
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <future>
+#include <vector>
+
+namespace MLLib {
+namespace util {
+
+namespace {
+
+/**
+ * @brief Run body over [0, count) on the pool of the selected CPU node
+ *
+ * Falls back to the calling thread when no node is selected, the array is
+ * small, or the caller already runs on the node.
+ */
+template <typename Body>
+void run_on_selected_node(size_t count, Body body) {
+  int node = Device::getCPUNode();
+  if (node < 0 || count * sizeof(double) < FIRST_TOUCH_MIN_BYTES ||
+      Device::getCurrentThreadNode() == node) {
+    body(0, count);
+    return;
+  }
+
+  // All chunks go to the node's workers; the caller is on another node
+  ThreadPool& pool = Device::getNodeThreadPool(node);
+  const size_t chunks = std::min(pool.size(), count);
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+  std::vector<std::future<void>> pending;
+  pending.reserve(chunks);
+  for (size_t start = 0; start < count; start += chunk_size) {
+    size_t stop = std::min(count, start + chunk_size);
+    pending.push_back(pool.submit([&body, start, stop]() { body(start, stop); }));
+  }
+  for (auto& future : pending) {
+    future.get();
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<double[]> allocate_uninitialized(size_t count) {
+  if (count == 0) {
+    return nullptr;
+  }
+  // Default-initialized: no page is written until first_touch_*
+  return std::unique_ptr<double[]>(new double[count]);
+}
+
+void first_touch_fill(double* data, size_t count, double value) {
+  run_on_selected_node(count, [data, value](size_t begin, size_t end) {
+    std::fill(data + begin, data + end, value);
+  });
+}
+
+void first_touch_copy(const double* src, size_t count, double* dst) {
+  run_on_selected_node(count, [src, dst](size_t begin, size_t end) {
+    std::copy(src + begin, src + end, dst + begin);
+  });
+}
+
+}  // namespace util
+}  // namespace MLLib
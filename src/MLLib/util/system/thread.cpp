@@ -0,0 +1,140 @@
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include <algorithm>
+#include <exception>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace MLLib {
+namespace util {
+
+namespace {
+// Pool owning the current thread, used to detect nested parallel loops
+thread_local const ThreadPool* current_pool = nullptr;
+}  // namespace
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+ThreadPool::ThreadPool(size_t num_threads,
+                       std::function<void()> on_thread_start)
+    : stop_(false) {
+  num_threads = std::max<size_t>(1, num_threads);
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(
+        [this, on_thread_start]() { worker_loop(on_thread_start); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+void ThreadPool::worker_loop(const std::function<void()>& on_thread_start) {
+  current_pool = this;
+  if (on_thread_start) {
+    on_thread_start();
+  }
+
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;  // stop_ is set and the queue is drained
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+bool ThreadPool::is_worker_thread() const {
+  return current_pool == this;
+}
+
+void ThreadPool::parallel_for(size_t begin, size_t end,
+                              const std::function<void(size_t, size_t)>& body,
+                              size_t min_chunk) {
+  if (begin >= end) {
+    return;
+  }
+
+  const size_t count = end - begin;
+  min_chunk = std::max<size_t>(1, min_chunk);
+  size_t chunks = std::min(workers_.size() + 1, count / min_chunk);
+  if (chunks <= 1 || is_worker_thread()) {
+    body(begin, end);
+    return;
+  }
+
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+  std::vector<std::future<void>> pending;
+  pending.reserve(chunks - 1);
+  for (size_t start = begin + chunk_size; start < end; start += chunk_size) {
+    size_t stop = std::min(end, start + chunk_size);
+    pending.push_back(submit([&body, start, stop]() { body(start, stop); }));
+  }
+
+  std::exception_ptr error;
+  try {
+    body(begin, std::min(end, begin + chunk_size));
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // Wait for every chunk before returning: they reference body
+  for (auto& future : pending) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+ThreadPool& ThreadPool::global() {
+  static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+}  // namespace util
+}  // namespace MLLib
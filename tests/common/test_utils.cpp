@@ -1,5 +1,7 @@
 #include "test_utils.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <exception>
@@ -162,6 +164,63 @@ void TestCase::assertVectorNear(const std::vector<double>& expected,
   recordAssertion(condition, full_message);
 }
 
+void TestCase::checkLayerGradients(layer::BaseLayer& layer,
+                                   const NDArray& input,
+                                   const std::string& label) {
+  NDArray output;
+  layer.infer(input, output);
+  NDArray r(output.shape());
+  for (size_t i = 0; i < r.size(); ++i) {
+    r[i] = std::cos(0.37 * static_cast<double>(i));
+  }
+
+  auto objective = [&](const NDArray& x) {
+    NDArray out;
+    layer.infer(x, out);
+    double total = 0.0;
+    for (size_t i = 0; i < out.size(); ++i) {
+      total += out[i] * r[i];
+    }
+    return total;
+  };
+
+  layer.forward(input);
+  NDArray grad_input = layer.backward(r);
+  const double h = 1e-6;
+  const double tolerance = 1e-6;
+
+  double worst = 0.0;
+  for (size_t i = 0; i < input.size(); ++i) {
+    NDArray plus = input;
+    NDArray minus = input;
+    plus[i] += h;
+    minus[i] -= h;
+    const double numeric = (objective(plus) - objective(minus)) / (2 * h);
+    worst = std::max(worst, std::abs(numeric - grad_input[i]));
+  }
+  assertTrue(worst < tolerance, label + " input gradient");
+
+  std::vector<NDArray*> params = layer.get_parameters();
+  std::vector<NDArray*> grads = layer.get_gradients();
+  assertEqual(params.size(), grads.size(), label + " gradient per param");
+  for (size_t p = 0; p < params.size() && p < grads.size(); ++p) {
+    worst = 0.0;
+    NDArray& param = *params[p];
+    for (size_t i = 0; i < param.size(); ++i) {
+      const double original = param[i];
+      param[i] = original + h;
+      const double up = objective(input);
+      param[i] = original - h;
+      const double down = objective(input);
+      param[i] = original;
+      worst =
+          std::max(worst, std::abs((up - down) / (2 * h) - (*grads[p])[i]));
+    }
+    assertTrue(worst < tolerance,
+               label + " parameter " + std::to_string(p) + " gradient");
+  }
+}
+
 void TestCase::recordAssertion(bool condition, const std::string& message) {
   if (condition) {
     passed_count_++;
@@ -230,6 +289,14 @@ int TestSuite::getTotalFailedCount() const {
 }
 
 // Utility functions
+NDArray smoothTestInput(const std::vector<size_t>& shape) {
+  NDArray input(shape);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = std::sin(0.7 * static_cast<double>(i) + 0.3);
+  }
+  return input;
+}
+
 std::string createTempFile(const std::string& content) {
   std::string temp_path = "/tmp/mllib_test_" + std::to_string(std::rand());
   std::ofstream file(temp_path);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../../include/MLLib/layer/base.hpp"
+#include "../../include/MLLib/ndarray.hpp"
 #include <cassert>
 #include <chrono>
 #include <cmath>
@@ -220,6 +222,18 @@ protected:
   template <typename Func>
   void assertNoThrow(Func func, const std::string& message = "");
 
+  /**
+   * @brief Check a layer's backward() against finite differences
+   * @param layer Layer under test
+   * @param input Input batch
+   * @param label Prefix for assertion messages
+   * @details Differentiates sum(output * r) for a fixed cosine pattern r
+   * with respect to the input and every get_parameters() entry, and
+   * compares with backward() and get_gradients().
+   */
+  void checkLayerGradients(layer::BaseLayer& layer, const NDArray& input,
+                           const std::string& label);
+
 private:
   std::string name_;
   int passed_count_;
@@ -281,6 +295,13 @@ private:
   std::vector<std::unique_ptr<TestCase>> test_cases_;
 };
 
+/**
+ * @brief Smooth, non-repeating test input sin(0.7 i + 0.3)
+ * @param shape Array shape
+ * @return Filled array
+ */
+NDArray smoothTestInput(const std::vector<size_t>& shape);
+
 /**
  * @brief Create temporary file for testing
  * @param content Content to write to file
@@ -0,0 +1,221 @@
+/**
+ * @file test_backend_dispatch.hpp
+ * @brief Unit tests for the resolved Backend dispatch table
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/backend/backend.hpp"
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/ndarray.hpp"
+#include "../../../common/test_utils.hpp"
+#include "test_device_residency.hpp"
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class BackendDispatchTableTest
+ * @brief Test that the active table follows Device::setDevice()
+ */
+class BackendDispatchTableTest : public TestCase {
+public:
+  BackendDispatchTableTest() : TestCase("BackendDispatchTableTest") {}
+
+protected:
+  void test() override {
+    DeviceType previous = Device::getCurrentDevice();
+    const Backend::BackendOps& cpu_ops =
+        Backend::Backend::getOps(DeviceType::CPU);
+    const Backend::BackendOps& gpu_ops =
+        Backend::Backend::getOps(DeviceType::GPU);
+
+    assertTrue(&cpu_ops != &gpu_ops, "CPU and GPU have separate tables");
+    assertTrue(&Backend::Backend::getOps(DeviceType::AUTO) != &cpu_ops &&
+                   &Backend::Backend::getOps(DeviceType::AUTO) != &gpu_ops,
+               "AUTO has its own placing table");
+
+    Device::setDevice(DeviceType::GPU);
+    assertTrue(&Backend::Backend::getOps() == &gpu_ops,
+               "Switching to GPU swaps in the GPU table");
+
+    Device::setDevice(DeviceType::CPU);
+    assertTrue(&Backend::Backend::getOps() == &cpu_ops,
+               "Switching back restores the CPU table");
+
+    Device::setDeviceWithValidation(DeviceType::CPU, false);
+    assertTrue(&Backend::Backend::getOps() == &cpu_ops,
+               "Validated switch also updates the table");
+
+    // Shape errors still propagate through the GPU fallback wrapper
+    Device::setDevice(DeviceType::GPU);
+    NDArray a({2, 3});
+    NDArray b({2, 3});
+    NDArray result;
+    assertThrows<std::invalid_argument>(
+        [&]() { Backend::Backend::matmul(a, b, result); },
+        "Invalid shapes throw on GPU dispatch");
+
+    Device::setDevice(previous);
+  }
+};
+
+/**
+ * @class StaticBackendTest
+ * @brief Test compile-time bound backends against runtime dispatch
+ */
+class StaticBackendTest : public TestCase {
+public:
+  StaticBackendTest() : TestCase("StaticBackendTest") {}
+
+protected:
+  void test() override {
+    NDArray a({3, 4});
+    NDArray b({4, 2});
+    NDArray c({3, 4});
+    for (size_t i = 0; i < a.size(); ++i) {
+      a[i] = 0.25 * static_cast<double>(i) - 1.0;
+      c[i] = static_cast<double>(i % 3);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      b[i] = 0.5 * static_cast<double>(i);
+    }
+
+    using CPU = Backend::StaticBackend<DeviceType::CPU>;
+    NDArray expected;
+    NDArray actual;
+
+    Backend::Backend::matmul(a, b, expected);
+    CPU::matmul(a, b, actual);
+    assertVectorNear(expected.to_vector(), actual.to_vector(), 1e-12,
+                     "Static matmul matches dispatched matmul");
+
+    Backend::Backend::multiply(a, c, expected);
+    CPU::multiply(a, c, actual);
+    assertVectorNear(expected.to_vector(), actual.to_vector(), 1e-12,
+                     "Static multiply matches dispatched multiply");
+
+    Backend::Backend::multiply_scalar(a, -2.0, expected);
+    Backend::DefaultBackend::multiply_scalar(a, -2.0, actual);
+    assertVectorNear(expected.to_vector(), actual.to_vector(), 1e-12,
+                     "DefaultBackend matches dispatched backend");
+  }
+};
+
+/**
+ * @class DenseBackendDispatchTest
+ * @brief Test that Dense computes through Backend
+ */
+class DenseBackendDispatchTest : public TestCase {
+public:
+  DenseBackendDispatchTest() : TestCase("DenseBackendDispatchTest") {}
+
+protected:
+  void test() override {
+    layer::Dense dense(3, 2);
+    NDArray* weights = dense.get_parameters()[0];
+    NDArray* bias = dense.get_parameters()[1];
+    for (size_t i = 0; i < weights->size(); ++i) {
+      (*weights)[i] = 0.1 * static_cast<double>(i + 1);
+    }
+    (*bias)[0] = 0.5;
+    (*bias)[1] = -0.5;
+
+    NDArray input(std::vector<std::vector<double>>{{1.0, 2.0, 3.0},
+                                                   {-1.0, 0.0, 1.0}});
+    NDArray output = dense.forward(input);
+
+    // Row i: sum_k input[i,k] * w[k,j] + bias[j]
+    std::vector<double> expected = {2.2 + 0.5, 2.8 - 0.5, 0.4 + 0.5,
+                                    0.4 - 0.5};
+    assertVectorNear(expected, output.to_vector(), 1e-12,
+                     "Dense forward output");
+
+    NDArray grad_output(
+        std::vector<std::vector<double>>{{1.0, 0.0}, {0.0, 1.0}});
+    NDArray grad_input = dense.backward(grad_output);
+    std::vector<double> expected_grad = {0.1, 0.3, 0.5, 0.2, 0.4, 0.6};
+    assertVectorNear(expected_grad, grad_input.to_vector(), 1e-12,
+                     "Dense backward input gradient");
+
+#ifndef CPU_ONLY
+    // With a device installed, Dense runs its GEMMs on the device
+    MockDeviceScope scope;
+    dense.forward(input);
+    assertTrue(scope.memory->stats().kernel_launches >= 1,
+               "Dense forward matmul runs on the device");
+#endif
+  }
+};
+
+/**
+ * @class BackendAccumulateTest
+ * @brief Test in-place accumulation and output reuse without allocation
+ */
+class BackendAccumulateTest : public TestCase {
+public:
+  BackendAccumulateTest() : TestCase("BackendAccumulateTest") {}
+
+protected:
+  void test() override {
+    NDArray x({2, 3});
+    NDArray y({2, 3});
+    NDArray z({2, 3});
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<double>(i);
+      y[i] = 1.0;
+      z[i] = 0.5;
+    }
+    const double* storage = y.data();
+
+    Backend::Backend::axpy(2.0, x, y);
+    assertVectorNear({1.0, 3.0, 5.0, 7.0, 9.0, 11.0}, y.to_vector(), 0.0,
+                     "axpy accumulates");
+    Backend::Backend::axpby(1.0, x, -0.5, y);
+    assertVectorNear({-0.5, -0.5, -0.5, -0.5, -0.5, -0.5}, y.to_vector(),
+                     1e-15, "axpby scales both operands");
+    Backend::Backend::multiply_add(x, z, y);
+    assertVectorNear({-0.5, 0.0, 0.5, 1.0, 1.5, 2.0}, y.to_vector(), 1e-15,
+                     "multiply_add accumulates the product");
+    assertTrue(y.data() == storage, "Accumulators keep their storage");
+
+    NDArray wrong({3, 2});
+    assertThrows<std::invalid_argument>(
+        [&]() { Backend::Backend::axpy(1.0, wrong, y); }, "axpy shapes");
+    assertThrows<std::invalid_argument>(
+        [&]() { Backend::Backend::multiply_add(x, wrong, y); },
+        "multiply_add shapes");
+
+    // An output of the right element count is reshaped, not reallocated
+    const double* wrong_storage = wrong.data();
+    Backend::Backend::add(x, z, wrong);
+    assertTrue(wrong.data() == wrong_storage, "Output storage reused");
+    assertTrue(wrong.shape() == x.shape(), "Output takes the result shape");
+
+    using CPU = Backend::StaticBackend<DeviceType::CPU>;
+    NDArray expected = y;
+    Backend::Backend::axpby(0.25, x, 2.0, expected);
+    CPU::axpby(0.25, x, 2.0, y);
+    assertVectorNear(expected.to_vector(), y.to_vector(), 0.0,
+                     "Static axpby matches dispatched axpby");
+
+#ifndef CPU_ONLY
+    // Device-resident accumulators stay on the device
+    MockDeviceScope scope;
+    NDArray acc({2, 3});
+    acc.fill(1.0);
+    Backend::Backend::axpy(-1.0, x, acc);
+    Backend::Backend::multiply_add(x, x, acc);
+    assertEqual(size_t(2), scope.memory->stats().kernel_launches,
+                "Two device kernels");
+    assertTrue(acc.residency() == Residency::DEVICE, "Result on the device");
+    const NDArray& view = acc;
+    assertVectorNear({1.0, 1.0, 3.0, 7.0, 13.0, 21.0}, view.to_vector(),
+                     1e-12, "Device accumulation");
+#endif
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
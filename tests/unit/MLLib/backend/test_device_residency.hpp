@@ -0,0 +1,307 @@
+/**
+ * @file test_device_residency.hpp
+ * @brief Unit tests for device-resident NDArrays with lazy host sync
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/backend/backend.hpp"
+#include "../../../../include/MLLib/backend/mock_device.hpp"
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../../include/MLLib/layer/activation/relu.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/model/sequential.hpp"
+#include "../../../../include/MLLib/ndarray.hpp"
+#include "../../../common/test_utils.hpp"
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Install a mock device and select GPU for the scope of a test
+ */
+class MockDeviceScope {
+public:
+  MockDeviceScope()
+      : memory(std::make_shared<Backend::MockDeviceMemoryBackend>()),
+        previous_device_(Device::getCurrentDevice()) {
+    Backend::Backend::setDeviceMemoryBackend(memory);
+    Device::setDevice(DeviceType::GPU);
+  }
+
+  ~MockDeviceScope() {
+    Backend::Backend::setDeviceMemoryBackend(nullptr);
+    Device::setDevice(previous_device_);
+  }
+
+  std::shared_ptr<Backend::MockDeviceMemoryBackend> memory;
+
+private:
+  DeviceType previous_device_;
+};
+
+/**
+ * @class DeviceResidencyChainTest
+ * @brief Test that chained ops stay on the device until the host reads
+ */
+class DeviceResidencyChainTest : public TestCase {
+public:
+  DeviceResidencyChainTest() : TestCase("DeviceResidencyChainTest") {}
+
+protected:
+  void test() override {
+    MockDeviceScope scope;
+
+    NDArray a({2, 3});
+    NDArray b({3, 2});
+    for (size_t i = 0; i < 6; ++i) {
+      a[i] = static_cast<double>(i + 1);
+      b[i] = 0.5 * static_cast<double>(i);
+    }
+    NDArray expected = (a.matmul(b) + 1.0) * (a.matmul(b) + 1.0);
+
+    NDArray product;
+    NDArray shifted;
+    NDArray squared;
+    Backend::Backend::matmul(a, b, product);
+    Backend::Backend::add_scalar(product, 1.0, shifted);
+    Backend::Backend::multiply(shifted, shifted, squared);
+
+    auto stats = scope.memory->stats();
+    assertEqual(size_t(2), stats.uploads, "Only the two inputs are uploaded");
+    assertEqual(size_t(0), stats.downloads, "Nothing is read back yet");
+    assertEqual(size_t(3), stats.kernel_launches, "Three device kernels");
+    assertTrue(squared.residency() == Residency::DEVICE,
+               "Result is device-resident");
+    assertTrue(a.residency() == Residency::BOTH,
+               "Uploaded input keeps a valid host copy");
+
+    const NDArray& view = squared;
+    assertVectorNear(expected.to_vector(), view.to_vector(), 1e-12,
+                     "Device chain matches host computation");
+    assertEqual(size_t(1), scope.memory->stats().downloads,
+                "Host read downloads once");
+    assertTrue(squared.residency() == Residency::BOTH,
+               "Const read leaves both copies valid");
+
+    // Reusing synced arrays does not transfer again
+    NDArray again;
+    Backend::Backend::add(squared, shifted, again);
+    assertEqual(size_t(2), scope.memory->stats().uploads,
+                "Valid device copies are reused");
+  }
+};
+
+/**
+ * @class DeviceResidencyInvalidationTest
+ * @brief Test host writes, CPU fallbacks and copies of resident arrays
+ */
+class DeviceResidencyInvalidationTest : public TestCase {
+public:
+  DeviceResidencyInvalidationTest()
+      : TestCase("DeviceResidencyInvalidationTest") {}
+
+protected:
+  void test() override {
+    MockDeviceScope scope;
+
+    NDArray x({4});
+    NDArray y;
+    Backend::Backend::fill(x, 2.0);
+    assertEqual(size_t(0), scope.memory->stats().uploads,
+                "Device fill needs no upload");
+    Backend::Backend::multiply_scalar(x, 3.0, y);
+
+    // Writing through the host invalidates the device copy
+    y[0] = 10.0;
+    assertTrue(y.residency() == Residency::HOST, "Host write takes ownership");
+    assertNear(6.0, y[1], 1e-12, "Other elements were downloaded first");
+    NDArray z;
+    Backend::Backend::add_scalar(y, 1.0, z);
+    assertEqual(size_t(1), scope.memory->stats().uploads,
+                "Modified array is uploaded again");
+    assertNear(11.0, z.to_vector()[0], 1e-12, "Host write reached device");
+
+    // Copies take the host view; CPU ops see device results
+    NDArray copy(z);
+    assertTrue(copy.residency() == Residency::HOST, "Copies are host-side");
+    assertNear(7.0, copy[2], 1e-12, "Copy holds synced data");
+
+    Backend::Backend::copy(x, z);
+    Device::setDevice(DeviceType::CPU);
+    NDArray cpu_sum;
+    Backend::Backend::add(z, x, cpu_sum);
+    assertNear(4.0, cpu_sum[3], 1e-12, "CPU path syncs device data");
+
+    NDArray fresh({3});
+    assertThrows<std::logic_error>(
+        [&]() { fresh.set_residency(Residency::DEVICE); },
+        "Device residency needs a buffer");
+  }
+};
+
+/**
+ * @class DeviceResidencyConcurrentReadTest
+ * @brief Test that concurrent const readers download a resident array once
+ */
+class DeviceResidencyConcurrentReadTest : public TestCase {
+public:
+  DeviceResidencyConcurrentReadTest()
+      : TestCase("DeviceResidencyConcurrentReadTest") {}
+
+protected:
+  void test() override {
+    MockDeviceScope scope;
+
+    NDArray x({256});
+    NDArray y;
+    Backend::Backend::fill(x, 1.5);
+    Backend::Backend::multiply_scalar(x, 2.0, y);
+    assertTrue(y.residency() == Residency::DEVICE, "Result is resident");
+
+    const NDArray& shared = y;
+    const size_t thread_count = 8;
+    std::vector<double> sums(thread_count, 0.0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&shared, &sums, t]() {
+        const double* data = shared.data();
+        for (size_t i = 0; i < shared.size(); ++i) {
+          sums[t] += data[i];
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t t = 0; t < thread_count; ++t) {
+      assertNear(768.0, sums[t], 1e-12, "Every reader sees downloaded data");
+    }
+    assertEqual(size_t(1), scope.memory->stats().downloads,
+                "Concurrent readers share one download");
+    assertTrue(y.residency() == Residency::BOTH, "Both copies are valid");
+  }
+};
+
+/**
+ * @class DeviceResidencyConcurrentPredictTest
+ * @brief Test concurrent const predict() on shared weights with a device
+ */
+class DeviceResidencyConcurrentPredictTest : public TestCase {
+public:
+  DeviceResidencyConcurrentPredictTest()
+      : TestCase("DeviceResidencyConcurrentPredictTest") {}
+
+protected:
+  void test() override {
+    const size_t thread_count = 8;
+    const size_t requests = 20;
+    std::vector<NDArray> inputs;
+    for (size_t r = 0; r < requests; ++r) {
+      NDArray input({3, 6});
+      for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = std::sin(0.3 * static_cast<double>(r * 18 + i));
+      }
+      inputs.push_back(input);
+    }
+
+    // The same calls made from one thread give the reference transfers
+    auto serial = makeModel();
+    std::vector<std::vector<double>> expected;
+    for (const auto& input : inputs) {
+      expected.push_back(serial->predict(input).to_vector());
+    }
+    size_t serial_uploads = 0;
+    {
+      MockDeviceScope scope;
+      for (size_t call = 0; call < thread_count * requests; ++call) {
+        serial->predict(inputs[call % requests]);
+      }
+      serial_uploads = scope.memory->stats().uploads;
+    }
+
+    auto model = makeModel();
+    copyWeights(*serial, *model);
+    MockDeviceScope scope;
+    const model::Sequential& shared = *model;
+    std::vector<size_t> mismatches(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&, t]() {
+        for (size_t r = 0; r < requests; ++r) {
+          std::vector<double> values = shared.predict(inputs[r]).to_vector();
+          for (size_t i = 0; i < values.size(); ++i) {
+            if (std::abs(values[i] - expected[r][i]) > 1e-12) {
+              ++mismatches[t];
+              break;
+            }
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    size_t total = 0;
+    for (size_t count : mismatches) {
+      total += count;
+    }
+    assertEqual(size_t(0), total, "Device predictions match host ones");
+    // Racing readers of shared weights and inputs would upload them again
+    assertEqual(serial_uploads, scope.memory->stats().uploads,
+                "Shared arrays are uploaded once between all threads");
+
+    // Line threads up on the first use of one large shared array
+    NDArray weights({1 << 16});
+    weights.fill(0.5);
+    const NDArray& shared_weights = weights;
+    const size_t before = scope.memory->stats().uploads;
+    std::atomic<bool> go{false};
+    std::vector<NDArray> outputs(thread_count);
+    threads.clear();
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&, t]() {
+        while (!go.load()) {
+        }
+        Backend::Backend::multiply_scalar(shared_weights, 2.0, outputs[t]);
+      });
+    }
+    go.store(true);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    assertEqual(before + 1, scope.memory->stats().uploads,
+                "Concurrent first use uploads once");
+    assertNear(1.0, outputs[thread_count - 1][0], 1e-12,
+               "Every reader sees the uploaded data");
+  }
+
+private:
+  static std::shared_ptr<model::Sequential> makeModel() {
+    auto model = std::make_shared<model::Sequential>();
+    model->add(std::make_shared<layer::Dense>(6, 16));
+    model->add(std::make_shared<layer::activation::ReLU>());
+    model->add(std::make_shared<layer::Dense>(16, 2));
+    return model;
+  }
+
+  static void copyWeights(model::Sequential& from, model::Sequential& to) {
+    for (size_t layer = 0; layer < from.get_layers().size(); ++layer) {
+      std::vector<NDArray*> source = from.get_layers()[layer]->get_parameters();
+      std::vector<NDArray*> target = to.get_layers()[layer]->get_parameters();
+      for (size_t p = 0; p < source.size(); ++p) {
+        *target[p] = *source[p];
+      }
+    }
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,182 @@
+/**
+ * @file test_expression_kernel.hpp
+ * @brief Unit tests for CPU expression kernels and the kernel registry
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/backend/expression_kernel.hpp"
+#include "../../../../include/MLLib/backend/gpu_kernel_manager.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cmath>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class ExpressionKernelCompileTest
+ * @brief Test parsing, evaluation and constant folding
+ */
+class ExpressionKernelCompileTest : public TestCase {
+public:
+  ExpressionKernelCompileTest() : TestCase("ExpressionKernelCompileTest") {}
+
+protected:
+  void test() override {
+    using Backend::ExpressionKernel;
+
+    std::vector<double> x = {-2.0, -0.5, 0.0, 0.5, 2.0};
+    std::vector<double> out(x.size());
+
+    ExpressionKernel leaky("input > 0.0f ? input : alpha * input", {"input"},
+                           {"alpha"});
+    leaky.execute({x.data()}, out.data(), x.size(), {0.1});
+    assertVectorNear({-0.2, -0.05, 0.0, 0.5, 2.0}, out, 1e-12,
+                     "Ternary with parameter");
+
+    ExpressionKernel mixed("-(input * input) + 2 * max(input, 0.0) - pow(2.0, "
+                           "3.0) / 4.0 + (input >= 0.5 && input < 1.0)",
+                           {"input"});
+    mixed.execute({x.data()}, out.data(), x.size());
+    std::vector<double> expected;
+    for (double v : x) {
+      expected.push_back(-(v * v) + 2 * std::max(v, 0.0) - 2.0 +
+                         ((v >= 0.5 && v < 1.0) ? 1.0 : 0.0));
+    }
+    assertVectorNear(expected, out, 1e-12, "Precedence and functions");
+
+    // pow(2.0, 3.0) / 4.0 folds to one constant
+    ExpressionKernel folded("input - pow(2.0, 3.0) / 4.0", {"input"});
+    assertEqual(size_t(3), folded.instruction_count(),
+                "Constant subexpression folded");
+
+    ExpressionKernel binary("input1 * input2 + 1e-3f", {"input1", "input2"});
+    std::vector<double> y = {1.0, 2.0, 3.0, 4.0, 5.0};
+    binary.execute({x.data(), y.data()}, out.data(), x.size());
+    assertNear(-2.0 + 1e-3, out[0], 1e-12, "Binary expression");
+
+    assertThrows<std::invalid_argument>(
+        []() { ExpressionKernel("input +", {"input"}); },
+        "Incomplete expression throws");
+    assertThrows<std::invalid_argument>(
+        []() { ExpressionKernel("beta * input", {"input"}); },
+        "Unknown name throws");
+    assertThrows<std::invalid_argument>(
+        []() { ExpressionKernel("erf(input)", {"input"}); },
+        "Unknown function throws");
+    assertThrows<std::invalid_argument>(
+        [&]() { leaky.execute({x.data()}, out.data(), x.size()); },
+        "Missing parameter throws");
+  }
+};
+
+/**
+ * @class ExpressionKernelParallelTest
+ * @brief Test large multi-block evaluation against a scalar reference
+ */
+class ExpressionKernelParallelTest : public TestCase {
+public:
+  ExpressionKernelParallelTest() : TestCase("ExpressionKernelParallelTest") {}
+
+protected:
+  void test() override {
+    const size_t size = 100003;  // Not a multiple of the block size
+    std::vector<double> x(size);
+    for (size_t i = 0; i < size; ++i) {
+      x[i] = std::sin(static_cast<double>(i)) * 4.0;
+    }
+
+    Backend::ExpressionKernel elu(
+        "input > 0.0f ? input : alpha * (exp(input) - 1.0f)", {"input"},
+        {"alpha"});
+    std::vector<double> out(size);
+    elu.execute({x.data()}, out.data(), size, {0.7});
+
+    bool match = true;
+    for (size_t i = 0; i < size && match; ++i) {
+      double ref = x[i] > 0.0 ? x[i] : 0.7 * (std::exp(x[i]) - 1.0);
+      match = std::fabs(ref - out[i]) < 1e-12;
+    }
+    assertTrue(match, "Parallel evaluation matches scalar reference");
+
+    // In place: output aliases the input
+    std::vector<double> in_place = x;
+    elu.execute({in_place.data()}, in_place.data(), size, {0.7});
+    assertVectorNear(out, in_place, 1e-12, "In-place evaluation");
+  }
+};
+
+/**
+ * @class ActivationRegistryCPUTest
+ * @brief Test that registered activations run on the CPU backend
+ */
+class ActivationRegistryCPUTest : public TestCase {
+public:
+  ActivationRegistryCPUTest() : TestCase("ActivationRegistryCPUTest") {}
+
+protected:
+  void test() override {
+    using Backend::ActivationKernelRegistry;
+    using Backend::GPUKernelManager;
+
+    std::vector<double> x = {-3.0, -1.0, 0.0, 1.0, 3.0};
+    std::vector<double> out(x.size());
+
+    ActivationKernelRegistry::registerActivation(
+        {"test_swish", "input / (1.0f + exp(-beta * input))", {"beta"}, true});
+    ActivationKernelRegistry::executeActivation("test_swish", x.data(),
+                                                out.data(), x.size(), {1.0});
+    std::vector<double> expected;
+    for (double v : x) {
+      expected.push_back(v / (1.0 + std::exp(-v)));
+    }
+    assertVectorNear(expected, out, 1e-12, "Custom activation runs on CPU");
+
+    // Builtins use their default parameters when none are given
+    GPUKernelManager::executeUnaryKernel("leaky_relu", x.data(), out.data(),
+                                         x.size());
+    assertVectorNear({-0.03, -0.01, 0.0, 1.0, 3.0}, out, 1e-12,
+                     "Builtin leaky_relu default alpha");
+
+    GPUKernelManager::registerExpressionKernel(
+        "test_scaled_diff", "p0 * (input1 - input2)", 2, {2.0});
+    std::vector<double> y = {1.0, 1.0, 1.0, 1.0, 1.0};
+    GPUKernelManager::executeBinaryKernel("test_scaled_diff", x.data(),
+                                          y.data(), out.data(), x.size());
+    assertVectorNear({-8.0, -4.0, -2.0, 0.0, 4.0}, out, 1e-12,
+                     "Registered binary kernel");
+
+    assertThrows<std::invalid_argument>(
+        []() {
+          ActivationKernelRegistry::registerActivation(
+              {"test_broken", "input *", {}, false});
+        },
+        "Invalid expression is rejected at registration");
+    assertThrows<std::invalid_argument>(
+        []() {
+          GPUKernelManager::registerExpressionKernel("test_ternary",
+                                                     "input1 + input2", 3);
+        },
+        "Arity must be one or two");
+
+    // Unary arity is explicit: names like "input10" do not flip it
+    GPUKernelManager::registerExpressionKernel("test_shift", "input + p0", 1,
+                                               {0.5});
+    GPUKernelManager::executeUnaryKernel("test_shift", x.data(), out.data(),
+                                         x.size());
+    assertVectorNear({-2.5, -0.5, 0.5, 1.5, 3.5}, out, 1e-12,
+                     "Registered unary kernel");
+
+    // Shader source is ignored rather than parsed on the CPU build
+    assertNoThrow(
+        []() {
+          GPUKernelManager::registerKernel(
+              {"test_metal", "kernel void test_metal_kernel() {}", {}});
+        },
+        "Shader source is ignored on the CPU build");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,182 @@
+/**
+ * @file test_placement.hpp
+ * @brief Unit tests for cost-model driven op placement
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/backend/backend.hpp"
+#include "../../../../include/MLLib/backend/mock_device.hpp"
+#include "../../../../include/MLLib/backend/placement.hpp"
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../common/test_utils.hpp"
+#include <memory>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Slow-but-cheap-to-launch CPU and fast-but-costly-to-reach GPU
+ */
+inline Backend::CostModel simulatedCPUModel() {
+  Backend::CostModel model;
+  model.gemm = {1.0, 1e-3};
+  model.elementwise = {0.5, 1e-3};
+  model.transfer = {0.0, 0.0};
+  return model;
+}
+
+inline Backend::CostModel simulatedGPUModel() {
+  Backend::CostModel model;
+  model.gemm = {50.0, 1e-5};
+  model.elementwise = {20.0, 1e-5};
+  model.transfer = {10.0, 1e-3};
+  return model;
+}
+
+inline Backend::CostProfile simulatedProfile() {
+  Backend::SimulatedDevice cpu(DeviceType::CPU, simulatedCPUModel());
+  Backend::SimulatedDevice gpu(DeviceType::GPU, simulatedGPUModel());
+  return Backend::benchmarkProfile({cpu.target(), gpu.target()});
+}
+
+/**
+ * @class CostProfileBenchmarkTest
+ * @brief Test fitting simulated devices and persisting the profile
+ */
+class CostProfileBenchmarkTest : public TestCase {
+public:
+  CostProfileBenchmarkTest() : TestCase("CostProfileBenchmarkTest") {}
+
+protected:
+  void test() override {
+    Backend::CostProfile profile = simulatedProfile();
+    assertTrue(profile.has(DeviceType::CPU) && profile.has(DeviceType::GPU),
+               "Both devices measured");
+
+    const Backend::CostModel& gpu = profile.get(DeviceType::GPU);
+    assertNear(50.0, gpu.gemm.fixed_us, 1e-6, "GEMM launch cost recovered");
+    assertNear(1e-5, gpu.gemm.per_unit_us, 1e-12, "GEMM rate recovered");
+    assertNear(20.0, gpu.elementwise.fixed_us, 1e-6,
+               "Element-wise launch cost recovered");
+    assertNear(1e-3, gpu.transfer.per_unit_us, 1e-12,
+               "Transfer rate recovered");
+
+    std::string dir = createTempDirectory();
+    std::string path = dir + "/profile.txt";
+    assertTrue(profile.save(path), "Profile saved");
+
+    Backend::CostProfile loaded;
+    assertTrue(loaded.load(path), "Profile loaded");
+    assertNear(gpu.gemm.per_unit_us,
+               loaded.get(DeviceType::GPU).gemm.per_unit_us, 1e-18,
+               "Round trip keeps full precision");
+    assertNear(0.5, loaded.get(DeviceType::CPU).elementwise.fixed_us, 1e-9,
+               "CPU model round trip");
+
+    Backend::CostProfile untouched = loaded;
+    assertFalse(untouched.load(dir + "/missing.txt"),
+                "Missing file fails to load");
+    assertTrue(untouched.has(DeviceType::GPU),
+               "Failed load leaves the profile unchanged");
+    assertThrows<std::invalid_argument>(
+        []() { Backend::CostProfile().get(DeviceType::GPU); },
+        "Missing model throws");
+    removeTempDirectory(dir);
+
+    // Real backend targets produce a usable profile too
+    Backend::BenchmarkPlan plan;
+    plan.gemm_sizes = {4, 8};
+    plan.elementwise_sizes = {64, 256};
+    plan.transfer_bytes = {64, 256};
+    plan.repetitions = 1;
+    Backend::CostProfile measured = Backend::benchmarkProfile(
+        {Backend::BenchmarkTarget::backend(DeviceType::CPU)}, plan);
+    assertTrue(measured.get(DeviceType::CPU).gemm.per_unit_us >= 0.0,
+               "Measured CPU model is non-negative");
+  }
+};
+
+/**
+ * @class PlacementDecisionTest
+ * @brief Test per-op placement with transfer costs
+ */
+class PlacementDecisionTest : public TestCase {
+public:
+  PlacementDecisionTest() : TestCase("PlacementDecisionTest") {}
+
+protected:
+  void test() override {
+    using Backend::OpDescriptor;
+    Backend::PlacementScheduler scheduler(simulatedProfile());
+
+    assertTrue(scheduler.place(OpDescriptor::gemm(4, 4, 4)) == DeviceType::CPU,
+               "Small GEMM stays on the CPU");
+    assertTrue(scheduler.place(OpDescriptor::gemm(256, 256, 256)) ==
+                   DeviceType::GPU,
+               "Large GEMM goes to the GPU");
+
+    OpDescriptor add = OpDescriptor::elementwise(100000);
+    assertTrue(scheduler.place(add, DeviceType::CPU) == DeviceType::CPU,
+               "Host-resident element-wise op is not worth the transfer");
+    assertTrue(scheduler.place(add, DeviceType::GPU) == DeviceType::GPU,
+               "Device-resident element-wise op stays on the device");
+
+    Backend::PlacementScheduler empty;
+    assertTrue(empty.place(OpDescriptor::gemm(1024, 1024, 1024)) ==
+                   DeviceType::CPU,
+               "Without a profile everything runs on the CPU");
+  }
+};
+
+/**
+ * @class AutoPlacementBackendTest
+ * @brief Test that DeviceType::AUTO places Backend calls per op
+ */
+class AutoPlacementBackendTest : public TestCase {
+public:
+  AutoPlacementBackendTest() : TestCase("AutoPlacementBackendTest") {}
+
+protected:
+  void test() override {
+    DeviceType previous = Device::getCurrentDevice();
+    auto memory = std::make_shared<Backend::MockDeviceMemoryBackend>();
+    Backend::Backend::setDeviceMemoryBackend(memory);
+    Backend::PlacementScheduler::global().setProfile(simulatedProfile());
+    Device::setDevice(DeviceType::AUTO);
+
+    NDArray small_a({4, 4});
+    NDArray small_b({4, 4});
+    small_a.fill(1.0);
+    small_b.fill(2.0);
+    NDArray small_c;
+    Backend::Backend::matmul(small_a, small_b, small_c);
+    assertEqual(size_t(0), memory->stats().kernel_launches,
+                "Small GEMM runs on the CPU");
+
+    NDArray big_a({128, 128});
+    NDArray big_b({128, 128});
+    big_a.fill(1.0);
+    big_b.fill(0.5);
+    NDArray big_c;
+    Backend::Backend::matmul(big_a, big_b, big_c);
+    assertEqual(size_t(1), memory->stats().kernel_launches,
+                "Large GEMM runs on the device");
+
+    NDArray shifted;
+    Backend::Backend::add_scalar(big_c, 1.0, shifted);
+    assertEqual(size_t(2), memory->stats().kernel_launches,
+                "Op on a device-resident result stays on the device");
+
+    const NDArray& view = shifted;
+    assertNear(65.0, view.to_vector()[0], 1e-12, "AUTO result is correct");
+
+    Backend::PlacementScheduler::global().setProfile(Backend::CostProfile());
+    Backend::Backend::setDeviceMemoryBackend(nullptr);
+    Device::setDevice(previous);
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
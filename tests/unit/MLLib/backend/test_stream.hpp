@@ -0,0 +1,155 @@
+/**
+ * @file test_stream.hpp
+ * @brief Unit tests for asynchronous Backend streams
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/backend/stream.hpp"
+#include "../../../../include/MLLib/layer/activation/relu.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/model/sequential.hpp"
+#include "../../../../include/MLLib/ndarray.hpp"
+#include "../../../common/test_utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class StreamOrderingTest
+ * @brief Test in-order execution and asynchronous Backend operations
+ */
+class StreamOrderingTest : public TestCase {
+public:
+  StreamOrderingTest() : TestCase("StreamOrderingTest") {}
+
+protected:
+  void test() override {
+    Backend::Stream stream;
+
+    std::vector<int> order;
+    for (int i = 0; i < 20; ++i) {
+      stream.enqueue([&order, i]() { order.push_back(i); });
+    }
+    stream.synchronize();
+    bool in_order = order.size() == 20;
+    for (size_t i = 0; in_order && i < order.size(); ++i) {
+      in_order = order[i] == static_cast<int>(i);
+    }
+    assertTrue(in_order, "Work should run in enqueue order");
+
+    NDArray a({2, 2});
+    NDArray b({2, 2});
+    NDArray product({2, 2});
+    NDArray sum({2, 2});
+    NDArray scaled({2, 2});
+    stream.fill(a, 2.0);
+    stream.fill(b, 3.0);
+    stream.matmul(a, b, product);
+    stream.add(product, a, sum);
+    Backend::Event done = stream.multiply_scalar(sum, 0.5, scaled);
+    done.wait();
+    assertTrue(done.ready(), "Event should be ready after wait");
+    assertNear(7.0, scaled[0], 1e-12, "(2*3*2 + 2) * 0.5");
+    assertNear(7.0, scaled[3], 1e-12, "(2*3*2 + 2) * 0.5");
+
+    assertTrue(Backend::Event().ready(), "Default event is complete");
+  }
+};
+
+/**
+ * @class StreamEventTest
+ * @brief Test cross-stream dependencies, overlap and error propagation
+ */
+class StreamEventTest : public TestCase {
+public:
+  StreamEventTest() : TestCase("StreamEventTest") {}
+
+protected:
+  void test() override {
+    Backend::Stream producer;
+    Backend::Stream consumer;
+
+    // Consumer must not read before the producer's event fires
+    std::atomic<bool> produced{false};
+    producer.enqueue([&produced]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(30));
+      produced = true;
+    });
+    consumer.wait_event(producer.record());
+    bool seen = consumer.enqueue([&produced]() { return produced.load(); })
+                    .get();
+    assertTrue(seen, "wait_event should order work across streams");
+
+    // Independent streams overlap
+    auto start = std::chrono::steady_clock::now();
+    auto first = producer.enqueue(
+        []() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+    auto second = consumer.enqueue(
+        []() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+    first.wait();
+    second.wait();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    assertTrue(elapsed < 190, "Streams should run concurrently");
+
+    // Errors surface through the op's event, and the stream keeps working
+    NDArray a({2, 2});
+    NDArray b({3, 3});
+    NDArray out({2, 2});
+    Backend::Event failed = producer.add(a, b, out);
+    assertThrows<std::invalid_argument>([&]() { failed.wait(); },
+                                        "Shape mismatch should propagate");
+    assertEqual(5, producer.enqueue([]() { return 5; }).get(),
+                "Stream should continue after a failure");
+  }
+};
+
+/**
+ * @class StreamPredictTest
+ * @brief Test pipelined Sequential::predict_async
+ */
+class StreamPredictTest : public TestCase {
+public:
+  StreamPredictTest() : TestCase("StreamPredictTest") {}
+
+protected:
+  void test() override {
+    model::Sequential encoder;
+    encoder.add(std::make_shared<layer::Dense>(4, 3));
+    encoder.add(std::make_shared<layer::activation::ReLU>());
+    model::Sequential decoder;
+    decoder.add(std::make_shared<layer::Dense>(3, 4));
+
+    NDArray input({2, 4});
+    for (size_t i = 0; i < input.size(); ++i) {
+      input[i] = 0.1 * static_cast<double>(i);
+    }
+    NDArray expected = decoder.predict(encoder.predict(input));
+
+    // Encode on one stream, decode on another
+    Backend::Stream encode_stream;
+    Backend::Stream decode_stream;
+    std::vector<std::future<NDArray>> outputs;
+    for (int request = 0; request < 4; ++request) {
+      auto encoded = encoder.predict_async(input, encode_stream).share();
+      outputs.push_back(decode_stream.enqueue(
+          [&decoder, encoded]() { return decoder.predict(encoded.get()); }));
+    }
+
+    for (auto& output : outputs) {
+      NDArray result = output.get();
+      assertVectorNear(expected.to_vector(), result.to_vector(), 1e-12,
+                       "Pipelined output should match synchronous predict");
+    }
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,98 @@
+/**
+ * @file test_window.hpp
+ * @brief Unit tests for sliding-window time-series views
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/data/window.hpp"
+#include "../../../common/test_utils.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class WindowDatasetTest
+ * @brief Test window views, gathering and streaming with a bounded history
+ */
+class WindowDatasetTest : public TestCase {
+public:
+  WindowDatasetTest() : TestCase("WindowDatasetTest") {}
+
+protected:
+  void test() override {
+    using data::WindowDataset;
+    using data::WindowView;
+
+    // Series of 10 steps with 2 features: step t holds (t, 10 + t)
+    NDArray series({10, 2});
+    for (size_t t = 0; t < 10; ++t) {
+      series[2 * t] = static_cast<double>(t);
+      series[2 * t + 1] = 10.0 + static_cast<double>(t);
+    }
+    WindowDataset windows(series, 4, 2);
+    assertEqual(size_t(2), windows.get_features(), "Features from shape");
+    assertEqual(size_t(4), windows.size(), "Windows at 0, 2, 4, 6");
+    assertEqual(size_t(8), windows.sample_size(), "Flat window size");
+
+    // Views share the series buffer
+    WindowView first = windows[0];
+    WindowView second = windows[1];
+    assertTrue(second.data == first.data + 2 * 2, "No copy per window");
+    assertEqual(size_t(6), windows[3].start, "Last window start");
+    assertNear(16.0, windows[3].step(0)[1], 1e-12, "Step values");
+    assertThrows<std::out_of_range>([&]() { windows[4]; }, "Past the end");
+
+    NDArray batch;
+    const size_t picks[] = {3, 0};
+    windows.gather(picks, 2, batch);
+    assertTrue(batch.shape() == std::vector<size_t>{2, 8}, "Batch shape");
+    assertVectorNear({6, 16, 7, 17, 8, 18, 9, 19},
+                     std::vector<double>(batch.data(), batch.data() + 8),
+                     1e-12, "Gathered window");
+    const double* buffer = batch.data();
+    windows.gather(1, 3, batch);
+    assertTrue(batch.data() == buffer, "Same-shape batch reused");
+    assertNear(2.0, batch[0], 1e-12, "Range gather");
+
+    // Streaming: each step completes one window once the first is full,
+    // and only the last 5 steps are kept
+    WindowDataset stream(3, 1, 1, 5);
+    size_t completed = 0;
+    for (size_t t = 0; t < 12; ++t) {
+      const double value = static_cast<double>(t);
+      completed = stream.append(&value, 1);
+      if (t == 1) {
+        assertEqual(size_t(0), completed, "Window not full yet");
+      }
+    }
+    assertEqual(size_t(1), completed, "One window per step");
+    assertEqual(size_t(5), stream.length(), "History bound");
+    assertEqual(size_t(12), stream.total_steps(), "Steps seen");
+    assertEqual(size_t(3), stream.size(), "Windows in the history");
+    assertEqual(size_t(7), stream[0].start, "Oldest held window");
+    assertVectorNear({9, 10, 11},
+                     std::vector<double>(stream[2].data, stream[2].data + 3),
+                     1e-12, "Newest window");
+
+    std::vector<double> burst(20, 1.0);
+    assertEqual(size_t(3), stream.append(burst.data(), 20),
+                "Only held windows counted");
+    stream.clear();
+    assertTrue(stream.empty(), "Cleared");
+
+    assertThrows<std::invalid_argument>([&]() { WindowDataset(0); },
+                                        "Empty window");
+    assertThrows<std::invalid_argument>([&]() { WindowDataset(8, 1, 1, 4); },
+                                        "History below window");
+    assertThrows<std::invalid_argument>(
+        [&]() { windows.append(NDArray({3, 3})); }, "Wrong feature count");
+    assertThrows<std::invalid_argument>(
+        [&]() { WindowDataset(NDArray({0, 3}), 2); }, "Series without steps");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
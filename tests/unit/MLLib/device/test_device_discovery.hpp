@@ -0,0 +1,233 @@
+/**
+ * @file test_device_discovery.hpp
+ * @brief Unit tests for sysfs/procfs based GPU discovery
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Fake sysfs/procfs tree with one NVIDIA, one AMD and one Intel GPU
+ * and two NUMA nodes with CPUs plus a memory-only node
+ *
+ * Restores real discovery on destruction so later tests are unaffected.
+ */
+class FakeSysfsTree {
+public:
+  FakeSysfsTree() : root_(createTempDirectory()) {
+    write("proc/sys/kernel/random/boot_id", "6f1c2f0e-fake-boot\n");
+    write("proc/meminfo", "MemTotal:       16777216 kB\n");
+    write("proc/driver/nvidia/gpus/0000:01:00.0/information",
+          "Model: \t\t NVIDIA A100-SXM4-40GB\nIRQ:   \t\t 42\n");
+    // nvidia-drm card duplicates the procfs entry and must not add a GPU
+    write("sys/class/drm/card0/device/vendor", "0x10de\n");
+    write("sys/class/drm/card1/device/vendor", "0x1002\n");
+    write("sys/class/drm/card1/device/product_name", "AMD Instinct MI100\n");
+    write("sys/class/drm/card1/device/mem_info_vram_total", "34359738368\n");
+    // Connector nodes are not GPUs
+    write("sys/class/drm/card1-DP-1/device/vendor", "0x1002\n");
+    write("sys/class/drm/card2/device/vendor", "0x8086\n");
+    // Unknown vendors are ignored
+    write("sys/class/drm/card3/device/vendor", "0x1af4\n");
+
+    write("sys/devices/system/node/node0/cpulist", "0-1\n");
+    write("sys/devices/system/node/node0/meminfo",
+          "Node 0 MemTotal:       8388608 kB\n");
+    write("sys/devices/system/node/node1/cpulist", "2-3,6\n");
+    write("sys/devices/system/node/node1/meminfo",
+          "Node 1 MemTotal:       4194304 kB\n");
+    write("sys/devices/system/node/node2/cpulist", "\n");
+    write("sys/devices/system/node/possible", "0-2\n");
+  }
+
+  ~FakeSysfsTree() {
+    Device::setCapabilityCachePath("");
+    Device::setSysfsRoot("");
+    removeTempDirectory(root_);
+  }
+
+  const std::string& root() const { return root_; }
+
+  void write(const std::string& relative, const std::string& content) {
+    std::filesystem::path path = std::filesystem::path(root_) / relative;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path);
+    file << content;
+  }
+
+  void remove(const std::string& relative) {
+    std::filesystem::remove_all(std::filesystem::path(root_) / relative);
+  }
+
+private:
+  std::string root_;
+};
+
+/**
+ * @class DeviceSysfsDiscoveryTest
+ * @brief Test GPU discovery against a fake sysfs root
+ */
+class DeviceSysfsDiscoveryTest : public TestCase {
+public:
+  DeviceSysfsDiscoveryTest() : TestCase("DeviceSysfsDiscoveryTest") {}
+
+protected:
+  void test() override {
+    FakeSysfsTree tree;
+    Device::setSysfsRoot(tree.root());
+    assertEqual(tree.root(), Device::getSysfsRoot(),
+                "Configured sysfs root should be reported");
+
+    auto gpus = Device::detectGPUs();
+    assertEqual(size_t(3), gpus.size(), "Fake tree exposes three GPUs");
+    if (gpus.size() != 3) return;
+
+    assertTrue(gpus[0].vendor == GPUVendor::NVIDIA, "NVIDIA GPU first");
+    assertEqual(std::string("NVIDIA A100-SXM4-40GB"), gpus[0].name,
+                "NVIDIA name comes from procfs information");
+    assertEqual(size_t(0), gpus[0].memory_mb,
+                "NVIDIA VRAM is unknown without nvidia-smi");
+
+    assertTrue(gpus[1].vendor == GPUVendor::AMD, "AMD GPU second");
+    assertEqual(std::string("AMD Instinct MI100"), gpus[1].name,
+                "AMD name comes from product_name");
+    assertEqual(size_t(32768), gpus[1].memory_mb,
+                "AMD VRAM comes from mem_info_vram_total");
+
+    assertTrue(gpus[2].vendor == GPUVendor::INTEL_GPU, "Intel GPU third");
+    assertEqual(size_t(4096), gpus[2].memory_mb,
+                "Intel shared memory is a quarter of MemTotal");
+
+    assertTrue(Device::getPrimaryGPUVendor() == GPUVendor::NVIDIA,
+               "NVIDIA remains the primary vendor");
+    assertTrue(Device::isGPUVendorAvailable(GPUVendor::AMD),
+               "AMD vendor should be available");
+
+    // Results are cached until refreshed
+    tree.remove("sys/class/drm/card1");
+    assertEqual(size_t(3), Device::detectGPUs().size(),
+                "Discovery should run only once");
+    Device::refreshGPUDetection();
+    assertEqual(size_t(2), Device::detectGPUs().size(),
+                "Refresh should probe the tree again");
+  }
+};
+
+/**
+ * @class DeviceDiscoveryConcurrencyTest
+ * @brief Test that concurrent first calls observe one discovery result
+ */
+class DeviceDiscoveryConcurrencyTest : public TestCase {
+public:
+  DeviceDiscoveryConcurrencyTest()
+      : TestCase("DeviceDiscoveryConcurrencyTest") {}
+
+protected:
+  void test() override {
+    FakeSysfsTree tree;
+    Device::setSysfsRoot(tree.root());
+
+    const size_t thread_count = 8;
+    std::vector<size_t> counts(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back(
+          [&counts, t]() { counts[t] = Device::detectGPUs().size(); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t t = 0; t < thread_count; ++t) {
+      assertEqual(size_t(3), counts[t], "Every thread sees the same GPUs");
+    }
+  }
+};
+
+/**
+ * @class DeviceCapabilityCacheTest
+ * @brief Test persisting and reloading discovery results
+ */
+class DeviceCapabilityCacheTest : public TestCase {
+public:
+  DeviceCapabilityCacheTest() : TestCase("DeviceCapabilityCacheTest") {}
+
+protected:
+  void test() override {
+    FakeSysfsTree tree;
+    const std::string cache = tree.root() + "/capabilities.cache";
+    Device::setSysfsRoot(tree.root());
+    Device::setCapabilityCachePath(cache);
+
+    // Cold start probes and writes the cache
+    assertEqual(size_t(3), Device::detectGPUs().size(), "Cold start");
+    assertTrue(fileExists(cache), "Cache file should be written");
+
+    // Warm start uses the cache even though the tree changed
+    tree.remove("sys/class/drm/card2");
+    Device::refreshGPUDetection();
+    auto warm = Device::detectGPUs();
+    assertEqual(size_t(3), warm.size(), "Warm start should use the cache");
+    if (warm.size() == 3) {
+      assertEqual(std::string("AMD Instinct MI100"), warm[1].name,
+                  "Cached name should round-trip");
+      assertEqual(size_t(32768), warm[1].memory_mb,
+                  "Cached memory should round-trip");
+    }
+
+    // A new boot invalidates the cache
+    tree.write("proc/sys/kernel/random/boot_id", "another-boot\n");
+    Device::refreshGPUDetection();
+    assertEqual(size_t(2), Device::detectGPUs().size(),
+                "Stale cache should be ignored after reboot");
+
+    // Malformed caches are rejected
+    tree.write("capabilities.cache", "not a cache\n");
+    assertFalse(Device::loadCapabilityCache(cache),
+                "Malformed cache should be rejected");
+    assertFalse(Device::loadCapabilityCache(tree.root() + "/missing"),
+                "Missing cache should be rejected");
+
+    // Explicit save/load round trip
+    Device::setCapabilityCachePath("");
+    const std::string saved = tree.root() + "/saved.cache";
+    assertTrue(Device::saveCapabilityCache(saved), "Save should succeed");
+    tree.remove("sys/class/drm");
+    assertTrue(Device::loadCapabilityCache(saved), "Load should succeed");
+    assertEqual(size_t(2), Device::detectGPUs().size(),
+                "Loaded cache should replace discovery results");
+
+    // Concurrent writers use distinct temp files and leave none behind
+    const std::string shared = tree.root() + "/shared.cache";
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; ++t) {
+      writers.emplace_back(
+          [&shared]() { Device::saveCapabilityCache(shared); });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    assertTrue(Device::loadCapabilityCache(shared),
+               "Concurrently written cache should load");
+    size_t leftovers = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(tree.root())) {
+      leftovers += entry.path().filename().string().find(".tmp") !=
+          std::string::npos;
+    }
+    assertEqual(size_t(0), leftovers, "No temp files are left behind");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
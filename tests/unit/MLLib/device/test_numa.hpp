@@ -0,0 +1,109 @@
+/**
+ * @file test_numa.hpp
+ * @brief Unit tests for NUMA CPU sub-devices and first-touch allocation
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/device/device.hpp"
+#include "../../../../include/MLLib/ndarray.hpp"
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include "../../../common/test_utils.hpp"
+#include "test_device_discovery.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class NUMATopologyTest
+ * @brief Test NUMA node discovery from a fake sysfs root
+ */
+class NUMATopologyTest : public TestCase {
+public:
+  NUMATopologyTest() : TestCase("NUMATopologyTest") {}
+
+protected:
+  void test() override {
+    FakeSysfsTree tree;
+    Device::setSysfsRoot(tree.root());
+
+    auto nodes = Device::detectNUMANodes();
+    assertEqual(size_t(2), nodes.size(),
+                "Memory-only node should not be a CPU sub-device");
+    if (nodes.size() != 2) return;
+
+    assertEqual(0, nodes[0].id, "First node id");
+    assertVectorEqual(std::vector<int>{0, 1}, nodes[0].cpus,
+                      "Node 0 CPU range");
+    assertEqual(size_t(8192), nodes[0].memory_mb, "Node 0 memory");
+
+    assertEqual(1, nodes[1].id, "Second node id");
+    assertVectorEqual(std::vector<int>{2, 3, 6}, nodes[1].cpus,
+                      "Node 1 CPU list with ranges and singles");
+    assertEqual(size_t(4096), nodes[1].memory_mb, "Node 1 memory");
+
+    // Without NUMA information the whole machine is node 0
+    tree.remove("sys/devices/system/node");
+    Device::refreshGPUDetection();
+    nodes = Device::detectNUMANodes();
+    assertEqual(size_t(1), nodes.size(), "Fallback single node");
+    if (!nodes.empty()) {
+      assertFalse(nodes[0].cpus.empty(), "Fallback node owns every CPU");
+      assertEqual(size_t(16384), nodes[0].memory_mb,
+                  "Fallback memory comes from /proc/meminfo");
+    }
+  }
+};
+
+/**
+ * @class NUMASubDeviceTest
+ * @brief Test CPU sub-device selection, pinned pools and first touch
+ */
+class NUMASubDeviceTest : public TestCase {
+public:
+  NUMASubDeviceTest() : TestCase("NUMASubDeviceTest") {}
+
+protected:
+  void test() override {
+    FakeSysfsTree tree;
+    Device::setSysfsRoot(tree.root());
+
+    assertEqual(-1, Device::getCPUNode(), "No sub-device selected by default");
+    assertThrows<std::invalid_argument>([]() { Device::setCPUNode(7); },
+                                        "Unknown node should be rejected");
+    assertThrows<std::invalid_argument>(
+        []() { Device::getNodeThreadPool(2); },
+        "Memory-only node has no pool");
+
+    // Pool workers are bound to their node
+    util::ThreadPool& pool = Device::getNodeThreadPool(1);
+    assertEqual(size_t(3), pool.size(), "One worker per node CPU");
+    int worker_node = pool.submit([]() { return Device::getCPUNode(); }).get();
+    assertEqual(1, worker_node, "Worker should report its node");
+    assertTrue(&pool == &Device::getNodeThreadPool(1),
+               "Pool is created once per node");
+
+    // Large arrays are first touched by the selected node's workers
+    Device::setCPUNode(1);
+    assertEqual(1, Device::getCPUNode(), "Selected node");
+    NDArray large({256, 256});
+    bool all_zero = true;
+    for (size_t i = 0; i < large.size(); ++i) {
+      all_zero = all_zero && large.data()[i] == 0.0;
+    }
+    assertTrue(all_zero, "First-touch allocation should zero storage");
+
+    large.data()[12345] = 3.5;
+    NDArray copy(large);
+    assertNear(3.5, copy.data()[12345], 1e-12,
+               "First-touch copy should preserve data");
+
+    Device::setCPUNode(-1);
+    assertEqual(-1, Device::getCPUNode(), "Selection cleared");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,148 @@
+/**
+ * @file test_attention.hpp
+ * @brief Unit tests for the MultiHeadAttention layer
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/attention.hpp"
+#include "../../../common/test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class MultiHeadAttentionTest
+ * @brief Compare the blocked kernel with plain attention and check
+ * gradients
+ */
+class MultiHeadAttentionTest : public TestCase {
+public:
+  MultiHeadAttentionTest() : TestCase("MultiHeadAttentionTest") {}
+
+protected:
+  void test() override {
+    using layer::MultiHeadAttention;
+
+    // Blocks of 3 do not divide 7 steps
+    for (bool causal : {false, true}) {
+      const std::string label = causal ? "Causal" : "Full";
+      MultiHeadAttention attention(4, 2, causal, 3);
+      NDArray input = smoothTestInput({2, 7 * 4});
+      NDArray output;
+      attention.infer(input, output);
+      assertVectorNear(reference(attention, input, 2, 7), output.to_vector(),
+                       1e-10, label + " matches plain attention");
+      checkLayerGradients(attention, input, label);
+    }
+
+    // Several blocks per sequence give the same result as one block
+    MultiHeadAttention blocked(8, 4, true, 16);
+    MultiHeadAttention whole(8, 4, true, 1000);
+    auto params = blocked.get_parameters();
+    auto copies = whole.get_parameters();
+    for (size_t p = 0; p < params.size(); ++p) {
+      *copies[p] = *params[p];
+    }
+    NDArray long_input = smoothTestInput({1, 100 * 8});
+    NDArray a;
+    NDArray b;
+    blocked.infer(long_input, a);
+    whole.infer(long_input, b);
+    assertVectorNear(b.to_vector(), a.to_vector(), 1e-10,
+                     "Independent of the block size");
+
+    NDArray three_d({2, 5, 8});
+    three_d.fill(0.3);
+    assertTrue(blocked.forward(three_d).shape() ==
+                   std::vector<size_t>{2, 5, 8},
+               "[batch, steps, features] keeps its shape");
+    assertThrows<std::invalid_argument>(
+        [&]() { blocked.forward(NDArray({2, 12})); }, "Partial step");
+    assertThrows<std::invalid_argument>(
+        [&]() { MultiHeadAttention(6, 4); }, "Heads must divide model_dim");
+    MultiHeadAttention fresh(4, 1);
+    assertThrows<std::runtime_error>(
+        [&]() { fresh.backward(NDArray({1, 4})); }, "Backward first");
+  }
+
+private:
+  /**
+   * @brief Attention with the full score matrix and a plain softmax
+   */
+  static std::vector<double> reference(layer::MultiHeadAttention& attention,
+                                       const NDArray& input, size_t batch,
+                                       size_t steps) {
+    const size_t dim = attention.get_model_dim();
+    const size_t heads = attention.get_heads();
+    const size_t head_dim = dim / heads;
+    const NDArray& wqkv = attention.get_qkv_weights();
+    const NDArray& bqkv = attention.get_qkv_bias();
+    const NDArray& wo = attention.get_output_weights();
+    const NDArray& bo = attention.get_output_bias();
+    const size_t rows = batch * steps;
+
+    std::vector<double> qkv(rows * 3 * dim);
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < 3 * dim; ++c) {
+        double sum = bqkv[c];
+        for (size_t k = 0; k < dim; ++k) {
+          sum += input[r * dim + k] * wqkv[k * 3 * dim + c];
+        }
+        qkv[r * 3 * dim + c] = sum;
+      }
+    }
+
+    std::vector<double> context(rows * dim, 0.0);
+    const double scale = 1.0 / std::sqrt(static_cast<double>(head_dim));
+    for (size_t b = 0; b < batch; ++b) {
+      for (size_t h = 0; h < heads; ++h) {
+        for (size_t i = 0; i < steps; ++i) {
+          const size_t keys = attention.is_causal() ? i + 1 : steps;
+          std::vector<double> scores(keys);
+          for (size_t j = 0; j < keys; ++j) {
+            double s = 0.0;
+            for (size_t k = 0; k < head_dim; ++k) {
+              s += qkv[(b * steps + i) * 3 * dim + h * head_dim + k] *
+                   qkv[(b * steps + j) * 3 * dim + dim + h * head_dim + k];
+            }
+            scores[j] = scale * s;
+          }
+          const double top = *std::max_element(scores.begin(), scores.end());
+          double total = 0.0;
+          for (double& s : scores) {
+            s = std::exp(s - top);
+            total += s;
+          }
+          for (size_t j = 0; j < keys; ++j) {
+            for (size_t k = 0; k < head_dim; ++k) {
+              context[(b * steps + i) * dim + h * head_dim + k] +=
+                  scores[j] / total *
+                  qkv[(b * steps + j) * 3 * dim + 2 * dim + h * head_dim + k];
+            }
+          }
+        }
+      }
+    }
+
+    std::vector<double> output(rows * dim);
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < dim; ++c) {
+        double sum = bo[c];
+        for (size_t k = 0; k < dim; ++k) {
+          sum += context[r * dim + k] * wo[k * dim + c];
+        }
+        output[r * dim + c] = sum;
+      }
+    }
+    return output;
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
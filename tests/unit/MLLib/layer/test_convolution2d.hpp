@@ -0,0 +1,98 @@
+/**
+ * @file test_convolution2d.hpp
+ * @brief Unit tests for Conv2D and ConvTranspose2D layers
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/convolution2d.hpp"
+#include "../../../common/test_utils.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class Conv2DTest
+ * @brief Test convolution output values, shapes and gradients
+ */
+class Conv2DTest : public TestCase {
+public:
+  Conv2DTest() : TestCase("Conv2DTest") {}
+
+protected:
+  void test() override {
+    using layer::Conv2D;
+    using layer::ImageShape;
+
+    // 3x3 image, 2x2 kernel of ones: each output sums a 2x2 window
+    Conv2D sum_conv(ImageShape{1, 3, 3}, 1, 2);
+    NDArray ones({4, 1});
+    ones.fill(1.0);
+    sum_conv.set_weights(ones);
+    NDArray bias({1});
+    bias[0] = 0.5;
+    sum_conv.set_biases(bias);
+    NDArray image({1, 9});
+    for (size_t i = 0; i < 9; ++i) {
+      image[i] = static_cast<double>(i + 1);
+    }
+    assertVectorNear({12.5, 16.5, 24.5, 28.5},
+                     sum_conv.forward(image).to_vector(), 1e-12,
+                     "Window sums");
+
+    Conv2D strided(ImageShape{1, 28, 28}, 16, 3, 2, 1);
+    assertTrue(strided.get_output_shape() == ImageShape{16, 14, 14},
+               "Stride 2 halves the size");
+    assertThrows<std::invalid_argument>(
+        [&]() { strided.forward(NDArray({2, 100})); }, "Partial image");
+    assertThrows<std::invalid_argument>(
+        [&]() { Conv2D(ImageShape{1, 2, 2}, 1, 5); }, "Kernel too large");
+
+    Conv2D conv(ImageShape{2, 5, 4}, 3, 3, 2, 1);
+    checkLayerGradients(
+        conv, smoothTestInput({2, conv.get_input_shape().size()}), "Conv2D");
+  }
+};
+
+/**
+ * @class ConvTranspose2DTest
+ * @brief Test transposed convolution shapes, values and gradients
+ */
+class ConvTranspose2DTest : public TestCase {
+public:
+  ConvTranspose2DTest() : TestCase("ConvTranspose2DTest") {}
+
+protected:
+  void test() override {
+    using layer::ConvTranspose2D;
+    using layer::ImageShape;
+
+    // One pixel spreads the kernel over the output
+    ConvTranspose2D spread(ImageShape{1, 1, 1}, 1, 2);
+    NDArray kernel({1, 4});
+    for (size_t i = 0; i < 4; ++i) {
+      kernel[i] = static_cast<double>(i + 1);
+    }
+    spread.set_weights(kernel);
+    NDArray pixel({1, 1});
+    pixel[0] = 2.0;
+    assertVectorNear({2.0, 4.0, 6.0, 8.0}, spread.forward(pixel).to_vector(),
+                     1e-12, "Scaled kernel");
+
+    ConvTranspose2D upsample(ImageShape{16, 14, 14}, 1, 3, 2, 1, 1);
+    assertTrue(upsample.get_output_shape() == ImageShape{1, 28, 28},
+               "Stride 2 doubles the size");
+    assertThrows<std::invalid_argument>(
+        [&]() { ConvTranspose2D(ImageShape{1, 4, 4}, 1, 3, 2, 1, 2); },
+        "Output padding must be below stride");
+
+    ConvTranspose2D transpose(ImageShape{3, 3, 2}, 2, 3, 2, 1, 1);
+    NDArray pixels = smoothTestInput({2, transpose.get_input_shape().size()});
+    checkLayerGradients(transpose, pixels, "ConvTranspose2D");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,161 @@
+/**
+ * @file test_pruning.hpp
+ * @brief Unit tests for weight pruning and block sparse Dense inference
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/activation/relu.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/layer/pruning.hpp"
+#include "../../../../include/MLLib/model/sequential.hpp"
+#include "../../../../include/MLLib/sparse.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class PruningTest
+ * @brief Test magnitude, N:M and block pruning of Dense weights
+ */
+class PruningTest : public TestCase {
+public:
+  PruningTest() : TestCase("PruningTest") {}
+
+protected:
+  void test() override {
+    using namespace MLLib::layer;
+
+    Dense magnitude(10, 6);
+    const NDArray original = magnitude.get_weights();
+    assertNear(0.75, prune_magnitude(magnitude, 0.75), 1e-12,
+               "Magnitude sparsity");
+    // Every kept weight is at least as large as every pruned one
+    double largest_pruned = 0.0;
+    double smallest_kept = 1e9;
+    for (size_t i = 0; i < original.size(); ++i) {
+      const double w = magnitude.get_weights()[i];
+      if (w == 0.0) {
+        largest_pruned = std::max(largest_pruned, std::abs(original[i]));
+      } else {
+        assertNear(original[i], w, 0.0, "Kept weights are unchanged");
+        smallest_kept = std::min(smallest_kept, std::abs(w));
+      }
+    }
+    assertTrue(largest_pruned <= smallest_kept, "Smallest weights pruned");
+
+    // 2:4 along the inputs, with a trailing group of two
+    Dense n_m(10, 3);
+    assertNear(0.4, prune_n_m(n_m, 2, 4), 1e-12, "2:4 sparsity");
+    const NDArray& w = n_m.get_weights();
+    bool pattern = true;
+    for (size_t col = 0; col < 3; ++col) {
+      for (size_t start = 0; start < 8; start += 4) {
+        size_t kept = 0;
+        for (size_t k = 0; k < 4; ++k) {
+          kept += w[(start + k) * 3 + col] != 0.0;
+        }
+        pattern &= kept == 2;
+      }
+    }
+    assertTrue(pattern, "Two of every four inputs kept");
+
+    Dense blocks(9, 8);
+    prune_blocks(blocks, 3, 4, 0.5);
+    BlockSparseMatrix bsr =
+        BlockSparseMatrix::from_dense(blocks.get_weights(), 3, 4);
+    assertEqual(size_t(3), bsr.num_blocks(), "Half the blocks remain");
+    assertNear(0.5, weight_sparsity(blocks), 1e-12, "Block sparsity");
+
+    assertThrows<std::invalid_argument>(
+        [&]() { prune_magnitude(magnitude, 1.5); }, "Sparsity above 1");
+    assertThrows<std::invalid_argument>([&]() { prune_n_m(n_m, 3, 2); },
+                                        "n greater than m");
+    assertThrows<std::invalid_argument>(
+        [&]() { prune_blocks(blocks, 0, 4, 0.5); }, "Empty block");
+  }
+};
+
+/**
+ * @class BlockSparseDenseTest
+ * @brief Test BSR products and compressed Dense inference and storage
+ */
+class BlockSparseDenseTest : public TestCase {
+public:
+  BlockSparseDenseTest() : TestCase("BlockSparseDenseTest") {}
+
+protected:
+  void test() override {
+    // Sizes that are not multiples of the block size
+    NDArray dense({7, 10});
+    for (size_t i = 0; i < dense.size(); ++i) {
+      dense[i] = (i / 10) % 3 == 1 || (i % 10) >= 8
+                     ? 0.0
+                     : 0.05 * static_cast<double>(i % 13) - 0.3;
+    }
+    BlockSparseMatrix bsr = BlockSparseMatrix::from_dense(dense, 2, 4);
+    assertVectorNear(dense.to_vector(), bsr.to_dense().to_vector(), 0.0,
+                     "Dense round trip");
+    assertTrue(bsr.density() < 1.0, "Zero blocks are dropped");
+
+    NDArray input({5, 7});
+    for (size_t i = 0; i < input.size(); ++i) {
+      input[i] = 0.1 * static_cast<double>(i % 9) - 0.4;
+    }
+    NDArray product;
+    bsr.left_multiply(input, product);
+    assertVectorNear(input.matmul(dense).to_vector(), product.to_vector(),
+                     1e-12, "Block sparse product");
+    assertThrows<std::invalid_argument>(
+        [&]() { bsr.left_multiply(NDArray({5, 6}), product); },
+        "Inner dimension mismatch");
+    assertThrows<std::invalid_argument>(
+        [&]() { BlockSparseMatrix(4, 4, 2, 2, {0, 1}, {0}, {1, 2, 3, 4}); },
+        "Wrong number of block rows");
+
+    // Compressed inference matches the dense layer
+    auto first = std::make_shared<layer::Dense>(12, 9);
+    auto second = std::make_shared<layer::Dense>(9, 3);
+    layer::prune_blocks(*first, 4, 3, 0.6);
+    model::Sequential model;
+    model.add(first);
+    model.add(std::make_shared<layer::activation::ReLU>());
+    model.add(second);
+
+    NDArray x({4, 12});
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = 0.07 * static_cast<double>(i % 11) - 0.35;
+    }
+    NDArray expected = model.predict(x);
+    const size_t dense_bytes = model.serialize().at("layer_0").size();
+
+    first->compress_weights(4, 3);
+    assertTrue(first->has_compressed_weights(), "Compressed");
+    assertVectorNear(expected.to_vector(), model.predict(x).to_vector(),
+                     1e-12, "Compressed inference");
+
+    // Only the stored blocks are saved and the layer reloads compressed
+    auto data = model.serialize();
+    assertTrue(data.at("layer_0").size() < dense_bytes, "Smaller blob");
+    model::Sequential loaded;
+    assertTrue(loaded.deserialize(data), "Deserialize");
+    auto* reloaded =
+        dynamic_cast<layer::Dense*>(loaded.get_layers()[0].get());
+    assertTrue(reloaded && reloaded->has_compressed_weights(),
+               "Reloaded compressed");
+    assertVectorNear(expected.to_vector(), loaded.predict(x).to_vector(),
+                     1e-12, "Reloaded inference");
+
+    // Training works on the dense weights again
+    first->get_parameters();
+    assertTrue(!first->has_compressed_weights(), "Dropped for training");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,140 @@
+/**
+ * @file test_recurrent.hpp
+ * @brief Unit tests for LSTM, GRU, RepeatVector and TimeDistributed layers
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/layer/recurrent.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class LSTMTest
+ * @brief Test LSTM shapes, values, gradients and truncated BPTT
+ */
+class LSTMTest : public TestCase {
+public:
+  LSTMTest() : TestCase("LSTMTest") {}
+
+protected:
+  void test() override {
+    using layer::LSTM;
+
+    // Zero weights: c = sigmoid(0) * tanh(0) = 0 keeps the state at zero
+    LSTM idle(2, 3);
+    idle.set_input_weights(zeros({2, 12}));
+    idle.set_recurrent_weights(zeros({3, 12}));
+    NDArray sequence({2, 4 * 2});
+    sequence.fill(1.0);
+    NDArray last = idle.forward(sequence);
+    assertTrue(last.shape() == std::vector<size_t>{2, 3}, "Last state shape");
+    assertVectorNear(std::vector<double>(6, 0.0), last.to_vector(), 1e-12,
+                     "Zero state");
+
+    LSTM full(2, 3, true);
+    assertEqual(size_t(12), full.forward(sequence).shape()[1],
+                "Every step returned");
+    NDArray three_d({2, 4, 2});
+    three_d.fill(1.0);
+    assertTrue(full.forward(three_d).shape() ==
+                   std::vector<size_t>{2, 4, 3},
+               "[batch, steps, features] keeps its rank");
+    assertThrows<std::invalid_argument>(
+        [&]() { full.forward(NDArray({2, 7})); }, "Partial step");
+    assertThrows<std::invalid_argument>([&]() { LSTM(0, 3); }, "No input");
+
+    LSTM last_only(3, 4);
+    checkLayerGradients(last_only, smoothTestInput({2, 5 * 3}), "Last output");
+    LSTM sequences(3, 4, true);
+    checkLayerGradients(sequences, smoothTestInput({2, 5 * 3}),
+                        "Sequence output");
+
+    // Only the last two steps receive a gradient
+    LSTM truncated(1, 3, false, 2);
+    NDArray series({1, 6});
+    for (size_t i = 0; i < 6; ++i) {
+      series[i] = 0.2 * static_cast<double>(i);
+    }
+    truncated.forward(series);
+    NDArray ones({1, 3});
+    ones.fill(1.0);
+    NDArray grad = truncated.backward(ones);
+    assertVectorNear(std::vector<double>(4, 0.0),
+                     std::vector<double>(grad.data(), grad.data() + 4), 1e-12,
+                     "Steps beyond the window");
+    assertTrue(std::abs(grad[4]) > 0.0 && std::abs(grad[5]) > 0.0,
+               "Steps inside the window");
+  }
+
+private:
+  static NDArray zeros(const std::vector<size_t>& shape) {
+    NDArray array(shape);
+    array.fill(0.0);
+    return array;
+  }
+};
+
+/**
+ * @class GRUTest
+ * @brief Test GRU shapes, gradients, RepeatVector and TimeDistributed
+ */
+class GRUTest : public TestCase {
+public:
+  GRUTest() : TestCase("GRUTest") {}
+
+protected:
+  void test() override {
+    using layer::GRU;
+
+    GRU last_only(2, 3);
+    NDArray sequence({3, 4 * 2});
+    sequence.fill(0.5);
+    assertTrue(last_only.forward(sequence).shape() ==
+                   std::vector<size_t>{3, 3},
+               "Last state shape");
+    checkLayerGradients(last_only, smoothTestInput({2, 4 * 2}), "Last output");
+    GRU sequences(2, 3, true);
+    checkLayerGradients(sequences, smoothTestInput({2, 4 * 2}),
+                        "Sequence output");
+
+    // RepeatVector copies each row, backward sums the copies
+    layer::RepeatVector repeat(3);
+    NDArray code({2, 2});
+    for (size_t i = 0; i < 4; ++i) {
+      code[i] = static_cast<double>(i + 1);
+    }
+    assertVectorNear({1, 2, 1, 2, 1, 2, 3, 4, 3, 4, 3, 4},
+                     repeat.forward(code).to_vector(), 1e-12, "Repeated");
+    NDArray grad({2, 6});
+    for (size_t i = 0; i < 12; ++i) {
+      grad[i] = static_cast<double>(i);
+    }
+    assertVectorNear({6, 9, 24, 27}, repeat.backward(grad).to_vector(), 1e-12,
+                     "Summed gradient");
+
+    // The wrapped layer runs on every step and keeps its parameters
+    auto dense = std::make_shared<layer::Dense>(3, 2);
+    layer::TimeDistributed per_step(dense, 3);
+    assertEqual(size_t(2), per_step.get_parameters().size(),
+                "Dense parameters exposed");
+    NDArray hidden({2, 4 * 3});
+    hidden.fill(0.1);
+    assertEqual(size_t(8), per_step.forward(hidden).shape()[1],
+                "Two outputs per step");
+    checkLayerGradients(per_step, smoothTestInput({2, 4 * 3}),
+                        "TimeDistributed");
+    assertThrows<std::invalid_argument>(
+        [&]() { layer::TimeDistributed(nullptr, 3); }, "No layer");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,116 @@
+/**
+ * @file test_conv_autoencoder.hpp
+ * @brief Unit tests for the convolutional autoencoder
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/convolutional.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/denoising.hpp"
+#include "../../../../../include/MLLib/model/model_io.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class ConvAutoencoderTest
+ * @brief Test ConvAutoencoder shapes, size, training and model I/O
+ */
+class ConvAutoencoderTest : public TestCase {
+public:
+  ConvAutoencoderTest() : TestCase("ConvAutoencoderTest") {}
+
+protected:
+  void test() override {
+    using namespace MLLib::model::autoencoder;
+    util::Random::seed(5);
+
+    // 8x8 -> 4x4x4 -> 2x2x8 -> 16
+    ConvAutoencoderConfig config;
+    config.image = {1, 8, 8};
+    config.filters = {4, 8};
+    config.latent_dim = 16;
+    ConvAutoencoder autoencoder(config);
+    assertEqual(64, autoencoder.get_input_dim(), "Flat input size");
+    assertEqual(16, autoencoder.get_latent_dim(), "Latent size");
+
+    // Stripes of either orientation
+    std::vector<NDArray> data;
+    for (size_t i = 0; i < 16; ++i) {
+      NDArray image({1, 64});
+      for (size_t p = 0; p < 64; ++p) {
+        const size_t line = i % 2 ? p / 8 : p % 8;
+        image[p] = (line + i / 2) % 3 == 0 ? 0.9 : 0.1;
+      }
+      data.push_back(image);
+    }
+    NDArray batch({16, 64});
+    for (size_t i = 0; i < 16; ++i) {
+      std::copy(data[i].data(), data[i].data() + 64, batch.data() + i * 64);
+    }
+    assertEqual(size_t(16), autoencoder.encode(batch).shape()[0],
+                "Batch encode");
+    assertEqual(size_t(64), autoencoder.reconstruct(batch).shape()[1],
+                "Reconstruction keeps the image size");
+
+    loss::MSELoss mse;
+    optimizer::Adam adam(0.01);
+    std::vector<double> losses;
+    autoencoder.train(data, mse, adam, 40, 4, nullptr,
+                [&](int, double l, double) { losses.push_back(l); });
+    assertTrue(losses.back() < 0.5 * losses.front(), "Loss falls");
+
+    // Round trip through a saved file
+    std::string temp_dir = createTempDirectory();
+    std::string path = temp_dir + "/conv_autoencoder";
+    assertTrue(model::GenericModelIO::save_model(autoencoder, path,
+                                                 model::SaveFormat::BINARY),
+               "Save");
+    auto loaded = model::GenericModelIO::load_model<ConvAutoencoder>(
+        path, model::SaveFormat::BINARY);
+    assertTrue(loaded != nullptr, "Load");
+    if (loaded) {
+      assertEqual(size_t(2), loaded->get_conv_config().filters.size(),
+                  "Architecture restored");
+      assertVectorNear(autoencoder.reconstruct(batch).to_vector(),
+                       loaded->reconstruct(batch).to_vector(), 1e-12,
+                       "Same reconstruction");
+    }
+    removeTempDirectory(temp_dir);
+
+    // Far smaller than the Dense image factory
+    auto conv = ConvAutoencoder::create_for_images(28, 28, 1, 64);
+    auto dense = DenoisingAutoencoder::create_for_images(28, 28, 1, 64);
+    assertTrue(3 * countParameters(*conv) < countParameters(*dense),
+               "Fewer parameters");
+
+    config.filters = {};
+    assertThrows<std::invalid_argument>([&]() { ConvAutoencoder{config}; },
+                                        "No stages");
+  }
+
+private:
+  static size_t countParameters(
+      const model::autoencoder::BaseAutoencoder& autoencoder) {
+    size_t count = 0;
+    const model::Sequential* networks[] = {&autoencoder.get_encoder(),
+                                           &autoencoder.get_decoder()};
+    for (const model::Sequential* network : networks) {
+      for (const auto& layer : network->get_layers()) {
+        for (const NDArray* param : layer->get_parameters()) {
+          count += param->size();
+        }
+      }
+    }
+    return count;
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
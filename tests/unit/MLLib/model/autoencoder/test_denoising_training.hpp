@@ -0,0 +1,69 @@
+/**
+ * @file test_denoising_training.hpp
+ * @brief Unit tests for mini-batch denoising autoencoder training
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/denoising.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class DenoisingBatchTrainingTest
+ * @brief Test that corrupted mini-batch training learns every noise type
+ */
+class DenoisingBatchTrainingTest : public TestCase {
+public:
+  DenoisingBatchTrainingTest() : TestCase("DenoisingBatchTrainingTest") {}
+
+protected:
+  void test() override {
+    std::vector<NDArray> data;
+    for (int i = 0; i < 24; ++i) {
+      NDArray sample({1, 8});
+      for (int j = 0; j < 8; ++j) {
+        sample.data()[j] = (j % 2 == i % 2) ? 0.9 : 0.1;
+      }
+      data.push_back(sample);
+    }
+    loss::MSELoss mse;
+
+    const model::autoencoder::NoiseType types[] = {
+        model::autoencoder::NoiseType::GAUSSIAN,
+        model::autoencoder::NoiseType::SALT_PEPPER,
+        model::autoencoder::NoiseType::DROPOUT,
+        model::autoencoder::NoiseType::UNIFORM};
+    for (auto type : types) {
+      util::Random::seed(21);
+      model::autoencoder::DenoisingAutoencoder model(8, 2, {6}, 0.1, type);
+      optimizer::Adam adam(0.02);
+      std::vector<double> losses;
+      model.train(data, mse, adam, 60, 8, nullptr,
+                  [&](int, double train_loss, double) {
+                    losses.push_back(train_loss);
+                  });
+      assertEqual(size_t(60), losses.size(), "One callback per epoch");
+      assertTrue(losses.back() < 0.5 * losses.front(),
+                 "Training loss falls with corrupted inputs");
+    }
+
+    // The last batch may be smaller than the others
+    util::Random::seed(22);
+    model::autoencoder::DenoisingAutoencoder model(8, 2, {6});
+    optimizer::Adam adam(0.01);
+    double validation = -1.0;
+    model.train(data, mse, adam, 2, 5, &data,
+                [&](int, double, double val_loss) { validation = val_loss; });
+    assertTrue(validation > 0.0, "Validation loss reported");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,99 @@
+/**
+ * @file test_lstm_autoencoder.hpp
+ * @brief Unit tests for the LSTM autoencoder
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/recurrent.hpp"
+#include "../../../../../include/MLLib/model/model_io.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class LSTMAutoencoderTest
+ * @brief Test LSTMAutoencoder shapes, training and model I/O
+ */
+class LSTMAutoencoderTest : public TestCase {
+public:
+  LSTMAutoencoderTest() : TestCase("LSTMAutoencoderTest") {}
+
+protected:
+  void test() override {
+    using namespace MLLib::model::autoencoder;
+    util::Random::seed(7);
+
+    // Windows of 8 steps with 2 features, squeezed into 4 values
+    LSTMAutoencoderConfig config;
+    config.steps = 8;
+    config.features = 2;
+    config.hidden_size = 12;
+    config.latent_dim = 4;
+    LSTMAutoencoder autoencoder(config);
+    assertEqual(16, autoencoder.get_input_dim(), "Flat window size");
+    assertEqual(4, autoencoder.get_latent_dim(), "Latent size");
+    assertTrue(autoencoder.get_type() == AutoencoderType::RECURRENT, "Type");
+
+    // Sine and cosine windows at different phases
+    std::vector<NDArray> data;
+    NDArray batch({12, 16});
+    for (size_t i = 0; i < 12; ++i) {
+      NDArray window({1, 16});
+      for (size_t t = 0; t < 8; ++t) {
+        const double angle = 0.5 * static_cast<double>(i + t);
+        window[2 * t] = std::sin(angle);
+        window[2 * t + 1] = std::cos(angle);
+      }
+      std::copy(window.data(), window.data() + 16, batch.data() + i * 16);
+      data.push_back(window);
+    }
+    assertEqual(size_t(4), autoencoder.encode(batch).shape()[1],
+                "Batch encode");
+    assertEqual(size_t(16), autoencoder.reconstruct(batch).shape()[1],
+                "Reconstruction keeps the window size");
+
+    loss::MSELoss mse;
+    optimizer::Adam adam(0.01);
+    std::vector<double> losses;
+    autoencoder.train(data, mse, adam, 60, 4, nullptr,
+                      [&](int, double l, double) { losses.push_back(l); });
+    assertTrue(losses.back() < 0.5 * losses.front(), "Loss falls");
+
+    // Round trip through a saved file
+    std::string temp_dir = createTempDirectory();
+    std::string path = temp_dir + "/lstm_autoencoder";
+    assertTrue(model::GenericModelIO::save_model(autoencoder, path,
+                                                 model::SaveFormat::BINARY),
+               "Save");
+    auto loaded = model::GenericModelIO::load_model<LSTMAutoencoder>(
+        path, model::SaveFormat::BINARY);
+    assertTrue(loaded != nullptr, "Load");
+    if (loaded) {
+      assertEqual(size_t(12), loaded->get_lstm_config().hidden_size,
+                  "Architecture restored");
+      assertVectorNear(autoencoder.reconstruct(batch).to_vector(),
+                       loaded->reconstruct(batch).to_vector(), 1e-12,
+                       "Same reconstruction");
+    }
+    removeTempDirectory(temp_dir);
+
+    // Without a bottleneck the last hidden state is the code
+    LSTMAutoencoder hidden_code(8, 2, 6);
+    assertEqual(6, hidden_code.get_latent_dim(), "Hidden state code");
+
+    config.hidden_size = 0;
+    assertThrows<std::invalid_argument>([&]() { LSTMAutoencoder{config}; },
+                                        "No hidden units");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
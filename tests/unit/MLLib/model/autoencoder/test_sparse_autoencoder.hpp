@@ -0,0 +1,213 @@
+/**
+ * @file test_sparse_autoencoder.hpp
+ * @brief Unit tests for the sparse autoencoder
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/sparse.hpp"
+#include "../../../../../include/MLLib/model/model_io.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Copy rows [begin, end) of a 2-D array
+ */
+inline NDArray codeRows(const NDArray& array, size_t begin, size_t end) {
+  const size_t width = array.shape()[1];
+  NDArray rows({end - begin, width});
+  std::copy(array.data() + begin * width, array.data() + end * width,
+            rows.data());
+  return rows;
+}
+
+/**
+ * @class SparseLatentGradientTest
+ * @brief Test the fused penalty gradient against finite differences
+ */
+class SparseLatentGradientTest : public TestCase {
+public:
+  SparseLatentGradientTest() : TestCase("SparseLatentGradientTest") {}
+
+protected:
+  void test() override {
+    using model::autoencoder::SparseLatent;
+    using model::autoencoder::SparsityType;
+
+    NDArray input({3, 4});
+    NDArray weights({3, 4});
+    for (size_t i = 0; i < input.size(); ++i) {
+      // Distinct values away from the ReLU kink
+      input[i] = 0.3 * std::sin(1.7 * i + 0.4) + (i % 3 == 0 ? -0.5 : 0.4);
+      weights[i] = std::cos(0.9 * i);
+    }
+
+    SparseLatent kl(SparsityType::KL_DIVERGENCE, 0.7, 0.2);
+    SparseLatent l1(SparsityType::L1, 0.7, 0.2);
+    SparseLatent top2(SparsityType::KL_DIVERGENCE, 0.7, 0.2, 2);
+    checkGradients(kl, input, weights, "KL");
+    checkGradients(l1, input, weights, "L1");
+    checkGradients(top2, input, weights, "Top-k");
+
+    NDArray codes = top2.forward(input);
+    for (size_t r = 0; r < 3; ++r) {
+      size_t active = 0;
+      for (size_t j = 0; j < 4; ++j) {
+        active += codes[r * 4 + j] != 0.0;
+      }
+      assertEqual(size_t(2), active, "Two units kept per row");
+    }
+  }
+
+private:
+  /**
+   * @brief Check d(sum(weights * codes) + penalty)/d(input)
+   */
+  void checkGradients(model::autoencoder::SparseLatent& layer,
+                      const NDArray& input, const NDArray& weights,
+                      const std::string& label) {
+    auto objective = [&](const NDArray& x) {
+      layer.reset_penalty();
+      NDArray codes = layer.forward(x);
+      double value = layer.get_penalty();
+      for (size_t i = 0; i < codes.size(); ++i) {
+        value += weights[i] * codes[i];
+      }
+      return value;
+    };
+
+    objective(input);
+    NDArray analytic = layer.backward(weights);
+
+    const double h = 1e-6;
+    std::vector<double> numeric(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+      NDArray plus = input;
+      NDArray minus = input;
+      plus[i] += h;
+      minus[i] -= h;
+      numeric[i] = (objective(plus) - objective(minus)) / (2.0 * h);
+    }
+    assertVectorNear(numeric, analytic.to_vector(), 1e-6,
+                     label + " penalty gradient");
+  }
+};
+
+/**
+ * @class SparseAutoencoderTest
+ * @brief Test sparse training, top-k decoding and model I/O
+ */
+class SparseAutoencoderTest : public TestCase {
+public:
+  SparseAutoencoderTest() : TestCase("SparseAutoencoderTest") {}
+
+protected:
+  void test() override {
+    using namespace MLLib::model::autoencoder;
+    util::Random::seed(11);
+
+    std::vector<NDArray> data;
+    NDArray batch({12, 16});
+    for (size_t i = 0; i < 12; ++i) {
+      NDArray sample({1, 16});
+      for (size_t j = 0; j < 16; ++j) {
+        sample[j] = (j + i) % 4 == 0 ? 0.9 : 0.1;
+        batch[i * 16 + j] = sample[j];
+      }
+      data.push_back(sample);
+    }
+
+    // KL training pulls the mean activation down to the target rate
+    AutoencoderConfig config = AutoencoderConfig::basic(16, 12, {10});
+    config.sparsity_penalty = 1.0;
+    SparseConfig sparse_config;
+    sparse_config.target_rate = 0.1;
+    SparseAutoencoder autoencoder(config, sparse_config);
+    assertTrue(autoencoder.get_type() == AutoencoderType::SPARSE, "Type");
+
+    const double initial_rate = autoencoder.mean_activation(batch);
+    loss::MSELoss mse;
+    optimizer::Adam adam(0.01);
+    std::vector<double> losses;
+    autoencoder.train(data, mse, adam, 60, 4, nullptr,
+                      [&](int, double l, double) { losses.push_back(l); });
+    assertTrue(losses.back() < losses.front(), "Loss with penalty falls");
+    assertTrue(autoencoder.mean_activation(batch) < 0.5 * initial_rate,
+               "Activations become sparse");
+
+    // Top-k codes decode through the CSR path like dense codes
+    SparseAutoencoder l1(16, 12, {10}, 0.01, SparsityType::L1);
+    sparse_config.type = SparsityType::L1;
+    sparse_config.top_k = 3;
+    config.sparsity_penalty = 0.01;
+    SparseAutoencoder k_sparse(config, sparse_config);
+    NDArray codes = k_sparse.encode(batch);
+    size_t active = 0;
+    for (size_t i = 0; i < codes.size(); ++i) {
+      active += codes[i] != 0.0;
+    }
+    assertTrue(active <= 12 * 3, "At most top_k units per code");
+    assertVectorNear(k_sparse.get_decoder().predict(codes).to_vector(),
+                     k_sparse.decode(codes).to_vector(), 1e-12,
+                     "Sparse decode matches the dense decoder");
+    assertEqual(size_t(12), l1.reconstruct(data).size(),
+                "Batched reconstruction");
+
+    // The batched overload decodes the stacked set in one pass
+    std::vector<NDArray> code_set = {codeRows(codes, 0, 5),
+                                     codeRows(codes, 5, 12)};
+    std::vector<NDArray> decoded = k_sparse.decode(code_set);
+    NDArray whole = k_sparse.decode(codes);
+    assertEqual(size_t(2), decoded.size(), "One output per code set");
+    assertVectorNear(codeRows(whole, 0, 5).to_vector(),
+                     decoded[0].to_vector(), 1e-12, "First set's rows");
+    assertVectorNear(codeRows(whole, 5, 12).to_vector(),
+                     decoded[1].to_vector(), 1e-12, "Second set's rows");
+    assertTrue(decoded[1].shape() == std::vector<size_t>({7, 16}),
+               "Rows split back per code set");
+
+    // Round trip through a saved file
+    std::string temp_dir = createTempDirectory();
+    std::string path = temp_dir + "/sparse_autoencoder";
+    assertTrue(model::GenericModelIO::save_model(k_sparse, path,
+                                                 model::SaveFormat::BINARY),
+               "Save");
+    auto loaded = model::GenericModelIO::load_model<SparseAutoencoder>(
+        path, model::SaveFormat::BINARY);
+    assertTrue(loaded != nullptr, "Load");
+    if (loaded) {
+      assertEqual(size_t(3), loaded->get_sparse_config().top_k,
+                  "Sparse configuration restored");
+      assertVectorNear(k_sparse.reconstruct(batch).to_vector(),
+                       loaded->reconstruct(batch).to_vector(), 1e-12,
+                       "Same reconstruction");
+    }
+
+    // An unknown sparsity type is rejected instead of cast into the enum
+    auto serialized = k_sparse.serialize();
+    serialized["sparse_type"] = {7};
+    SparseAutoencoder corrupt(config, sparse_config);
+    assertFalse(corrupt.deserialize(serialized), "Unknown sparsity type");
+    removeTempDirectory(temp_dir);
+
+    sparse_config.top_k = 13;
+    assertThrows<std::invalid_argument>(
+        [&]() { SparseAutoencoder{config, sparse_config}; }, "top_k too big");
+    sparse_config = SparseConfig();
+    sparse_config.target_rate = 1.0;
+    assertThrows<std::invalid_argument>(
+        [&]() { SparseAutoencoder{config, sparse_config}; }, "Bad target");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,130 @@
+/**
+ * @file test_vae_batched.hpp
+ * @brief Unit tests for batched VAE sampling, KL and training
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/variational.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/optimizer/sgd.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <cmath>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class VAEReparameterizationTest
+ * @brief Test closed-form KL and batched reparameterized sampling
+ */
+class VAEReparameterizationTest : public TestCase {
+public:
+  VAEReparameterizationTest() : TestCase("VAEReparameterizationTest") {}
+
+protected:
+  void test() override {
+    util::Random::seed(11);
+    model::autoencoder::VariationalAutoencoder vae(6, 3, {5});
+    loss::MSELoss mse;
+
+    // Zero reconstruction error isolates the KL term
+    NDArray input({2, 6});
+    NDArray mean({2, 3});
+    NDArray log_var({2, 3});
+    assertNear(0.0, vae.calculate_vae_loss(input, input, mean, log_var, mse),
+               1e-12, "KL of the prior is zero");
+    mean.fill(1.0);
+    log_var.fill(std::log(2.0));
+    // Per element: -0.5 * (1 + ln 2 - 1 - 2) = 1 - ln(2) / 2; three per row
+    assertNear(3.0 * (1.0 - 0.5 * std::log(2.0)),
+               vae.calculate_vae_loss(input, input, mean, log_var, mse), 1e-12,
+               "Closed-form KL averaged over rows");
+
+    // (sample - mean) / std must be standard normal over a large batch
+    const size_t rows = 4000;
+    NDArray batch({rows, 6});
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i] = 0.1 * static_cast<double>(i % 7);
+    }
+    auto output = vae.encode_variational(batch);
+    assertEqual(rows, output.sample.shape()[0], "One sample per row");
+    double sum = 0.0;
+    double squares = 0.0;
+    for (size_t i = 0; i < output.sample.size(); ++i) {
+      double z = (output.sample[i] - output.mean[i]) /
+                 std::exp(0.5 * output.log_var[i]);
+      sum += z;
+      squares += z * z;
+    }
+    double n = static_cast<double>(output.sample.size());
+    assertNear(0.0, sum / n, 0.05, "Noise mean");
+    assertNear(1.0, squares / n, 0.05, "Noise variance");
+    assertVectorNear(output.mean.to_vector(), vae.encode(batch).to_vector(),
+                     1e-12, "encode returns the latent mean");
+  }
+};
+
+/**
+ * @class VAEBatchedTrainingTest
+ * @brief Test that mini-batch training lowers reconstruction and KL
+ */
+class VAEBatchedTrainingTest : public TestCase {
+public:
+  VAEBatchedTrainingTest() : TestCase("VAEBatchedTrainingTest") {}
+
+protected:
+  void test() override {
+    std::vector<NDArray> data;
+    for (int i = 0; i < 32; ++i) {
+      NDArray sample({1, 8});
+      for (int j = 0; j < 8; ++j) {
+        sample.data()[j] = (j % 2 == i % 2) ? 1.0 : 0.0;
+      }
+      data.push_back(sample);
+    }
+    loss::MSELoss mse;
+
+    // Deterministic latent: full-batch gradient descent on recon + KL must
+    // decrease the objective every step
+    {
+      util::Random::seed(5);
+      model::autoencoder::VAEConfig config;
+      config.reparameterize = false;
+      model::autoencoder::VariationalAutoencoder vae(
+          model::autoencoder::AutoencoderConfig::basic(8, 2, {6}), config);
+      optimizer::SGD sgd(0.05);
+      std::vector<double> objective;
+      vae.train(data, mse, sgd, 20, 32, nullptr,
+                [&](int, double recon, double kl) {
+                  objective.push_back(recon + kl);
+                });
+      assertEqual(size_t(20), objective.size(), "One callback per epoch");
+      bool decreasing = true;
+      for (size_t i = 1; i < objective.size(); ++i) {
+        decreasing = decreasing && objective[i] < objective[i - 1];
+      }
+      assertTrue(decreasing, "Gradients of both heads descend the objective");
+    }
+
+    // Sampled latent with mini-batches still learns the patterns
+    {
+      util::Random::seed(6);
+      model::autoencoder::VariationalAutoencoder vae(8, 2, {6}, 0.01);
+      optimizer::Adam adam(0.02);
+      std::vector<double> recon_losses;
+      vae.train(data, mse, adam, 150, 8, nullptr,
+                [&](int, double recon, double) {
+                  recon_losses.push_back(recon);
+                });
+      assertTrue(recon_losses.back() < 0.5 * recon_losses.front(),
+                 "Reconstruction loss falls during training");
+    }
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
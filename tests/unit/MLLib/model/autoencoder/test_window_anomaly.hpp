@@ -0,0 +1,90 @@
+/**
+ * @file test_window_anomaly.hpp
+ * @brief Unit tests for anomaly detection on windowed series
+ */
+
+#pragma once
+
+#include "../../../../../include/MLLib/data/window.hpp"
+#include "../../../../../include/MLLib/loss/mse.hpp"
+#include "../../../../../include/MLLib/model/autoencoder/anomaly_detector.hpp"
+#include "../../../../../include/MLLib/optimizer/adam.hpp"
+#include "../../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../../common/test_utils.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class WindowAnomalyDetectionTest
+ * @brief Test training, thresholds and online scoring on series windows
+ */
+class WindowAnomalyDetectionTest : public TestCase {
+public:
+  WindowAnomalyDetectionTest() : TestCase("WindowAnomalyDetectionTest") {}
+
+protected:
+  void test() override {
+    using model::autoencoder::AnomalyDetector;
+    util::Random::seed(11);
+
+    // Normal behaviour: a slow sine wave
+    const size_t window = 16;
+    NDArray series({400});
+    for (size_t t = 0; t < 400; ++t) {
+      series[t] = 0.5 + 0.4 * std::sin(0.2 * static_cast<double>(t));
+    }
+    data::WindowDataset normal(series, window);
+    assertEqual(size_t(385), normal.size(), "Overlapping windows");
+
+    AnomalyDetector detector(static_cast<int>(window), 4, {8});
+    loss::MSELoss mse;
+    optimizer::Adam adam(0.01);
+    std::vector<double> losses;
+    detector.train_on_normal(normal, mse, adam, 30, 32,
+                             [&](int, double l, double) {
+                               losses.push_back(l);
+                             });
+    assertTrue(losses.back() < 0.5 * losses.front(), "Loss falls");
+
+    // Same errors as scoring the windows one by one
+    auto results = detector.detect_anomalies(normal, 5);
+    assertEqual(normal.size() - 5, results.reconstruction_errors.size(),
+                "Errors from the first window on");
+    NDArray sample;
+    normal.gather(5, 6, sample);
+    assertNear(detector.get_reconstruction_error(sample),
+               results.reconstruction_errors[0], 1e-12, "Batched error");
+
+    detector.calculate_threshold(normal);
+    assertTrue(detector.get_threshold() > 0.0, "Threshold set");
+
+    // Online: readings arrive one at a time, a spike follows the sine
+    data::WindowDataset stream(window, 1, 1, 2 * window);
+    bool flagged_spike = false;
+    for (size_t t = 0; t < 60; ++t) {
+      double reading = 0.5 + 0.4 * std::sin(0.2 * static_cast<double>(t));
+      if (t == 50) {
+        reading += 3.0;
+      }
+      const size_t fresh = stream.append(&reading, 1);
+      auto online = detector.detect_anomalies(stream, stream.size() - fresh);
+      assertEqual(fresh, online.anomaly_flags.size(), "Only new windows");
+      for (bool flag : online.anomaly_flags) {
+        flagged_spike |= t == 50 && flag;
+      }
+    }
+    assertTrue(flagged_spike, "Spike detected");
+    assertTrue(stream.length() <= 2 * window, "Stream history bounded");
+
+    data::WindowDataset wrong(series, 8);
+    assertThrows<std::invalid_argument>(
+        [&]() { detector.calculate_threshold(wrong); }, "Window size");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
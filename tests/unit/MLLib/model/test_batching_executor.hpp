@@ -0,0 +1,331 @@
+/**
+ * @file test_batching_executor.hpp
+ * @brief Unit tests for dynamic request batching
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/model/batching_executor.hpp"
+#include "../../../common/test_utils.hpp"
+#include "test_concurrent_inference.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Expected single-sample output of the shared inference model
+ */
+inline std::vector<double> predictSample(const model::Sequential& model,
+                                         const std::vector<double>& sample) {
+  return model.predict(sample);
+}
+
+inline std::vector<double> makeBatchingSample(size_t seed) {
+  return makeInferenceInput(seed, 1).to_vector();
+}
+
+/**
+ * @class GateLayer
+ * @brief Identity layer whose forward passes block until opened
+ * @details Counts how many forward passes run at once.
+ */
+class GateLayer : public layer::BaseLayer {
+public:
+  NDArray forward(const NDArray& input) override { return input; }
+
+  void infer(const NDArray& input, NDArray& output) const override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++running_;
+    peak_ = std::max(peak_, running_);
+    changed_.notify_all();
+    changed_.wait(lock, [this]() { return open_; });
+    --running_;
+    output = input;
+  }
+
+  NDArray backward(const NDArray& grad_output) override { return grad_output; }
+
+  std::vector<NDArray*> get_parameters() override { return {}; }
+
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    changed_.notify_all();
+  }
+
+  /**
+   * @brief Wait until the given number of forward passes are blocked
+   */
+  bool waitRunning(size_t count) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, std::chrono::seconds(5),
+                             [&]() { return running_ >= count; });
+  }
+
+  size_t peak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  mutable std::condition_variable changed_;
+  mutable size_t running_ = 0;
+  mutable size_t peak_ = 0;
+  bool open_ = false;
+};
+
+/**
+ * @class BatchingExecutorBatchTest
+ * @brief Test that queued requests share one forward pass
+ */
+class BatchingExecutorBatchTest : public TestCase {
+public:
+  BatchingExecutorBatchTest() : TestCase("BatchingExecutorBatchTest") {}
+
+protected:
+  void test() override {
+    std::shared_ptr<const model::Sequential> model = makeInferenceModel();
+
+    model::BatchingOptions options;
+    options.max_batch_size = 16;
+    options.max_wait = std::chrono::seconds(10);
+
+    std::vector<std::future<std::vector<double>>> futures;
+    {
+      model::BatchingExecutor executor(model, options);
+      for (size_t i = 0; i < 16; ++i) {
+        futures.push_back(executor.submit(makeBatchingSample(i)));
+      }
+      for (size_t i = 0; i < futures.size(); ++i) {
+        assertVectorNear(predictSample(*model, makeBatchingSample(i)),
+                         futures[i].get(), 1e-12,
+                         "Batched row matches single-sample predict");
+      }
+
+      model::BatchingMetrics metrics = executor.metrics();
+      assertEqual(uint64_t(1), metrics.batches,
+                  "A full batch closes before max_wait");
+      assertEqual(uint64_t(16), metrics.requests, "All requests completed");
+      assertNear(16.0, metrics.average_batch_size, 1e-12,
+                 "Average batch size");
+      assertEqual(size_t(0), metrics.queue_depth, "Queue drained");
+    }
+
+    assertThrows<std::invalid_argument>(
+        [&]() {
+          model::BatchingOptions bad;
+          bad.max_batch_size = 0;
+          model::BatchingExecutor executor(model, bad);
+        },
+        "Zero batch size rejected");
+    assertThrows<std::invalid_argument>(
+        []() { model::BatchingExecutor executor(nullptr); },
+        "Null model rejected");
+  }
+};
+
+/**
+ * @class BatchingExecutorConcurrencyTest
+ * @brief Test requests submitted from several threads
+ */
+class BatchingExecutorConcurrencyTest : public TestCase {
+public:
+  BatchingExecutorConcurrencyTest()
+      : TestCase("BatchingExecutorConcurrencyTest") {}
+
+protected:
+  void test() override {
+    std::shared_ptr<const model::Sequential> model = makeInferenceModel();
+
+    model::BatchingOptions options;
+    options.max_batch_size = 8;
+    options.max_wait = std::chrono::microseconds(500);
+    options.num_workers = 2;
+    model::BatchingExecutor executor(model, options);
+
+    const size_t threads = 4;
+    const size_t per_thread = 16;
+    std::vector<std::vector<std::vector<double>>> results(threads);
+    std::vector<std::thread> clients;
+    for (size_t t = 0; t < threads; ++t) {
+      clients.emplace_back([&, t]() {
+        std::vector<std::future<std::vector<double>>> futures;
+        for (size_t i = 0; i < per_thread; ++i) {
+          futures.push_back(
+              executor.submit(makeBatchingSample(t * per_thread + i)));
+        }
+        for (auto& future : futures) {
+          results[t].push_back(future.get());
+        }
+      });
+    }
+    for (auto& client : clients) {
+      client.join();
+    }
+
+    for (size_t t = 0; t < threads; ++t) {
+      for (size_t i = 0; i < per_thread; ++i) {
+        assertVectorNear(
+            predictSample(*model, makeBatchingSample(t * per_thread + i)),
+            results[t][i], 1e-12, "Each caller receives its own row");
+      }
+    }
+
+    model::BatchingMetrics metrics = executor.metrics();
+    assertEqual(uint64_t(threads * per_thread), metrics.requests,
+                "All requests counted");
+    assertTrue(metrics.batches >= threads * per_thread / 8,
+               "Batches never exceed max_batch_size");
+    assertTrue(metrics.max_latency_us >= metrics.average_latency_us,
+               "Latency metrics consistent");
+  }
+};
+
+/**
+ * @class BatchingExecutorDeadlineTest
+ * @brief Test max_wait, queue limits and error propagation
+ */
+class BatchingExecutorDeadlineTest : public TestCase {
+public:
+  BatchingExecutorDeadlineTest() : TestCase("BatchingExecutorDeadlineTest") {}
+
+protected:
+  void test() override {
+    std::shared_ptr<const model::Sequential> model = makeInferenceModel();
+
+    // A lone request is answered once its wait bound expires
+    {
+      model::BatchingOptions options;
+      options.max_batch_size = 64;
+      options.max_wait = std::chrono::milliseconds(5);
+      model::BatchingExecutor executor(model, options);
+
+      auto future = executor.submit(makeBatchingSample(3));
+      assertTrue(future.wait_for(std::chrono::seconds(5)) ==
+                     std::future_status::ready,
+                 "Partial batch flushed after max_wait");
+      assertVectorNear(predictSample(*model, makeBatchingSample(3)),
+                       future.get(), 1e-12, "Partial batch result");
+      assertNear(1.0, executor.metrics().average_batch_size, 1e-12,
+                 "Batch of one");
+    }
+
+    // Bounded queue rejects overflow; shutdown flushes what was accepted
+    std::future<std::vector<double>> first;
+    std::future<std::vector<double>> second;
+    {
+      model::BatchingOptions options;
+      options.max_batch_size = 64;
+      options.max_wait = std::chrono::seconds(60);
+      options.max_queue_depth = 2;
+      model::BatchingExecutor executor(model, options);
+
+      first = executor.submit(makeBatchingSample(1));
+      second = executor.submit(makeBatchingSample(2));
+      assertThrows<std::runtime_error>(
+          [&]() { executor.submit(makeBatchingSample(3)); },
+          "Full queue rejects requests");
+      assertEqual(uint64_t(1), executor.metrics().rejected,
+                  "Rejection counted");
+      assertEqual(size_t(2), executor.queue_depth(), "Two pending requests");
+      assertThrows<std::invalid_argument>(
+          [&]() { executor.submit({}); }, "Empty request rejected");
+    }
+    assertVectorNear(predictSample(*model, makeBatchingSample(1)), first.get(),
+                     1e-12, "Destructor runs pending requests");
+    assertVectorNear(predictSample(*model, makeBatchingSample(2)),
+                     second.get(), 1e-12, "Destructor runs pending requests");
+
+    // Lowering max_wait applies to requests already waiting
+    {
+      model::BatchingOptions options;
+      options.max_wait = std::chrono::seconds(60);
+      model::BatchingExecutor executor(model, options);
+      auto future = executor.submit(makeBatchingSample(4));
+      executor.set_max_wait(std::chrono::microseconds(0));
+      assertTrue(future.wait_for(std::chrono::seconds(5)) ==
+                     std::future_status::ready,
+                 "Knob change re-evaluates the pending batch");
+      assertThrows<std::invalid_argument>(
+          [&]() { executor.set_max_batch_size(0); }, "Zero batch size");
+    }
+
+    // Forward pass errors reach the caller through the future
+    {
+      model::BatchingExecutor executor(model);
+      auto future = executor.submit({1.0, 2.0});
+      assertThrows<std::invalid_argument>(
+          [&]() { future.get(); }, "Feature size mismatch propagated");
+    }
+  }
+};
+
+/**
+ * @class BatchingExecutorBackpressureTest
+ * @brief Test that batches wait for a free worker and still count as queued
+ */
+class BatchingExecutorBackpressureTest : public TestCase {
+public:
+  BatchingExecutorBackpressureTest()
+      : TestCase("BatchingExecutorBackpressureTest") {}
+
+protected:
+  void test() override {
+    auto gate = std::make_shared<GateLayer>();
+    auto model = std::make_shared<model::Sequential>();
+    model->add(gate);
+
+    model::BatchingOptions options;
+    options.max_batch_size = 1;
+    options.max_wait = std::chrono::microseconds(0);
+    options.num_workers = 2;
+    options.max_queue_depth = 6;
+
+    std::vector<std::future<std::vector<double>>> futures;
+    {
+      model::BatchingExecutor executor(model, options);
+      for (size_t i = 0; i < 6; ++i) {
+        futures.push_back(executor.submit({static_cast<double>(i)}));
+      }
+      // Sample with the gate closed, assert once it is open so a failure
+      // cannot leave the executor blocked in its destructor
+      const bool busy = gate->waitRunning(2);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      const size_t depth = executor.queue_depth();
+      const size_t reported = executor.metrics().queue_depth;
+      bool rejected = false;
+      try {
+        futures.push_back(executor.submit({6.0}));
+      } catch (const std::runtime_error&) {
+        rejected = true;
+      }
+      gate->open();
+
+      assertTrue(busy, "Both workers busy");
+      assertEqual(size_t(6), depth,
+                  "Running requests count towards the queue depth");
+      assertEqual(size_t(6), reported,
+                  "Metrics report queued plus running requests");
+      assertTrue(rejected, "Running requests count against max_queue_depth");
+      for (size_t i = 0; i < futures.size(); ++i) {
+        assertVectorNear(std::vector<double>{static_cast<double>(i)},
+                         futures[i].get(), 0.0, "Request answered");
+      }
+      assertEqual(size_t(0), executor.queue_depth(), "Nothing pending");
+    }
+    assertEqual(size_t(2), gate->peak(),
+                "No more batches run than there are workers");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,171 @@
+/**
+ * @file test_concurrent_inference.hpp
+ * @brief Unit tests for const, reentrant Sequential inference
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/activation/relu.hpp"
+#include "../../../../include/MLLib/layer/activation/sigmoid.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/model/sequential.hpp"
+#include "../../../common/test_utils.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @brief Small MLP shared by the inference tests
+ */
+inline std::shared_ptr<model::Sequential> makeInferenceModel() {
+  auto model = std::make_shared<model::Sequential>();
+  model->add(std::make_shared<layer::Dense>(4, 8));
+  model->add(std::make_shared<layer::activation::ReLU>());
+  model->add(std::make_shared<layer::Dense>(8, 3));
+  model->add(std::make_shared<layer::activation::Sigmoid>());
+  return model;
+}
+
+inline NDArray makeInferenceInput(size_t seed, size_t batch) {
+  NDArray input({batch, 4});
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = 0.1 * static_cast<double>((seed * 7 + i * 3) % 11) - 0.5;
+  }
+  return input;
+}
+
+/**
+ * @class SequentialConstInferenceTest
+ * @brief Test that inference leaves the model untouched
+ */
+class SequentialConstInferenceTest : public TestCase {
+public:
+  SequentialConstInferenceTest() : TestCase("SequentialConstInferenceTest") {}
+
+protected:
+  void test() override {
+    auto model = makeInferenceModel();
+    NDArray input = makeInferenceInput(1, 5);
+
+    // Reference: the training forward path
+    NDArray expected = input;
+    for (const auto& layer : model->get_layers()) {
+      expected = layer->forward(expected);
+    }
+
+    const model::Sequential& shared = *model;
+    NDArray output = shared.predict(input);
+    assertVectorNear(expected.to_vector(), output.to_vector(), 1e-12,
+                     "Const predict matches forward");
+    for (const auto& layer : shared.get_layers()) {
+      assertTrue(layer->is_training(), "Predict does not toggle layer mode");
+    }
+
+    model::InferenceContext context;
+    const NDArray& first = shared.predict(input, context);
+    const double* storage = first.data();
+    const NDArray& second = shared.predict(makeInferenceInput(2, 5), context);
+    assertTrue(second.data() == storage,
+               "Reused context keeps its buffers for the same shape");
+    assertTrue(&context.output() == &second, "Context exposes last output");
+
+    assertThrows<std::logic_error>(
+        []() { model::InferenceContext().output(); },
+        "Unused context has no output");
+  }
+};
+
+/**
+ * @class SequentialConcurrentPredictTest
+ * @brief Test many threads predicting on one shared model
+ */
+class SequentialConcurrentPredictTest : public TestCase {
+public:
+  SequentialConcurrentPredictTest()
+      : TestCase("SequentialConcurrentPredictTest") {}
+
+protected:
+  void test() override {
+    auto model = makeInferenceModel();
+    const size_t threads = 4;
+    const size_t requests = 50;
+
+    std::vector<std::vector<double>> expected;
+    for (size_t r = 0; r < requests; ++r) {
+      expected.push_back(model->predict(makeInferenceInput(r, 3)).to_vector());
+    }
+
+    std::vector<size_t> mismatches(threads, 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t]() {
+        const model::Sequential& shared = *model;
+        model::InferenceContext context;
+        for (size_t r = 0; r < requests; ++r) {
+          size_t id = (r + t * 13) % requests;
+          const NDArray& output =
+              shared.predict(makeInferenceInput(id, 3), context);
+          std::vector<double> values = output.to_vector();
+          for (size_t i = 0; i < values.size(); ++i) {
+            if (std::fabs(values[i] - expected[id][i]) > 1e-12) {
+              ++mismatches[t];
+              break;
+            }
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    size_t total = 0;
+    for (size_t count : mismatches) {
+      total += count;
+    }
+    assertEqual(size_t(0), total, "Concurrent predictions match serial ones");
+  }
+};
+
+/**
+ * @class SequentialBatchedPredictTest
+ * @brief Test that the multi-input predict stacks inputs correctly
+ */
+class SequentialBatchedPredictTest : public TestCase {
+public:
+  SequentialBatchedPredictTest() : TestCase("SequentialBatchedPredictTest") {}
+
+protected:
+  void test() override {
+    auto model = makeInferenceModel();
+    const model::Sequential& shared = *model;
+
+    // Mixed batch sizes, enough inputs to be split across threads
+    std::vector<NDArray> inputs;
+    for (size_t i = 0; i < 70; ++i) {
+      inputs.push_back(makeInferenceInput(i, 1 + i % 3));
+    }
+
+    std::vector<NDArray> outputs = shared.predict(inputs);
+    assertEqual(inputs.size(), outputs.size(), "One output per input");
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      assertEqual(inputs[i].shape()[0], outputs[i].shape()[0],
+                  "Output keeps the input's row count");
+      assertVectorNear(shared.predict(inputs[i]).to_vector(),
+                       outputs[i].to_vector(), 1e-12,
+                       "Batched output matches single predict");
+    }
+
+    assertTrue(shared.predict(std::vector<NDArray>()).empty(),
+               "No inputs, no outputs");
+    assertThrows<std::invalid_argument>(
+        [&]() { shared.predict(std::vector<NDArray>{NDArray({2, 5})}); },
+        "Incompatible feature count is reported");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,99 @@
+/**
+ * @file test_static_sequential.hpp
+ * @brief Unit tests for compile-time fixed-shape Sequential models
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/activation/relu.hpp"
+#include "../../../../include/MLLib/layer/activation/sigmoid.hpp"
+#include "../../../../include/MLLib/layer/activation/tanh.hpp"
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/model/model_io.hpp"
+#include "../../../../include/MLLib/model/static_sequential.hpp"
+#include "../../../common/test_utils.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class StaticSequentialTest
+ * @brief Test that a StaticSequential reproduces a trained Sequential
+ */
+class StaticSequentialTest : public TestCase {
+public:
+  StaticSequentialTest() : TestCase("StaticSequentialTest") {}
+
+protected:
+  void test() override {
+    using namespace MLLib::model;
+
+    Sequential dynamic;
+    dynamic.add(std::make_shared<layer::Dense>(3, 8));
+    dynamic.add(std::make_shared<layer::activation::ReLU>());
+    dynamic.add(std::make_shared<layer::Dense>(8, 4, false));
+    dynamic.add(std::make_shared<layer::activation::Tanh>());
+    dynamic.add(std::make_shared<layer::Dense>(4, 2));
+    dynamic.add(std::make_shared<layer::activation::Sigmoid>());
+    // Nonzero biases so they are checked too
+    for (size_t i : {size_t(0), size_t(4)}) {
+      auto* dense = dynamic_cast<layer::Dense*>(dynamic.get_layers()[i].get());
+      NDArray bias = dense->get_bias();
+      for (size_t j = 0; j < bias.size(); ++j) {
+        bias[j] = 0.1 * static_cast<double>(j) - 0.2;
+      }
+      dense->set_biases(bias);
+    }
+
+    using Model = StaticSequential<fixed::Dense<3, 8>, fixed::ReLU,
+                                   fixed::Dense<8, 4, false>, fixed::Tanh,
+                                   fixed::Dense<4, 2>, fixed::Sigmoid>;
+    static_assert(Model::input_size == 3 && Model::output_size == 2,
+                  "Shapes follow the layer types");
+
+    Model fixed_model;
+    assertTrue(fixed_model.load(dynamic), "Load from Sequential");
+
+    const std::vector<std::vector<double>> inputs = {
+        {0.0, 0.0, 0.0}, {1.0, -0.5, 0.25}, {-2.0, 0.7, 1.5}};
+    for (const auto& x : inputs) {
+      const std::array<double, 3> input = {x[0], x[1], x[2]};
+      const std::array<double, 2> output = fixed_model.predict(input);
+      assertVectorNear(dynamic.predict(x),
+                       std::vector<double>(output.begin(), output.end()),
+                       1e-12, "Same prediction");
+    }
+
+    // Round trip through a saved file
+    std::string temp_dir = createTempDirectory();
+    std::string path = temp_dir + "/tiny_model";
+    assertTrue(GenericModelIO::save_model(dynamic, path, SaveFormat::BINARY),
+               "Save");
+    Model from_file;
+    assertTrue(from_file.load(path), "Load from file");
+    const std::array<double, 3> input = {0.3, -0.1, 0.9};
+    std::array<double, 2> out;
+    from_file.predict(input, out);
+    assertVectorNear(dynamic.predict(std::vector<double>{0.3, -0.1, 0.9}),
+                     std::vector<double>(out.begin(), out.end()), 1e-12,
+                     "Same prediction after file load");
+    assertTrue(!from_file.load(temp_dir + "/missing"), "Missing file");
+    removeTempDirectory(temp_dir);
+
+    // A model of another architecture is rejected without side effects
+    StaticSequential<fixed::Dense<3, 8>, fixed::Sigmoid> other;
+    other.layer<0>().bias().fill(1.0);
+    assertTrue(!other.load(dynamic), "Layer count mismatch");
+    Sequential wrong_activation;
+    wrong_activation.add(std::make_shared<layer::Dense>(3, 8));
+    wrong_activation.add(std::make_shared<layer::activation::ReLU>());
+    assertTrue(!other.load(wrong_activation), "Activation mismatch");
+    assertNear(1.0, other.layer<0>().bias()[0], 0.0, "Parameters unchanged");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../../../include/MLLib/ndarray.hpp"
+#include "../../../include/MLLib/ndarray_expr.hpp"
 #include "../../common/test_utils.hpp"
+#include <cmath>
 
 namespace MLLib {
 namespace test {
@@ -54,6 +56,19 @@ protected:
     assertEqual(size_t(3), arr5.shape()[0], "First dimension should be 3");
     assertEqual(size_t(2), arr5.shape()[1], "Second dimension should be 2");
     assertEqual(size_t(6), arr5.size(), "Total size should be 3*2=6");
+
+    // Test move constructor and assignment take over the storage
+    const double* storage = arr5.data();
+    NDArray arr6(std::move(arr5));
+    assertTrue(arr6.data() == storage, "Move constructor should not copy");
+    assertEqual(size_t(6), arr6.size(), "Moved array keeps its size");
+    assertEqual(size_t(0), arr5.size(), "Moved-from array should be empty");
+    NDArray arr7;
+    arr7 = std::move(arr6);
+    assertTrue(arr7.data() == storage, "Move assignment should not copy");
+    assertEqual(size_t(3), arr7.shape()[0], "Moved array keeps its shape");
+    assertEqual(size_t(0), arr6.shape().size(),
+                "Moved-from array should have no shape");
   }
 };
 
@@ -307,5 +322,218 @@ protected:
   }
 };
 
+/**
+ * @class NDArrayBroadcastTest
+ * @brief Test NumPy-style broadcasting of element-wise operators
+ */
+class NDArrayBroadcastTest : public TestCase {
+public:
+  NDArrayBroadcastTest() : TestCase("NDArrayBroadcastTest") {}
+
+protected:
+  void test() override {
+    NDArray matrix({2, 3});
+    for (size_t i = 0; i < 6; ++i) {
+      matrix[i] = static_cast<double>(i);
+    }
+    NDArray row(std::vector<double>{10.0, 20.0, 30.0});
+    NDArray column({2, 1});
+    column[0] = 2.0;
+    column[1] = 4.0;
+
+    assertVectorNear({10.0, 21.0, 32.0, 13.0, 24.0, 35.0},
+                     (matrix + row).to_vector(), 1e-12, "Row broadcast");
+    assertVectorNear({0.0, 0.5, 1.0, 0.75, 1.0, 1.25},
+                     (matrix / column).to_vector(), 1e-12,
+                     "Column broadcast");
+    NDArray outer = column * row;
+    assertTrue(outer.shape() == std::vector<size_t>({2, 3}),
+               "Both operands broadcast");
+    assertVectorNear({20.0, 40.0, 60.0, 40.0, 80.0, 120.0}, outer.to_vector(),
+                     1e-12, "Outer product by broadcasting");
+
+    NDArray scalar(std::vector<double>{1.0});
+    assertVectorNear({-1.0, 0.0, 1.0, 2.0, 3.0, 4.0},
+                     (matrix - scalar).to_vector(), 1e-12,
+                     "Single element broadcast");
+
+    // 3-D broadcast of a middle axis
+    NDArray cube({2, 2, 3});
+    cube.fill(1.0);
+    NDArray middle({2, 1, 3});
+    for (size_t i = 0; i < 6; ++i) {
+      middle[i] = static_cast<double>(i);
+    }
+    NDArray sum3 = cube + middle;
+    assertVectorNear({1, 2, 3, 1, 2, 3, 4, 5, 6, 4, 5, 6}, sum3.to_vector(),
+                     1e-12, "Middle axis broadcast");
+
+    matrix += row;
+    matrix -= row;
+    matrix *= column;
+    assertVectorNear({0.0, 2.0, 4.0, 12.0, 16.0, 20.0}, matrix.to_vector(),
+                     1e-12, "In-place broadcast");
+
+    assertThrows<std::invalid_argument>([&]() { row += matrix; },
+                                        "In-place result must keep its shape");
+    NDArray wrong({2, 2});
+    assertThrows<std::invalid_argument>([&]() { auto r = matrix + wrong; },
+                                        "Incompatible shapes");
+  }
+};
+
+/**
+ * @class NDArrayReductionTest
+ * @brief Test axis reductions and accumulation schemes
+ */
+class NDArrayReductionTest : public TestCase {
+public:
+  NDArrayReductionTest() : TestCase("NDArrayReductionTest") {}
+
+protected:
+  void test() override {
+    NDArray m({2, 3});
+    std::vector<double> values = {1.0, 5.0, 3.0, 4.0, 2.0, 6.0};
+    for (size_t i = 0; i < 6; ++i) {
+      m[i] = values[i];
+    }
+
+    assertNear(21.0, m.sum(), 1e-12, "Total sum");
+    assertNear(3.5, m.mean(), 1e-12, "Total mean");
+    assertNear(35.0 / 12.0, m.var(), 1e-12, "Total variance");
+    assertNear(std::sqrt(91.0), m.norm(), 1e-12, "Total norm");
+    assertNear(6.0, m.max(), 0.0, "Total max");
+    assertEqual(size_t(5), m.argmax(), "Total argmax");
+
+    assertVectorNear({5.0, 7.0, 9.0}, m.sum(0).to_vector(), 1e-12,
+                     "Sum over rows");
+    assertVectorNear({9.0, 12.0}, m.sum(-1).to_vector(), 1e-12,
+                     "Sum over columns");
+    assertTrue(m.sum(1, true).shape() == std::vector<size_t>({2, 1}),
+               "Keep reduced axis");
+    assertVectorNear({3.0, 4.0}, m.mean(1).to_vector(), 1e-12, "Row means");
+    assertVectorNear({2.25, 2.25, 2.25}, m.var(0).to_vector(), 1e-12,
+                     "Column variance");
+    assertVectorNear({5.0, 6.0}, m.max(1).to_vector(), 0.0, "Row max");
+    assertVectorNear({1.0, 0.0, 1.0}, m.argmax(0).to_vector(), 0.0,
+                     "Column argmax");
+    assertVectorNear({std::sqrt(17.0), std::sqrt(29.0), std::sqrt(45.0)},
+                     m.norm(0).to_vector(), 1e-12, "Column norms");
+
+    // Large strided and contiguous reductions agree with a long-double
+    // reference under every accumulation scheme
+    const size_t rows = 3000;
+    const size_t cols = 300;
+    NDArray big({rows, cols});
+    for (size_t i = 0; i < big.size(); ++i) {
+      big[i] = 1.0 + 1e-3 * static_cast<double>(i % 997);
+    }
+    std::vector<long double> column_sums(cols, 0.0L);
+    std::vector<long double> row_sums(rows, 0.0L);
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < cols; ++c) {
+        column_sums[c] += big[r * cols + c];
+        row_sums[r] += big[r * cols + c];
+      }
+    }
+    const Accumulation schemes[] = {Accumulation::NAIVE,
+                                    Accumulation::PAIRWISE,
+                                    Accumulation::KAHAN};
+    for (auto scheme : schemes) {
+      NDArray by_column = big.sum(0, false, scheme);
+      NDArray by_row = big.sum(1, false, scheme);
+      bool close = true;
+      for (size_t c = 0; c < cols; ++c) {
+        double expected = static_cast<double>(column_sums[c]);
+        close = close && std::fabs(by_column[c] - expected) < 1e-9;
+      }
+      for (size_t r = 0; r < rows; ++r) {
+        double expected = static_cast<double>(row_sums[r]);
+        close = close && std::fabs(by_row[r] - expected) < 1e-9;
+      }
+      assertTrue(close, "Axis sums match the reference");
+    }
+
+    // Kahan keeps the small terms a naive running sum would round away
+    NDArray skewed({1 << 17});
+    skewed.fill(1e-16);
+    skewed[0] = 1.0;
+    double exact = 1.0 + 1e-16 * static_cast<double>((1 << 17) - 1);
+    assertNear(exact, skewed.sum(Accumulation::KAHAN), 1e-15,
+               "Compensated summation");
+    assertNear(exact, skewed.sum(Accumulation::PAIRWISE), 1e-14,
+               "Pairwise summation");
+
+    assertThrows<std::invalid_argument>([&]() { m.sum(2); },
+                                        "Axis out of range");
+  }
+};
+
+/**
+ * @class NDArrayExpressionTest
+ * @brief Test lazy expressions against the eager operators
+ */
+class NDArrayExpressionTest : public TestCase {
+public:
+  NDArrayExpressionTest() : TestCase("NDArrayExpressionTest") {}
+
+protected:
+  void test() override {
+    using expr::lazy;
+
+    // Large enough to be split across the thread pool
+    const size_t n = 100003;
+    NDArray a({n});
+    NDArray b({n});
+    NDArray c({n});
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = std::sin(0.001 * i);
+      b[i] = 0.5 + 0.25 * std::cos(0.002 * i);
+      c[i] = 1.0 + static_cast<double>(i % 7);
+    }
+
+    NDArray eager = a * 2.0 + b * c;
+    NDArray fused = lazy(a) * 2.0 + lazy(b) * c;
+    assertTrue(eager.shape() == fused.shape(), "Shape of the result");
+    assertVectorNear(eager.to_vector(), fused.to_vector(), 0.0,
+                     "Fused result matches eager operators");
+
+    // Existing storage is reused and may be read by the expression
+    const double* storage = fused.data();
+    fused.assign(1.0 - lazy(fused) / c);
+    assertTrue(fused.data() == storage, "Storage reused");
+    bool aliased_ok = true;
+    for (size_t i = 0; i < n; ++i) {
+      aliased_ok &= fused[i] == 1.0 - eager[i] / c[i];
+    }
+    assertTrue(aliased_ok, "Expression reading its own target");
+
+    NDArray small({2, 2});
+    small.assign(-expr::square(lazy(a)) + a);
+    assertEqual(n, small.size(), "Target resized");
+    assertNear(a[5] - a[5] * a[5], small[5], 1e-15, "Negate and square");
+
+    // Same storage size with a new shape
+    NDArray matrix({3, 2});
+    NDArray flat({6});
+    for (size_t i = 0; i < 6; ++i) {
+      matrix[i] = static_cast<double>(i);
+    }
+    flat.assign(lazy(matrix) + 1.0);
+    assertTrue(flat.shape() == matrix.shape(), "Shape taken");
+    assertNear(6.0, flat[5], 0.0, "Reshaped values");
+
+    assertNear(a.sum(), expr::sum(lazy(a)), 1e-9, "Lazy sum");
+    NDArray diff = a - b;
+    assertNear((diff * diff).mean(), expr::mean(expr::square(lazy(a) - b)),
+               1e-12, "Lazy mean");
+    assertNear(0.0, expr::mean(lazy(NDArray())), 0.0, "Empty mean");
+
+    NDArray row({1, 2});
+    assertThrows<std::invalid_argument>([&]() { lazy(matrix) + row; },
+                                        "Lazy operands do not broadcast");
+  }
+};
+
 }  // namespace test
 }  // namespace MLLib
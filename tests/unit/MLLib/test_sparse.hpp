@@ -0,0 +1,184 @@
+/**
+ * @file test_sparse.hpp
+ * @brief Unit tests for CSR matrices and sparse inputs to Dense layers
+ */
+
+#pragma once
+
+#include "../../../include/MLLib/layer/activation/sigmoid.hpp"
+#include "../../../include/MLLib/layer/dense.hpp"
+#include "../../../include/MLLib/loss/mse.hpp"
+#include "../../../include/MLLib/model/sequential.hpp"
+#include "../../../include/MLLib/optimizer/sgd.hpp"
+#include "../../../include/MLLib/sparse.hpp"
+#include "../../common/test_utils.hpp"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class SparseMatrixTest
+ * @brief Test CSR construction, conversion and sparse x dense products
+ */
+class SparseMatrixTest : public TestCase {
+public:
+  SparseMatrixTest() : TestCase("SparseMatrixTest") {}
+
+protected:
+  void test() override {
+    // Unordered triplets with one duplicate coordinate
+    SparseMatrix a = SparseMatrix::from_coo(3, 4, {2, 0, 0, 2, 0},
+                                            {1, 3, 0, 1, 3},
+                                            {1.0, 2.0, 3.0, 4.0, 0.5});
+    assertEqual(size_t(3), a.nnz(), "Duplicates are summed");
+    assertTrue(a.row_offsets() == std::vector<size_t>({0, 2, 2, 3}),
+               "Row offsets");
+    assertTrue(a.col_indices() == std::vector<size_t>({0, 3, 1}),
+               "Sorted columns");
+    assertVectorNear({3.0, 0.0, 0.0, 2.5, 0.0, 0.0, 0.0, 0.0, 0.0, 5.0, 0.0,
+                      0.0},
+                     a.to_dense().to_vector(), 0.0, "Dense copy");
+
+    SparseMatrix round_trip = SparseMatrix::from_dense(a.to_dense());
+    assertTrue(round_trip.values() == a.values() &&
+                   round_trip.col_indices() == a.col_indices(),
+               "from_dense keeps the nonzeros");
+
+    SparseMatrix t = a.transpose();
+    assertEqual(size_t(4), t.rows(), "Transposed rows");
+    NDArray a_dense = a.to_dense();
+    NDArray t_dense = t.to_dense();
+    bool transposed = true;
+    for (size_t r = 0; r < 3; ++r) {
+      for (size_t c = 0; c < 4; ++c) {
+        transposed &= t_dense[c * 3 + r] == a_dense[r * 4 + c];
+      }
+    }
+    assertTrue(transposed, "Transpose");
+
+    NDArray b({4, 5});
+    for (size_t i = 0; i < b.size(); ++i) {
+      b[i] = 0.1 * static_cast<double>(i) - 0.7;
+    }
+    NDArray expected = a.to_dense().matmul(b);
+    NDArray product = a.matmul(b);
+    assertVectorNear(expected.to_vector(), product.to_vector(), 1e-12,
+                     "Sparse x dense matches dense matmul");
+
+    // Output storage of the right size is reused
+    NDArray out({5, 3});
+    const double* storage = out.data();
+    a.matmul(b, out);
+    assertTrue(out.data() == storage, "Output reused");
+    assertVectorNear(expected.to_vector(), out.to_vector(), 1e-12,
+                     "Reused output values");
+
+    assertThrows<std::invalid_argument>([&]() { a.matmul(NDArray({3, 2})); },
+                                        "Inner dimension mismatch");
+    assertThrows<std::invalid_argument>(
+        [&]() { SparseMatrix::from_coo(2, 2, {2}, {0}, {1.0}); },
+        "Row out of range");
+    assertThrows<std::invalid_argument>(
+        [&]() { SparseMatrix(1, 3, {0, 2}, {2, 1}, {1.0, 1.0}); },
+        "Unsorted CSR columns");
+  }
+};
+
+/**
+ * @class SparseDenseLayerTest
+ * @brief Test that sparse inputs train Dense layers like dense inputs
+ */
+class SparseDenseLayerTest : public TestCase {
+public:
+  SparseDenseLayerTest() : TestCase("SparseDenseLayerTest") {}
+
+protected:
+  void test() override {
+    // One-hot rows
+    const size_t samples = 6, width = 40;
+    std::vector<size_t> rows;
+    std::vector<size_t> cols;
+    std::vector<double> ones;
+    std::vector<std::vector<double>> dense_x(samples,
+                                             std::vector<double>(width, 0.0));
+    std::vector<std::vector<double>> y;
+    for (size_t i = 0; i < samples; ++i) {
+      rows.push_back(i);
+      cols.push_back(7 * i % width);
+      ones.push_back(1.0);
+      dense_x[i][7 * i % width] = 1.0;
+      y.push_back({i % 2 ? 1.0 : 0.0, i % 3 ? 0.0 : 1.0});
+    }
+    SparseMatrix x = SparseMatrix::from_coo(samples, width, rows, cols, ones);
+
+    layer::Dense dense(width, 3);
+    layer::Dense reference(width, 3);
+    reference.set_weights(dense.get_weights());
+    reference.set_biases(dense.get_bias());
+
+    NDArray grad({samples, 3});
+    for (size_t i = 0; i < grad.size(); ++i) {
+      grad[i] = 0.01 * static_cast<double>(i % 5);
+    }
+    NDArray expected_output = reference.forward(x.to_dense());
+    assertVectorNear(expected_output.to_vector(),
+                     dense.forward(x).to_vector(), 1e-12, "Sparse forward");
+    reference.backward(grad);
+    NDArray input_grad = dense.backward(grad);
+    assertEqual(size_t(0), input_grad.size(), "No gradient for data");
+    assertVectorNear(reference.get_weight_gradients().to_vector(),
+                     dense.get_weight_gradients().to_vector(), 1e-12,
+                     "Sparse weight gradient");
+    assertVectorNear(reference.get_bias_gradients().to_vector(),
+                     dense.get_bias_gradients().to_vector(), 1e-12,
+                     "Bias gradient");
+
+    // Whole models train identically from the same weights
+    model::Sequential sparse_model;
+    model::Sequential dense_model;
+    for (auto* model : {&sparse_model, &dense_model}) {
+      model->add(std::make_shared<layer::Dense>(width, 4));
+      model->add(std::make_shared<layer::activation::Sigmoid>());
+      model->add(std::make_shared<layer::Dense>(4, 2));
+    }
+    copyWeights(sparse_model, dense_model);
+
+    loss::MSELoss mse;
+    optimizer::SGD sgd_sparse(0.5);
+    optimizer::SGD sgd_dense(0.5);
+    std::vector<double> sparse_losses;
+    std::vector<double> dense_losses;
+    sparse_model.train(x, y, mse, sgd_sparse,
+                       [&](int, double l) { sparse_losses.push_back(l); }, 20);
+    dense_model.train(dense_x, y, mse, sgd_dense,
+                      [&](int, double l) { dense_losses.push_back(l); }, 20);
+    assertVectorNear(dense_losses, sparse_losses, 1e-12, "Same loss curve");
+    assertTrue(sparse_losses.back() < sparse_losses.front(), "Loss falls");
+    assertVectorNear(dense_model.predict(x.to_dense()).to_vector(),
+                     sparse_model.predict(x).to_vector(), 1e-12,
+                     "Sparse predict");
+
+    model::Sequential no_dense;
+    no_dense.add(std::make_shared<layer::activation::Sigmoid>());
+    assertThrows<std::invalid_argument>([&]() { no_dense.predict(x); },
+                                        "Sparse input needs a Dense layer");
+  }
+
+private:
+  static void copyWeights(model::Sequential& from, model::Sequential& to) {
+    for (size_t i = 0; i < from.num_layers(); ++i) {
+      auto* source = dynamic_cast<layer::Dense*>(from.get_layers()[i].get());
+      auto* target = dynamic_cast<layer::Dense*>(to.get_layers()[i].get());
+      if (source && target) {
+        target->set_weights(source->get_weights());
+        target->set_biases(source->get_bias());
+      }
+    }
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -0,0 +1,205 @@
+/**
+ * @file test_random.hpp
+ * @brief Unit tests for the counter-based random number generator
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/layer/dense.hpp"
+#include "../../../../include/MLLib/util/misc/random.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class PhiloxReproducibilityTest
+ * @brief Test known-answer vectors and position-addressed reproducibility
+ */
+class PhiloxReproducibilityTest : public TestCase {
+public:
+  PhiloxReproducibilityTest() : TestCase("PhiloxReproducibilityTest") {}
+
+protected:
+  void test() override {
+    // Random123 known-answer vectors for Philox4x32-10
+    auto zero = util::Philox4x32::apply({0, 0, 0, 0}, {0, 0});
+    assertTrue(zero[0] == 0x6627e8d5u && zero[1] == 0xe169c58du &&
+                   zero[2] == 0xbc57ac4cu && zero[3] == 0x9b00dbd8u,
+               "Zero counter and key");
+    auto ones = util::Philox4x32::apply(
+        {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+        {0xffffffffu, 0xffffffffu});
+    assertTrue(ones[0] == 0x408f276du && ones[1] == 0x41c83b0eu &&
+                   ones[2] == 0xa20bc7c6u && ones[3] == 0x6d5451fdu,
+               "All-ones counter and key");
+
+    // A parallel fill equals the same range drawn in small odd-sized pieces
+    const size_t count = util::RANDOM_PARALLEL_MIN * 2 + 3;
+    std::vector<double> whole(count);
+    util::RandomStream parallel(7, 3);
+    parallel.normal(whole.data(), count);
+    assertEqual(uint64_t(count), parallel.position(), "Position advances");
+
+    std::vector<double> pieces(count);
+    util::RandomStream serial(7, 3);
+    for (size_t start = 0; start < count; start += 997) {
+      serial.normal(pieces.data() + start, std::min<size_t>(997, count - start));
+    }
+    bool identical = true;
+    for (size_t i = 0; i < count; ++i) {
+      identical = identical && whole[i] == pieces[i];
+    }
+    assertTrue(identical, "Values do not depend on how a fill is split");
+
+    util::RandomStream seeker(7, 3);
+    seeker.seek(12345);
+    assertTrue(seeker.normal() == whole[12345], "Seek addresses one element");
+
+    util::RandomStream other(7, 4);
+    assertTrue(other.normal() != whole[0], "Streams are independent");
+    assertTrue(parallel.split(1).uniform() != parallel.split(2).uniform(),
+               "Split streams are independent");
+
+    // Seeding the process reproduces layer initialization
+    util::Random::seed(42);
+    layer::Dense first(16, 8);
+    util::Random::seed(42);
+    layer::Dense second(16, 8);
+    assertVectorNear(first.get_weights().to_vector(),
+                     second.get_weights().to_vector(), 0.0,
+                     "Same seed, same weights");
+    layer::Dense third(16, 8);
+    assertTrue(third.get_weights().to_vector() !=
+                   second.get_weights().to_vector(),
+               "Each layer draws from its own stream");
+  }
+};
+
+/**
+ * @class RandomDistributionTest
+ * @brief Test moments of uniform, normal and Bernoulli fills
+ */
+class RandomDistributionTest : public TestCase {
+public:
+  RandomDistributionTest() : TestCase("RandomDistributionTest") {}
+
+protected:
+  void test() override {
+    const size_t count = 200000;
+    std::vector<double> values(count);
+    util::RandomStream stream(2024);
+
+    auto moments = [&](double& mean, double& variance) {
+      mean = 0.0;
+      for (double v : values) mean += v;
+      mean /= count;
+      variance = 0.0;
+      for (double v : values) variance += (v - mean) * (v - mean);
+      variance /= count;
+    };
+    double mean = 0.0;
+    double variance = 0.0;
+
+    stream.uniform(values.data(), count, -1.0, 3.0);
+    moments(mean, variance);
+    assertNear(1.0, mean, 0.02, "Uniform mean");
+    assertNear(16.0 / 12.0, variance, 0.02, "Uniform variance");
+    bool in_range = true;
+    for (double v : values) {
+      in_range = in_range && v >= -1.0 && v < 3.0;
+    }
+    assertTrue(in_range, "Uniform stays in [low, high)");
+
+    stream.normal(values.data(), count, 2.0, 0.5);
+    moments(mean, variance);
+    assertNear(2.0, mean, 0.01, "Normal mean");
+    assertNear(0.25, variance, 0.01, "Normal variance");
+
+    stream.bernoulli(values.data(), count, 0.3);
+    moments(mean, variance);
+    assertNear(0.3, mean, 0.01, "Bernoulli rate");
+
+    assertThrows<std::invalid_argument>(
+        [&]() { stream.bernoulli(values.data(), 1, 1.5); },
+        "Probability outside [0, 1]");
+  }
+};
+
+/**
+ * @class RandomNoiseKernelTest
+ * @brief Test the fused corruption fills
+ */
+class RandomNoiseKernelTest : public TestCase {
+public:
+  RandomNoiseKernelTest() : TestCase("RandomNoiseKernelTest") {}
+
+protected:
+  void test() override {
+    const size_t count = util::RANDOM_PARALLEL_MIN + 5;
+    std::vector<double> clean(count);
+    for (size_t i = 0; i < count; ++i) {
+      clean[i] = 0.5 + 0.001 * static_cast<double>(i % 100);
+    }
+
+    // Fused noise equals the separate fill added to the input, also in place
+    std::vector<double> noise(count);
+    util::RandomStream(9).normal(noise.data(), count, 0.0, 0.2);
+    std::vector<double> noisy = clean;
+    util::RandomStream fused(9);
+    fused.add_normal(noisy.data(), noisy.data(), count, 0.2);
+    assertEqual(uint64_t(count), fused.position(), "Position advances");
+    bool matches = true;
+    for (size_t i = 0; i < count; ++i) {
+      matches = matches && std::fabs(noisy[i] - (clean[i] + noise[i])) < 1e-15;
+    }
+    assertTrue(matches, "Gaussian corruption in one pass");
+
+    std::vector<double> out(count);
+    util::RandomStream(10).add_uniform(clean.data(), out.data(), count, -0.1,
+                                       0.1);
+    bool bounded = true;
+    for (size_t i = 0; i < count; ++i) {
+      double d = out[i] - clean[i];
+      bounded = bounded && d >= -0.1 && d < 0.1;
+    }
+    assertTrue(bounded, "Uniform corruption stays in range");
+
+    util::RandomStream(11).dropout(clean.data(), out.data(), count, 0.25);
+    size_t dropped = 0;
+    bool kept = true;
+    for (size_t i = 0; i < count; ++i) {
+      if (out[i] == 0.0) {
+        ++dropped;
+      } else {
+        kept = kept && out[i] == clean[i];
+      }
+    }
+    assertTrue(kept, "Dropout keeps the other values");
+    assertNear(0.25, static_cast<double>(dropped) / count, 0.01,
+               "Dropout rate");
+
+    util::RandomStream(12).salt_pepper(clean.data(), out.data(), count, 0.2);
+    size_t salt = 0;
+    size_t pepper = 0;
+    for (size_t i = 0; i < count; ++i) {
+      salt += out[i] == 1.0;
+      pepper += out[i] == 0.0;
+    }
+    assertNear(0.1, static_cast<double>(salt) / count, 0.01, "Salt fraction");
+    assertNear(0.1, static_cast<double>(pepper) / count, 0.01,
+               "Pepper fraction");
+
+    assertThrows<std::invalid_argument>(
+        [&]() {
+          util::RandomStream(13).dropout(clean.data(), out.data(), 1, -0.5);
+        },
+        "Rate outside [0, 1]");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
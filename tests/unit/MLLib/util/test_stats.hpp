@@ -0,0 +1,185 @@
+/**
+ * @file test_stats.hpp
+ * @brief Unit tests for the batched reconstruction and image metrics
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/model/autoencoder/denoising.hpp"
+#include "../../../../include/MLLib/util/number/stats.hpp"
+#include "../../../common/test_utils.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class ErrorMetricsTest
+ * @brief Test per-sample MSE, MAE, RMSE and PSNR
+ */
+class ErrorMetricsTest : public TestCase {
+public:
+  ErrorMetricsTest() : TestCase("ErrorMetricsTest") {}
+
+protected:
+  void test() override {
+    NDArray a({2, 4});
+    NDArray b({2, 4});
+    // Sample 0 differs by 0.5 everywhere, sample 1 by 1.0 in one element
+    for (size_t i = 0; i < 4; ++i) {
+      a[i] = 0.25 * i;
+      b[i] = a[i] + 0.5;
+      a[4 + i] = 0.1;
+      b[4 + i] = i == 2 ? 1.1 : 0.1;
+    }
+
+    assertVectorNear({0.25, 0.25}, util::mse(a, b), 1e-12, "MSE per sample");
+    assertVectorNear({0.5, 0.25}, util::mae(a, b), 1e-12, "MAE per sample");
+    assertVectorNear({0.5, 0.5}, util::rmse(a, b), 1e-12, "RMSE per sample");
+    assertVectorNear({10.0 * std::log10(16.0), 10.0 * std::log10(16.0)},
+                     util::psnr(a, b, 2.0), 1e-12, "PSNR with data range");
+    assertTrue(std::isinf(util::psnr(a, a)[0]), "Identical samples");
+    assertNear(0.375, util::mean(util::mae(a, b)), 1e-12, "Mean of samples");
+    assertNear(0.0, util::mean({}), 0.0, "Mean of nothing");
+
+    NDArray c({4, 2});
+    assertThrows<std::invalid_argument>([&]() { util::mse(a, c); },
+                                        "Shape mismatch");
+  }
+};
+
+/**
+ * @class SSIMTest
+ * @brief Test windowed SSIM against its defining properties
+ */
+class SSIMTest : public TestCase {
+public:
+  SSIMTest() : TestCase("SSIMTest") {}
+
+protected:
+  void test() override {
+    const size_t n = 3, h = 16, w = 16, c = 2;
+    NDArray clean({n, h, w, c});
+    for (size_t i = 0; i < clean.size(); ++i) {
+      clean[i] = 0.5 + 0.4 * std::sin(0.37 * i);
+    }
+
+    auto same = util::ssim(clean, clean);
+    assertVectorNear({1.0, 1.0, 1.0}, same, 1e-12, "Identical images");
+
+    // A constant offset keeps structure and contrast; only luminance drops
+    NDArray shifted = clean;
+    for (size_t i = 0; i < shifted.size(); ++i) {
+      shifted[i] += 0.1;
+    }
+    double offset = util::ssim(clean, shifted)[0];
+    assertTrue(offset < 1.0 && offset > 0.9, "Brightness shift");
+
+    // Stronger noise scores lower, and every sample gets its own value
+    NDArray noisy = clean;
+    for (size_t i = 0; i < noisy.size(); ++i) {
+      double amplitude = 0.05 * static_cast<double>(1 + i / (h * w * c));
+      noisy[i] += (i % 3 == 0 ? amplitude : -amplitude);
+    }
+    auto scores = util::ssim(clean, noisy);
+    assertTrue(scores[0] > scores[1] && scores[1] > scores[2],
+               "SSIM decreases with noise");
+
+    NDArray inverted = clean;
+    for (size_t i = 0; i < inverted.size(); ++i) {
+      inverted[i] = 1.0 - clean[i];
+    }
+    assertTrue(util::ssim(clean, inverted)[0] < 0.0, "Anti-correlated images");
+
+    // Channels are scored independently and averaged
+    NDArray first({1, h, w, 1});
+    NDArray second({1, h, w, 1});
+    NDArray both({1, h, w, 2});
+    NDArray both_noisy({1, h, w, 2});
+    for (size_t p = 0; p < h * w; ++p) {
+      first[p] = clean[p * c];
+      second[p] = noisy[(2 * h * w + p) * c + 1];
+      both[p * 2] = first[p];
+      both[p * 2 + 1] = first[p];
+      both_noisy[p * 2] = first[p];
+      both_noisy[p * 2 + 1] = second[p];
+    }
+    assertNear(0.5 * (1.0 + util::ssim(first, second)[0]),
+               util::ssim(both, both_noisy)[0], 1e-12, "Channel average");
+
+    // Flat samples and windows larger than the image still work
+    NDArray rows({2, 5});
+    NDArray other({2, 5});
+    for (size_t i = 0; i < rows.size(); ++i) {
+      rows[i] = 0.1 * i;
+      other[i] = 0.1 * i + (i % 2 ? 0.05 : -0.05);
+    }
+    auto flat = util::ssim(rows, other);
+    assertEqual(size_t(2), flat.size(), "One value per row");
+    assertTrue(flat[0] < 1.0 && flat[0] > 0.0, "Row SSIM in range");
+
+    util::SSIMOptions even;
+    even.window = 4;
+    assertThrows<std::invalid_argument>([&]() { util::ssim(rows, other, even); },
+                                        "Even window");
+  }
+};
+
+/**
+ * @class DenoisingMetricsTest
+ * @brief Test that denoising evaluation reports the real metrics
+ */
+class DenoisingMetricsTest : public TestCase {
+public:
+  DenoisingMetricsTest() : TestCase("DenoisingMetricsTest") {}
+
+protected:
+  void test() override {
+    auto model =
+        model::autoencoder::DenoisingAutoencoder::create_for_images(4, 4, 1, 8);
+    assertEqual(size_t(3), model->get_denoising_config().image_shape.size(),
+                "Image shape recorded");
+
+    std::vector<NDArray> clean;
+    std::vector<NDArray> noisy;
+    for (int i = 0; i < 5; ++i) {
+      NDArray sample({1, 16});
+      for (size_t j = 0; j < 16; ++j) {
+        sample[j] = 0.05 * static_cast<double>((i + j) % 10);
+      }
+      clean.push_back(sample);
+      noisy.push_back(sample);
+    }
+
+    auto denoised = model->denoise(noisy);
+    double expected_mse = 0.0;
+    for (size_t i = 0; i < clean.size(); ++i) {
+      for (size_t j = 0; j < 16; ++j) {
+        double d = clean[i][j] - denoised[i][j];
+        expected_mse += d * d / 16.0;
+      }
+    }
+    expected_mse /= clean.size();
+
+    auto metrics = model->evaluate_denoising(clean, noisy);
+    assertNear(expected_mse, metrics["mse"], 1e-12, "MSE of the denoised set");
+    assertTrue(metrics["psnr"] > 0.0, "PSNR reported");
+    assertTrue(metrics["ssim"] >= -1.0 && metrics["ssim"] < 1.0,
+               "SSIM reported");
+
+    const NDArray& sample = clean[3];
+    double error = model->reconstruction_error(sample, "mse");
+    double rmse = model->reconstruction_error(sample, "rmse");
+    assertTrue(error > 0.0, "Reconstruction error is measured");
+    assertNear(std::sqrt(error), rmse, 1e-12, "RMSE is the root of MSE");
+    assertThrows<std::invalid_argument>(
+        [&]() { model->reconstruction_error(sample, "psnr"); },
+        "Unknown metric");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
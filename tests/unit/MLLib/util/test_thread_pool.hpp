@@ -0,0 +1,94 @@
+/**
+ * @file test_thread_pool.hpp
+ * @brief Unit tests for the worker thread pool
+ */
+
+#pragma once
+
+#include "../../../../include/MLLib/util/system/thread.hpp"
+#include "../../../common/test_utils.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace MLLib {
+namespace test {
+
+/**
+ * @class ThreadPoolSubmitTest
+ * @brief Test task submission, results and exception propagation
+ */
+class ThreadPoolSubmitTest : public TestCase {
+public:
+  ThreadPoolSubmitTest() : TestCase("ThreadPoolSubmitTest") {}
+
+protected:
+  void test() override {
+    util::ThreadPool pool(3);
+    assertEqual(size_t(3), pool.size(), "Worker count");
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 16; ++i) {
+      results.push_back(pool.submit([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 16; ++i) {
+      assertEqual(i * i, results[i].get(), "Task result");
+    }
+
+    auto failing = pool.submit([]() -> int {
+      throw std::runtime_error("task failed");
+    });
+    assertThrows<std::runtime_error>([&]() { failing.get(); },
+                                     "Exception should reach the future");
+
+    assertFalse(pool.is_worker_thread(), "Test thread is not a worker");
+    assertTrue(pool.submit([&pool]() { return pool.is_worker_thread(); }).get(),
+               "Tasks run on workers");
+  }
+};
+
+/**
+ * @class ThreadPoolParallelForTest
+ * @brief Test parallel_for coverage, nesting and errors
+ */
+class ThreadPoolParallelForTest : public TestCase {
+public:
+  ThreadPoolParallelForTest() : TestCase("ThreadPoolParallelForTest") {}
+
+protected:
+  void test() override {
+    util::ThreadPool pool(4);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(0, hits.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) hits[i]++;
+    });
+    bool exactly_once = true;
+    for (auto& hit : hits) exactly_once = exactly_once && hit == 1;
+    assertTrue(exactly_once, "Every index visited exactly once");
+
+    // Nested loops from workers run inline instead of deadlocking
+    std::atomic<size_t> total{0};
+    pool.parallel_for(0, 8, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        pool.parallel_for(0, 10, [&](size_t b, size_t e) { total += e - b; });
+      }
+    });
+    assertEqual(size_t(80), total.load(), "Nested parallel_for");
+
+    assertThrows<std::invalid_argument>(
+        [&]() {
+          pool.parallel_for(0, 100, [](size_t begin, size_t) {
+            if (begin > 0) throw std::invalid_argument("chunk failed");
+          });
+        },
+        "Chunk exceptions should be rethrown");
+
+    size_t calls = 0;
+    pool.parallel_for(5, 5, [&](size_t, size_t) { ++calls; });
+    assertEqual(size_t(0), calls, "Empty range does nothing");
+  }
+};
+
+}  // namespace test
+}  // namespace MLLib
@@ -1,19 +1,41 @@
 #include "../common/test_utils.hpp"
+#include "MLLib/backend/test_backend_dispatch.hpp"
+#include "MLLib/backend/test_device_residency.hpp"
+#include "MLLib/backend/test_expression_kernel.hpp"
 #include "MLLib/backend/test_gpu_backend.hpp"
+#include "MLLib/backend/test_placement.hpp"
+#include "MLLib/backend/test_stream.hpp"
+#include "MLLib/data/test_window.hpp"
+#include "MLLib/device/test_device_discovery.hpp"
+#include "MLLib/device/test_numa.hpp"
 #include "MLLib/layer/activation/test_activation.hpp"
 #include "MLLib/layer/activation/test_elu.hpp"
 #include "MLLib/layer/activation/test_gelu.hpp"
 #include "MLLib/layer/activation/test_leaky_relu.hpp"
 #include "MLLib/layer/activation/test_softmax.hpp"
 #include "MLLib/layer/activation/test_swish.hpp"
+#include "MLLib/layer/test_attention.hpp"
+#include "MLLib/layer/test_convolution2d.hpp"
 #include "MLLib/layer/test_dense.hpp"
+#include "MLLib/layer/test_pruning.hpp"
+#include "MLLib/layer/test_recurrent.hpp"
 #include "MLLib/model/autoencoder/test_base_autoencoder.hpp"
+#include "MLLib/model/autoencoder/test_conv_autoencoder.hpp"
+#include "MLLib/model/autoencoder/test_lstm_autoencoder.hpp"
+#include "MLLib/model/autoencoder/test_sparse_autoencoder.hpp"
+#include "MLLib/model/autoencoder/test_denoising_training.hpp"
+#include "MLLib/model/autoencoder/test_vae_batched.hpp"
+#include "MLLib/model/autoencoder/test_window_anomaly.hpp"
+#include "MLLib/model/autoencoder/test_variational_autoencoder.hpp"
 #include "MLLib/model/test_autoencoder_model_io.hpp"
+#include "MLLib/model/test_batching_executor.hpp"
+#include "MLLib/model/test_concurrent_inference.hpp"
 #include "MLLib/model/test_json_io.hpp"
 #include "MLLib/model/test_large_sequential_model_io.hpp"
 #include "MLLib/model/test_model_io.hpp"
 #include "MLLib/model/test_sequential.hpp"
 #include "MLLib/model/test_sequential_model_io.hpp"
+#include "MLLib/model/test_static_sequential.hpp"
 #include "MLLib/optimizer/test_adadelta.hpp"
 #include "MLLib/optimizer/test_adagrad.hpp"
 #include "MLLib/optimizer/test_adam.hpp"
@@ -21,9 +43,12 @@
 #include "MLLib/optimizer/test_rmsprop.hpp"
 #include "MLLib/test_config.hpp"
 #include "MLLib/test_ndarray.hpp"
+#include "MLLib/test_sparse.hpp"
+#include "MLLib/util/test_random.hpp"
+#include "MLLib/util/test_stats.hpp"
+#include "MLLib/util/test_thread_pool.hpp"
 // Temporarily disable other autoencoder tests
 // #include "MLLib/model/autoencoder/test_dense_autoencoder.hpp"
-// #include "MLLib/model/autoencoder/test_variational_autoencoder.hpp"
 // #include "MLLib/model/autoencoder/test_denoising_autoencoder.hpp"
 // #include "MLLib/model/autoencoder/test_anomaly_detector.hpp"
 #include <chrono>
@@ -76,6 +101,14 @@ int main() {
   runTest(std::make_unique<NDArrayArithmeticTest>());
   runTest(std::make_unique<NDArrayMatmulTest>());
   runTest(std::make_unique<NDArrayErrorTest>());
+  runTest(std::make_unique<NDArrayBroadcastTest>());
+  runTest(std::make_unique<NDArrayReductionTest>());
+  runTest(std::make_unique<NDArrayExpressionTest>());
+
+  // Sparse matrix tests
+  printf("\n--- Sparse Matrix Tests ---\n");
+  runTest(std::make_unique<SparseMatrixTest>());
+  runTest(std::make_unique<SparseDenseLayerTest>());
 
   // Dense layer tests
   printf("\n--- Dense Layer Tests ---\n");
@@ -84,6 +117,25 @@ int main() {
   runTest(std::make_unique<DenseBackwardTest>());
   runTest(std::make_unique<DenseParameterTest>());
 
+  // Pruning tests
+  printf("\n--- Pruning Tests ---\n");
+  runTest(std::make_unique<PruningTest>());
+  runTest(std::make_unique<BlockSparseDenseTest>());
+
+  // Convolution layer tests
+  printf("\n--- Convolution Layer Tests ---\n");
+  runTest(std::make_unique<Conv2DTest>());
+  runTest(std::make_unique<ConvTranspose2DTest>());
+
+  // Recurrent layer tests
+  printf("\n--- Recurrent Layer Tests ---\n");
+  runTest(std::make_unique<LSTMTest>());
+  runTest(std::make_unique<GRUTest>());
+
+  // Attention layer tests
+  printf("\n--- Attention Layer Tests ---\n");
+  runTest(std::make_unique<MultiHeadAttentionTest>());
+
   // Activation function tests
   printf("\n--- Activation Function Tests ---\n");
   runTest(std::make_unique<ReLUTest>());
@@ -133,6 +185,14 @@ int main() {
   // Sequential model tests
   printf("\n--- Sequential Model Tests ---\n");
   runTest(std::make_unique<SequentialModelTests>());
+  runTest(std::make_unique<SequentialConstInferenceTest>());
+  runTest(std::make_unique<SequentialConcurrentPredictTest>());
+  runTest(std::make_unique<SequentialBatchedPredictTest>());
+  runTest(std::make_unique<StaticSequentialTest>());
+  runTest(std::make_unique<BatchingExecutorBatchTest>());
+  runTest(std::make_unique<BatchingExecutorConcurrencyTest>());
+  runTest(std::make_unique<BatchingExecutorDeadlineTest>());
+  runTest(std::make_unique<BatchingExecutorBackpressureTest>());
 
   // GPU backend tests
   printf("\n--- GPU Backend Tests ---\n");
@@ -143,6 +203,61 @@ int main() {
   runTest(std::make_unique<GPUModelTest>());
   runTest(std::make_unique<GPUPerformanceTest>());
 
+  // Backend stream tests
+  printf("\n--- Backend Stream Tests ---\n");
+  runTest(std::make_unique<StreamOrderingTest>());
+  runTest(std::make_unique<StreamEventTest>());
+  runTest(std::make_unique<StreamPredictTest>());
+
+  // Backend dispatch tests
+  printf("\n--- Backend Dispatch Tests ---\n");
+  runTest(std::make_unique<BackendDispatchTableTest>());
+  runTest(std::make_unique<StaticBackendTest>());
+  runTest(std::make_unique<DenseBackendDispatchTest>());
+  runTest(std::make_unique<BackendAccumulateTest>());
+
+  // Expression kernel tests
+  printf("\n--- Expression Kernel Tests ---\n");
+  runTest(std::make_unique<ExpressionKernelCompileTest>());
+  runTest(std::make_unique<ExpressionKernelParallelTest>());
+  runTest(std::make_unique<ActivationRegistryCPUTest>());
+
+  // Placement scheduler tests
+  printf("\n--- Placement Scheduler Tests ---\n");
+  runTest(std::make_unique<CostProfileBenchmarkTest>());
+  runTest(std::make_unique<PlacementDecisionTest>());
+  runTest(std::make_unique<AutoPlacementBackendTest>());
+
+  // Device residency tests
+  printf("\n--- Device Residency Tests ---\n");
+  runTest(std::make_unique<DeviceResidencyChainTest>());
+  runTest(std::make_unique<DeviceResidencyInvalidationTest>());
+  runTest(std::make_unique<DeviceResidencyConcurrentReadTest>());
+  runTest(std::make_unique<DeviceResidencyConcurrentPredictTest>());
+
+  // Device discovery tests
+  printf("\n--- Device Discovery Tests ---\n");
+  runTest(std::make_unique<DeviceSysfsDiscoveryTest>());
+  runTest(std::make_unique<DeviceDiscoveryConcurrencyTest>());
+  runTest(std::make_unique<DeviceCapabilityCacheTest>());
+  runTest(std::make_unique<NUMATopologyTest>());
+  runTest(std::make_unique<NUMASubDeviceTest>());
+
+  // Utility tests
+  printf("\n--- Thread Pool Tests ---\n");
+  runTest(std::make_unique<ThreadPoolSubmitTest>());
+  runTest(std::make_unique<ThreadPoolParallelForTest>());
+
+  printf("\n--- Random Tests ---\n");
+  runTest(std::make_unique<PhiloxReproducibilityTest>());
+  runTest(std::make_unique<RandomDistributionTest>());
+  runTest(std::make_unique<RandomNoiseKernelTest>());
+
+  printf("\n--- Metrics Tests ---\n");
+  runTest(std::make_unique<ErrorMetricsTest>());
+  runTest(std::make_unique<SSIMTest>());
+  runTest(std::make_unique<DenoisingMetricsTest>());
+
   // Model I/O tests
   printf("\n--- Model I/O Tests ---\n");
   runTest(std::make_unique<ModelFormatTest>());
@@ -160,6 +275,27 @@ int main() {
   runTest(std::make_unique<AutoencoderErrorHandlingTest>());
   runTest(std::make_unique<AutoencoderBatchProcessingTest>());
 
+  printf("\n--- Variational Autoencoder Tests ---\n");
+  runTest(std::make_unique<VAEReparameterizationTest>());
+  runTest(std::make_unique<VAEBatchedTrainingTest>());
+
+  printf("\n--- Denoising Autoencoder Tests ---\n");
+  runTest(std::make_unique<DenoisingBatchTrainingTest>());
+
+  printf("\n--- Convolutional Autoencoder Tests ---\n");
+  runTest(std::make_unique<ConvAutoencoderTest>());
+
+  printf("\n--- Sparse Autoencoder Tests ---\n");
+  runTest(std::make_unique<SparseLatentGradientTest>());
+  runTest(std::make_unique<SparseAutoencoderTest>());
+
+  printf("\n--- LSTM Autoencoder Tests ---\n");
+  runTest(std::make_unique<LSTMAutoencoderTest>());
+
+  printf("\n--- Windowed Time Series Tests ---\n");
+  runTest(std::make_unique<WindowDatasetTest>());
+  runTest(std::make_unique<WindowAnomalyDetectionTest>());
+
   // Sequential Model I/O tests
   printf("\n--- Sequential Model I/O Tests ---\n");
   runTest(std::make_unique<SequentialModelIOTest>());
@@ -196,6 +332,7 @@ int main() {
     MLLib::test::autoencoder::test_autoencoder_training();
     MLLib::test::autoencoder::test_noise_addition();
     MLLib::test::autoencoder::test_model_save_load();
+    MLLib::test::autoencoder::run_variational_autoencoder_tests();
     printf("✅ All autoencoder tests completed\n");
   } catch (const std::exception& e) {
     printf("❌ Autoencoder tests failed: %s\n", e.what());